@@ -16,6 +16,7 @@
 #include <boost/nowide/iostream.hpp>
 #include <chrono>
 #include <cstdio>
+#include <mutex>
 #include <sstream>
 #ifdef WIN32
 #    include "Windows.h"
@@ -54,6 +55,7 @@ HeadlessGame::HeadlessGame(const GlobalGameSettings& ggs, const bfs::path& map,
         players_.push_back(AIFactory::Create(world_.GetPlayer(playerId).aiInfo, playerId, world_));
 
     world_.InitAfterLoad();
+    aiThreadPool_ = std::make_unique<AIThreadPool>(1);
 }
 
 HeadlessGame::~HeadlessGame()
@@ -61,6 +63,11 @@ HeadlessGame::~HeadlessGame()
     Close();
 }
 
+void HeadlessGame::SetNumAIThreads(const unsigned numThreads)
+{
+    aiThreadPool_ = std::make_unique<AIThreadPool>(numThreads);
+}
+
 void HeadlessGame::Run(unsigned maxGF)
 {
     AsyncChecksum checksum;
@@ -69,6 +76,10 @@ void HeadlessGame::Run(unsigned maxGF)
 
     game_.Start(false);
 
+    std::vector<AIPlayer*> ais;
+    for(auto& player : players_)
+        ais.push_back(player.get());
+
     while(em_.GetCurrentGF() < maxGF && !game_.IsGameFinished())
     {
         // In the actual game, the network frame intervall is based on ping (highest_ping < NFW-length < 20*gf_length).
@@ -96,20 +107,22 @@ void HeadlessGame::Run(unsigned maxGF)
             }
         }
 
-        for(auto& player : players_)
-            player->RunGF(em_.GetCurrentGF(), isnfw);
+        aiThreadPool_->RunGF(ais, em_.GetCurrentGF(), isnfw);
 
         game_.RunGF();
 
         if(replay_.IsRecording())
             replay_.UpdateLastGF(em_.GetCurrentGF());
 
-        if(std::chrono::steady_clock::now() > nextReport)
+        if(printProgress_ && std::chrono::steady_clock::now() > nextReport)
         {
             nextReport += std::chrono::seconds(1);
             PrintState();
         }
     }
+    // Don't mix the output of games running in parallel
+    static std::mutex printMutex;
+    std::lock_guard<std::mutex> lock(printMutex);
     PrintState();
 }
 
@@ -183,9 +196,8 @@ std::string HumanReadableNumber(unsigned num)
 
 void HeadlessGame::PrintState()
 {
-    static bool first_run = true;
-    if(first_run)
-        first_run = false;
+    if(!printedState_)
+        printedState_ = true;
     else
         printConsole("\x1b[%dA", 8 + world_.GetNumPlayers()); // Move cursor back up
 
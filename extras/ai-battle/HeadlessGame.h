@@ -7,6 +7,7 @@
 #include "Game.h"
 #include "Replay.h"
 #include "ai/AIPlayer.h"
+#include "ai/AIThreadPool.h"
 #include "gameTypes/AIInfo.h"
 #include <boost/filesystem.hpp>
 #include <chrono>
@@ -24,6 +25,10 @@ public:
     HeadlessGame(const GlobalGameSettings& ggs, const boost::filesystem::path& map, const std::vector<AI::Info>& ais);
     ~HeadlessGame();
 
+    /// Run the AIs on the given number of threads (0 or 1 = sequentially)
+    void SetNumAIThreads(unsigned numThreads);
+    /// Print the state every second while running (default). The final state is always printed
+    void SetPrintProgress(bool printProgress) { printProgress_ = printProgress; }
     void Run(unsigned maxGF = std::numeric_limits<unsigned>::max());
     void Close();
 
@@ -38,10 +43,14 @@ private:
     GameWorld& world_;
     EventManager& em_;
     std::vector<std::unique_ptr<AIPlayer>> players_;
+    std::unique_ptr<AIThreadPool> aiThreadPool_;
 
     Replay replay_;
     boost::filesystem::path replayPath_;
 
+    bool printProgress_ = true;
+    /// Whether the state was already printed, so the next print overwrites it
+    bool printedState_ = false;
     unsigned lastReportGf_ = 0;
     std::chrono::steady_clock::time_point gameStartTime_;
 };
@@ -2,6 +2,7 @@
 //
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "GFProfiler.h"
 #include "GlobalGameSettings.h"
 #include "HeadlessGame.h"
 #include "QuickStartGame.h"
@@ -14,14 +15,28 @@
 #include <boost/filesystem.hpp>
 #include <boost/nowide/args.hpp>
 #include <boost/nowide/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
 #include <boost/nowide/iostream.hpp>
 #include <boost/optional.hpp>
 #include <boost/program_options.hpp>
+#include <algorithm>
+#include <exception>
+#include <thread>
 
 namespace bnw = boost::nowide;
 namespace bfs = boost::filesystem;
 namespace po = boost::program_options;
 
+namespace {
+/// Path for the output of the game with the given index when running multiple games: <name>_<idx>.<ext>
+bfs::path getGamePath(const bfs::path& path, const unsigned gameIdx, const unsigned numGames)
+{
+    if(numGames <= 1)
+        return path;
+    return path.parent_path() / (path.stem().string() + "_" + std::to_string(gameIdx) + path.extension().string());
+}
+} // namespace
+
 int main(int argc, char** argv)
 {
     bnw::nowide_filesystem();
@@ -29,6 +44,7 @@ int main(int argc, char** argv)
 
     boost::optional<std::string> replay_path;
     boost::optional<std::string> savegame_path;
+    boost::optional<std::string> profile_path;
     unsigned random_init = static_cast<unsigned>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
     po::options_description desc("Allowed options");
@@ -42,6 +58,9 @@ int main(int argc, char** argv)
         ("save", po::value(&savegame_path),"Filename to write savegame to (optional)")
         ("random_init", po::value(&random_init),"Seed value for the random number generator (optional)")
         ("maxGF", po::value<unsigned>()->default_value(std::numeric_limits<unsigned>::max()),"Maximum number of game frames to run (optional)")
+        ("ai-threads", po::value<unsigned>()->default_value(1),"Number of threads to run the AIs on (optional)")
+        ("parallel-games", po::value<unsigned>()->default_value(1),"Number of games to run at the same time on separate threads. Game i uses random_init + i (optional)")
+        ("profile", po::value(&profile_path),"Filename to write a Chrome trace of the last GFs to (optional, requires RTTR_ENABLE_PROFILING)")
         ("version", "Show version information and exit")
         ;
     // clang-format on
@@ -88,10 +107,22 @@ int main(int argc, char** argv)
         bnw::cout << std::endl;
 
         RTTRCONFIG.Init();
-        RANDOM.Init(random_init);
 
         const bfs::path mapPath = RTTRCONFIG.ExpandPath(options["map"].as<std::string>());
         const std::vector<AI::Info> ais = ParseAIOptions(options["ai"].as<std::vector<std::string>>());
+        const unsigned numGames = std::max(1u, options["parallel-games"].as<unsigned>());
+
+        if(profile_path && !GFProfiler::isAvailable)
+        {
+            bnw::cerr << "Profiling is not available. Compile with RTTR_ENABLE_PROFILING to use it" << std::endl;
+            return 1;
+        }
+        // The profiler records the GFs of all games together
+        if(profile_path && numGames > 1)
+        {
+            bnw::cerr << "Profiling is only possible when running a single game" << std::endl;
+            return 1;
+        }
 
         GlobalGameSettings ggs;
         const auto objective = options["objective"].as<std::string>();
@@ -106,14 +137,61 @@ int main(int argc, char** argv)
         }
 
         ggs.objective = GameObjective::TotalDomination;
-        HeadlessGame game(ggs, mapPath, ais);
-        if(replay_path)
-            game.RecordReplay(*replay_path, random_init);
-
-        game.Run(options["maxGF"].as<unsigned>());
-        game.Close();
-        if(savegame_path)
-            game.SaveGame(*savegame_path);
+
+        // Each game runs on its own thread with its own RNG and game object context, so they don't affect each other
+        const auto runGame = [&](const unsigned gameIdx) {
+            const unsigned gameRandomInit = random_init + gameIdx;
+            RANDOM.Init(gameRandomInit);
+            HeadlessGame game(ggs, mapPath, ais);
+            game.SetNumAIThreads(options["ai-threads"].as<unsigned>());
+            // Progress of multiple games can't be shown in place
+            game.SetPrintProgress(numGames == 1);
+            if(replay_path)
+                game.RecordReplay(getGamePath(*replay_path, gameIdx, numGames), gameRandomInit);
+
+            game.Run(options["maxGF"].as<unsigned>());
+            game.Close();
+            if(savegame_path)
+                game.SaveGame(getGamePath(*savegame_path, gameIdx, numGames));
+        };
+        if(numGames == 1)
+            runGame(0);
+        else
+        {
+            std::vector<std::exception_ptr> errors(numGames);
+            std::vector<std::thread> threads;
+            for(unsigned i = 0; i < numGames; i++)
+            {
+                threads.emplace_back([&runGame, &errors, i]() {
+                    try
+                    {
+                        runGame(i);
+                    } catch(...)
+                    {
+                        errors[i] = std::current_exception();
+                    }
+                });
+            }
+            for(std::thread& thread : threads)
+                thread.join();
+            for(const std::exception_ptr& error : errors)
+            {
+                if(error)
+                    std::rethrow_exception(error);
+            }
+        }
+
+        if(profile_path)
+        {
+            bnw::ofstream traceFile(*profile_path);
+            GFProfiler::WriteChromeTrace(traceFile);
+            if(!traceFile)
+            {
+                bnw::cerr << "Could not write profile to " << *profile_path << std::endl;
+                return 1;
+            }
+            bnw::cout << "Profile written to " << *profile_path << std::endl;
+        }
     } catch(const std::exception& e)
     {
         bnw::cerr << e.what() << std::endl;
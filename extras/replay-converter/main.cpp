@@ -0,0 +1,59 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Replay.h"
+#include "ReplayKeyframes.h"
+#include <boost/filesystem/operations.hpp>
+#include <boost/nowide/args.hpp>
+#include <boost/nowide/filesystem.hpp>
+#include <boost/nowide/iostream.hpp>
+#include <exception>
+
+namespace bnw = boost::nowide;
+namespace bfs = boost::filesystem;
+
+/// Convert replays of older formats to the current one, i.e. with the commands stored in indexed compressed blocks
+int main(int argc, char** argv)
+{
+    bnw::nowide_filesystem();
+    bnw::args _(argc, argv);
+
+    if(argc < 2 || argc > 3)
+    {
+        bnw::cerr << "Usage: " << argv[0] << " <replay> [<output>]" << std::endl
+                  << "Converts the replay to the current format. Without output the replay is replaced." << std::endl;
+        return 1;
+    }
+
+    try
+    {
+        const bfs::path srcPath = argv[1];
+        const bool inPlace = argc == 2;
+        const bfs::path dstPath = inPlace ? bfs::path(srcPath).concat(".tmp") : bfs::path(argv[2]);
+        if(bfs::exists(dstPath))
+        {
+            bnw::cerr << dstPath << " already exists" << std::endl;
+            return 1;
+        }
+
+        Replay replay;
+        if(!replay.Convert(srcPath, dstPath))
+        {
+            bnw::cerr << "Could not convert " << srcPath << ": " << replay.GetLastErrorMsg() << std::endl;
+            return 1;
+        }
+        if(inPlace)
+        {
+            bfs::rename(dstPath, srcPath);
+            // Keyframes refer to positions in the old file
+            bfs::remove(ReplayKeyframes::GetFilePath(srcPath));
+        }
+        bnw::cout << "Converted " << srcPath << std::endl;
+    } catch(const std::exception& e)
+    {
+        bnw::cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
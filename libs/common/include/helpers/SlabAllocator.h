@@ -0,0 +1,193 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "RTTR_Assert.h"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace helpers {
+
+/// Allocator for objects of different types which are frequently created and destroyed.
+/// Sizes are rounded up to a multiple of the granularity (size class) and taken from slabs holding many blocks of
+/// that size. Freed blocks are reused (LIFO) for the next allocation of the same size class.
+/// Sizes above maxBlockSize are passed to the system allocator.
+/// Memory of the slabs is only returned to the system when the allocator is destroyed.
+class SlabAllocator
+{
+public:
+    /// Step between the size classes. Also the alignment of all blocks
+    static constexpr size_t granularity = alignof(std::max_align_t);
+    static constexpr size_t maxBlockSize = 1024;
+    static constexpr size_t numSizeClasses = maxBlockSize / granularity;
+    /// Minimum size of a slab in bytes
+    static constexpr size_t minSlabSize = 16 * 1024;
+
+    struct Stats
+    {
+        /// Total number of allocations
+        size_t numAllocations = 0;
+        /// Number of blocks currently in use and the maximum of it
+        size_t numUsed = 0, maxUsed = 0;
+        /// Number of blocks in all slabs, i.e. usable without requesting memory from the system
+        size_t capacity = 0;
+    };
+
+    SlabAllocator() = default;
+    SlabAllocator(const SlabAllocator&) = delete;
+    SlabAllocator& operator=(const SlabAllocator&) = delete;
+    ~SlabAllocator()
+    {
+        // Late deallocations must not access freed memory, so leak the slabs if there are still blocks in use
+        for(SizeClass& sizeClass : sizeClasses_)
+        {
+            if(sizeClass.stats.numUsed == 0u)
+                continue;
+            for(auto& slab : sizeClass.slabs)
+                slab.release();
+        }
+    }
+
+    static constexpr size_t getSizeClass(size_t size) { return (std::max<size_t>(size, 1u) - 1u) / granularity; }
+    static constexpr size_t getBlockSize(size_t sizeClass) { return (sizeClass + 1u) * granularity; }
+
+    /// Return uninitialized memory of at least the given size
+    void* allocate(size_t size)
+    {
+        if(size > maxBlockSize)
+        {
+            void* mem = ::operator new(size);
+            onAllocation(largeStats_);
+            return mem;
+        }
+        SizeClass& sizeClass = sizeClasses_[getSizeClass(size)];
+        if(!sizeClass.freeList)
+            addSlab(sizeClass, getBlockSize(getSizeClass(size)));
+        Block* block = sizeClass.freeList;
+        sizeClass.freeList = block->nextFree;
+        onAllocation(sizeClass.stats);
+        return block;
+    }
+    /// Return memory obtained by allocate() with the same size to the allocator
+    void deallocate(void* mem, size_t size)
+    {
+        RTTR_Assert(mem);
+        if(size > maxBlockSize)
+        {
+            RTTR_Assert(largeStats_.numUsed > 0u);
+            --largeStats_.numUsed;
+            ::operator delete(mem);
+            return;
+        }
+        SizeClass& sizeClass = sizeClasses_[getSizeClass(size)];
+        RTTR_Assert(sizeClass.stats.numUsed > 0u);
+        auto* block = static_cast<Block*>(mem);
+        block->nextFree = sizeClass.freeList;
+        sizeClass.freeList = block;
+        --sizeClass.stats.numUsed;
+    }
+
+    /// Return memory obtained by allocate() of an allocator which was destroyed while it was still in use.
+    /// Blocks from slabs are left alone as their slabs were leaked by the allocator
+    static void deallocateOrphaned(void* mem, size_t size)
+    {
+        RTTR_Assert(mem);
+        if(size > maxBlockSize)
+            ::operator delete(mem);
+    }
+
+    const Stats& getStats(size_t sizeClass) const { return sizeClasses_[sizeClass].stats; }
+    /// Statistics of the allocations bigger than maxBlockSize. Capacity is always 0
+    const Stats& getLargeStats() const { return largeStats_; }
+    /// Bytes requested from the system for slabs
+    size_t getReservedBytes() const
+    {
+        size_t result = 0;
+        for(size_t i = 0; i < numSizeClasses; i++)
+            result += sizeClasses_[i].stats.capacity * getBlockSize(i);
+        return result;
+    }
+
+    /// Call func(void* block, size_t blockSize) for each block from a slab currently in use.
+    /// Slow as it needs to find all free blocks, so only meant for statistics
+    template<class T_Func>
+    void forEachUsedBlock(T_Func&& func) const
+    {
+        std::vector<const Block*> freeBlocks;
+        for(size_t i = 0; i < numSizeClasses; i++)
+        {
+            const SizeClass& sizeClass = sizeClasses_[i];
+            if(sizeClass.stats.numUsed == 0u)
+                continue;
+            freeBlocks.clear();
+            for(const Block* block = sizeClass.freeList; block; block = block->nextFree)
+                freeBlocks.push_back(block);
+            std::sort(freeBlocks.begin(), freeBlocks.end(), std::less<const Block*>());
+            const size_t blockSize = getBlockSize(i);
+            const size_t unitsPerBlock = blockSize / granularity;
+            for(const auto& slab : sizeClass.slabs)
+            {
+                for(size_t j = 0; j < sizeClass.blocksPerSlab; j++)
+                {
+                    auto* block = reinterpret_cast<Block*>(slab.get() + j * unitsPerBlock);
+                    if(!std::binary_search(freeBlocks.begin(), freeBlocks.end(), block, std::less<const Block*>()))
+                        func(static_cast<void*>(block), blockSize);
+                }
+            }
+        }
+    }
+
+private:
+    /// Unit of which the slabs consist, a block spans one or more units
+    struct alignas(granularity) Unit
+    {
+        unsigned char data[granularity];
+    };
+    /// View of a free block
+    struct Block
+    {
+        Block* nextFree;
+    };
+    struct SizeClass
+    {
+        std::vector<std::unique_ptr<Unit[]>> slabs;
+        size_t blocksPerSlab = 0;
+        Block* freeList = nullptr;
+        Stats stats;
+    };
+
+    static void onAllocation(Stats& stats)
+    {
+        ++stats.numAllocations;
+        stats.maxUsed = std::max(stats.maxUsed, ++stats.numUsed);
+    }
+
+    static void addSlab(SizeClass& sizeClass, const size_t blockSize)
+    {
+        if(sizeClass.blocksPerSlab == 0u)
+            sizeClass.blocksPerSlab = std::max<size_t>(minSlabSize / blockSize, 8u);
+        const size_t unitsPerBlock = blockSize / granularity;
+        sizeClass.slabs.emplace_back(std::make_unique<Unit[]>(sizeClass.blocksPerSlab * unitsPerBlock));
+        Unit* slab = sizeClass.slabs.back().get();
+        // Link in reverse so blocks are handed out in address order
+        for(size_t i = sizeClass.blocksPerSlab; i > 0; --i)
+        {
+            auto* block = reinterpret_cast<Block*>(slab + (i - 1) * unitsPerBlock);
+            block->nextFree = sizeClass.freeList;
+            sizeClass.freeList = block;
+        }
+        sizeClass.stats.capacity += sizeClass.blocksPerSlab;
+    }
+
+    std::array<SizeClass, numSizeClasses> sizeClasses_;
+    Stats largeStats_;
+};
+
+} // namespace helpers
@@ -8,14 +8,17 @@
 #include "Game.h"
 #include "GameObject.h"
 #include "random/Random.h"
+#include "world/GameWorld.h"
 #include "s25util/Serializer.h"
 #include <ostream>
 
-AsyncChecksum::AsyncChecksum() : randChecksum(0), objCt(0), objIdCt(0), eventCt(0), evInstanceCt(0) {}
+AsyncChecksum::AsyncChecksum() : randChecksum(0), objCt(0), objIdCt(0), eventCt(0), evInstanceCt(0), worldDigest(0)
+{}
 
 AsyncChecksum::AsyncChecksum(unsigned randChecksum, unsigned objCt, unsigned objIdCt, unsigned eventCt,
-                             unsigned evInstanceCt)
-    : randChecksum(randChecksum), objCt(objCt), objIdCt(objIdCt), eventCt(eventCt), evInstanceCt(evInstanceCt)
+                             unsigned evInstanceCt, unsigned worldDigest)
+    : randChecksum(randChecksum), objCt(objCt), objIdCt(objIdCt), eventCt(eventCt), evInstanceCt(evInstanceCt),
+      worldDigest(worldDigest)
 {}
 
 void AsyncChecksum::Serialize(Serializer& ser) const
@@ -25,15 +28,17 @@ void AsyncChecksum::Serialize(Serializer& ser) const
     ser.PushUnsignedInt(objIdCt);
     ser.PushUnsignedInt(eventCt);
     ser.PushUnsignedInt(evInstanceCt);
+    ser.PushUnsignedInt(worldDigest);
 }
 
-void AsyncChecksum::Deserialize(Serializer& ser)
+void AsyncChecksum::Deserialize(Serializer& ser, const bool hasWorldDigest)
 {
     randChecksum = ser.PopUnsignedInt();
     objCt = ser.PopUnsignedInt();
     objIdCt = ser.PopUnsignedInt();
     eventCt = ser.PopUnsignedInt();
     evInstanceCt = ser.PopUnsignedInt();
+    worldDigest = hasWorldDigest ? ser.PopUnsignedInt() : 0;
 }
 
 unsigned AsyncChecksum::getHash() const
@@ -46,11 +51,13 @@ unsigned AsyncChecksum::getHash() const
 AsyncChecksum AsyncChecksum::create(const Game& game)
 {
     return AsyncChecksum(RANDOM.GetChecksum(), GameObject::GetNumObjs(), GameObject::GetObjIDCounter(),
-                         game.em_->GetNumActiveEvents(), game.em_->GetEventInstanceCtr());
+                         game.em_->GetNumActiveEvents(), game.em_->GetEventInstanceCtr(),
+                         game.world_.GetDigest().GetHash());
 }
 
 std::ostream& operator<<(std::ostream& os, const AsyncChecksum& checksum)
 {
     return os << "RandCS = " << checksum.randChecksum << ",\tobjects/ID = " << checksum.objCt << "/" << checksum.objIdCt
-              << ",\tevents/ID = " << checksum.eventCt << "/" << checksum.evInstanceCt;
+              << ",\tevents/ID = " << checksum.eventCt << "/" << checksum.evInstanceCt
+              << ",\tworld = " << checksum.worldDigest;
 }
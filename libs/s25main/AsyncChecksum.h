@@ -15,10 +15,14 @@ struct AsyncChecksum
     unsigned randChecksum;
     unsigned objCt, objIdCt;
     unsigned eventCt, evInstanceCt;
+    /// Hash of the world state (see WorldDigest), 0 if unknown (e.g. old replays)
+    unsigned worldDigest;
     AsyncChecksum();
-    AsyncChecksum(unsigned randChecksum, unsigned objCt, unsigned objIdCt, unsigned eventCt, unsigned evInstanceCt);
+    AsyncChecksum(unsigned randChecksum, unsigned objCt, unsigned objIdCt, unsigned eventCt, unsigned evInstanceCt,
+                  unsigned worldDigest = 0);
     void Serialize(Serializer& ser) const;
-    void Deserialize(Serializer& ser);
+    /// Read the checksum. The world digest is only read if hasWorldDigest is true (not stored by older versions)
+    void Deserialize(Serializer& ser, bool hasWorldDigest = true);
     /// Get a hash for this checksum
     unsigned getHash() const;
 
@@ -30,8 +34,10 @@ struct AsyncChecksum
 
 inline bool AsyncChecksum::operator==(const AsyncChecksum& rhs) const
 {
+    // An unknown world digest matches any other
     return randChecksum == rhs.randChecksum && objCt == rhs.objCt && objIdCt == rhs.objIdCt && eventCt == rhs.eventCt
-           && evInstanceCt == rhs.evInstanceCt;
+           && evInstanceCt == rhs.evInstanceCt
+           && (worldDigest == 0 || rhs.worldDigest == 0 || worldDigest == rhs.worldDigest);
 }
 
 inline bool AsyncChecksum::operator!=(const AsyncChecksum& rhs) const
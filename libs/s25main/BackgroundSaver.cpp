@@ -0,0 +1,52 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "BackgroundSaver.h"
+#include "Savegame.h"
+#include "Timer.h"
+#include <exception>
+
+BackgroundSaver::~BackgroundSaver()
+{
+    WaitForResult();
+}
+
+bool BackgroundSaver::Start(std::unique_ptr<Savegame> save, const boost::filesystem::path& filepath,
+                            const std::string& mapName, const duration snapshotTime)
+{
+    if(IsSaving())
+        return false;
+    pendingSave_ = std::async(std::launch::async, [save = std::move(save), filepath, mapName, snapshotTime]() {
+        Result result;
+        result.filepath = filepath;
+        result.snapshotTime = snapshotTime;
+        const Timer timer(true);
+        try
+        {
+            result.success = save->Save(filepath, mapName);
+            if(!result.success)
+                result.error = "Could not write file";
+        } catch(const std::exception& e)
+        {
+            result.error = e.what();
+        }
+        result.writeTime = timer.getElapsed();
+        return result;
+    });
+    return true;
+}
+
+std::optional<BackgroundSaver::Result> BackgroundSaver::FetchResult()
+{
+    if(!IsSaving() || pendingSave_.wait_for(std::chrono::seconds::zero()) != std::future_status::ready)
+        return std::nullopt;
+    return pendingSave_.get();
+}
+
+std::optional<BackgroundSaver::Result> BackgroundSaver::WaitForResult()
+{
+    if(!IsSaving())
+        return std::nullopt;
+    return pendingSave_.get();
+}
@@ -0,0 +1,53 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Clock.h"
+#include <boost/filesystem/path.hpp>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+
+class Savegame;
+
+/// Writes savegames in the background so the game does not stall while the game data is compressed and written.
+/// The snapshot of the game must be taken before (on the game thread), only writing the savegame is done in
+/// the background. At most 1 save can be in progress at any time.
+class BackgroundSaver
+{
+public:
+    using duration = Clock::duration;
+
+    struct Result
+    {
+        boost::filesystem::path filepath;
+        bool success = false;
+        /// Error message if not successful
+        std::string error;
+        /// Time used to take the snapshot of the game (on the game thread)
+        duration snapshotTime{};
+        /// Time used to compress and write the savegame (in the background)
+        duration writeTime{};
+    };
+
+    BackgroundSaver() = default;
+    /// Waits for a pending save
+    ~BackgroundSaver();
+
+    /// True if a save was started and its result was not yet fetched
+    bool IsSaving() const { return pendingSave_.valid(); }
+    /// Start writing the savegame whose game data already contains the snapshot of the game.
+    /// Returns false (and does nothing) if another save is still in progress
+    bool Start(std::unique_ptr<Savegame> save, const boost::filesystem::path& filepath, const std::string& mapName,
+               duration snapshotTime);
+    /// Return the result of the current save if it is finished
+    std::optional<Result> FetchResult();
+    /// Wait till the current save (if any) is finished and return its result
+    std::optional<Result> WaitForResult();
+
+private:
+    std::future<Result> pendingSave_;
+};
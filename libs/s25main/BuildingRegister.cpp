@@ -64,7 +64,7 @@ void BuildingRegister::Add(noBuildingSite* building_site)
 void BuildingRegister::Remove(noBuildingSite* building_site)
 {
     RTTR_Assert(helpers::contains(building_sites, building_site));
-    building_sites.remove(building_site);
+    helpers::erase(building_sites, building_site);
 }
 
 void BuildingRegister::Add(noBuilding* bld, BuildingType bldType)
@@ -94,25 +94,25 @@ void BuildingRegister::Remove(noBuilding* bld, BuildingType bldType)
     if(BuildingProperties::IsMilitary(bldType))
     {
         RTTR_Assert(helpers::contains(military_buildings, bld));
-        military_buildings.remove(static_cast<nobMilitary*>(bld));
+        helpers::erase(military_buildings, static_cast<nobMilitary*>(bld));
     } else if(BuildingProperties::IsWareHouse(bldType))
     {
         RTTR_Assert(helpers::contains(warehouses, bld));
-        warehouses.remove(static_cast<nobBaseWarehouse*>(bld));
+        helpers::erase(warehouses, static_cast<nobBaseWarehouse*>(bld));
     } else
     {
         RTTR_Assert(helpers::contains(buildings[bldType], bld));
-        buildings[bldType].remove(static_cast<nobUsual*>(bld));
+        helpers::erase(buildings[bldType], static_cast<nobUsual*>(bld));
     }
     if(bldType == BuildingType::HarborBuilding)
     {
         RTTR_Assert(helpers::contains(harbors, bld));
-        harbors.remove(static_cast<nobHarborBuilding*>(bld));
+        helpers::erase(harbors, static_cast<nobHarborBuilding*>(bld));
     }
 }
 
 /// Gibt Liste von Gebäuden des Spieler zurück
-const std::list<nobUsual*>& BuildingRegister::GetBuildings(const BuildingType type) const
+const std::vector<nobUsual*>& BuildingRegister::GetBuildings(const BuildingType type) const
 {
     RTTR_Assert(BuildingProperties::IsUsual(type));
     return buildings[type];
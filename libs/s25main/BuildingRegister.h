@@ -5,7 +5,6 @@
 #pragma once
 
 #include "gameTypes/BuildingCount.h"
-#include <list>
 #include <vector>
 
 class noBuilding;
@@ -16,6 +15,8 @@ class nobHarborBuilding;
 class nobBaseWarehouse;
 class SerializedGameData;
 
+/// All buildings and building sites of a player.
+/// Stored in vectors for fast iteration, keeping the order in which they were added as it influences the game
 class BuildingRegister
 {
 public:
@@ -31,11 +32,11 @@ public:
     void Add(noBuilding* bld, BuildingType bldType);
     void Remove(noBuilding* bld, BuildingType bldType);
 
-    const std::list<noBuildingSite*>& GetBuildingSites() const { return building_sites; }
-    const std::list<nobUsual*>& GetBuildings(BuildingType type) const;
-    const std::list<nobMilitary*>& GetMilitaryBuildings() const { return military_buildings; }
-    const std::list<nobHarborBuilding*>& GetHarbors() const { return harbors; }
-    const std::list<nobBaseWarehouse*>& GetStorehouses() const { return warehouses; }
+    const std::vector<noBuildingSite*>& GetBuildingSites() const { return building_sites; }
+    const std::vector<nobUsual*>& GetBuildings(BuildingType type) const;
+    const std::vector<nobMilitary*>& GetMilitaryBuildings() const { return military_buildings; }
+    const std::vector<nobHarborBuilding*>& GetHarbors() const { return harbors; }
+    const std::vector<nobBaseWarehouse*>& GetStorehouses() const { return warehouses; }
 
     /// Liefert die Anzahl aller Gebäude einzeln
     BuildingCount GetBuildingNums() const;
@@ -47,10 +48,10 @@ public:
     unsigned short CalcAverageProductivity() const;
 
 private:
-    std::list<noBuildingSite*> building_sites;
+    std::vector<noBuildingSite*> building_sites;
     // Only "usual" buildings
-    helpers::EnumArray<std::list<nobUsual*>, BuildingType> buildings;
-    std::list<nobMilitary*> military_buildings;
-    std::list<nobHarborBuilding*> harbors;
-    std::list<nobBaseWarehouse*> warehouses;
+    helpers::EnumArray<std::vector<nobUsual*>, BuildingType> buildings;
+    std::vector<nobMilitary*> military_buildings;
+    std::vector<nobHarborBuilding*> harbors;
+    std::vector<nobBaseWarehouse*> warehouses;
 };
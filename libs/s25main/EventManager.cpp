@@ -3,12 +3,14 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "EventManager.h"
+#include "GFProfiler.h"
 #include "GameEvent.h"
 #include "GameObject.h"
 #include "SerializedGameData.h"
 #include "helpers/containerUtils.h"
 #include "s25util/Log.h"
 #include <mygettext/mygettext.h>
+#include <algorithm>
 
 EventManager::EventManager(unsigned startGF)
     : numActiveEvents(0), eventInstanceCtr(1), currentGF(startGF), curActiveEvent(nullptr)
@@ -21,16 +23,18 @@ EventManager::~EventManager()
 
 void EventManager::Clear()
 {
-    for(const auto& event : events)
-    {
-        for(const GameEvent* ev : event.second)
-        {
-            delete ev;
-            RTTR_Assert(numActiveEvents > 0u);
-            numActiveEvents--;
-        }
-    }
-    events.clear();
+    const auto disposer = [this](GameEvent* ev) {
+        delete ev;
+        RTTR_Assert(numActiveEvents > 0u);
+        numActiveEvents--;
+    };
+    for(EventList& curEvents : nearEvents)
+        curEvents.clear_and_dispose(disposer);
+    for(EventList& curEvents : farEvents)
+        curEvents.clear_and_dispose(disposer);
+    for(auto& it : distantEvents)
+        it.second.clear_and_dispose(disposer);
+    distantEvents.clear();
     RTTR_Assert(numActiveEvents == 0u);
 
     for(auto* it : killList)
@@ -40,6 +44,7 @@ void EventManager::Clear()
         delete obj;
     }
     killList.clear();
+    killSet.clear();
 
     // Reset counters (next should already be 0 but just to be sure)
     numActiveEvents = 0u;
@@ -47,11 +52,30 @@ void EventManager::Clear()
     eventInstanceCtr = 1u;
 }
 
+EventManager::EventList* EventManager::GetEventList(const unsigned targetGF)
+{
+    const unsigned curBlock = GetBlock(currentGF);
+    const unsigned targetBlock = GetBlock(targetGF);
+    RTTR_Assert(targetBlock >= curBlock);
+    if(targetBlock - curBlock < 2u)
+        return &nearEvents[targetGF % numNearLists];
+    if(targetBlock - curBlock < 2u + numFarLists)
+        return &farEvents[targetBlock % numFarLists];
+    return nullptr;
+}
+
 const GameEvent* EventManager::AddEventToQueue(const GameEvent* event)
 {
     // Should be in the future!
     RTTR_Assert(event->GetTargetGF() > currentGF);
-    events[event->GetTargetGF()].push_back(event);
+    // Events are handed out as const to the objects but are owned (and modified) by us
+    auto& ev = const_cast<GameEvent&>(*event);
+    EventList* targetList = GetEventList(ev.GetTargetGF());
+    if(targetList)
+        targetList->push_back(ev);
+    else
+        distantEvents[ev.GetTargetGF()].push_back(ev);
+    ev.obj->events_.push_back(ev);
     ++numActiveEvents;
     return event;
 }
@@ -82,7 +106,7 @@ unsigned EventManager::GetNextEventInstanceId()
 
 void EventManager::ExecuteNextGF()
 {
-    currentGF++;
+    AdvanceToGF(currentGF + 1);
 
     ExecuteCurrentEvents();
     DestroyCurrentObjects();
@@ -96,6 +120,7 @@ void EventManager::DestroyCurrentObjects()
         GameObject* obj = it;
         // Object is no longer in the kill list (some may check this upon destruction)
         it = nullptr;
+        killSet.erase(obj);
         obj->Destroy();
         RTTR_Assert(!ObjectHasEvents(*obj));
         delete obj;
@@ -104,47 +129,129 @@ void EventManager::DestroyCurrentObjects()
     killList.clear();
 }
 
+void EventManager::AdvanceToGF(const unsigned gf)
+{
+    RTTR_Assert(gf >= currentGF);
+    if(numActiveEvents > 0u)
+    {
+        while(GetBlock(currentGF) != GetBlock(gf))
+        {
+            currentGF = (GetBlock(currentGF) + 1u) << blockSizeBits;
+            CascadeEvents();
+        }
+    }
+    currentGF = gf;
+}
+
+void EventManager::CascadeEvents()
+{
+    const unsigned curBlock = GetBlock(currentGF);
+    RTTR_Assert(currentGF == curBlock << blockSizeBits);
+    // The next block is now handled by the near wheel. Its lists are empty as they were used by the previous block
+    EventList& nextBlockEvents = farEvents[(curBlock + 1u) % numFarLists];
+    while(!nextBlockEvents.empty())
+    {
+        GameEvent& ev = nextBlockEvents.front();
+        nextBlockEvents.pop_front();
+        RTTR_Assert(GetBlock(ev.GetTargetGF()) == curBlock + 1u);
+        nearEvents[ev.GetTargetGF() % numNearLists].push_back(ev);
+    }
+    // The now empty list is used for the block which just got in range of the far wheel
+    const unsigned firstFarGF = (curBlock + 1u + numFarLists) << blockSizeBits;
+    const auto itEnd = distantEvents.lower_bound(firstFarGF + blockSize);
+    for(auto it = distantEvents.begin(); it != itEnd; it = distantEvents.erase(it))
+    {
+        RTTR_Assert(it->first >= firstFarGF);
+        nextBlockEvents.splice(nextBlockEvents.end(), it->second);
+    }
+}
+
 std::vector<const GameEvent*> EventManager::GetEvents() const
 {
     std::vector<const GameEvent*> nextEv;
-    for(const auto& event : events)
-        nextEv.insert(nextEv.end(), event.second.begin(), event.second.end());
+    nextEv.reserve(numActiveEvents);
+    const unsigned curBlock = GetBlock(currentGF);
+    const unsigned endNearGF = (curBlock + 2u) << blockSizeBits;
+    for(unsigned gf = currentGF; gf < endNearGF; gf++)
+    {
+        for(const GameEvent& ev : nearEvents[gf % numNearLists])
+            nextEv.push_back(&ev);
+    }
+    // Lists of the far wheel contain events of multiple GFs. Sort them keeping the order of events of the same GF
+    std::vector<const GameEvent*> blockEvents;
+    for(unsigned block = curBlock + 2u; block < curBlock + 2u + numFarLists; block++)
+    {
+        blockEvents.clear();
+        for(const GameEvent& ev : farEvents[block % numFarLists])
+            blockEvents.push_back(&ev);
+        std::stable_sort(blockEvents.begin(), blockEvents.end(), [](const GameEvent* lhs, const GameEvent* rhs) {
+            return lhs->GetTargetGF() < rhs->GetTargetGF();
+        });
+        nextEv.insert(nextEv.end(), blockEvents.begin(), blockEvents.end());
+    }
+    for(const auto& it : distantEvents)
+    {
+        for(const GameEvent& ev : it.second)
+            nextEv.push_back(&ev);
+    }
     return nextEv;
 }
 
-void EventManager::ExecuteCurrentEvents()
+unsigned EventManager::GetNextEventGF() const
 {
-    if(events.empty())
-        return;
-    // Get list of events to be executed next
-    auto itCurEvents = events.begin();
-
-    RTTR_Assert(itCurEvents->first >= currentGF);
-
-    if(itCurEvents->first == currentGF)
-        ExecuteEvents(itCurEvents);
+    if(numActiveEvents == 0u)
+        return 0;
+    const unsigned curBlock = GetBlock(currentGF);
+    const unsigned endNearGF = (curBlock + 2u) << blockSizeBits;
+    for(unsigned gf = currentGF; gf < endNearGF; gf++)
+    {
+        if(!nearEvents[gf % numNearLists].empty())
+            return gf;
+    }
+    for(unsigned block = curBlock + 2u; block < curBlock + 2u + numFarLists; block++)
+    {
+        const EventList& blockEvents = farEvents[block % numFarLists];
+        if(!blockEvents.empty())
+        {
+            return std::min_element(blockEvents.begin(), blockEvents.end(),
+                                    [](const GameEvent& lhs, const GameEvent& rhs) {
+                                        return lhs.GetTargetGF() < rhs.GetTargetGF();
+                                    })
+              ->GetTargetGF();
+        }
+    }
+    for(const auto& it : distantEvents)
+    {
+        if(!it.second.empty())
+            return it.first;
+    }
+    RTTR_Assert(false); // Event counter is wrong
+    return 0;
 }
 
-void EventManager::ExecuteEvents(const EventMap::iterator& itEvents)
+void EventManager::ExecuteCurrentEvents()
 {
-    EventList& curEvents = itEvents->second;
-    // We have to allow 2 cases:
-    // 1) Adding of events to current GF -> std::list allows this without invalidating any iterators
-    // 2) Checking for events -> Remove all deleted events so only valid ones are in the list
-    for(auto e_it = curEvents.begin(); e_it != curEvents.end(); e_it = curEvents.erase(e_it))
+    EventList& curEvents = nearEvents[currentGF % numNearLists];
+    // Events may add new events (for later GFs) or remove other events (also of this GF) while being executed.
+    // So always take the first remaining event.
+    while(!curEvents.empty())
     {
-        const GameEvent* ev = *e_it;
-        RTTR_Assert(ev->obj);
-        RTTR_Assert(ev->obj->GetObjId() <= GameObject::GetObjIDCounter());
+        GameEvent& ev = curEvents.front();
+        curEvents.pop_front();
+        RTTR_Assert(ev.GetTargetGF() == currentGF);
+        RTTR_Assert(ev.obj);
+        RTTR_Assert(ev.obj->GetObjId() <= GameObject::GetObjIDCounter());
 
-        curActiveEvent = ev;
-        ev->obj->HandleEvent(ev->id);
+        curActiveEvent = &ev;
+        {
+            RTTR_PROFILE_EVENT(ev.obj->GetGOT());
+            ev.obj->HandleEvent(ev.id);
+        }
 
-        delete ev;
+        delete &ev;
         --numActiveEvents;
     }
     curActiveEvent = nullptr;
-    events.erase(itEvents);
 }
 
 void EventManager::Serialize(SerializedGameData& sgd) const
@@ -183,35 +290,35 @@ void EventManager::Deserialize(SerializedGameData& sgd)
         boost::format eventCtError(_("Event count mismatch. Read events: %1%. Expected: %2%.\n"));
         throw SerializedGameData::Error((eventCtError % numActiveEvents % numEvents).str());
     }
-    for(const auto& it : events)
+    for(const GameEvent* ev : GetEvents())
     {
-        for(const GameEvent* ev : it.second)
+        if(ev->GetInstanceId() >= eventInstanceCtr)
         {
-            if(ev->GetInstanceId() >= eventInstanceCtr)
-            {
-                boost::format eventIdError(_("Invalid event instance id. Found: %1%. Expected less than %2%.\n"));
-                throw SerializedGameData::Error((eventIdError % ev->GetInstanceId() % eventInstanceCtr).str());
-            }
+            boost::format eventIdError(_("Invalid event instance id. Found: %1%. Expected less than %2%.\n"));
+            throw SerializedGameData::Error((eventIdError % ev->GetInstanceId() % eventInstanceCtr).str());
         }
     }
 }
 
+GameEvent* EventManager::DeserializeEvent(SerializedGameData& sgd, unsigned instanceId)
+{
+    return new GameEvent(sgd, instanceId);
+}
+
+void EventManager::DestroyEvent(const GameEvent* event)
+{
+    RTTR_Assert(!event || !event->GameEventQueueHook::is_linked());
+    delete event;
+}
+
 bool EventManager::ObjectHasEvents(const GameObject& obj)
 {
-    for(const auto& event : events)
-    {
-        for(const GameEvent* ev : event.second)
-        {
-            if(ev->obj == &obj)
-                return true;
-        }
-    }
-    return false;
+    return !obj.events_.empty();
 }
 
 bool EventManager::IsObjectInKillList(const GameObject& obj)
 {
-    return helpers::contains(killList, &obj);
+    return helpers::contains(killSet, &obj);
 }
 
 void EventManager::RemoveEvent(const GameEvent*& ep)
@@ -227,37 +334,38 @@ void EventManager::RemoveEvent(const GameEvent*& ep)
         return;
     }
     RemoveEventFromQueue(*ep);
-    deletePtr(ep);
+    delete ep;
+    ep = nullptr;
 }
 
 void EventManager::RemoveEventFromQueue(const GameEvent& event)
 {
     RTTR_Assert(curActiveEvent != &event);
-    auto itEventsAtTime = events.find(event.GetTargetGF());
-    if(itEventsAtTime != events.end())
+    if(!event.GameEventQueueHook::is_linked())
     {
-        EventList& eventsAtTime = itEventsAtTime->second;
-        auto e_it = helpers::find(eventsAtTime, &event);
-        if(e_it != eventsAtTime.end())
-        {
-            eventsAtTime.erase(e_it);
-            --numActiveEvents;
-            RTTR_Assert(!helpers::contains(eventsAtTime, &event)); // Event existed multiple times?
-        } else
+        RTTR_Assert(false);
+        LOG.write("Bug detected: Event to be removed did not exist");
+        return;
+    }
+    EventList* eventsAtTime = GetEventList(event.GetTargetGF());
+    if(eventsAtTime)
+    {
+        eventsAtTime->erase(EventList::s_iterator_to(event));
+    } else
+    {
+        const auto itEventsAtTime = distantEvents.find(event.GetTargetGF());
+        if(itEventsAtTime == distantEvents.end())
         {
             RTTR_Assert(false);
-            LOG.write("Bug detected: Event to be removed did not exist");
+            LOG.write("Bug detected: GF of event to be removed did not exist");
+            return;
         }
-
-        // Note: Removing this is possible, as it cannot be the currently processed list
-        //       because there is always the curActiveEvent left, which cannot be removed (check above)
-        if(eventsAtTime.empty())
-            events.erase(itEventsAtTime);
-    } else
-    {
-        RTTR_Assert(false);
-        LOG.write("Bug detected: GF of event to be removed did not exist");
+        itEventsAtTime->second.erase(EventList::s_iterator_to(event));
+        if(itEventsAtTime->second.empty())
+            distantEvents.erase(itEventsAtTime);
     }
+    const_cast<GameEvent&>(event).GameEventObjectHook::unlink();
+    --numActiveEvents;
 }
 
 void EventManager::AddToKillList(GameObject* obj)
@@ -265,6 +373,7 @@ void EventManager::AddToKillList(GameObject* obj)
     RTTR_Assert(obj);
     RTTR_Assert(!IsObjectInKillList(*obj));
     killList.emplace_back(obj);
+    killSet.insert(obj);
 }
 
 void EventManager::AddToKillList(std::unique_ptr<GameObject> obj)
@@ -4,13 +4,16 @@
 
 #pragma once
 
+#include "GameEvent.h"
+#include <boost/intrusive/list.hpp>
+#include <array>
 #include <list>
 #include <map>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 
 class SerializedGameData;
-class GameEvent;
 class GameObject;
 
 class EventManager
@@ -43,38 +46,65 @@ public:
 
     void Serialize(SerializedGameData& sgd) const;
     void Deserialize(SerializedGameData& sgd);
+    /// Create an event from the savegame. It is added to the queue by Deserialize
+    GameEvent* DeserializeEvent(SerializedGameData& sgd, unsigned instanceId);
+    /// Free an event that was created but not added to the queue
+    void DestroyEvent(const GameEvent* event);
 
     unsigned GetNextEventInstanceId();
 
     unsigned GetCurrentGF() const { return currentGF; }
 
-    /// Return true if the object has any active events. SLOW!
+    /// Return true if the object has any active events
     bool ObjectHasEvents(const GameObject& obj);
     /// Return true if the object will be destroyed after the current GF
     bool IsObjectInKillList(const GameObject& obj);
 
 protected:
-    // Use list to allow removing of events while iterating (Event A can cause Event B in the same GF to be removed)
-    using EventList = std::list<const GameEvent*>;
-    using EventMap = std::map<unsigned, EventList>;
+    // Events are stored in a hierarchical timing wheel with buckets of GFs:
+    // - The near wheel has one list per GF for the current and the next block of GFs
+    // - The far wheel has one list per block for the following blocks
+    // - All later events are stored in a map by GF
+    // Whenever a new block is reached the events of the next block are moved from the far wheel to the near wheel and
+    // the events of the block that just got in range of the far wheel are moved into it.
+    // Events are always moved before any event of the same GF can be added directly to the new list, so the lists keep
+    // the order in which events were added which is the order of execution (required for synchronity)
+    using EventList = boost::intrusive::list<GameEvent, boost::intrusive::base_hook<GameEventQueueHook>,
+                                             boost::intrusive::constant_time_size<false>>;
+    static constexpr unsigned blockSizeBits = 10;
+    static constexpr unsigned blockSize = 1u << blockSizeBits;
+    static constexpr unsigned numNearLists = 2 * blockSize;
+    static constexpr unsigned numFarLists = 256;
     // Use list to allow adding events while iterating (Destroying 1 object may lead to destruction of another)
     using GameObjList = std::list<GameObject*>;
     unsigned numActiveEvents;
     /// Instances created. Must be != 0
     unsigned eventInstanceCtr;
     unsigned currentGF;
-    EventMap events;      /// Mapping of GF to Events to be executed in this GF
+    std::array<EventList, numNearLists> nearEvents; /// Events in the current and next block, one list per GF
+    std::array<EventList, numFarLists> farEvents;   /// Events in the following blocks, one list per block
+    std::map<unsigned, EventList> distantEvents;    /// Mapping of GF to events for all later events
     GameObjList killList; /// Objects that will be killed after current GF
+    std::unordered_set<const GameObject*> killSet; /// Objects in the kill list for fast lookup
     const GameEvent* curActiveEvent;
 
     const GameEvent* AddEventToQueue(const GameEvent* event);
     void RemoveEventFromQueue(const GameEvent& event);
     /// Execute all events of the current GF
     void ExecuteCurrentEvents();
-    /// Execute the events from the given iterator
-    void ExecuteEvents(const EventMap::iterator& itEvents);
     /// Destroy all objects in the kill list
     void DestroyCurrentObjects();
     /// Get all events in the order they will be processed
     std::vector<const GameEvent*> GetEvents() const;
+    /// Return the GF of the next event to be executed or 0 if there are no events
+    unsigned GetNextEventGF() const;
+    /// Set the current GF to the given value. There must not be any events scheduled in between
+    void AdvanceToGF(unsigned gf);
+
+private:
+    static unsigned GetBlock(unsigned gf) { return gf >> blockSizeBits; }
+    /// Return the list the event for the given GF has to be stored in or nullptr if it is a distant event
+    EventList* GetEventList(unsigned targetGF);
+    /// Move the events of the next blocks to their new lists. Called when a new block was reached
+    void CascadeEvents();
 };
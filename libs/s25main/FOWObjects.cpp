@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "FOWObjects.h"
+#include "GameObject.h"
 #include "Loader.h"
 #include "SerializedGameData.h"
 #include "buildings/noBaseBuilding.h"
@@ -25,6 +26,24 @@ unsigned CalcPlayerFOWDrawColor(const unsigned color)
     return MakeColor(0xFF, red, green, blue);
 }
 
+////////////////////////////////////////////////////////////////////////////////////
+// FOWObject
+
+void* FOWObject::operator new(const size_t size)
+{
+    return GameObject::GetContext().fowObjAllocator.allocate(size);
+}
+
+void FOWObject::operator delete(void* ptr, const size_t size)
+{
+    if(!ptr)
+        return;
+    if(GameObject::Context* context = GameObject::TryGetContext())
+        context->fowObjAllocator.deallocate(ptr, size);
+    else
+        helpers::SlabAllocator::deallocateOrphaned(ptr, size);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 // fowBuilding
 
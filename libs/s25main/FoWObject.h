@@ -5,6 +5,7 @@
 #pragma once
 
 #include "DrawPoint.h"
+#include <cstddef>
 #include <cstdint>
 
 class SerializedGameData;
@@ -32,4 +33,8 @@ public:
     virtual void Draw(DrawPoint drawPt) const = 0;
     virtual void Serialize(SerializedGameData& sgd) const = 0;
     virtual FoW_Type GetType() const = 0;
+
+    /// Replaced whenever a player sees a change of a node, so allocated like the game objects (see GameObject::Context)
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
 };
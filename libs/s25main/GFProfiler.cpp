@@ -0,0 +1,198 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "GFProfiler.h"
+#include "helpers/EnumRange.h"
+#include <atomic>
+#include <mutex>
+#include <ostream>
+#include <utility>
+
+namespace {
+using clock = GFProfile::clock;
+using rep = GFProfile::duration::rep;
+
+/// Measurements of the GF currently running. Atomic where AIs may write concurrently
+struct CurrentMeasurements
+{
+    helpers::EnumArray<std::atomic<rep>, SimulationPhase> phaseTimes{};
+    helpers::EnumArray<rep, GO_Type> eventTimes{};
+    helpers::EnumArray<unsigned, GO_Type> numEvents{};
+    std::atomic<unsigned> numPathfinderCalls{0};
+    std::atomic<unsigned> numExpandedNodes{0};
+    // Each AI is run by only 1 thread
+    std::array<GFProfile::Span, MAX_PLAYERS> aiRuns{};
+
+    void MoveTo(GFProfile& profile)
+    {
+        for(const auto phase : helpers::enumRange<SimulationPhase>())
+            profile.phaseTimes[phase] = GFProfile::duration(phaseTimes[phase].exchange(0));
+        for(const auto objType : helpers::enumRange<GO_Type>())
+        {
+            profile.eventTimes[objType] = GFProfile::duration(std::exchange(eventTimes[objType], 0));
+            profile.numEvents[objType] = std::exchange(numEvents[objType], 0);
+        }
+        profile.numPathfinderCalls = numPathfinderCalls.exchange(0);
+        profile.numExpandedNodes = numExpandedNodes.exchange(0);
+        profile.aiRuns = std::exchange(aiRuns, {});
+    }
+};
+
+CurrentMeasurements current;
+/// Ring buffer of the profiles and position of the next one to write
+std::vector<GFProfile> profiles;
+unsigned nextProfileIdx = 0;
+std::mutex profilesMutex;
+
+/// Names of the object types. GO_Type starts at 1
+constexpr std::array<const char*, helpers::NumEnumValues_v<GO_Type>> objTypeNames = {
+  {"", "Nothing", "NobHq", "NobMilitary", "NobStorehouse", "NobUsual", "NobShipyard", "NobHarborbuilding",
+   "Buildingsite", "NofAggressivedefender", "NofAttacker", "NofDefender", "NofPassivesoldier", "NofWellguy",
+   "NofCarrier", "NofWoodcutter", "NofFisher", "NofForester", "NofCarpenter", "NofStonemason", "NofHunter",
+   "NofFarmer", "NofMiller", "NofBaker", "NofButcher", "NofMiner", "NofBrewer", "NofPigbreeder", "NofDonkeybreeder",
+   "NofIronfounder", "NofMinter", "NofMetalworker", "NofArmorer", "NofBuilder", "NofPlaner", "NofGeologist",
+   "NofShipwright", "NofScoutFree", "NofScoutLookouttower", "NofWarehouseworker", "NofCatapultman", "NofPassiveworker",
+   "NofCharburner", "Extension", "Envobject", "Fire", "Flag", "Grainfield", "Granite", "Sign", "Skeleton",
+   "Staticobject", "Disappearingmapenvobject", "Tree", "Animal", "Fighting", "Roadsegment", "Ware", "Catapultstone",
+   "Burnedwarehouse", "Shipbuildingsite", "Ship", "Charburnerpile", "NofTradeleader", "NofTradedonkey",
+   "Economymodehandler"}};
+
+double toMicroseconds(const GFProfile::duration time)
+{
+    return std::chrono::duration<double, std::micro>(time).count();
+}
+double toMicroseconds(const clock::time_point time)
+{
+    return toMicroseconds(time.time_since_epoch());
+}
+
+void writeCompleteEvent(std::ostream& os, const char* name, const GFProfile::Span& span, unsigned threadId)
+{
+    os << R"({"name":")" << name << R"(","ph":"X","pid":1,"tid":)" << threadId << R"(,"ts":)"
+       << toMicroseconds(span.start) << R"(,"dur":)" << toMicroseconds(span.length);
+}
+} // namespace
+
+std::vector<GFProfile> GFProfiler::GetProfiles()
+{
+    std::lock_guard<std::mutex> lock(profilesMutex);
+    std::vector<GFProfile> result;
+    result.reserve(profiles.size());
+    result.insert(result.end(), profiles.begin() + nextProfileIdx, profiles.end());
+    result.insert(result.end(), profiles.begin(), profiles.begin() + nextProfileIdx);
+    return result;
+}
+
+void GFProfiler::Clear()
+{
+    std::lock_guard<std::mutex> lock(profilesMutex);
+    profiles.clear();
+    nextProfileIdx = 0;
+    GFProfile ignored;
+    current.MoveTo(ignored);
+}
+
+void GFProfiler::WriteChromeTrace(std::ostream& os)
+{
+    const std::vector<GFProfile> gfProfiles = GetProfiles();
+    os << R"({"displayTimeUnit":"ms","traceEvents":[)" << '\n';
+    os << R"({"name":"thread_name","ph":"M","pid":1,"tid":0,"args":{"name":"Game"}})";
+    for(unsigned i = 0; i < MAX_PLAYERS; i++)
+        os << ",\n" << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << i + 1 << R"(,"args":{"name":"AI )" << i
+           << R"("}})";
+    for(const GFProfile& profile : gfProfiles)
+    {
+        os << ",\n";
+        writeCompleteEvent(os, "GF", profile.run, 0);
+        os << R"(,"args":{"gf":)" << profile.gf << R"(,"pathfinderCalls":)" << profile.numPathfinderCalls
+           << R"(,"expandedNodes":)" << profile.numExpandedNodes;
+        for(const auto objType : helpers::enumRange<GO_Type>())
+        {
+            if(profile.numEvents[objType] > 0u)
+                os << R"(,")" << GetName(objType) << R"(":")" << profile.numEvents[objType] << " events, "
+                   << toMicroseconds(profile.eventTimes[objType]) << R"(us")";
+        }
+        os << "}}";
+        for(unsigned i = 0; i < MAX_PLAYERS; i++)
+        {
+            if(profile.aiRuns[i].length == GFProfile::duration::zero())
+                continue;
+            os << ",\n";
+            writeCompleteEvent(os, "AI", profile.aiRuns[i], i + 1);
+            os << R"(,"args":{"gf":)" << profile.gf << "}}";
+        }
+        // Counters for the overview
+        os << ",\n"
+           << R"({"name":"Phases [us]","ph":"C","pid":1,"ts":)" << toMicroseconds(profile.run.start)
+           << R"(,"args":{)";
+        const char* separator = "";
+        for(const auto phase : helpers::enumRange<SimulationPhase>())
+        {
+            os << separator << '"' << getName(phase) << R"(":)" << toMicroseconds(profile.phaseTimes[phase]);
+            separator = ",";
+        }
+        os << "}},\n"
+           << R"({"name":"Pathfinding","ph":"C","pid":1,"ts":)" << toMicroseconds(profile.run.start)
+           << R"(,"args":{"calls":)" << profile.numPathfinderCalls << R"(,"expandedNodes":)"
+           << profile.numExpandedNodes << "}}";
+    }
+    os << "\n]}\n";
+}
+
+const char* GFProfiler::GetName(const GO_Type objType)
+{
+    return objTypeNames[rttr::enum_cast(objType)];
+}
+
+void GFProfiler::AddPhaseTime(const SimulationPhase phase, const duration time)
+{
+    current.phaseTimes[phase] += time.count();
+}
+
+void GFProfiler::AddPathfinderCall()
+{
+    current.numPathfinderCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+void GFProfiler::AddExpandedNode()
+{
+    current.numExpandedNodes.fetch_add(1, std::memory_order_relaxed);
+}
+
+GFProfiler::GFScope::GFScope(const unsigned gf) : gf_(gf), start_(clock::now()) {}
+
+GFProfiler::GFScope::~GFScope()
+{
+    GFProfile profile;
+    profile.gf = gf_;
+    profile.run.start = start_;
+    profile.run.length = clock::now() - start_;
+    current.MoveTo(profile);
+
+    std::lock_guard<std::mutex> lock(profilesMutex);
+    if(profiles.size() < maxNumProfiles)
+        profiles.push_back(profile);
+    else
+    {
+        profiles[nextProfileIdx] = profile;
+        nextProfileIdx = (nextProfileIdx + 1) % maxNumProfiles;
+    }
+}
+
+GFProfiler::EventScope::EventScope(const GO_Type objType) : objType_(objType), start_(clock::now()) {}
+
+GFProfiler::EventScope::~EventScope()
+{
+    current.eventTimes[objType_] += (clock::now() - start_).count();
+    ++current.numEvents[objType_];
+}
+
+GFProfiler::AIScope::AIScope(const unsigned playerId) : playerId_(playerId), start_(clock::now()) {}
+
+GFProfiler::AIScope::~AIScope()
+{
+    GFProfile::Span& span = current.aiRuns[playerId_];
+    span.start = start_;
+    span.length = clock::now() - start_;
+}
@@ -0,0 +1,120 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "SimulationPhaseTimes.h"
+#include "helpers/EnumArray.h"
+#include "gameTypes/GO_Type.h"
+#include "gameData/MaxPlayers.h"
+#include <array>
+#include <chrono>
+#include <iosfwd>
+#include <vector>
+
+/// Measurements of a single GF
+struct GFProfile
+{
+    using clock = std::chrono::steady_clock;
+    using duration = clock::duration;
+
+    /// A measured time span. Not measured if the length is zero
+    struct Span
+    {
+        clock::time_point start;
+        duration length{};
+    };
+
+    unsigned gf = 0;
+    /// Execution of the GF (Game::RunGF)
+    Span run;
+    /// Time spent in the phases of the simulation, which can overlap (see SimulationPhaseTimes)
+    helpers::EnumArray<duration, SimulationPhase> phaseTimes{};
+    /// Time spent handling events per type of the object receiving it
+    helpers::EnumArray<duration, GO_Type> eventTimes{};
+    helpers::EnumArray<unsigned, GO_Type> numEvents{};
+    /// Calls to the pathfinders and nodes taken from their open lists
+    unsigned numPathfinderCalls = 0;
+    unsigned numExpandedNodes = 0;
+    /// Execution of the AIs (AIPlayer::RunGF) which happens before the GF is executed
+    std::array<Span, MAX_PLAYERS> aiRuns{};
+};
+
+/// Records where the time of each GF is spent for finding the cause of lag spikes.
+/// The data of the last GFs is kept in a ring buffer and can be written as a Chrome trace (chrome://tracing).
+/// Only available if compiled with RTTR_ENABLE_PROFILING as measuring costs time even in the hottest paths.
+/// Use the RTTR_PROFILE_* macros to add measurements, which do nothing otherwise.
+class GFProfiler
+{
+public:
+    using duration = GFProfile::duration;
+
+#ifdef RTTR_ENABLE_PROFILING
+    static constexpr bool isAvailable = true;
+#else
+    static constexpr bool isAvailable = false;
+#endif
+    /// Number of GFs kept
+    static constexpr unsigned maxNumProfiles = 1000;
+
+    /// Return the profiles of the last GFs, oldest first
+    static std::vector<GFProfile> GetProfiles();
+    /// Remove all profiles and the current measurements
+    static void Clear();
+    /// Write the stored profiles in the Chrome trace event format (JSON)
+    static void WriteChromeTrace(std::ostream& os);
+    static const char* GetName(GO_Type objType);
+
+    static void AddPhaseTime(SimulationPhase phase, duration time);
+    static void AddPathfinderCall();
+    static void AddExpandedNode();
+
+    /// Measure the execution of a GF. All measurements made since the last GF are assigned to this one
+    class GFScope
+    {
+    public:
+        explicit GFScope(unsigned gf);
+        ~GFScope();
+
+    private:
+        unsigned gf_;
+        GFProfile::clock::time_point start_;
+    };
+
+    class EventScope
+    {
+    public:
+        explicit EventScope(GO_Type objType);
+        ~EventScope();
+
+    private:
+        GO_Type objType_;
+        GFProfile::clock::time_point start_;
+    };
+
+    class AIScope
+    {
+    public:
+        explicit AIScope(unsigned playerId);
+        ~AIScope();
+
+    private:
+        unsigned playerId_;
+        GFProfile::clock::time_point start_;
+    };
+};
+
+#ifdef RTTR_ENABLE_PROFILING
+#    define RTTR_PROFILE_GF(gf) const GFProfiler::GFScope rttrProfileGF(gf)
+#    define RTTR_PROFILE_EVENT(objType) const GFProfiler::EventScope rttrProfileEvent(objType)
+#    define RTTR_PROFILE_AI(playerId) const GFProfiler::AIScope rttrProfileAI(playerId)
+#    define RTTR_PROFILE_PATHFINDER_CALL() GFProfiler::AddPathfinderCall()
+#    define RTTR_PROFILE_EXPANDED_NODE() GFProfiler::AddExpandedNode()
+#else
+#    define RTTR_PROFILE_GF(gf) static_cast<void>(0)
+#    define RTTR_PROFILE_EVENT(objType) static_cast<void>(0)
+#    define RTTR_PROFILE_AI(playerId) static_cast<void>(0)
+#    define RTTR_PROFILE_PATHFINDER_CALL() static_cast<void>(0)
+#    define RTTR_PROFILE_EXPANDED_NODE() static_cast<void>(0)
+#endif
@@ -5,11 +5,14 @@
 #include "Game.h"
 #include "EconomyModeHandler.h"
 #include "EventManager.h"
+#include "GFProfiler.h"
 #include "GameInterface.h"
 #include "GamePlayer.h"
+#include "SimulationPhaseTimes.h"
 #include "addons/AddonEconomyModeGameLength.h"
 #include "addons/const_addons.h"
 #include "ai/AIPlayer.h"
+#include "ai/AIThreadPool.h"
 #include "lua/LuaInterfaceGame.h"
 #include "network/GameClient.h"
 #include "gameData/GameConsts.h"
@@ -51,6 +54,33 @@ void Game::AddAIPlayer(std::unique_ptr<AIPlayer> newAI)
     aiPlayers_.push_back(std::move(newAI));
 }
 
+void Game::SetNumAIThreads(const unsigned numThreads)
+{
+    if(numThreads > 1)
+        aiThreadPool_ = std::make_unique<AIThreadPool>(numThreads);
+    else
+        aiThreadPool_.reset();
+}
+
+void Game::RunAIs(const unsigned gf, const bool gfisnwf)
+{
+    SimulationPhaseTimer timer(SimulationPhase::AI);
+    if(!aiThreadPool_)
+    {
+        for(AIPlayer& ai : aiPlayers_)
+        {
+            RTTR_PROFILE_AI(ai.GetPlayerId());
+            ai.RunGF(gf, gfisnwf);
+        }
+        return;
+    }
+    std::vector<AIPlayer*> ais;
+    ais.reserve(aiPlayers_.size());
+    for(AIPlayer& ai : aiPlayers_)
+        ais.push_back(&ai);
+    aiThreadPool_->RunGF(ais, gf, gfisnwf);
+}
+
 void Game::SetLua(std::unique_ptr<LuaInterfaceGame> newLua)
 {
     lua = std::move(newLua);
@@ -72,9 +102,13 @@ unsigned getNumAlivePlayers(const GameWorldBase& world)
 
 void Game::RunGF()
 {
+    RTTR_PROFILE_GF(em_->GetCurrentGF());
     unsigned numPlayersAlive = getNumAlivePlayers(world_);
-    //  EventManager Bescheid sagen
-    em_->ExecuteNextGF();
+    {
+        //  EventManager Bescheid sagen
+        SimulationPhaseTimer timer(SimulationPhase::Events);
+        em_->ExecuteNextGF();
+    }
     // Notfallprogramm durchlaufen lassen
     for(unsigned i = 0; i < world_.GetNumPlayers(); ++i)
     {
@@ -100,6 +134,7 @@ void Game::RunGF()
 
 void Game::StatisticStep()
 {
+    SimulationPhaseTimer timer(SimulationPhase::Statistics);
     for(unsigned i = 0; i < world_.GetNumPlayers(); ++i)
         world_.GetPlayer(i).StatisticStep();
 
@@ -10,6 +10,7 @@
 #include <memory>
 
 class AIPlayer;
+class AIThreadPool;
 
 /// Holds all data for a running game
 class Game
@@ -31,6 +32,10 @@ public:
     bool IsGameFinished() const { return finished_; }
     AIPlayer* GetAIPlayer(unsigned id);
     void AddAIPlayer(std::unique_ptr<AIPlayer> newAI);
+    /// Run the AI players on the given number of threads (0 or 1 = sequentially)
+    void SetNumAIThreads(unsigned numThreads);
+    /// Execute the GF of all AI players
+    void RunAIs(unsigned gf, bool gfisnwf);
     void SetLua(std::unique_ptr<LuaInterfaceGame> newLua);
 
 private:
@@ -42,4 +47,5 @@ private:
 
     bool started_, finished_;
     std::unique_ptr<LuaInterfaceGame> lua;
+    std::unique_ptr<AIThreadPool> aiThreadPool_;
 };
@@ -10,9 +10,10 @@
 namespace gc {
 
 /// Current version of the game commands, see VersionedDeserializer.
+/// 1: World digest in the async checksum
 unsigned Deserializer::getCurrentVersion()
 {
-    return 0;
+    return 1;
 }
 
 GameCommandPtr GameCommand::Deserialize(Deserializer& ser)
@@ -20,6 +20,21 @@ GameEvent::GameEvent(SerializedGameData& sgd, const unsigned instanceId)
     RTTR_Assert(obj);
 }
 
+void* GameEvent::operator new(const size_t size)
+{
+    return GameObject::GetContext().eventAllocator.allocate(size);
+}
+
+void GameEvent::operator delete(void* ptr, const size_t size)
+{
+    if(!ptr)
+        return;
+    if(GameObject::Context* context = GameObject::TryGetContext())
+        context->eventAllocator.deallocate(ptr, size);
+    else
+        helpers::SlabAllocator::deallocateOrphaned(ptr, size);
+}
+
 void GameEvent::Serialize(SerializedGameData& sgd) const
 {
     sgd.PushObject(obj);
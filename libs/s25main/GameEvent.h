@@ -4,10 +4,20 @@
 
 #pragma once
 
+#include <boost/intrusive/list_hook.hpp>
+#include <cstddef>
+
 class GameObject;
 class SerializedGameData;
 
-class GameEvent
+/// Hook used by the EventManager to put the event in its queue
+using GameEventQueueHook = boost::intrusive::list_base_hook<>;
+struct GameEventObjectTag;
+/// Hook used to put the event in the list of events of its object. Unlinks itself on destruction
+using GameEventObjectHook = boost::intrusive::list_base_hook<boost::intrusive::tag<GameEventObjectTag>,
+                                                             boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+
+class GameEvent : public GameEventQueueHook, public GameEventObjectHook
 {
     const unsigned instanceId; /// unique ID
 public:
@@ -24,6 +34,11 @@ public:
     GameEvent(SerializedGameData& sgd, unsigned instanceId);
     void Serialize(SerializedGameData& sgd) const;
 
+    /// Events are frequently created and destroyed, so they are allocated by the allocator of the current context of
+    /// the game objects
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
     /// Return GF at which this event will be executed
     unsigned GetTargetGF() const { return startGF + length; }
     unsigned GetInstanceId() const { return instanceId; }
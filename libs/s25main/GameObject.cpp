@@ -8,42 +8,77 @@
 #include "postSystem/PostMsg.h"
 #include "world/GameWorld.h"
 #include <iostream>
+#include <utility>
 
-/**
- *  Objekt-ID-Counter.
- */
-unsigned GameObject::objIdCounter_ = 0;
-unsigned GameObject::objCounter_ = 0;
+namespace {
+/// Trivially destructible, so it can still be read after the thread context was destroyed
+thread_local bool isThreadContextDestroyed = false;
+} // namespace
 
-GameWorld* GameObject::world = nullptr;
+struct GameObject::ThreadContext : Context
+{
+    ~ThreadContext()
+    {
+        isThreadContextDestroyed = true;
+        if(currentContext_ == this)
+            currentContext_ = nullptr;
+    }
+};
+
+GameObject::Context& GameObject::GetThreadContext()
+{
+    RTTR_Assert(!isThreadContextDestroyed);
+    static thread_local ThreadContext threadContext;
+    currentContext_ = &threadContext;
+    return threadContext;
+}
+
+GameObject::Context* GameObject::TryGetContext()
+{
+    if(currentContext_)
+        return currentContext_;
+    return isThreadContextDestroyed ? nullptr : &GetThreadContext();
+}
+
+GameObject::ContextScope::ContextScope(Context& context) : previousContext_(std::exchange(currentContext_, &context))
+{}
+
+GameObject::ContextScope::~ContextScope()
+{
+    currentContext_ = previousContext_;
+}
 
-GameObject::GameObject() : objId(++objIdCounter_)
+GameObject::GameObject() : objId(++GetContext().objIdCounter)
 {
     // ein Objekt mehr
-    ++objCounter_;
+    ++GetContext().objCounter;
 }
 
 GameObject::GameObject(SerializedGameData& sgd, const unsigned obj_id) : objId(obj_id)
 {
     // ein Objekt mehr
-    ++objCounter_;
+    ++GetContext().objCounter;
     sgd.AddObject(this);
 }
 
 GameObject::GameObject(const GameObject& go) : objId(go.objId)
 {
     // ein Objekt mehr
-    ++objCounter_;
+    ++GetContext().objCounter;
 }
 
 void GameObject::Destroy() {}
 
 GameObject::~GameObject()
 {
+    Context* context = TryGetContext();
+    // Destroyed after the end of the thread's game (see TryGetContext)
+    if(!context)
+        return;
     // RTTR_Assert(!world || !GetEvMgr().ObjectHasEvents(*this));
-    RTTR_Assert(!world || !GetEvMgr().IsObjectInKillList(*this));
+    RTTR_Assert(!context->world || !context->world->GetEvMgr().IsObjectInKillList(*this));
     // ein Objekt weniger
-    --objCounter_;
+    --context->objCounter;
 }
 
 EventManager& GameObject::GetEvMgr()
@@ -58,16 +93,58 @@ void GameObject::SendPostMessage(unsigned player, std::unique_ptr<PostMsg> msg)
 
 void GameObject::DetachWorld(GameWorld* gameWorld)
 {
-    if(world == gameWorld)
-        world = nullptr;
+    if(GetContext().world == gameWorld)
+        GetContext().world = nullptr;
 }
 
 void GameObject::AttachWorld(GameWorld* gameWorld)
 {
-    world = gameWorld;
+    GetContext().world = gameWorld;
 }
 
 std::string GameObject::ToString() const
 {
     return "GameObject(" + std::to_string(objId) + ")";
 }
+
+void* GameObject::operator new(const size_t size)
+{
+    return GetContext().objAllocator.allocate(size);
+}
+
+void GameObject::operator delete(void* ptr, const size_t size)
+{
+    if(!ptr)
+        return;
+    if(Context* context = TryGetContext())
+        context->objAllocator.deallocate(ptr, size);
+    else
+        helpers::SlabAllocator::deallocateOrphaned(ptr, size);
+}
+
+helpers::EnumArray<GameObject::AllocationStats, GO_Type> GameObject::GetAllocationStats()
+{
+    helpers::EnumArray<AllocationStats, GO_Type> result{};
+    GetContext().objAllocator.forEachUsedBlock([&result](void* block, const size_t blockSize) {
+        // The GameObject is the first base of all objects, so it is at the start of the block
+        const auto* obj = static_cast<const GameObject*>(block);
+        RTTR_Assert(dynamic_cast<const void*>(obj) == block);
+        AllocationStats& stats = result[obj->GetGOT()];
+        stats.numObjects++;
+        stats.numBytes += blockSize;
+    });
+    return result;
+}
+
+GameObject::AllocationStats GameObject::GetEventAllocationStats()
+{
+    AllocationStats result;
+    const helpers::SlabAllocator& allocator = GetContext().eventAllocator;
+    for(size_t i = 0; i < helpers::SlabAllocator::numSizeClasses; i++)
+    {
+        const size_t numUsed = allocator.getStats(i).numUsed;
+        result.numObjects += static_cast<unsigned>(numUsed);
+        result.numBytes += numUsed * helpers::SlabAllocator::getBlockSize(i);
+    }
+    return result;
+}
@@ -4,8 +4,12 @@
 
 #pragma once
 
+#include "GameEvent.h"
 #include "commonDefines.h"
+#include "helpers/EnumArray.h"
+#include "helpers/SlabAllocator.h"
 #include "gameTypes/GO_Type.h"
+#include <boost/intrusive/list.hpp>
 #include <memory>
 #include <string>
 
@@ -40,6 +44,10 @@ public:
 
     virtual std::string ToString() const;
 
+    /// Game objects are frequently created and destroyed, so they are allocated by the allocator of the current context
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
 protected:
     // Following are some "sandbox methods". They avoid dependencies of subclasses to commonly used functions
     static EventManager& GetEvMgr();
@@ -47,38 +55,107 @@ protected:
     static void SendPostMessage(unsigned player, std::unique_ptr<PostMsg> msg);
 
 private:
+    friend class EventManager;
+    using EventList = boost::intrusive::list<GameEvent, boost::intrusive::base_hook<GameEventObjectHook>,
+                                             boost::intrusive::constant_time_size<false>>;
+
     unsigned objId; /// unique ID
+    /// Active events of this object. Managed by the EventManager
+    EventList events_;
 
     // Static members
 public:
+    /// State shared by all objects of a game.
+    /// There is one context per thread, so games running on different threads are independent of each other.
+    /// Other threads accessing the objects of a game (e.g. AIs) have to use its context via a ContextScope.
+    /// Objects must be freed on the thread (or in the scope) they were created in, as their memory belongs to the
+    /// allocators of that context. The context of a thread is destroyed at the thread's exit, which can be before
+    /// objects held by static or other thread local variables are freed (see TryGetContext).
+    struct Context
+    {
+        /// Zugriff auf übrige Spielwelt
+        GameWorld* world = nullptr;
+        unsigned objIdCounter = 0; /// Objekt-ID-Counter (number of objects created)
+        unsigned objCounter = 0;   /// Objekt-Counter (number of objects alive)
+        /// Memory of the game objects, their events and the FoW objects of this game
+        helpers::SlabAllocator objAllocator, eventAllocator, fowObjAllocator;
+    };
+    /// Use the given context on the current thread while this object exists
+    class ContextScope
+    {
+    public:
+        explicit ContextScope(Context& context);
+        ~ContextScope();
+        ContextScope(const ContextScope&) = delete;
+        ContextScope& operator=(const ContextScope&) = delete;
+
+    private:
+        Context* previousContext_;
+    };
+    /// Return the context used by the current thread
+    static Context& GetContext()
+    {
+        // Inline as it is used for every access to the world
+        if(currentContext_)
+            return *currentContext_;
+        return GetThreadContext();
+    }
+    /// Same but return nullptr if the context of the thread was already destroyed (at thread exit).
+    /// Objects freed afterwards skip the counters and leave their memory to the destroyed allocators
+    static Context* TryGetContext();
+
     /// Set the currently active world for all game objects
     static void AttachWorld(GameWorld* gameWorld);
     /// Remove the world from all game objects
     static void DetachWorld(GameWorld* gameWorld);
     /// Return the number of objects alive
-    static unsigned GetNumObjs() { return objCounter_; }
+    static unsigned GetNumObjs() { return GetContext().objCounter; }
     /// Gibt Obj-ID-Counter zurück
-    static unsigned GetObjIDCounter() { return objIdCounter_; }
+    static unsigned GetObjIDCounter() { return GetContext().objIdCounter; }
+    struct AllocationStats
+    {
+        unsigned numObjects = 0;
+        size_t numBytes = 0;
+    };
+    /// Return the number of objects alive and the memory used by them per type.
+    /// Only includes objects taken from the slabs (see SlabAllocator::maxBlockSize).
+    /// Slow, so only meant for statistics
+    static helpers::EnumArray<AllocationStats, GO_Type> GetAllocationStats();
+    /// Same for the events of all objects
+    static AllocationStats GetEventAllocationStats();
     /// Reset the object counter and the object ID counter to 0
     static void ResetCounters()
     {
-        objIdCounter_ = 0;
-        objCounter_ = 0;
+        Context& context = GetContext();
+        context.objIdCounter = 0;
+        context.objCounter = 0;
     }
     /// Set the objIdCounter to the given value and resets the object counter to 1 (noNodeObj)
     static void ResetCounters(unsigned objIdCounter)
     {
-        objIdCounter_ = objIdCounter;
-        objCounter_ = 1;
+        Context& context = GetContext();
+        context.objIdCounter = objIdCounter;
+        context.objCounter = 1;
     }
 
+private:
+    /// Context of the innermost ContextScope or the thread context once it was used. nullptr before that.
+    /// Trivially initialized, so it is accessed without the wrapper function of dynamically initialized thread locals
+    static inline thread_local Context* currentContext_ = nullptr;
+    struct ThreadContext;
+    /// Make the context of the thread the current one and return it
+    static Context& GetThreadContext();
+
 protected:
+    /// Behaves like a pointer to the world of the current context
+    struct WorldOfContext
+    {
+        GameWorld* operator->() const { return GetContext().world; }
+        GameWorld& operator*() const { return *GetContext().world; }
+        operator GameWorld*() const { return GetContext().world; }
+    };
     /// Zugriff auf übrige Spielwelt
-    static GameWorld* world;
-
-private:
-    static unsigned objIdCounter_; /// Objekt-ID-Counter (number of objects created)
-    static unsigned objCounter_;   /// Objekt-Counter (number of objects alive)
+    static constexpr WorldOfContext world{};
 };
 
 /// Calls destroy on a GameObject and then deletes it setting the ptr to nullptr
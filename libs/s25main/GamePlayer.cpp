@@ -322,47 +322,23 @@ nobBaseWarehouse* GamePlayer::FindWarehouse(const noRoadNode& start, const T_IsW
                                             bool to_wh, bool use_boat_roads, unsigned* length,
                                             const RoadSegment* forbidden) const
 {
-    nobBaseWarehouse* best = nullptr;
-
-    unsigned best_length = std::numeric_limits<unsigned>::max();
-
+    std::vector<nobBaseWarehouse*> goodWarehouses;
     for(nobBaseWarehouse* wh : buildings.GetStorehouses())
     {
         // Lagerhaus geeignet?
         RTTR_Assert(wh);
-        if(!isWarehouseGood(*wh))
-            continue;
-
-        if(start.GetPos() == wh->GetPos())
-        {
-            // We are already there -> Take it
-            if(length)
-                *length = 0;
-            return wh;
-        }
-
-        // now check if there is at least a chance that the next wh is closer than current best because pathfinding
-        // takes time
-        if(world.CalcDistance(start.GetPos(), wh->GetPos()) > best_length)
-            continue;
-        // Bei der erlaubten Benutzung von Bootsstraßen Waren-Pathfinding benutzen wenns zu nem Lagerhaus gehn soll
-        // start <-> ziel tauschen bei der wegfindung
-        unsigned tlength;
-        if(world.GetRoadPathFinder().FindPath(to_wh ? start : *wh, to_wh ? *wh : start, use_boat_roads, best_length,
-                                              forbidden, &tlength))
-        {
-            if(tlength < best_length || !best)
-            {
-                best_length = tlength;
-                best = wh;
-            }
-        }
+        if(isWarehouseGood(*wh))
+            goodWarehouses.push_back(wh);
     }
-
-    if(length)
-        *length = best_length;
-
-    return best;
+    if(goodWarehouses.empty())
+    {
+        if(length)
+            *length = std::numeric_limits<unsigned>::max();
+        return nullptr;
+    }
+    // A single search for all warehouses. Use ware pathfinding (including boat roads) if allowed
+    return world.GetRoadPathFinder().FindNearestWarehouse(start, goodWarehouses, to_wh, use_boat_roads, forbidden,
+                                                          length);
 }
 
 void GamePlayer::AddBuildingSite(noBuildingSite* bldSite)
@@ -405,6 +381,8 @@ void GamePlayer::AddBuilding(noBuilding* bld, BuildingType bldType)
 
     if(bldType == BuildingType::HarborBuilding)
     {
+        // New ship connections for paths on roads
+        world.RoadGraphChanged();
         // Schiff durchgehen und denen Bescheid sagen
         for(noShip* ship : ships)
             ship->NewHarborBuilt(static_cast<nobHarborBuilding*>(bld));
@@ -430,7 +408,9 @@ void GamePlayer::RemoveBuilding(noBuilding* bld, BuildingType bldType)
     buildings.Remove(bld, bldType);
     ChangeStatisticValue(StatisticType::Buildings, -1);
     if(bldType == BuildingType::HarborBuilding)
-    { // Schiffen Bescheid sagen
+    {
+        world.RoadGraphChanged();
+        // Schiffen Bescheid sagen
         for(noShip* ship : ships)
             ship->HarborDestroyed(static_cast<nobHarborBuilding*>(bld));
     } else if(bldType == BuildingType::Headquarters)
@@ -506,6 +486,14 @@ void GamePlayer::FindClientForLostWares()
 
 void GamePlayer::RoadDestroyed()
 {
+    // The connected components of the road network tell which goals are still reachable.
+    // Much cheaper than a path search which fails only after visiting the whole remaining network
+    RoadPathFinder& roadPathFinder = world.GetRoadPathFinder();
+    roadPathFinder.ResetWareComponents();
+    const auto canReachGoal = [&roadPathFinder](const Ware& ware) {
+        return ware.GetGoal() && roadPathFinder.IsConnectedForWares(*ware.GetLocation(), *ware.GetGoal());
+    };
+
     // Alle Waren, die an Flagge liegen und in Lagerhäusern, müssen gucken, ob sie ihr Ziel noch erreichen können, jetzt
     // wo eine Straße fehlt
     for(auto it = ware_list.begin(); it != ware_list.end();)
@@ -514,7 +502,7 @@ void GamePlayer::RoadDestroyed()
         if(ware->IsWaitingAtFlag()) // Liegt die Flagge an einer Flagge, muss ihr Weg neu berechnet werden
         {
             RoadPathDirection last_next_dir = ware->GetNextDir();
-            ware->RecalcRoute();
+            ware->RecalcRoute(canReachGoal(*ware));
             // special case: ware was lost some time ago and the new goal is at this flag and not a warehouse,hq,harbor
             // and the "flip-route" picked so a carrier would pick up the ware carry it away from goal then back and
             // drop  it off at the goal was just destroyed?
@@ -560,7 +548,8 @@ void GamePlayer::RoadDestroyed()
             }
         } else if(ware->IsWaitingInWarehouse())
         {
-            if(!ware->IsRouteToGoal())
+            // Same as IsRouteToGoal
+            if(!canReachGoal(*ware))
             {
                 // Das Ziel wird nun nich mehr beliefert
                 ware->NotifyGoalAboutLostWare();
@@ -573,7 +562,7 @@ void GamePlayer::RoadDestroyed()
         } else if(ware->IsWaitingForShip())
         {
             // Weg neu berechnen
-            ware->RecalcRoute();
+            ware->RecalcRoute(canReachGoal(*ware));
         }
 
         ++it;
@@ -1031,6 +1020,11 @@ noBaseBuilding* GamePlayer::FindClientForWare(const Ware& ware)
     // sort our clients, highest score first
     std::sort(possibleClients.begin(), possibleClients.end());
 
+    // All paths start at the same node, so continue one search for all clients
+    RoadPathFinder& roadPathFinder = world.GetRoadPathFinder();
+    if(!possibleClients.empty())
+        roadPathFinder.StartWareDistanceSearch(*start);
+
     noBaseBuilding* lastBld = nullptr;
     noBaseBuilding* bestBld = nullptr;
     unsigned best_points = 0;
@@ -1056,9 +1050,8 @@ noBaseBuilding* GamePlayer::FindClientForWare(const Ware& ware)
         // Find path ONLY if it may be better. Pathfinding is limited to the worst path score that would lead to a
         // better score. This eliminates the worst case scenario where all nodes in a split road network would be hit by
         // the pathfinding only to conclude that there is no possible path.
-        if(world.FindPathForWareOnRoads(*start, *possibleClient.bld, &path_length, nullptr,
-                                        (possibleClient.points - best_points) * 2 - 1)
-           != RoadPathDirection::None)
+        if(roadPathFinder.GetWareDistance(*possibleClient.bld, (possibleClient.points - best_points) * 2 - 1,
+                                          path_length))
         {
             unsigned score = possibleClient.points - (path_length / 2);
 
@@ -1104,6 +1097,8 @@ nobBaseMilitary* GamePlayer::FindClientForCoin(const Ware& ware) const
 {
     nobBaseMilitary* bb = nullptr;
     unsigned best_points = 0, points;
+    RoadPathFinder& roadPathFinder = world.GetRoadPathFinder();
+    bool isSearchStarted = false;
 
     // Militärgebäude durchgehen
     for(nobMilitary* milBld : buildings.GetMilitaryBuildings())
@@ -1114,8 +1109,13 @@ nobBaseMilitary* GamePlayer::FindClientForCoin(const Ware& ware) const
         // Wenn 0, will er gar keine Münzen (Goldzufuhr gestoppt)
         if(points)
         {
+            if(!isSearchStarted)
+            {
+                roadPathFinder.StartWareDistanceSearch(*ware.GetLocation());
+                isSearchStarted = true;
+            }
             // Weg dorthin berechnen
-            if(world.FindPathForWareOnRoads(*ware.GetLocation(), *milBld, &way_points) != RoadPathDirection::None)
+            if(roadPathFinder.GetWareDistance(*milBld, std::numeric_limits<unsigned>::max(), way_points))
             {
                 // Die Wegpunkte noch davon abziehen
                 points -= way_points;
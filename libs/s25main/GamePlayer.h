@@ -8,6 +8,7 @@
 #include "GamePlayerInfo.h"
 #include "helpers/EnumArray.h"
 #include "helpers/MultiArray.h"
+#include "pathfinding/RoadRouteCache.h"
 #include "variant.h"
 #include "gameTypes/BuildingType.h"
 #include "gameTypes/Inventory.h"
@@ -100,6 +101,8 @@ public:
     void AddBuildingSite(noBuildingSite* bldSite);
     void RemoveBuildingSite(noBuildingSite* bldSite);
     const BuildingRegister& GetBuildingRegister() const { return buildings; }
+    RoadRouteCache& GetRoadRouteCache() { return roadRouteCache; }
+    const RoadRouteCache& GetRoadRouteCache() const { return roadRouteCache; }
 
     /// Notify that a new road connection exists (not only an existing road splitted)
     void NewRoadConnection(RoadSegment* rs);
@@ -350,6 +353,8 @@ private:
 
     /// Lister aller Straßen von dem Spieler
     std::list<RoadSegment*> roads;
+    /// Next hops of figures walking on the roads to the most used goals
+    RoadRouteCache roadRouteCache;
 
     struct JobNeeded
     {
@@ -6,6 +6,7 @@
 
 #include "Loader.h"
 #include "ListDir.h"
+#include "RTTR_Version.h"
 #include "RttrConfig.h"
 #include "Settings.h"
 #include "Timer.h"
@@ -17,6 +18,7 @@
 #include "helpers/containerUtils.h"
 #include "ogl/MusicItem.h"
 #include "ogl/SoundEffectItem.h"
+#include "ogl/TextureAtlasCache.h"
 #include "ogl/glArchivItem_Bitmap_Player.h"
 #include "ogl/glArchivItem_Bitmap_RLE.h"
 #include "ogl/glArchivItem_Bitmap_Raw.h"
@@ -46,15 +48,19 @@
 #include "s25util/System.h"
 #include "s25util/strAlgos.h"
 #include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
 #include <boost/pointer_cast.hpp>
 #include <boost/range/adaptor/map.hpp>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstdio>
+#include <exception>
 #include <iomanip>
 #include <memory>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 struct Loader::FileEntry
 {
@@ -63,6 +69,16 @@ struct Loader::FileEntry
     ResolvedFile resolvedFile;
 };
 
+struct Loader::LoadTask
+{
+    ResourceId id;
+    ResolvedFile resolvedFile;
+    libsiedler2::Archiv archive;
+    bool failed = false;
+    /// Unexpected exception thrown while loading
+    std::exception_ptr error;
+};
+
 template<typename T>
 static T convertChecked(libsiedler2::ArchivItem* item)
 {
@@ -188,9 +204,16 @@ bool Loader::LoadFilesAtStart()
 {
     namespace res = s25::resources;
     // Palettes
-    if(!LoadFiles({res::pal5, res::pal6, res::pal7, res::paletti0, res::paletti1, res::paletti8})
-       || !Load(ResourceId("colors")))
-        return false;
+    {
+        std::vector<LoadTask> tasks;
+        for(const char* palette : {res::pal5, res::pal6, res::pal7, res::paletti0, res::paletti1, res::paletti8})
+        {
+            if(!AddLoadTask(tasks, config_.ExpandPath(palette)))
+                return false;
+        }
+        if(!AddLoadTask(tasks, ResourceId("colors")) || !RunLoadTasks(tasks, nullptr))
+            return false;
+    }
 
     if(!LoadFonts())
         return false;
@@ -210,13 +233,21 @@ bool Loader::LoadFilesAtStart()
             files.push_back((loadScreenFolders[1] / filename).string());
     }
 
-    if(!LoadFiles(files))
-        return false;
-
-    if(!LoadSounds())
+    std::vector<LoadTask> tasks;
+    for(const std::string& file : files)
+    {
+        if(!AddLoadTask(tasks, config_.ExpandPath(file)))
+            return false;
+    }
+    for(const char* resource : {"io_new", "client", "languages", "logo", "menu", "rttr"})
+    {
+        if(!AddLoadTask(tasks, ResourceId(resource)))
+            return false;
+    }
+    if(!RunLoadTasks(tasks, GetPaletteN("pal5")))
         return false;
 
-    return LoadResources({"io_new", "client", "languages", "logo", "menu", "rttr"});
+    return LoadSounds();
 }
 
 bool Loader::LoadSounds()
@@ -450,9 +481,13 @@ bool Loader::LoadFilesAtGame(const std::string& mapGfxPath, bool isWinterGFX, co
                                       res::boot_z,   res::mis0bobs, res::mis1bobs, res::mis2bobs,
                                       res::mis3bobs, res::mis4bobs, res::mis5bobs};
 
-    const libsiedler2::ArchivItem_Palette* pal5 = GetPaletteN("pal5");
-
-    if(!LoadFiles(files) || !Load(ResourceId("map_new"), pal5))
+    std::vector<LoadTask> tasks;
+    for(const std::string& file : files)
+    {
+        if(!AddLoadTask(tasks, config_.ExpandPath(file)))
+            return false;
+    }
+    if(!AddLoadTask(tasks, ResourceId("map_new")))
         return false;
 
     // Load nation building and icon graphics
@@ -460,19 +495,27 @@ bool Loader::LoadFilesAtGame(const std::string& mapGfxPath, bool isWinterGFX, co
     for(Nation nation : nations)
     {
         const auto resourceSource = getNationResourcesSource(nation, isWinterGFX, config_);
-        if(!Load(resourceSource.buildingsFilePath, pal5) || !Load(resourceSource.iconsFilePath, pal5))
+        if(!AddLoadTask(tasks, resourceSource.buildingsFilePath) || !AddLoadTask(tasks, resourceSource.iconsFilePath))
             return false;
-        nation_gfx[nation] = &files_[ResourceId::make(resourceSource.buildingsFilePath)].archive;
-        nationIcons_[nation] = &files_[ResourceId::make(resourceSource.iconsFilePath)].archive;
     }
 
     // TODO: Move to addon folder and make it overwrite existing file
-    if(!LoadResources({"charburner", "charburner_bobs"}))
+    if(!AddLoadTask(tasks, ResourceId("charburner")) || !AddLoadTask(tasks, ResourceId("charburner_bobs")))
         return false;
 
     const bfs::path mapGFXFile = config_.ExpandPath(mapGfxPath);
-    if(!Load(mapGFXFile, pal5))
+    if(!AddLoadTask(tasks, mapGFXFile))
+        return false;
+
+    if(!RunLoadTasks(tasks, GetPaletteN("pal5")))
         return false;
+
+    for(Nation nation : nations)
+    {
+        const auto resourceSource = getNationResourcesSource(nation, isWinterGFX, config_);
+        nation_gfx[nation] = &files_[ResourceId::make(resourceSource.buildingsFilePath)].archive;
+        nationIcons_[nation] = &files_[ResourceId::make(resourceSource.iconsFilePath)].archive;
+    }
     map_gfx = &GetArchive(ResourceId::make(mapGFXFile));
 
     isWinterGFX_ = isWinterGFX;
@@ -482,34 +525,24 @@ bool Loader::LoadFilesAtGame(const std::string& mapGfxPath, bool isWinterGFX, co
 
 bool Loader::LoadFiles(const std::vector<std::string>& files)
 {
-    const libsiedler2::ArchivItem_Palette* pal5 = GetPaletteN("pal5");
-    // load the files
+    std::vector<LoadTask> tasks;
     for(const std::string& curFile : files)
     {
-        const bfs::path filePath = config_.ExpandPath(curFile);
-        if(!Load(filePath, pal5))
-        {
-            logger_.write(_("Failed to load %s\n")) % filePath;
+        if(!AddLoadTask(tasks, config_.ExpandPath(curFile)))
             return false;
-        }
     }
-
-    return true;
+    return RunLoadTasks(tasks, GetPaletteN("pal5"));
 }
 
 bool Loader::LoadResources(const std::vector<ResourceId>& resources)
 {
-    const libsiedler2::ArchivItem_Palette* pal5 = GetPaletteN("pal5");
+    std::vector<LoadTask> tasks;
     for(const ResourceId& curResource : resources)
     {
-        if(!Load(curResource, pal5))
-        {
-            logger_.write(_("Failed to load %s\n")) % curResource;
+        if(!AddLoadTask(tasks, curResource))
             return false;
-        }
     }
-
-    return true;
+    return RunLoadTasks(tasks, GetPaletteN("pal5"));
 }
 
 void Loader::fillCaches()
@@ -918,13 +951,44 @@ void Loader::fillCaches()
     }
 
     if(SETTINGS.video.shared_textures)
-    {
-        // generate mega texture
-        stp->pack();
-    } else
+        createSharedTextures();
+    else
         stp.reset();
 }
 
+void Loader::createSharedTextures()
+{
+    // Reuse the mega textures of the last start if the graphics did not change
+    const TextureAtlasCache cache(config_.ExpandPath(s25::folders::cache) / "textureAtlases.dat",
+                                  calcTextureCacheKey());
+    boost::optional<std::vector<TextureAtlas>> cachedAtlases = cache.load(stp->getNumItems());
+    if(cachedAtlases && stp->setAtlases(std::move(*cachedAtlases)) && stp->upload())
+        return;
+
+    // generate mega texture
+    if(!stp->createAtlases())
+        return;
+    if(!cache.save(stp->getAtlases(), stp->getNumItems()))
+        logger_.write(_("Failed to write texture cache %1%\n")) % cache.getFilepath();
+    stp->upload();
+}
+
+uint64_t Loader::calcTextureCacheKey() const
+{
+    TextureAtlasCache::KeyBuilder key;
+    key.add(rttr::version::GetRevision());
+    key.add(TextureAtlasCache::version);
+    key.add(isWinterGFX_);
+    for(const auto nation : helpers::enumRange<Nation>())
+        key.add(nation_gfx[nation] != nullptr);
+    for(const auto& file : files_)
+    {
+        for(const bfs::path& path : file.second.resolvedFile)
+            key.addFileInfo(path);
+    }
+    return key.get();
+}
+
 /**
  *  Extrahiert eine Textur aus den Daten.
  */
@@ -1016,28 +1080,89 @@ bool Loader::Load(libsiedler2::Archiv& archive, const ResourceId& resId, const l
 template<typename T>
 bool Loader::LoadImpl(const T& resIdOrPath, const libsiedler2::ArchivItem_Palette* palette)
 {
-    const auto resolvedFile = archiveLocator_->resolve(resIdOrPath);
+    std::vector<LoadTask> tasks;
+    return AddLoadTask(tasks, resIdOrPath) && RunLoadTasks(tasks, palette);
+}
+
+template<typename T>
+bool Loader::AddLoadTask(std::vector<LoadTask>& tasks, const T& resIdOrPath)
+{
+    ResolvedFile resolvedFile = archiveLocator_->resolve(resIdOrPath);
     if(!resolvedFile)
     {
         logger_.write(_("Failed to resolve resource %1%\n")) % resIdOrPath;
         return false;
     }
-    FileEntry& entry = files_[ResourceId::make(resIdOrPath)];
+    ResourceId id = ResourceId::make(resIdOrPath);
     // Do we really need to reload or can we reused the loaded version?
-    if(entry.resolvedFile != resolvedFile)
+    const auto itEntry = files_.find(id);
+    if(itEntry != files_.end() && itEntry->second.resolvedFile == resolvedFile)
     {
-        try
+        RTTR_Assert(!itEntry->second.archive.empty());
+        return true;
+    }
+    tasks.push_back(LoadTask{std::move(id), std::move(resolvedFile), {}, false, nullptr});
+    return true;
+}
+
+bool Loader::RunLoadTasks(std::vector<LoadTask>& tasks, const libsiedler2::ArchivItem_Palette* palette)
+{
+    const Timer timer(true);
+
+    // Decoding the archives is independent of each other. The tasks are distributed dynamically
+    // as the archives differ a lot in size
+    std::atomic<unsigned> nextTaskIdx(0);
+    const auto runTasks = [this, &tasks, &nextTaskIdx, palette]() {
+        for(unsigned i = nextTaskIdx++; i < tasks.size(); i = nextTaskIdx++)
         {
-            entry.archive = archiveLoader_->load(resolvedFile, palette);
-        } catch(const LoadError&)
+            LoadTask& task = tasks[i];
+            try
+            {
+                task.archive = archiveLoader_->load(task.resolvedFile, palette);
+            } catch(const LoadError&)
+            {
+                task.failed = true;
+            } catch(...)
+            {
+                task.error = std::current_exception();
+            }
+        }
+    };
+    const unsigned numThreads =
+      std::min(std::max(1u, std::thread::hardware_concurrency()), static_cast<unsigned>(tasks.size()));
+    std::vector<std::thread> threads;
+    for(unsigned i = 1; i < numThreads; i++)
+        threads.emplace_back(runTasks);
+    runTasks();
+    for(std::thread& thread : threads)
+        thread.join();
+
+    // Store the archives in order. Textures are created later on first use, i.e. in the main thread
+    bool success = true;
+    for(LoadTask& task : tasks)
+    {
+        if(task.error)
+            std::rethrow_exception(task.error);
+        if(task.failed)
         {
-            return false;
+            logger_.write(_("Failed to load %s\n")) % task.id;
+            success = false;
+            continue;
         }
+        FileEntry& entry = files_[task.id];
+        entry.archive = std::move(task.archive);
         // Update how we loaded this
-        entry.resolvedFile = resolvedFile;
+        entry.resolvedFile = std::move(task.resolvedFile);
+        RTTR_Assert(!entry.archive.empty());
     }
-    RTTR_Assert(!entry.archive.empty());
-    return true;
+
+    if(tasks.size() > 1u)
+    {
+        using namespace std::chrono;
+        logger_.write(_("Loaded %1% archives in %2%ms\n")) % tasks.size()
+          % duration_cast<milliseconds>(timer.getElapsed()).count();
+    }
+    return success;
 }
 
 bool Loader::Load(const bfs::path& path, const libsiedler2::ArchivItem_Palette* palette)
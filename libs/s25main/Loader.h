@@ -65,6 +65,8 @@ class Loader
 {
     /// Struct for storing loaded file entries
     struct FileEntry;
+    /// Archive to be loaded
+    struct LoadTask;
 
 public:
     Loader(Log&, const RttrConfig&);
@@ -229,6 +231,15 @@ private:
 
     template<typename T>
     bool LoadImpl(const T& resIdOrPath, const libsiedler2::ArchivItem_Palette* palette);
+    /// Resolve the file and add a task to load it, unless the same files are already loaded
+    template<typename T>
+    bool AddLoadTask(std::vector<LoadTask>& tasks, const T& resIdOrPath);
+    /// Load the archives of all tasks in parallel and store them afterwards
+    bool RunLoadTasks(std::vector<LoadTask>& tasks, const libsiedler2::ArchivItem_Palette* palette);
+    /// Create the shared textures for the caches or load them from the texture cache file
+    void createSharedTextures();
+    /// Key identifying the source files of the shared textures
+    uint64_t calcTextureCacheKey() const;
 
     Log& logger_;
     const RttrConfig& config_;
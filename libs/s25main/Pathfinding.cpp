@@ -19,9 +19,15 @@ helpers::OptionalEnum<Direction> GameWorldBase::FindHumanPath(const MapPoint sta
                                                               const unsigned max_route, const bool random_route,
                                                               unsigned* length, std::vector<Direction>* route) const
 {
+    FreePathFinder& pathFinder = GetFreePathFinder();
     Direction first_dir{};
-    if(GetFreePathFinder().FindPath(start, dest, random_route, max_route, route, length, &first_dir,
-                                    PathConditionHuman(*this)))
+    const bool found = pathFinder.IsHierarchicalPathfindingEnabled() ?
+                         pathFinder.FindPathHierarchical(start, dest, random_route, max_route, route, length,
+                                                         &first_dir, PathConditionHuman(*this),
+                                                         *pathFinder.GetHumanClusters()) :
+                         pathFinder.FindPath(start, dest, random_route, max_route, route, length, &first_dir,
+                                             PathConditionHuman(*this));
+    if(found)
         return first_dir;
     else
         return boost::none;
@@ -31,12 +37,36 @@ helpers::OptionalEnum<Direction> GameWorldBase::FindHumanPath(const MapPoint sta
 RoadPathDirection GameWorld::FindHumanPathOnRoads(const noRoadNode& start, const noRoadNode& goal, unsigned* length,
                                                   MapPoint* firstPt, const RoadSegment* const forbidden)
 {
-    RoadPathDirection first_dir;
-    if(GetRoadPathFinder().FindPath(start, goal, false, std::numeric_limits<unsigned>::max(), forbidden, length,
-                                    &first_dir, firstPt))
-        return first_dir;
-    else
-        return RoadPathDirection::None;
+    // Searches avoiding a road are rare and start == goal is a bug reported by the pathfinder, so don't cache them
+    if(forbidden || &start == &goal)
+    {
+        RoadPathDirection first_dir;
+        if(GetRoadPathFinder().FindPath(start, goal, false, std::numeric_limits<unsigned>::max(), forbidden, length,
+                                        &first_dir, firstPt))
+            return first_dir;
+        else
+            return RoadPathDirection::None;
+    }
+
+    RoadRouteCache& routeCache = GetPlayer(start.GetPlayer()).GetRoadRouteCache();
+    const RoadRouteCache::Route* route = routeCache.Get(GetRoadGraphEpoch(), start.GetObjId(), goal.GetObjId());
+    RoadRouteCache::Route newRoute;
+    if(!route)
+    {
+        if(!GetRoadPathFinder().FindPath(start, goal, false, std::numeric_limits<unsigned>::max(), nullptr,
+                                         &newRoute.length, &newRoute.firstDir, &newRoute.firstNodePos))
+            newRoute.firstDir = RoadPathDirection::None;
+        routeCache.Add(start.GetObjId(), goal.GetObjId(), newRoute);
+        route = &newRoute;
+    }
+    if(route->firstDir != RoadPathDirection::None)
+    {
+        if(length)
+            *length = route->length;
+        if(firstPt)
+            *firstPt = route->firstNodePos;
+    }
+    return route->firstDir;
 }
 
 /// Wegfindung für Waren im Straßennetz
@@ -73,8 +103,13 @@ bool GameWorldBase::FindShipPathToHarbor(const MapPoint start, unsigned harborId
 bool GameWorldBase::FindShipPath(const MapPoint start, const MapPoint dest, unsigned maxDistance,
                                  std::vector<Direction>* route, unsigned* length)
 {
-    return GetFreePathFinder().FindPath(start, dest, true, maxDistance, route, length, nullptr,
-                                        PathConditionShip(*this));
+    FreePathFinder& pathFinder = GetFreePathFinder();
+    if(pathFinder.IsHierarchicalPathfindingEnabled())
+    {
+        return pathFinder.FindPathHierarchical(start, dest, true, maxDistance, route, length, nullptr,
+                                               PathConditionShip(*this), *pathFinder.GetShipClusters());
+    }
+    return pathFinder.FindPath(start, dest, true, maxDistance, route, length, nullptr, PathConditionShip(*this));
 }
 
 /// Prüft, ob eine Schiffsroute noch Gültigkeit hat
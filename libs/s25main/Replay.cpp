@@ -6,11 +6,14 @@
 #include "Savegame.h"
 #include "enum_cast.hpp"
 #include "network/PlayerGameCommands.h"
+#include "variant.h"
 #include "gameTypes/MapInfo.h"
 #include <s25util/tmpFile.h>
 #include <boost/filesystem.hpp>
+#include <algorithm>
 #include <memory>
 #include <mygettext/mygettext.h>
+#include <stdexcept>
 
 std::string Replay::GetSignature() const
 {
@@ -30,7 +33,8 @@ std::string Replay::GetSignature() const
 ///
 /// Changelog:
 /// 1: Unused first CommandType (End) removed, GameCommand version added
-static const uint8_t currentReplayDataVersion = 1;
+/// 2: Commands stored in compressed blocks with an index when the recording is finished
+static const uint8_t currentReplayDataVersion = 2;
 // clang-format on
 
 /// Format version of replay files
@@ -53,6 +57,13 @@ void Replay::Close()
     isRecording_ = false;
     filepath_.clear();
     ClearPlayers();
+    commandStorage_ = CommandStorage::Uncompressed;
+    commandBlocks_.clear();
+    numCommands_ = 0;
+    curCommandBlock_.Clear();
+    nextCommandBlockIdx_ = 0;
+    lastReadGF_ = 0;
+    readPosition_ = 0;
 }
 
 bool Replay::StopRecording()
@@ -74,29 +85,23 @@ bool Replay::StopRecording()
         BinaryFile compressedReplay;
         compressedReplay.Open(tmpReplayFile.filePath, OpenFileMode::Write);
 
-        // Copy header data uncompressed
+        // Copy header data
         std::vector<char> data(lastGfFilePos_);
         file.ReadRawData(data.data(), data.size());
         compressedReplay.WriteRawData(data.data(), data.size());
         const auto lastGF = file.ReadUnsignedInt();
         RTTR_Assert(lastGF == lastGF_);
         compressedReplay.WriteUnsignedInt(lastGF);
-        file.ReadUnsignedChar(); // Ignore compressed flag (always zero for the temporary file)
+        file.ReadUnsignedChar(); // Ignore storage flag (always uncompressed for the temporary file)
+        compressedReplay.WriteUnsignedChar(rttr::enum_cast(CommandStorage::CompressedBlocks));
 
-        // Read and compress remaining data
-        const auto uncompressedSize = replayDataSize - file.Tell(); // Always positive as there is always some game data
-        data.resize(uncompressedSize);
+        // Copy game data. The map data is already compressed
+        data.resize(commandsFilePos_ - file.Tell());
         file.ReadRawData(data.data(), data.size());
-        data = CompressedData::compress(data);
-        // If the compressed data turns out to be larger than the uncompressed one, bail out
-        // This can happen for very short replays
-        if(data.size() >= uncompressedSize)
-            return true;
-        compressedReplay.WriteUnsignedChar(1); // Compressed flag
-        compressedReplay.WriteUnsignedInt(uncompressedSize);
-        compressedReplay.WriteUnsignedInt(data.size());
         compressedReplay.WriteRawData(data.data(), data.size());
 
+        WriteCommandBlocks(file, replayDataSize, compressedReplay);
+
         // All done. Replace uncompressed replay
         compressedReplay.Close();
         file.Close();
@@ -109,6 +114,75 @@ bool Replay::StopRecording()
     }
 }
 
+void Replay::WriteCommandBlocks(BinaryFile& src, const unsigned endPos, BinaryFile& dst)
+{
+    std::vector<CommandBlock> blocks;
+    Serializer blockData;
+    const auto writeBlock = [&dst, &blockData]() {
+        const std::vector<char> data(blockData.GetData(), blockData.GetData() + blockData.GetLength());
+        const std::vector<char> compressedData = CompressedData::compress(data);
+        dst.WriteUnsignedInt(data.size());
+        dst.WriteUnsignedInt(compressedData.size());
+        dst.WriteRawData(compressedData.data(), compressedData.size());
+        blockData.Clear();
+    };
+
+    unsigned numCommands = 0;
+    unsigned lastGF = 0;
+    while(src.Tell() < endPos)
+    {
+        const auto gf = src.ReadUnsignedInt();
+        // Commands are recorded in GF order, but don't rely on this for the (unsigned) difference
+        if(blocks.empty() || gf < lastGF || gf - blocks.back().firstGF >= commandBlockGFs)
+        {
+            if(!blocks.empty())
+                writeBlock();
+            blocks.push_back(CommandBlock{gf, numCommands, dst.Tell()});
+            lastGF = gf;
+        }
+        blockData.PushVarSize(gf - lastGF);
+        lastGF = gf;
+        ++numCommands;
+
+        const auto type = static_cast<CommandType>(src.ReadUnsignedChar());
+        blockData.PushUnsignedChar(rttr::enum_cast(type));
+        switch(type)
+        {
+            case CommandType::Chat:
+            {
+                const ChatCommand cmd(src);
+                blockData.PushUnsignedChar(cmd.player);
+                blockData.PushUnsignedChar(rttr::enum_cast(cmd.dest));
+                blockData.PushLongString(cmd.msg);
+                break;
+            }
+            case CommandType::Game:
+            {
+                // Copy the serialized commands as-is
+                Serializer cmdData;
+                cmdData.ReadFromFile(src);
+                blockData.PushVarSize(cmdData.GetLength());
+                blockData.PushRawData(cmdData.GetData(), cmdData.GetLength());
+                break;
+            }
+            default: throw std::invalid_argument("Invalid command type: " + std::to_string(rttr::enum_cast(type)));
+        }
+    }
+    if(!blocks.empty())
+        writeBlock();
+
+    const unsigned indexPos = dst.Tell();
+    dst.WriteUnsignedInt(numCommands);
+    dst.WriteUnsignedInt(blocks.size());
+    for(const CommandBlock& block : blocks)
+    {
+        dst.WriteUnsignedInt(block.firstGF);
+        dst.WriteUnsignedInt(block.firstCommand);
+        dst.WriteUnsignedInt(block.filePos);
+    }
+    dst.WriteUnsignedInt(indexPos);
+}
+
 bool Replay::StartRecording(const boost::filesystem::path& filepath, const MapInfo& mapInfo, const unsigned randomSeed)
 {
     // Deny overwrite, also avoids double-opening by different processes
@@ -162,6 +236,7 @@ bool Replay::StartRecording(const boost::filesystem::path& filepath, const MapIn
             break;
         case MapType::Savegame: mapInfo.savegame->Save(file_, GetMapName()); break;
     }
+    commandsFilePos_ = file_.Tell();
     // Flush now to not loose any information
     file_.Flush();
 
@@ -224,8 +299,10 @@ bool Replay::LoadGameData(MapInfo& mapInfo)
 {
     try
     {
-        const bool isCompressed = file_.ReadUnsignedChar() != 0;
-        if(isCompressed)
+        commandStorage_ = static_cast<CommandStorage>(file_.ReadUnsignedChar());
+        if(commandStorage_ > CommandStorage::CompressedBlocks)
+            throw std::runtime_error("Invalid replay command storage");
+        if(commandStorage_ == CommandStorage::Compressed)
         {
             const auto uncompressedSize = file_.ReadUnsignedInt();
             const auto compressedSize = file_.ReadUnsignedInt();
@@ -237,6 +314,7 @@ bool Replay::LoadGameData(MapInfo& mapInfo)
             compressedData.DecompressToFile(uncompressedDataFile_->filePath);
             file_.Close();
             file_.Open(uncompressedDataFile_->filePath, OpenFileMode::Read);
+            commandStorage_ = CommandStorage::Uncompressed;
         }
 
         ReadPlayerData(file_);
@@ -268,6 +346,8 @@ bool Replay::LoadGameData(MapInfo& mapInfo)
                 }
                 break;
         }
+        if(commandStorage_ == CommandStorage::CompressedBlocks)
+            ReadCommandBlockIndex();
     } catch(std::runtime_error& e)
     {
         lastErrorMsg = e.what();
@@ -276,6 +356,86 @@ bool Replay::LoadGameData(MapInfo& mapInfo)
     return true;
 }
 
+void Replay::ReadCommandBlockIndex()
+{
+    const unsigned commandsPos = file_.Tell();
+    file_.Seek(-4, SEEK_END);
+    const unsigned indexPos = file_.ReadUnsignedInt();
+    if(indexPos < commandsPos)
+        throw std::runtime_error("Invalid replay command index");
+    file_.Seek(indexPos, SEEK_SET);
+    numCommands_ = file_.ReadUnsignedInt();
+    commandBlocks_.resize(file_.ReadUnsignedInt());
+    for(CommandBlock& block : commandBlocks_)
+    {
+        block.firstGF = file_.ReadUnsignedInt();
+        block.firstCommand = file_.ReadUnsignedInt();
+        block.filePos = file_.ReadUnsignedInt();
+        if(block.filePos < commandsPos || block.filePos >= indexPos || block.firstCommand >= numCommands_)
+            throw std::runtime_error("Invalid replay command index");
+    }
+    curCommandBlock_.Clear();
+    nextCommandBlockIdx_ = 0;
+    readPosition_ = 0;
+}
+
+void Replay::LoadCommandBlock(const unsigned idx)
+{
+    const CommandBlock& block = commandBlocks_[idx];
+    file_.Seek(block.filePos, SEEK_SET);
+    const auto uncompressedSize = file_.ReadUnsignedInt();
+    std::vector<char> data(file_.ReadUnsignedInt());
+    file_.ReadRawData(data.data(), data.size());
+    data = CompressedData::decompress(data, uncompressedSize);
+    curCommandBlock_.Clear();
+    curCommandBlock_.PushRawData(data.data(), data.size());
+    nextCommandBlockIdx_ = idx + 1;
+    lastReadGF_ = block.firstGF;
+    readPosition_ = 2 * block.firstCommand;
+}
+
+bool Replay::Convert(const boost::filesystem::path& srcPath, const boost::filesystem::path& dstPath)
+{
+    Close();
+    Replay srcReplay;
+    MapInfo mapInfo;
+    if(!srcReplay.LoadHeader(srcPath) || !srcReplay.LoadGameData(mapInfo))
+    {
+        lastErrorMsg = srcReplay.GetLastErrorMsg();
+        return false;
+    }
+    for(unsigned i = 0; i < srcReplay.GetNumPlayers(); i++)
+        AddPlayer(srcReplay.GetPlayer(i));
+    ggs = srcReplay.ggs;
+    if(!StartRecording(dstPath, mapInfo, srcReplay.getSeed()))
+    {
+        lastErrorMsg = _("File could not be opened.");
+        Close();
+        return false;
+    }
+
+    try
+    {
+        // Commands of older versions are converted to the current version when recording them
+        while(const auto gf = srcReplay.ReadGF())
+        {
+            visit(composeVisitor(
+                    [this, gf](const ChatCommand& cmd) { AddChatCommand(*gf, cmd.player, cmd.dest, cmd.msg); },
+                    [this, gf](const GameCommand& cmd) { AddGameCommand(*gf, cmd.player, cmd.cmds); }),
+                  srcReplay.ReadCommand());
+        }
+    } catch(const std::exception& e)
+    {
+        lastErrorMsg = e.what();
+        Close();
+        boost::system::error_code ec;
+        boost::filesystem::remove(dstPath, ec);
+        return false;
+    }
+    UpdateLastGF(srcReplay.GetLastGF());
+    return StopRecording();
+}
+
 void Replay::AddChatCommand(unsigned gf, uint8_t player, ChatDestination dest, const std::string& str)
 {
     RTTR_Assert(IsRecording());
@@ -314,6 +474,21 @@ void Replay::AddGameCommand(unsigned gf, uint8_t player, const PlayerGameCommand
 std::optional<unsigned> Replay::ReadGF()
 {
     RTTR_Assert(IsReplaying());
+    if(commandStorage_ == CommandStorage::CompressedBlocks)
+    {
+        if(!curCommandBlock_.GetBytesLeft())
+        {
+            if(nextCommandBlockIdx_ >= commandBlocks_.size())
+            {
+                readPosition_ = 2 * numCommands_ + 1;
+                return std::nullopt;
+            }
+            LoadCommandBlock(nextCommandBlockIdx_);
+        }
+        lastReadGF_ += curCommandBlock_.PopVarSize();
+        ++readPosition_;
+        return lastReadGF_;
+    }
     try
     {
         return file_.ReadUnsignedInt();
@@ -328,6 +503,17 @@ std::optional<unsigned> Replay::ReadGF()
 boost_variant2<Replay::ChatCommand, Replay::GameCommand> Replay::ReadCommand()
 {
     RTTR_Assert(IsReplaying());
+    if(commandStorage_ == CommandStorage::CompressedBlocks)
+    {
+        const auto type = static_cast<CommandType>(curCommandBlock_.PopUnsignedChar());
+        ++readPosition_;
+        switch(type)
+        {
+            case CommandType::Chat: return ChatCommand(curCommandBlock_);
+            case CommandType::Game: return GameCommand(curCommandBlock_, gcVersion_);
+            default: throw std::invalid_argument("Invalid command type: " + std::to_string(rttr::enum_cast(type)));
+        }
+    }
     const auto type = static_cast<CommandType>(file_.ReadUnsignedChar() - (subVersion_ == 0 ? 1 : 0));
     switch(type)
     {
@@ -337,6 +523,47 @@ boost_variant2<Replay::ChatCommand, Replay::GameCommand> Replay::ReadCommand()
     }
 }
 
+unsigned Replay::GetReadPosition()
+{
+    RTTR_Assert(IsReplaying());
+    if(commandStorage_ == CommandStorage::CompressedBlocks)
+        return readPosition_;
+    return file_.Tell();
+}
+
+void Replay::SetReadPosition(const unsigned position)
+{
+    RTTR_Assert(IsReplaying());
+    if(commandStorage_ != CommandStorage::CompressedBlocks)
+    {
+        file_.Seek(position, SEEK_SET);
+        return;
+    }
+    if(position > 2 * numCommands_ + 1)
+        throw std::invalid_argument("Invalid replay position: " + std::to_string(position));
+    curCommandBlock_.Clear();
+    nextCommandBlockIdx_ = 0;
+    readPosition_ = 0;
+    if(position == 0)
+        return;
+    // Start at the block containing the last command (partially) read and skip the commands before it
+    const unsigned cmdIdx = (position - 1) / 2;
+    const auto itBlock =
+      std::upper_bound(commandBlocks_.begin(), commandBlocks_.end(), cmdIdx,
+                       [](const unsigned idx, const CommandBlock& block) { return idx < block.firstCommand; });
+    if(itBlock != commandBlocks_.begin())
+        LoadCommandBlock(static_cast<unsigned>(std::distance(commandBlocks_.begin(), itBlock)) - 1);
+    while(readPosition_ < position)
+    {
+        // Even positions are before the GF of a command, odd ones before the command itself
+        if(readPosition_ % 2 == 1)
+            ReadCommand();
+        else if(!ReadGF())
+            break;
+    }
+    RTTR_Assert(readPosition_ == position);
+}
+
 void Replay::UpdateLastGF(unsigned last_gf)
 {
     RTTR_Assert(IsRecording());
@@ -354,6 +581,11 @@ Replay::ChatCommand::ChatCommand(BinaryFile& file)
       msg(file.ReadLongString())
 {}
 
+Replay::ChatCommand::ChatCommand(Serializer& ser)
+    : player(ser.PopUnsignedChar()), dest(static_cast<ChatDestination>(ser.PopUnsignedChar())),
+      msg(ser.PopLongString())
+{}
+
 Replay::GameCommand::GameCommand(BinaryFile& file, const unsigned version)
 {
     gc::Deserializer ser{version};
@@ -361,3 +593,12 @@ Replay::GameCommand::GameCommand(BinaryFile& file, const unsigned version)
     player = ser.PopUnsignedChar();
     cmds.Deserialize(ser);
 }
+
+Replay::GameCommand::GameCommand(Serializer& ser, const unsigned version)
+{
+    const unsigned size = ser.PopVarSize();
+    gc::Deserializer deser{version};
+    deser.PushRawData(ser.PopAndDiscard(size), size);
+    player = deser.PopUnsignedChar();
+    cmds.Deserialize(deser);
+}
@@ -10,9 +10,11 @@
 #include "gameTypes/ChatDestination.h"
 #include "gameTypes/MapType.h"
 #include "s25util/BinaryFile.h"
+#include "s25util/Serializer.h"
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 class MapInfo;
 struct PlayerGameCommands;
@@ -22,7 +24,15 @@ class TmpFile;
 /// It has a header that holds minimal information:
 ///     File header (version etc.), record time, map name, player names, length (last GF), savegame header (if
 ///     applicable)
-/// All game relevant data is stored afterwards
+/// All game relevant data is stored afterwards.
+/// While recording the commands are appended one by one so nothing is lost on a crash.
+/// When the recording is stopped they are rewritten into compressed blocks of (at most) commandBlockGFs GFs each:
+///     Per block: uncompressed size, compressed size, data
+///     Index: number of commands, number of blocks, per block: GF of first command, index of first command, file offset
+///     File offset of the index (last 4 bytes of the file)
+/// Hence a tool can find the commands of any GF by reading only the index and a single block.
+/// Inside a block each command is stored as the (variable sized) GF difference to the previous command, its type and
+/// its data
 class Replay : public SavedFile
 {
 public:
@@ -34,6 +44,7 @@ public:
     struct ChatCommand
     {
         ChatCommand(BinaryFile& file);
+        ChatCommand(Serializer& ser);
         uint8_t player;
         ChatDestination dest;
         std::string msg;
@@ -41,10 +52,14 @@ public:
     struct GameCommand
     {
         GameCommand(BinaryFile& file, unsigned version);
+        GameCommand(Serializer& ser, unsigned version);
         uint8_t player;
         PlayerGameCommands cmds;
     };
 
+    /// Maximum number of GFs whose commands are stored in one block
+    static constexpr unsigned commandBlockGFs = 1000;
+
     Replay();
     ~Replay() override;
 
@@ -68,6 +83,9 @@ public:
     bool LoadHeader(const boost::filesystem::path& filepath);
     /// Load the remaining data into the mapInfo
     bool LoadGameData(MapInfo& mapInfo);
+    /// Record the replay at srcPath (e.g. of an older format or an unfinished recording) in the current format to
+    /// dstPath which must not exist. Keyframes of the source replay can't be used for the converted one.
+    bool Convert(const boost::filesystem::path& srcPath, const boost::filesystem::path& dstPath);
 
     /// Record a chat message
     void AddChatCommand(unsigned gf, uint8_t player, ChatDestination dest, const std::string& str);
@@ -77,6 +95,10 @@ public:
     /// Read the next GameFrame to which the following replay command applies if there are any left
     std::optional<unsigned> ReadGF();
     boost_variant2<ChatCommand, GameCommand> ReadCommand();
+    /// Get the current read position in the command data. Reading can be resumed from there with SetReadPosition.
+    /// This is the file offset for uncompressed commands and the number of GFs and commands read for command blocks
+    unsigned GetReadPosition();
+    void SetReadPosition(unsigned position);
 
     /// Update the (currently) last GameFrame in the file
     void UpdateLastGF(unsigned last_gf);
@@ -85,6 +107,28 @@ public:
     unsigned GetLastGF() const { return lastGF_; }
 
 protected:
+    /// How the commands are stored after the game data
+    enum class CommandStorage : uint8_t
+    {
+        Uncompressed,
+        /// All data following the header is compressed as a whole (old format)
+        Compressed,
+        CompressedBlocks,
+    };
+    struct CommandBlock
+    {
+        unsigned firstGF;
+        unsigned firstCommand;
+        unsigned filePos;
+    };
+
+    /// Read the uncompressed commands from src until endPos and write them as compressed blocks followed by the index
+    static void WriteCommandBlocks(BinaryFile& src, unsigned endPos, BinaryFile& dst);
+    /// Read the block index at the end of the file
+    void ReadCommandBlockIndex();
+    /// Decompress the given block and continue reading at its first command
+    void LoadCommandBlock(unsigned idx);
+
     BinaryFile file_;
     std::unique_ptr<TmpFile> uncompressedDataFile_; /// Used when reading a compressed replay
     boost::filesystem::path filepath_;              /// Path to current file
@@ -96,6 +140,20 @@ protected:
     unsigned lastGF_ = 0;
     /// Position of the last GF value in the file
     unsigned lastGfFilePos_ = 0;
+    /// Position of the first command in the file while recording
+    unsigned commandsFilePos_ = 0;
+    CommandStorage commandStorage_ = CommandStorage::Uncompressed;
+
+    /// Blocks of the commands, only used for CommandStorage::CompressedBlocks
+    std::vector<CommandBlock> commandBlocks_;
+    unsigned numCommands_ = 0;
+    /// Unread data of the current block
+    Serializer curCommandBlock_;
+    unsigned nextCommandBlockIdx_ = 0;
+    /// GF of the last command read
+    unsigned lastReadGF_ = 0;
+    /// Number of GFs and commands read since the start, i.e. 2 * numCommands_ + 1 when the end was reached
+    unsigned readPosition_ = 0;
     MapType mapType_ = MapType(0);
 
     /// Sub version for backwards compatibility (i.e. allow loading older files with same file version)
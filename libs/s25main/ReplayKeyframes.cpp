@@ -0,0 +1,173 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ReplayKeyframes.h"
+#include "EventManager.h"
+#include "Game.h"
+#include "RTTR_Version.h"
+#include "Replay.h"
+#include "SerializedGameData.h"
+#include "libendian/ConvertEndianess.h"
+#include "gameTypes/CompressedData.h"
+#include "s25util/BinaryFile.h"
+#include "s25util/Serializer.h"
+#include <stdexcept>
+
+namespace {
+const std::string keyframesSignature = "RTTRKF";
+/// Version of the keyframe file format. Increase when the format changes, old files are simply ignored
+constexpr uint16_t keyframesVersion = 1;
+
+/// Write the data identifying the replay (and program version) the keyframes belong to
+void WriteReplayId(BinaryFile& file, const Replay& replay)
+{
+    file.WriteShortString(rttr::version::GetRevision());
+    const s25util::time64_t saveTime = libendian::ConvertEndianess<false>::fromNative(replay.GetSaveTime());
+    file.WriteRawData(&saveTime, sizeof(saveTime));
+    file.WriteUnsignedInt(replay.getSeed());
+    file.WriteUnsignedInt(replay.GetLastGF());
+}
+
+bool IsSameReplayId(BinaryFile& file, const Replay& replay)
+{
+    const bool isSameRevision = file.ReadShortString() == rttr::version::GetRevision();
+    s25util::time64_t saveTime;
+    file.ReadRawData(&saveTime, sizeof(saveTime));
+    const bool isSameTime = libendian::ConvertEndianess<false>::toNative(saveTime) == replay.GetSaveTime();
+    const bool isSameSeed = file.ReadUnsignedInt() == replay.getSeed();
+    const bool isSameLength = file.ReadUnsignedInt() == replay.GetLastGF();
+    return isSameRevision && isSameTime && isSameSeed && isSameLength;
+}
+} // namespace
+
+ReplayKeyframes::ReplayKeyframes(const unsigned interval) : interval_(interval), isModified_(false)
+{
+    if(interval_ == 0)
+        throw std::invalid_argument("Keyframe interval must not be 0");
+}
+
+bool ReplayKeyframes::IsKeyframeDue(const unsigned gf) const
+{
+    return gf > 0 && gf % interval_ == 0 && keyframes_.find(gf) == keyframes_.end();
+}
+
+void ReplayKeyframes::Add(const Game& game, const unsigned replayPos, const std::optional<unsigned> nextCmdGF)
+{
+    SerializedGameData sgd;
+    sgd.MakeSnapshot(game);
+
+    ReplayKeyframe keyframe;
+    keyframe.gf = game.em_->GetCurrentGF();
+    keyframe.replayPos = replayPos;
+    keyframe.nextCmdGF = nextCmdGF;
+    keyframe.rngState = RANDOM.GetCurrentState();
+    keyframe.snapshotSize = sgd.GetLength();
+    keyframe.compressedSnapshot =
+      CompressedData::compress(std::vector<char>(sgd.GetData(), sgd.GetData() + sgd.GetLength()));
+    keyframes_[keyframe.gf] = std::move(keyframe);
+    isModified_ = true;
+}
+
+const ReplayKeyframe* ReplayKeyframes::FindBefore(const unsigned gf) const
+{
+    auto it = keyframes_.upper_bound(gf);
+    if(it == keyframes_.begin())
+        return nullptr;
+    return &(--it)->second;
+}
+
+void ReplayKeyframes::GetSnapshot(const ReplayKeyframe& keyframe, SerializedGameData& sgd)
+{
+    const std::vector<char> data = CompressedData::decompress(keyframe.compressedSnapshot, keyframe.snapshotSize);
+    sgd.Clear();
+    sgd.PushRawData(data.data(), data.size());
+}
+
+void ReplayKeyframes::Clear()
+{
+    keyframes_.clear();
+    isModified_ = false;
+}
+
+boost::filesystem::path ReplayKeyframes::GetFilePath(const boost::filesystem::path& replayPath)
+{
+    boost::filesystem::path result = replayPath;
+    return result.replace_extension("rplk");
+}
+
+bool ReplayKeyframes::Save(const boost::filesystem::path& filepath, const Replay& replay)
+{
+    BinaryFile file;
+    if(!file.Open(filepath, OpenFileMode::Write))
+        return false;
+    try
+    {
+        file.WriteRawData(keyframesSignature.data(), keyframesSignature.size());
+        file.WriteUnsignedShort(keyframesVersion);
+        WriteReplayId(file, replay);
+        file.WriteUnsignedInt(interval_);
+        file.WriteUnsignedInt(keyframes_.size());
+        for(const auto& it : keyframes_)
+        {
+            const ReplayKeyframe& keyframe = it.second;
+            file.WriteUnsignedInt(keyframe.gf);
+            file.WriteUnsignedInt(keyframe.replayPos);
+            file.WriteUnsignedChar(keyframe.nextCmdGF ? 1 : 0);
+            file.WriteUnsignedInt(keyframe.nextCmdGF.value_or(0));
+            Serializer ser;
+            keyframe.rngState.serialize(ser);
+            ser.WriteToFile(file);
+            file.WriteUnsignedInt(keyframe.snapshotSize);
+            file.WriteUnsignedInt(keyframe.compressedSnapshot.size());
+            file.WriteRawData(keyframe.compressedSnapshot.data(), keyframe.compressedSnapshot.size());
+        }
+    } catch(const std::runtime_error&)
+    {
+        return false;
+    }
+    isModified_ = false;
+    return true;
+}
+
+bool ReplayKeyframes::Load(const boost::filesystem::path& filepath, const Replay& replay)
+{
+    Clear();
+    BinaryFile file;
+    if(!file.Open(filepath, OpenFileMode::Read))
+        return false;
+    try
+    {
+        std::string signature(keyframesSignature.size(), '\0');
+        file.ReadRawData(&signature[0], signature.size());
+        if(signature != keyframesSignature || file.ReadUnsignedShort() != keyframesVersion
+           || !IsSameReplayId(file, replay))
+            return false;
+        interval_ = file.ReadUnsignedInt();
+        if(interval_ == 0)
+            return false;
+        const unsigned numKeyframes = file.ReadUnsignedInt();
+        for(unsigned i = 0; i < numKeyframes; i++)
+        {
+            ReplayKeyframe keyframe;
+            keyframe.gf = file.ReadUnsignedInt();
+            keyframe.replayPos = file.ReadUnsignedInt();
+            const bool hasNextCmdGF = file.ReadUnsignedChar() != 0;
+            const unsigned nextCmdGF = file.ReadUnsignedInt();
+            if(hasNextCmdGF)
+                keyframe.nextCmdGF = nextCmdGF;
+            Serializer ser;
+            ser.ReadFromFile(file);
+            keyframe.rngState.deserialize(ser);
+            keyframe.snapshotSize = file.ReadUnsignedInt();
+            keyframe.compressedSnapshot.resize(file.ReadUnsignedInt());
+            file.ReadRawData(keyframe.compressedSnapshot.data(), keyframe.compressedSnapshot.size());
+            keyframes_[keyframe.gf] = std::move(keyframe);
+        }
+    } catch(const std::runtime_error&)
+    {
+        Clear();
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,68 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "random/Random.h"
+#include <boost/filesystem/path.hpp>
+#include <map>
+#include <optional>
+#include <vector>
+
+class Game;
+class Replay;
+class SerializedGameData;
+
+/// State of a replayed game at the start of a GF from which the replay can be continued
+struct ReplayKeyframe
+{
+    /// GF at which the keyframe was taken, i.e. before the commands of this GF were executed
+    unsigned gf;
+    /// Read position of the replay and GF of the next command read at that position (if any)
+    unsigned replayPos;
+    std::optional<unsigned> nextCmdGF;
+    /// State of the ingame random number generator
+    UsedPRNG rngState;
+    /// Compressed snapshot of the game (see SerializedGameData::MakeSnapshot)
+    unsigned snapshotSize;
+    std::vector<char> compressedSnapshot;
+};
+
+/// Periodic keyframes of a replay which allow jumping to a GF without executing all GFs before it.
+/// They are taken while the replay is played and stored next to the replay file so they can be used the next time.
+class ReplayKeyframes
+{
+public:
+    /// Default number of GFs between 2 keyframes
+    static constexpr unsigned defaultInterval = 5000;
+
+    explicit ReplayKeyframes(unsigned interval = defaultInterval);
+
+    unsigned GetInterval() const { return interval_; }
+    unsigned GetNumKeyframes() const { return static_cast<unsigned>(keyframes_.size()); }
+    /// True if keyframes were added since the last load or save
+    bool IsModified() const { return isModified_; }
+
+    /// Return true if a keyframe should be taken at the given GF
+    bool IsKeyframeDue(unsigned gf) const;
+    /// Take a keyframe of the game (at the start of the current GF) and the replay at the given position
+    void Add(const Game& game, unsigned replayPos, std::optional<unsigned> nextCmdGF);
+    /// Return the last keyframe at or before the given GF if any
+    const ReplayKeyframe* FindBefore(unsigned gf) const;
+    /// Decompress the snapshot of the keyframe into the game data for ReadSnapshot
+    static void GetSnapshot(const ReplayKeyframe& keyframe, SerializedGameData& sgd);
+    void Clear();
+
+    /// Path of the keyframe file belonging to the replay file
+    static boost::filesystem::path GetFilePath(const boost::filesystem::path& replayPath);
+    /// Save all keyframes. The replay is used to detect if the keyframes belong to it when loading
+    bool Save(const boost::filesystem::path& filepath, const Replay& replay);
+    /// Load keyframes written for the replay replacing the current ones. Fails if they belong to another replay
+    bool Load(const boost::filesystem::path& filepath, const Replay& replay);
+
+private:
+    unsigned interval_;
+    std::map<unsigned, ReplayKeyframe> keyframes_;
+    bool isModified_;
+};
@@ -293,6 +293,7 @@ void RoadSegment::UpgradeDonkeyRoad()
         return;
 
     rt = RoadType::Donkey;
+    world->RoadGraphChanged();
 
     // Eselstraßen setzen
     MapPoint pt = f1->GetPos();
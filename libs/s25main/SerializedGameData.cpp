@@ -400,7 +400,8 @@ const GameEvent* SerializedGameData::PopEvent()
     const auto foundObj = readEvents.find(instanceId);
     if(foundObj != readEvents.end())
         return foundObj->second;
-    std::unique_ptr<GameEvent> ev = std::make_unique<GameEvent>(*this, instanceId);
+    // Events are owned by the EventManager which adds them to its queue on deserialization
+    GameEvent* ev = em->DeserializeEvent(*this, instanceId);
 
     unsigned short safety_code = PopUnsignedShort();
 
@@ -408,9 +409,10 @@ const GameEvent* SerializedGameData::PopEvent()
     {
         LOG.write("SerializedGameData::PopEvent: ERROR: After loading Event(instanceId = %1%); Code is wrong!\n")
           % instanceId;
+        em->DestroyEvent(ev);
         throw Error("Invalid safety code after PopEvent");
     }
-    return ev.release();
+    return ev;
 }
 
 /// FoW-Objekt
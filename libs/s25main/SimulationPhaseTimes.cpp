@@ -0,0 +1,57 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "SimulationPhaseTimes.h"
+#include "GFProfiler.h"
+
+std::atomic<bool> SimulationPhaseTimes::enabled_(false);
+helpers::EnumArray<std::atomic<SimulationPhaseTimes::duration::rep>, SimulationPhase> SimulationPhaseTimes::times_{};
+helpers::EnumArray<std::atomic<uint64_t>, SimulationPhase> SimulationPhaseTimes::counts_{};
+
+namespace {
+/// Number of running timers per phase on the current thread
+thread_local helpers::EnumArray<unsigned, SimulationPhase> numActiveTimers{};
+} // namespace
+
+const char* getName(const SimulationPhase phase)
+{
+    switch(phase)
+    {
+        case SimulationPhase::Events: return "Events";
+        case SimulationPhase::AI: return "AI";
+        case SimulationPhase::Statistics: return "Statistics";
+        case SimulationPhase::Visibility: return "Visibility";
+        case SimulationPhase::Pathfinding: return "Pathfinding";
+    }
+    return "";
+}
+
+void SimulationPhaseTimes::Reset()
+{
+    for(auto& time : times_)
+        time = 0;
+    for(auto& count : counts_)
+        count = 0;
+}
+
+SimulationPhaseTimer::SimulationPhaseTimer(const SimulationPhase phase)
+    : phase_(phase),
+      isRunning_(GFProfiler::isAvailable || SimulationPhaseTimes::enabled_.load(std::memory_order_relaxed))
+{
+    if(isRunning_ && numActiveTimers[phase_]++ == 0)
+        startTime_ = std::chrono::steady_clock::now();
+}
+
+SimulationPhaseTimer::~SimulationPhaseTimer()
+{
+    if(!isRunning_ || --numActiveTimers[phase_] != 0)
+        return;
+    const auto elapsed = std::chrono::steady_clock::now() - startTime_;
+    if(GFProfiler::isAvailable)
+        GFProfiler::AddPhaseTime(phase_, elapsed);
+    if(!SimulationPhaseTimes::IsEnabled())
+        return;
+    SimulationPhaseTimes::times_[phase_] += elapsed.count();
+    ++SimulationPhaseTimes::counts_[phase_];
+}
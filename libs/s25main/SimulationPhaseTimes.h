@@ -0,0 +1,68 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "helpers/EnumArray.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+/// Parts of the simulation whose run time can be measured
+enum class SimulationPhase : uint8_t
+{
+    Events,
+    AI,
+    Statistics,
+    Visibility,
+    Pathfinding
+};
+constexpr auto maxEnumValue(SimulationPhase)
+{
+    return SimulationPhase::Pathfinding;
+}
+/// Name of the phase for output
+const char* getName(SimulationPhase phase);
+
+/// Accumulates the time spent in the phases of the simulation, e.g. for benchmarks.
+/// Disabled by default so it only costs a check of a flag.
+/// Phases can be nested (e.g. pathfinding is done while executing events and running AIs)
+/// in which case the time is counted for both phases.
+class SimulationPhaseTimes
+{
+public:
+    using duration = std::chrono::steady_clock::duration;
+
+    static void Enable(bool enable) { enabled_ = enable; }
+    static bool IsEnabled() { return enabled_; }
+    /// Set all times and counts to zero
+    static void Reset();
+    /// Total time spent in the phase
+    static duration GetTime(SimulationPhase phase) { return duration(times_[phase]); }
+    /// How often the phase was entered
+    static uint64_t GetCount(SimulationPhase phase) { return counts_[phase]; }
+
+private:
+    friend class SimulationPhaseTimer;
+    // Atomic as AIs run on multiple threads
+    static std::atomic<bool> enabled_;
+    static helpers::EnumArray<std::atomic<duration::rep>, SimulationPhase> times_;
+    static helpers::EnumArray<std::atomic<uint64_t>, SimulationPhase> counts_;
+};
+
+/// Adds the time till its destruction to the given phase if measuring is enabled.
+/// Timers nested in one of the same phase (on the same thread) are ignored
+class SimulationPhaseTimer
+{
+public:
+    explicit SimulationPhaseTimer(SimulationPhase phase);
+    ~SimulationPhaseTimer();
+    SimulationPhaseTimer(const SimulationPhaseTimer&) = delete;
+    SimulationPhaseTimer& operator=(const SimulationPhaseTimer&) = delete;
+
+private:
+    const SimulationPhase phase_;
+    bool isRunning_;
+    std::chrono::steady_clock::time_point startTime_;
+};
@@ -88,10 +88,10 @@ void Ware::SetGoal(noBaseBuilding* newGoal)
         goal->TakeWare(this);
 }
 
-void Ware::RecalcRoute()
+void Ware::RecalcRoute(const bool canReachGoal)
 {
     // Nächste Richtung nehmen
-    if(location && goal)
+    if(location && goal && canReachGoal)
         next_dir = world->FindPathForWareOnRoads(*location, *goal, nullptr, &next_harbor);
     else
         next_dir = RoadPathDirection::None;
@@ -64,7 +64,8 @@ public:
     /// Sets the new goal and notifies it
     void SetGoal(noBaseBuilding* newGoal);
     /// Berechnet den Weg neu zu ihrem Ziel
-    void RecalcRoute();
+    /// If it is already known that the goal can't be reached (canReachGoal=false) the path search is skipped
+    void RecalcRoute(bool canReachGoal = true);
     /// set new next dir
     void SetNextDir(RoadPathDirection newNextDir) { next_dir = newNextDir; }
     void SetNextDir(Direction newNextDir) { next_dir = toRoadPathDirection(newNextDir); }
@@ -171,7 +171,7 @@ int AIInterface::CalcResourceValue(const MapPoint pt, AIResource res, helpers::O
     const unsigned resRadius = RES_RADIUS[res];
     if(!direction) // calculate complete value from scratch (3n^2+3n+1)
     {
-        std::vector<MapPoint> pts = gwb.GetPointsInRadiusWithCenter(pt, resRadius);
+        const MapPointsInRadius pts = gwb.PointsInRadius(pt, resRadius, true);
         return std::accumulate(pts.begin(), pts.end(), 0, [this, res](int lhs, const auto& curPt) {
             return lhs + this->GetResourceRating(curPt, res);
         });
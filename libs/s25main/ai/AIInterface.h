@@ -106,32 +106,32 @@ public:
     /// Return the headquarter of the player (or null if destroyed)
     const nobHQ* GetHeadquarter() const;
     /// Return reference to the list of building sites
-    const std::list<noBuildingSite*>& GetBuildingSites() const
+    const std::vector<noBuildingSite*>& GetBuildingSites() const
     {
         return player_.GetBuildingRegister().GetBuildingSites();
     }
-    const std::list<noBuildingSite*>& GetPlayerBuildingSites(unsigned playerId) const
+    const std::vector<noBuildingSite*>& GetPlayerBuildingSites(unsigned playerId) const
     {
         return gwb.GetPlayer(playerId).GetBuildingRegister().GetBuildingSites();
     }
     /// Return a list to buildings of a given type
-    const std::list<nobUsual*>& GetBuildings(const BuildingType type) const
+    const std::vector<nobUsual*>& GetBuildings(const BuildingType type) const
     {
         return player_.GetBuildingRegister().GetBuildings(type);
     }
-    const std::list<nobUsual*>& GetPlayerBuildings(const BuildingType type, unsigned playerId) const
+    const std::vector<nobUsual*>& GetPlayerBuildings(const BuildingType type, unsigned playerId) const
     {
         return gwb.GetPlayer(playerId).GetBuildingRegister().GetBuildings(type);
     }
     // Return a list containing all military buildings
-    const std::list<nobMilitary*>& GetMilitaryBuildings() const
+    const std::vector<nobMilitary*>& GetMilitaryBuildings() const
     {
         return player_.GetBuildingRegister().GetMilitaryBuildings();
     }
     /// Return a list containing all harbors
-    const std::list<nobHarborBuilding*>& GetHarbors() const { return player_.GetBuildingRegister().GetHarbors(); }
+    const std::vector<nobHarborBuilding*>& GetHarbors() const { return player_.GetBuildingRegister().GetHarbors(); }
     /// Return a list containing all storehouses and harbors and the hq
-    const std::list<nobBaseWarehouse*>& GetStorehouses() const
+    const std::vector<nobBaseWarehouse*>& GetStorehouses() const
     {
         return player_.GetBuildingRegister().GetStorehouses();
     }
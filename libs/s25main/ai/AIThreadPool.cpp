@@ -0,0 +1,112 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "ai/AIThreadPool.h"
+#include "GFProfiler.h"
+#include "GameObject.h"
+#include "SimulationPhaseTimes.h"
+#include "ai/AIPlayer.h"
+#include "pathfinding/PathfindingLock.h"
+#include <utility>
+
+AIThreadPool::AIThreadPool(const unsigned numThreads)
+    : ais_(nullptr), context_(nullptr), gf_(0), gfisnwf_(false), taskId_(0), numBusyWorkers_(0), stop_(false),
+      nextAI_(0)
+{
+    for(unsigned i = 1; i < numThreads; i++)
+        workers_.emplace_back([this]() { WorkerLoop(); });
+}
+
+AIThreadPool::~AIThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    workAvailable_.notify_all();
+    for(std::thread& worker : workers_)
+        worker.join();
+}
+
+void AIThreadPool::RunGF(const std::vector<AIPlayer*>& ais, const unsigned gf, const bool gfisnwf)
+{
+    SimulationPhaseTimer timer(SimulationPhase::AI);
+    if(workers_.empty() || ais.size() < 2u)
+    {
+        for(AIPlayer* ai : ais)
+        {
+            RTTR_PROFILE_AI(ai->GetPlayerId());
+            ai->RunGF(gf, gfisnwf);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ais_ = &ais;
+        context_ = &GameObject::GetContext();
+        gf_ = gf;
+        gfisnwf_ = gfisnwf;
+        nextAI_ = 0;
+        numBusyWorkers_ = static_cast<unsigned>(workers_.size());
+        ++taskId_;
+    }
+    workAvailable_.notify_all();
+    // Help with the work instead of waiting
+    RunAIs();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    workDone_.wait(lock, [this]() { return numBusyWorkers_ == 0; });
+    ais_ = nullptr;
+    context_ = nullptr;
+    if(error_)
+        std::rethrow_exception(std::exchange(error_, nullptr));
+}
+
+void AIThreadPool::WorkerLoop()
+{
+    unsigned lastTaskId = 0;
+    while(true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workAvailable_.wait(lock, [this, lastTaskId]() { return stop_ || taskId_ != lastTaskId; });
+            if(stop_)
+                return;
+            lastTaskId = taskId_;
+        }
+        {
+            // The AIs access the game objects
+            GameObject::ContextScope contextScope(*context_);
+            RunAIs();
+        }
+        bool isLastWorker;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            isLastWorker = --numBusyWorkers_ == 0;
+        }
+        if(isLastWorker)
+            workDone_.notify_one();
+    }
+}
+
+void AIThreadPool::RunAIs()
+{
+    // Other AIs run at the same time
+    PathfindingLock::AIThreadScope aiThreadScope;
+    const std::vector<AIPlayer*>& ais = *ais_;
+    for(unsigned i = nextAI_++; i < ais.size(); i = nextAI_++)
+    {
+        try
+        {
+            RTTR_PROFILE_AI(ais[i]->GetPlayerId());
+            ais[i]->RunGF(gf_, gfisnwf_);
+        } catch(...)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(!error_)
+                error_ = std::current_exception();
+        }
+    }
+}
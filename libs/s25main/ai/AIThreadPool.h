@@ -0,0 +1,56 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "GameObject.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class AIPlayer;
+
+/// Runs the AI players of a GF on multiple threads.
+/// AIs only read the world and put their commands and chat messages into their own buffers, so they can run
+/// concurrently as long as the game itself is not running. Path finding is serialized by PathfindingLock.
+/// The results do not depend on the order of execution: Each AI uses its own random number generator and the commands
+/// are fetched per player as before.
+class AIThreadPool
+{
+public:
+    /// Create a pool using the given number of threads including the calling one. 0 or 1 runs all AIs sequentially
+    explicit AIThreadPool(unsigned numThreads);
+    ~AIThreadPool();
+
+    unsigned GetNumThreads() const { return static_cast<unsigned>(workers_.size()) + 1u; }
+
+    /// Execute RunGF of all AIs and wait till all are done.
+    /// An exception thrown by any AI is passed on to the caller after all AIs are done
+    void RunGF(const std::vector<AIPlayer*>& ais, unsigned gf, bool gfisnwf);
+
+private:
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable workAvailable_, workDone_;
+    /// Current task, only changed while no worker is busy
+    const std::vector<AIPlayer*>* ais_;
+    /// Context of the game the AIs belong to
+    GameObject::Context* context_;
+    unsigned gf_;
+    bool gfisnwf_;
+    /// Incremented for every task, so the workers know when there is something to do
+    unsigned taskId_;
+    unsigned numBusyWorkers_;
+    bool stop_;
+    std::exception_ptr error_;
+    /// Index of the next AI to run
+    std::atomic<unsigned> nextAI_;
+
+    void WorkerLoop();
+    /// Run AIs until there is none left
+    void RunAIs();
+};
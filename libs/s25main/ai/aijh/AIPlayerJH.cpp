@@ -26,6 +26,7 @@
 #include "notifications/RoadNote.h"
 #include "notifications/ShipNote.h"
 #include "pathfinding/PathConditionRoad.h"
+#include "random/Random.h"
 #include "nodeObjs/noAnimal.h"
 #include "nodeObjs/noFlag.h"
 #include "nodeObjs/noShip.h"
@@ -160,10 +161,18 @@ static auto createResourceMaps(const AIInterface& aii, const AIMap& aiMap)
     return createResourceMaps(aii, aiMap, std::make_index_sequence<helpers::NumEnumValues_v<AIResource>>{});
 }
 
+/// Create the random number generator of an AI seeded by the player id and the current state of the game RNG,
+/// which is the seed of the game for new games. The game RNG is only read, so the game itself is not affected
+static std::minstd_rand createRng(const unsigned char playerId)
+{
+    std::seed_seq seeds{RANDOM.GetChecksum(), static_cast<unsigned>(playerId)};
+    return std::minstd_rand(seeds);
+}
+
 AIPlayerJH::AIPlayerJH(const unsigned char playerId, const GameWorldBase& gwb, const AI::Level level)
     : AIPlayer(playerId, gwb, level), UpgradeBldPos(MapPoint::Invalid()), resourceMaps(createResourceMaps(aii, aiMap)),
       isInitGfCompleted(false), defeated(player.IsDefeated()), bldPlanner(std::make_unique<BuildingPlanner>(*this)),
-      construction(std::make_unique<AIConstruction>(*this))
+      construction(std::make_unique<AIConstruction>(*this)), rng(createRng(playerId))
 {
     InitNodes();
     InitResourceMaps();
@@ -283,7 +292,7 @@ void AIPlayerJH::RunGF(const unsigned gf, bool gfisnwf)
     {
         AdjustSettings();
         // check for useless sawmills
-        const std::list<nobUsual*>& sawMills = aii.GetBuildings(BuildingType::Sawmill);
+        const std::vector<nobUsual*>& sawMills = aii.GetBuildings(BuildingType::Sawmill);
         if(sawMills.size() > 3)
         {
             int burns = 0;
@@ -329,7 +338,7 @@ void AIPlayerJH::PlanNewBuildings(const unsigned gf)
     // LOG.write(("new buildorders %i whs and %i mil for player %i
     // \n",aii.GetStorehouses().size(),aii.GetMilitaryBuildings().size(),playerId);
 
-    const std::list<nobBaseWarehouse*>& storehouses = aii.GetStorehouses();
+    const std::vector<nobBaseWarehouse*>& storehouses = aii.GetStorehouses();
     if(!storehouses.empty())
     {
         // collect swords,shields,helpers,privates and beer in first storehouse or whatever is closest to the
@@ -344,7 +353,7 @@ void AIPlayerJH::PlanNewBuildings(const unsigned gf)
         DistributeGoodsByBlocking(GoodType::Boards, 30);
         DistributeGoodsByBlocking(GoodType::Stones, 50);
         // go to the picked random warehouse and try to build around it
-        int randomStore = rand() % (storehouses.size());
+        int randomStore = GetRandomNumber() % (storehouses.size());
         auto it = storehouses.begin();
         std::advance(it, randomStore);
         const MapPoint whPos = (*it)->GetPos();
@@ -362,10 +371,10 @@ void AIPlayerJH::PlanNewBuildings(const unsigned gf)
     // end of construction around & orders for warehouses
 
     // now pick a random military building and try to build around that as well
-    const std::list<nobMilitary*>& militaryBuildings = aii.GetMilitaryBuildings();
+    const std::vector<nobMilitary*>& militaryBuildings = aii.GetMilitaryBuildings();
     if(militaryBuildings.empty())
         return;
-    int randomMiliBld = rand() % militaryBuildings.size();
+    int randomMiliBld = GetRandomNumber() % militaryBuildings.size();
     auto it2 = militaryBuildings.begin();
     std::advance(it2, randomMiliBld);
     MapPoint bldPos = (*it2)->GetPos();
@@ -407,7 +416,7 @@ unsigned AIPlayerJH::GetNumJobs() const
 /// warehouse left null
 nobBaseWarehouse* AIPlayerJH::GetUpgradeBuildingWarehouse()
 {
-    const std::list<nobBaseWarehouse*>& storehouses = aii.GetStorehouses();
+    const std::vector<nobBaseWarehouse*>& storehouses = aii.GetStorehouses();
     if(storehouses.empty())
         return nullptr;
     nobBaseWarehouse* wh = storehouses.front();
@@ -662,8 +671,7 @@ void AIPlayerJH::SetFarmedNodes(const MapPoint pt, bool set)
     const unsigned radius = 3;
 
     aiMap[pt].farmed = set;
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
-    for(const MapPoint& curPt : pts)
+    for(const MapPoint curPt : gwb.PointsInRadius(pt, radius))
         aiMap[curPt].farmed = set;
 }
 
@@ -729,7 +737,7 @@ void AIPlayerJH::ExecuteAIJob()
 
 void AIPlayerJH::DistributeGoodsByBlocking(const GoodType good, unsigned limit)
 {
-    const std::list<nobBaseWarehouse*>& storehouses = aii.GetStorehouses();
+    const std::vector<nobBaseWarehouse*>& storehouses = aii.GetStorehouses();
     if(aii.GetHarbors().size() >= storehouses.size() / 2)
     {
         // dont distribute on maps that are mostly sea maps - harbors are too difficult to defend and have to handle
@@ -811,7 +819,7 @@ void AIPlayerJH::DistributeGoodsByBlocking(const GoodType good, unsigned limit)
 
 void AIPlayerJH::DistributeMaxRankSoldiersByBlocking(unsigned limit, nobBaseWarehouse* upwh)
 {
-    const std::list<nobBaseWarehouse*>& storehouses = aii.GetStorehouses();
+    const std::vector<nobBaseWarehouse*>& storehouses = aii.GetStorehouses();
     unsigned numCompleteWh = storehouses.size();
 
     if(numCompleteWh < 1) // no warehouses -> no job
@@ -907,8 +915,7 @@ void AIPlayerJH::DistributeMaxRankSoldiersByBlocking(unsigned limit, nobBaseWare
 }
 MapPoint AIPlayerJH::SimpleFindPosition(const MapPoint& pt, BuildingQuality size, unsigned radius) const
 {
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
-    for(const MapPoint& curPt : pts)
+    for(const MapPoint curPt : gwb.PointsInRadius(pt, radius))
     {
         if(!aiMap[curPt].reachable || aiMap[curPt].farmed || !aii.IsOwnTerritory(curPt))
             continue;
@@ -1021,7 +1028,7 @@ unsigned AIPlayerJH::GetDensity(MapPoint pt, AIResource res, int radius)
 {
     RTTR_Assert(pt.x < aiMap.GetWidth() && pt.y < aiMap.GetHeight());
 
-    std::vector<MapPoint> pts = gwb.GetPointsInRadius(pt, radius);
+    const MapPointsInRadius pts = gwb.PointsInRadius(pt, radius);
     const unsigned numAllPTs = pts.size();
     RTTR_Assert(numAllPTs > 0);
 
@@ -1107,7 +1114,7 @@ void AIPlayerJH::HandleBuilingDestroyed(MapPoint pt, BuildingType bld)
         case BuildingType::HarborBuilding:
         {
             // destroy all other buildings around the harborspot in range 2 so we can rebuild the harbor ...
-            for(const MapPoint curPt : gwb.GetPointsInRadius(pt, 2))
+            for(const MapPoint curPt : gwb.PointsInRadius(pt, 2))
             {
                 const auto* const bb = gwb.GetSpecObj<noBaseBuilding>(curPt);
                 if(bb)
@@ -1209,7 +1216,7 @@ void AIPlayerJH::HandleExpedition(const noShip* ship)
         aii.FoundColony(ship);
     else
     {
-        const unsigned offset = rand() % helpers::MaxEnumValue_v<ShipDirection>;
+        const unsigned offset = GetRandomNumber() % helpers::MaxEnumValue_v<ShipDirection>;
         for(auto dir : helpers::EnumRange<ShipDirection>{})
         {
             dir = ShipDirection((rttr::enum_cast(dir) + offset) % helpers::MaxEnumValue_v<ShipDirection>);
@@ -1254,7 +1261,7 @@ void AIPlayerJH::HandleTreeChopped(const MapPoint pt)
 
     UpdateNodesAround(pt, 3);
 
-    int random = rand();
+    int random = GetRandomNumber();
 
     if(random % 2 == 0)
         AddMilitaryBuildJob(pt);
@@ -1326,7 +1333,7 @@ void AIPlayerJH::HandleNoMoreResourcesReachable(const MapPoint pt, BuildingType
 void AIPlayerJH::HandleShipBuilt(const MapPoint pt)
 {
     // Stop building ships if reached a maximum (TODO: make variable)
-    const std::list<nobUsual*>& shipyards = aii.GetBuildings(BuildingType::Shipyard);
+    const std::vector<nobUsual*>& shipyards = aii.GetBuildings(BuildingType::Shipyard);
     bool wantMoreShips;
     unsigned numRelevantSeas = GetNumAIRelevantSeaIds();
     if(numRelevantSeas == 0)
@@ -1398,7 +1405,7 @@ void AIPlayerJH::MilUpgradeOptim()
     // do we have a upgrade building?
     int upb = UpdateUpgradeBuilding();
     int count = 0;
-    const std::list<nobMilitary*>& militaryBuildings = aii.GetMilitaryBuildings();
+    const std::vector<nobMilitary*>& militaryBuildings = aii.GetMilitaryBuildings();
     for(const nobMilitary* milBld : militaryBuildings)
     {
         if(count != upb) // not upgrade building
@@ -1474,7 +1481,7 @@ bool AIPlayerJH::HasFrontierBuildings()
 
 void AIPlayerJH::CheckExpeditions()
 {
-    const std::list<nobHarborBuilding*>& harbors = aii.GetHarbors();
+    const std::vector<nobHarborBuilding*>& harbors = aii.GetHarbors();
     for(const nobHarborBuilding* harbor : harbors)
     {
         bool isHarborRelevant = HarborPosRelevant(harbor->GetHarborPosID(), true);
@@ -1496,7 +1503,7 @@ void AIPlayerJH::CheckExpeditions()
 
 void AIPlayerJH::CheckForester()
 {
-    const std::list<nobUsual*>& foresters = aii.GetBuildings(BuildingType::Forester);
+    const std::vector<nobUsual*>& foresters = aii.GetBuildings(BuildingType::Forester);
     if(!foresters.empty() && foresters.size() < 2 && aii.GetMilitaryBuildings().size() < 3
        && aii.GetBuildingSites().size() < 3)
     // stop the forester
@@ -1529,7 +1536,7 @@ void AIPlayerJH::TryToAttack()
     std::vector<const nobBaseMilitary*> potentialTargets;
 
     // use own military buildings (except inland buildings) to search for enemy military buildings
-    const std::list<nobMilitary*>& militaryBuildings = aii.GetMilitaryBuildings();
+    const std::vector<nobMilitary*>& militaryBuildings = aii.GetMilitaryBuildings();
     const unsigned numMilBlds = militaryBuildings.size();
     // when the ai has many buildings the ai will not check the complete list every time
     constexpr unsigned limit = 40;
@@ -1538,7 +1545,7 @@ void AIPlayerJH::TryToAttack()
         // We skip the current building with a probability of limit/numMilBlds
         // -> For twice the number of blds as the limit we will most likely skip every 2nd building
         // This way we check roughly (at most) limit buildings but avoid any preference for one building over an other
-        if(rand() % numMilBlds > limit)
+        if(GetRandomNumber() % numMilBlds > limit)
             continue;
 
         if(milBld->GetFrontierDistance() == FrontierDistance::Far) // inland building? -> skip it
@@ -1570,8 +1577,7 @@ void AIPlayerJH::TryToAttack()
     }
 
     // shuffle everything but headquarters and harbors without any troops in them
-    std::shuffle(potentialTargets.begin() + hq_or_harbor_without_soldiers, potentialTargets.end(),
-                 std::mt19937(std::random_device()()));
+    std::shuffle(potentialTargets.begin() + hq_or_harbor_without_soldiers, potentialTargets.end(), rng);
 
     // check for each potential attacking target the number of available attacking soldiers
     for(const nobBaseMilitary* target : potentialTargets)
@@ -1684,11 +1690,10 @@ void AIPlayerJH::TrySeaAttack()
             // \n",gwb.GetHarborPoint(i).x,gwb.GetHarborPoint(i).y);
         }
     }
-    auto prng = std::mt19937(std::random_device()());
     // any undefendedTargets? -> pick one by random
     if(!undefendedTargets.empty())
     {
-        std::shuffle(undefendedTargets.begin(), undefendedTargets.end(), prng);
+        std::shuffle(undefendedTargets.begin(), undefendedTargets.end(), rng);
         for(const nobBaseMilitary* targetMilBld : undefendedTargets)
         {
             std::vector<GameWorldBase::PotentialSeaAttacker> attackers =
@@ -1704,7 +1709,7 @@ void AIPlayerJH::TrySeaAttack()
     unsigned limit = 15;
     unsigned skip = 0;
     if(searcharoundharborspots.size() > 15)
-        skip = std::max<int>(rand() % (searcharoundharborspots.size() / 15 + 1) * 15, 1) - 1;
+        skip = std::max<int>(GetRandomNumber() % (searcharoundharborspots.size() / 15 + 1) * 15, 1) - 1;
     for(unsigned i = skip; i < searcharoundharborspots.size() && limit > 0; i++)
     {
         limit--;
@@ -1741,7 +1746,7 @@ void AIPlayerJH::TrySeaAttack()
     // random
     if(!undefendedTargets.empty())
     {
-        std::shuffle(undefendedTargets.begin(), undefendedTargets.end(), prng);
+        std::shuffle(undefendedTargets.begin(), undefendedTargets.end(), rng);
         for(const nobBaseMilitary* targetMilBld : undefendedTargets)
         {
             std::vector<GameWorldBase::PotentialSeaAttacker> attackers =
@@ -1753,7 +1758,7 @@ void AIPlayerJH::TrySeaAttack()
             }
         }
     }
-    std::shuffle(potentialTargets.begin(), potentialTargets.end(), prng);
+    std::shuffle(potentialTargets.begin(), potentialTargets.end(), rng);
     for(const nobBaseMilitary* ship : potentialTargets)
     {
         // TODO: decide if it is worth attacking the target and not just "possible"
@@ -2471,7 +2476,7 @@ unsigned AIPlayerJH::CalcMilSettings()
     int count = 0;
     unsigned soldierInUseFixed = 0;
     const int uun = UpdateUpgradeBuilding();
-    const std::list<nobMilitary*>& militaryBuildings = aii.GetMilitaryBuildings();
+    const std::vector<nobMilitary*>& militaryBuildings = aii.GetMilitaryBuildings();
     for(const nobMilitary* milBld : militaryBuildings)
     {
         if(milBld->GetFrontierDistance() == FrontierDistance::Near
@@ -14,6 +14,7 @@
 #include <list>
 #include <memory>
 #include <queue>
+#include <random>
 
 class noFlag;
 class noShip;
@@ -212,6 +213,8 @@ public:
     void ExecuteLuaConstructionOrder(MapPoint pt, BuildingType bt, bool forced = false);
 
     bool NoEnemyHarbor();
+    /// Return a random number from the generator of this AI
+    unsigned GetRandomNumber() { return rng(); }
 
     MapPoint UpgradeBldPos;
 
@@ -238,6 +241,9 @@ private:
 
     Subscription subBuilding, subExpedition, subResource, subRoad, subShip, subBQ;
     std::vector<MapPoint> nodesWithOutdatedBQ;
+    /// Each AI has its own random number generator seeded by the game and the player id.
+    /// So the decisions are reproducible and independent of other AIs which may run on other threads
+    std::minstd_rand rng;
 };
 
 } // namespace AIJH
@@ -79,8 +79,7 @@ MapPoint AIResourceMap::findBestPosition(const MapPoint& pt, BuildingQuality siz
     MapPoint best = MapPoint::Invalid();
     int best_value = (minimum == std::numeric_limits<int>::min()) ? minimum : minimum - 1;
 
-    std::vector<MapPoint> pts = aii.gwb.GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
+    for(const MapPoint curPt : aii.gwb.PointsInRadius(pt, radius, true))
     {
         const unsigned idx = map.GetIdx(curPt);
         if(map[idx] > best_value)
@@ -10,6 +10,7 @@
 #include "network/GameClient.h"
 #include "ogl/glArchivItem_Bitmap_Player.h"
 #include "world/GameWorld.h"
+#include "world/VisionMap.h"
 #include "gameData/MilitaryConsts.h"
 #include <numeric>
 
@@ -315,6 +316,7 @@ nobHQ::nobHQ(const MapPoint pos, const unsigned char player, const Nation nation
 
     // ins Militärquadrat einfügen
     world->GetMilitarySquares().Add(this);
+    world->GetVisionMap().AddObjectViewer(*this, pos, GetMilitaryRadius() + VISUALRANGE_MILITARY, player);
     world->RecalcTerritory(*this, TerritoryChangeReason::Build);
 }
 
@@ -323,6 +325,7 @@ void nobHQ::DestroyBuilding()
     nobBaseWarehouse::DestroyBuilding();
     // Wieder aus dem Militärquadrat rauswerfen
     world->GetMilitarySquares().Remove(this);
+    world->GetVisionMap().RemoveObjectViewer(*this);
     // Recalc territory. AFTER calling base destroy as otherwise figures might get stuck here
     world->RecalcTerritory(*this, TerritoryChangeReason::Destroyed);
 }
@@ -23,6 +23,7 @@
 #include "postSystem/PostMsgWithBuilding.h"
 #include "random/Random.h"
 #include "world/GameWorld.h"
+#include "world/VisionMap.h"
 #include "nodeObjs/noShip.h"
 #include "gameData/BuildingConsts.h"
 #include "gameData/GameConsts.h"
@@ -56,6 +57,7 @@ nobHarborBuilding::nobHarborBuilding(const MapPoint pos, const unsigned char pla
 {
     // ins Militärquadrat einfügen
     world->GetMilitarySquares().Add(this);
+    world->GetVisionMap().AddObjectViewer(*this, pos, GetMilitaryRadius() + VISUALRANGE_MILITARY, player);
     world->RecalcTerritory(*this, TerritoryChangeReason::Build);
 
     // Alle Waren 0
@@ -144,6 +146,7 @@ void nobHarborBuilding::DestroyBuilding()
     nobBaseWarehouse::DestroyBuilding();
 
     world->GetMilitarySquares().Remove(this);
+    world->GetVisionMap().RemoveObjectViewer(*this);
     // Recalc territory. AFTER calling base destroy as otherwise figures might get stuck here
     world->RecalcTerritory(*this, TerritoryChangeReason::Destroyed);
 }
@@ -28,6 +28,7 @@
 #include "postSystem/PostMsgWithBuilding.h"
 #include "random/Random.h"
 #include "world/GameWorld.h"
+#include "world/VisionMap.h"
 #include "nodeObjs/noFlag.h"
 #include "gameData/BuildingConsts.h"
 #include "gameData/BuildingProperties.h"
@@ -102,6 +103,7 @@ void nobMilitary::DestroyBuilding()
 {
     // Remove from military square and buildings first, to avoid e.g. sending canceled soldiers back to this building
     world->GetMilitarySquares().Remove(this);
+    world->GetVisionMap().RemoveObjectViewer(*this);
 
     // Bestellungen stornieren
     CancelOrders();
@@ -704,6 +706,7 @@ void nobMilitary::AddPassiveSoldier(std::unique_ptr<nofPassiveSoldier> soldier)
                                                         PostCategory::Military, *this, SoundEffect::Fanfare));
         // Ist nun besetzt
         new_built = false;
+        world->GetVisionMap().AddObjectViewer(*this, pos, GetMilitaryRadius() + VISUALRANGE_MILITARY, player);
         // Landgrenzen verschieben
         world->RecalcTerritory(*this, TerritoryChangeReason::Build);
         // Tür zumachen
@@ -947,6 +950,9 @@ void nobMilitary::Capture(const unsigned char new_owner)
     world->GetPlayer(old_player).RemoveBuilding(this, bldType_);
     // neuer Spieler
     player = new_owner;
+    // Die Sicht geht an den neuen Besitzer über
+    world->GetVisionMap().RemoveObjectViewer(*this);
+    world->GetVisionMap().AddObjectViewer(*this, pos, GetMilitaryRadius() + VISUALRANGE_MILITARY, player);
     // In der Wirtschaftsverwaltung dieses Gebäude jetzt zum neuen Spieler zählen und beim alten raushauen
     world->GetPlayer(new_owner).AddBuilding(this, bldType_);
 
@@ -51,6 +51,7 @@
 #include "ingameWindows/iwMusicPlayer.h"
 #include "ingameWindows/iwOptionsWindow.h"
 #include "ingameWindows/iwPostWindow.h"
+#include "ingameWindows/iwProfiler.h"
 #include "ingameWindows/iwRoadWindow.h"
 #include "ingameWindows/iwSave.h"
 #include "ingameWindows/iwShip.h"
@@ -753,6 +754,9 @@ bool dskGameInterface::Msg_KeyDown(const KeyEvent& ke)
             WINDOWMANAGER.ToggleWindow(
               std::make_unique<iwMapDebug>(gwv, game_->world_.IsSinglePlayer() || GAMECLIENT.IsReplayModeOn()));
             return true;
+        case KeyType::F4: // Profiler (time spent per GF)
+            WINDOWMANAGER.ToggleWindow(std::make_unique<iwProfiler>());
+            return true;
         case KeyType::F8: // Tastaturbelegung
             WINDOWMANAGER.ToggleWindow(std::make_unique<iwTextfile>("keyboardlayout.txt", _("Keyboard layout")));
             return true;
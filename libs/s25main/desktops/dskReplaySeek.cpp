@@ -0,0 +1,50 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "dskReplaySeek.h"
+#include "Loader.h"
+#include "WindowManager.h"
+#include "dskGameLoader.h"
+#include "dskMainMenu.h"
+#include "helpers/format.hpp"
+#include "ingameWindows/iwMsgbox.h"
+#include "network/GameClient.h"
+#include "ogl/FontStyle.h"
+#include "s25util/colors.h"
+#include <utility>
+
+dskReplaySeek::dskReplaySeek(boost::filesystem::path replayPath, const unsigned targetGF)
+    : Desktop(nullptr), replayPath_(std::move(replayPath)), targetGF_(targetGF)
+{
+    AddText(0, DrawPoint(800 / 2, 600 / 2), helpers::format(_("Jumping to GF %1%..."), targetGF_), COLOR_YELLOW,
+            FontStyle::CENTER | FontStyle::VCENTER, LargeFont);
+}
+
+dskReplaySeek::~dskReplaySeek()
+{
+    GAMECLIENT.RemoveInterface(this);
+}
+
+void dskReplaySeek::SetActive(bool activate)
+{
+    const bool wasActive = IsActive();
+    Desktop::SetActive(activate);
+    if(!activate || wasActive)
+        return;
+
+    GAMECLIENT.Stop();
+    GAMECLIENT.SetInterface(this);
+    if(!GAMECLIENT.StartReplay(replayPath_, targetGF_))
+    {
+        WINDOWMANAGER.Switch(std::make_unique<dskMainMenu>());
+        WINDOWMANAGER.ShowAfterSwitch(std::make_unique<iwMsgbox>(_("Error while playing replay!"), _("Invalid Replay!"),
+                                                                 nullptr, MsgboxButton::Ok,
+                                                                 MsgboxIcon::ExclamationRed));
+    }
+}
+
+void dskReplaySeek::CI_GameLoading(std::shared_ptr<Game> game)
+{
+    WINDOWMANAGER.Switch(std::make_unique<dskGameLoader>(std::move(game)));
+}
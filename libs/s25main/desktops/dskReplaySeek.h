@@ -0,0 +1,25 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "Desktop.h"
+#include "network/ClientInterface.h"
+#include <boost/filesystem/path.hpp>
+
+/// Restarts the running replay from the last keyframe before the target GF and jumps to it.
+/// This is done when this desktop gets active, i.e. after the game interface and hence the old game are gone.
+class dskReplaySeek : public Desktop, public ClientInterface
+{
+public:
+    dskReplaySeek(boost::filesystem::path replayPath, unsigned targetGF);
+    ~dskReplaySeek() override;
+
+    void SetActive(bool activate = true) override;
+    void CI_GameLoading(std::shared_ptr<Game> game) override;
+
+private:
+    boost::filesystem::path replayPath_;
+    unsigned targetGF_;
+};
@@ -233,10 +233,8 @@ bool nofActiveSoldier::FindEnemiesNearby(unsigned char excludedOwner)
     RTTR_Assert(enemy == nullptr);
     enemy = nullptr;
 
-    // Get all points in a radius of 2
-    std::vector<MapPoint> pts = world->GetPointsInRadiusWithCenter(pos, 2);
-
-    for(const auto& curPos : pts)
+    // Check all points in a radius of 2
+    for(const MapPoint curPos : world->PointsInRadius(pos, 2, true))
     {
         for(noBase& object : world->GetFigures(curPos))
         {
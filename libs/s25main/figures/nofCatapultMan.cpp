@@ -130,7 +130,7 @@ void nofCatapultMan::HandleDerivedEvent(const unsigned /*id*/)
                 if(CanAttackBuilding(building))
                 {
                     // Was nicht im Nebel liegt und auch schon besetzt wurde (nicht neu gebaut)?
-                    if(world->GetNode(building->GetPos()).fow[player].visibility == Visibility::Visible
+                    if(world->GetFoWNode(building->GetPos(), player).visibility == Visibility::Visible
                        && !static_cast<nobMilitary*>(building)->IsNewBuilt())
                     {
                         // Entfernung ausrechnen
@@ -7,6 +7,7 @@
 #include "buildings/nobUsual.h"
 #include "postSystem/PostMsgWithBuilding.h"
 #include "world/GameWorld.h"
+#include "world/VisionMap.h"
 #include "gameData/MilitaryConsts.h"
 class SerializedGameData;
 class nobBaseWarehouse;
@@ -31,6 +32,7 @@ void nofScout_LookoutTower::HandleDerivedEvent(const unsigned /*id*/) {}
 
 void nofScout_LookoutTower::WorkAborted()
 {
+    world->GetVisionMap().RemoveObjectViewer(*workplace);
     // Im enstprechenden Radius alles neu berechnen
     world->RecalcVisibilitiesAroundPoint(pos, VISUALRANGE_LOOKOUTTOWER, player, workplace);
 }
@@ -38,6 +40,7 @@ void nofScout_LookoutTower::WorkAborted()
 void nofScout_LookoutTower::WorkplaceReached()
 {
     // Im enstprechenden Radius alles sichtbar machen
+    world->GetVisionMap().AddObjectViewer(*workplace, workplace->GetPos(), VISUALRANGE_LOOKOUTTOWER, player);
     world->MakeVisibleAroundPoint(pos, VISUALRANGE_LOOKOUTTOWER, player);
 
     // Und Post versenden
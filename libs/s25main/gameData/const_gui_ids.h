@@ -44,6 +44,7 @@ enum GUI_ID : unsigned
     CGI_PLAYREPLAY,
     CGI_PLEASEWAIT,
     CGI_POSTOFFICE,
+    CGI_PROFILER,
     CGI_README,
     CGI_ROADWINDOW,
     CGI_SAVE,
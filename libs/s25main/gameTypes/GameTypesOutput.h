@@ -22,6 +22,7 @@
 #include "gameTypes/Direction.h"
 #include "gameTypes/FoWNode.h"
 #include "gameTypes/MapTypes.h"
+#include "gameTypes/RoadPathDirection.h"
 #include "gameTypes/TeamTypes.h"
 #include "gameData/DescIdx.h"
 #include <boost/preprocessor/seq/for_each.hpp>
@@ -62,6 +63,7 @@ RTTR_ENUM_OUTPUT(PointRoad, None, Normal, Donkey, Boat)
 RTTR_ENUM_OUTPUT(PactType, TreatyOfAlliance, NonAgressionPact, OneSidedAlliance)
 RTTR_ENUM_OUTPUT(ResourceType, Nothing, Iron, Gold, Coal, Granite, Water, Fish)
 RTTR_ENUM_OUTPUT(RoadDir, East, SouthEast, SouthWest)
+RTTR_ENUM_OUTPUT(RoadPathDirection, West, NorthWest, NorthEast, East, SouthEast, SouthWest, Ship, None)
 RTTR_ENUM_OUTPUT(Species, PolarBear, RabbitWhite, RabbitGrey, Fox, Stag, Deer, Duck, Sheep)
 RTTR_ENUM_OUTPUT(StartWares, VLow, Low, Normal, ALot)
 RTTR_ENUM_OUTPUT(Visibility, Invisible, FogOfWar, Visible)
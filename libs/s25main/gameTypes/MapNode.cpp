@@ -7,7 +7,9 @@
 #include "nodeObjs/noBase.h"
 #include "gameData/TerrainDesc.h"
 #include "gameData/WorldDescription.h"
+#include <RTTR_Assert.h>
 #include <algorithm>
+#include <memory>
 
 MapNode::MapNode()
     : altitude(10), shadow(64), t1(0), t2(0), resources(0), reserved(false), owner(0), bq(BuildingQuality::Nothing),
@@ -17,7 +19,8 @@ MapNode::MapNode()
     std::fill(boundary_stones.begin(), boundary_stones.end(), 0);
 }
 
-void MapNode::Serialize(SerializedGameData& sgd, const unsigned numPlayers, const WorldDescription& desc) const
+void MapNode::Serialize(SerializedGameData& sgd, const WorldDescription& desc, const std::vector<const FoWNode*>& fow,
+                        const Figures& figures) const
 {
     helpers::pushContainer(sgd, roads);
     sgd.PushUnsignedChar(altitude);
@@ -28,17 +31,20 @@ void MapNode::Serialize(SerializedGameData& sgd, const unsigned numPlayers, cons
     sgd.PushBool(reserved);
     sgd.PushUnsignedChar(owner);
     helpers::pushContainer(sgd, boundary_stones);
-    RTTR_Assert(numPlayers <= fow.size());
-    for(unsigned z = 0; z < numPlayers; ++z)
-        fow[z].Serialize(sgd);
+    for(const FoWNode* fowNode : fow)
+        fowNode->Serialize(sgd);
     sgd.PushObject(obj);
-    sgd.PushObjectContainer(figures);
+    // Same format as PushObjectContainer
+    sgd.PushVarSize(figures.size());
+    for(const noBase& figure : figures)
+        sgd.PushObject(&figure);
     sgd.PushUnsignedShort(seaId);
     sgd.PushUnsignedInt(harborId);
 }
 
-void MapNode::Deserialize(SerializedGameData& sgd, const unsigned numPlayers, const WorldDescription& desc,
-                          const std::vector<DescIdx<TerrainDesc>>& landscapeTerrains)
+void MapNode::Deserialize(SerializedGameData& sgd, const WorldDescription& desc,
+                          const std::vector<DescIdx<TerrainDesc>>& landscapeTerrains,
+                          const std::vector<FoWNode*>& fow, Figures& figures)
 {
     helpers::popContainer(sgd, roads);
 
@@ -67,11 +73,14 @@ void MapNode::Deserialize(SerializedGameData& sgd, const unsigned numPlayers, co
     helpers::popContainer(sgd, boundary_stones);
     if(sgd.GetGameDataVersion() < 9)
         bq = sgd.Pop<BuildingQuality>();
-    RTTR_Assert(numPlayers <= fow.size());
-    for(unsigned z = 0; z < numPlayers; ++z)
-        fow[z].Deserialize(sgd);
+    for(FoWNode* fowNode : fow)
+        fowNode->Deserialize(sgd);
     obj = sgd.PopObject<noBase>();
-    sgd.PopObjectContainer(figures);
+    RTTR_Assert(figures.empty());
+    std::vector<std::unique_ptr<noBase>> newFigures;
+    sgd.PopObjectContainer(newFigures);
+    for(auto& figure : newFigures)
+        figures.push_back(*figure.release());
     seaId = sgd.PopUnsignedShort();
     harborId = sgd.PopUnsignedInt();
 }
@@ -6,22 +6,21 @@
 
 #include "Resource.h"
 #include "helpers/EnumArray.h"
+#include "nodeObjs/noBase.h"
 #include "gameTypes/BuildingQuality.h"
 #include "gameTypes/FoWNode.h"
 #include "gameTypes/MapTypes.h"
 #include "gameData/DescIdx.h"
-#include "gameData/MaxPlayers.h"
-#include <array>
-#include <list>
-#include <memory>
+#include <boost/intrusive/list.hpp>
 #include <vector>
 
-class noBase;
 class SerializedGameData;
 struct TerrainDesc;
 struct WorldDescription;
 
-/// Eigenschaften von einem Punkt auf der Map
+/// Eigenschaften von einem Punkt auf der Map.
+/// Only contains the data used often when looking at many nodes. The FoW of the players and the figures on the node
+/// are stored separately by the world
 struct MapNode
 {
     /// Roads from this point: E, SE, SW
@@ -41,8 +40,6 @@ struct MapNode
     unsigned char owner;
     BoundaryStones boundary_stones;
     BuildingQuality bq;
-    /// How the players see the point in FoW
-    std::array<FoWNode, MAX_PLAYERS> fow;
 
     /// To which sea this belongs to (0=None)
     unsigned short seaId;
@@ -51,15 +48,22 @@ struct MapNode
 
     /// Objekt, welches sich dort befindet
     noBase* obj;
-    /// Figures or fights on this node
-    std::list<std::unique_ptr<noBase>> figures;
 
     MapNode();
     MapNode(const MapNode&) = delete;
     MapNode(MapNode&&) = default;
     MapNode& operator=(const MapNode&) = delete;
     MapNode& operator=(MapNode&&) = default;
-    void Serialize(SerializedGameData& sgd, unsigned numPlayers, const WorldDescription& desc) const;
-    void Deserialize(SerializedGameData& sgd, unsigned numPlayers, const WorldDescription& desc,
-                     const std::vector<DescIdx<TerrainDesc>>& landscapeTerrains);
+
+    /// Figures or fights on a node in the order they were added. Linked via their hook, the world owns them
+    using Figures = boost::intrusive::list<noBase, boost::intrusive::base_hook<FigureListHook>,
+                                           boost::intrusive::constant_time_size<false>>;
+
+    /// Serialize the node together with the FoW of all players and the figures on it.
+    /// They are not part of the node but are stored with it to keep the format of the savegames
+    void Serialize(SerializedGameData& sgd, const WorldDescription& desc, const std::vector<const FoWNode*>& fow,
+                   const Figures& figures) const;
+    void Deserialize(SerializedGameData& sgd, const WorldDescription& desc,
+                     const std::vector<DescIdx<TerrainDesc>>& landscapeTerrains, const std::vector<FoWNode*>& fow,
+                     Figures& figures);
 };
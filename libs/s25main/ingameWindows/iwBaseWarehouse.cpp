@@ -220,7 +220,7 @@ void iwBaseWarehouse::Msg_ButtonClick(const unsigned ctrl_id)
         case ID_GOTO_NEXT: // go to next of same type
         {
             // is there at least 1 other building of the same type?
-            const std::list<nobBaseWarehouse*>& storehouses =
+            const std::vector<nobBaseWarehouse*>& storehouses =
               gwv.GetWorld().GetPlayer(wh->GetPlayer()).GetBuildingRegister().GetStorehouses();
             // go through list once we get to current building -> open window for the next one and go to next location
             auto it =
@@ -227,7 +227,7 @@ void iwMilitaryBuilding::Msg_ButtonClick(const unsigned ctrl_id)
         break;
         case 9: // go to next of same type
         {
-            const std::list<nobMilitary*>& militaryBuildings =
+            const std::vector<nobMilitary*>& militaryBuildings =
               gwv.GetWorld().GetPlayer(building->GetPlayer()).GetBuildingRegister().GetMilitaryBuildings();
             // go through list once we get to current building -> open window for the next one and go to next location
             auto it = helpers::find_if(
@@ -0,0 +1,146 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "iwProfiler.h"
+#include "GFProfiler.h"
+#include "Loader.h"
+#include "controls/ctrlMultiline.h"
+#include "helpers/EnumRange.h"
+#include "ogl/FontStyle.h"
+#include "ogl/glFont.h"
+#include "gameData/const_gui_ids.h"
+#include "s25util/colors.h"
+#include <boost/format.hpp>
+#include <algorithm>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+namespace {
+enum
+{
+    ID_Text,
+    ID_Timer
+};
+constexpr unsigned numTextLines = 22;
+/// Number of object types with the most event time to show
+constexpr unsigned numShownObjTypes = 5;
+
+double toMs(const GFProfiler::duration time)
+{
+    return std::chrono::duration<double, std::milli>(time).count();
+}
+} // namespace
+
+iwProfiler::iwProfiler()
+    : IngameWindow(CGI_PROFILER, IngameWindow::posLastOrCenter, Extent(330, 0), _("Profiler"),
+                   LOADER.GetImageN("resource", 41))
+{
+    text = AddMultiline(ID_Text, DrawPoint(15, 30), Extent(300, numTextLines * NormalFont->getHeight()),
+                        TextureColor::Grey, NormalFont, FontStyle::NO_OUTLINE);
+    SetIwSize(Extent(GetIwSize().x, text->GetPos().y + text->GetSize().y));
+    using namespace std::chrono_literals;
+    AddTimer(ID_Timer, 1s);
+    UpdateText();
+}
+
+void iwProfiler::Msg_Timer(const unsigned /*ctrl_id*/)
+{
+    UpdateText();
+}
+
+void iwProfiler::UpdateText()
+{
+    text->Clear();
+    if(!GFProfiler::isAvailable)
+    {
+        text->AddString(_("Profiling is not available in this build."), COLOR_YELLOW);
+        text->AddString(_("Compile with RTTR_ENABLE_PROFILING to use it."), COLOR_YELLOW);
+        return;
+    }
+    const std::vector<GFProfile> profiles = GFProfiler::GetProfiles();
+    if(profiles.empty())
+    {
+        text->AddString(_("No GFs recorded yet"), COLOR_YELLOW);
+        return;
+    }
+
+    // Sum up all GFs
+    GFProfile total;
+    const GFProfile* slowestGF = &profiles.front();
+    std::array<GFProfile::duration, MAX_PLAYERS> maxAITimes{};
+    for(const GFProfile& profile : profiles)
+    {
+        total.run.length += profile.run.length;
+        if(profile.run.length > slowestGF->run.length)
+            slowestGF = &profile;
+        for(const auto phase : helpers::enumRange<SimulationPhase>())
+            total.phaseTimes[phase] += profile.phaseTimes[phase];
+        for(const auto objType : helpers::enumRange<GO_Type>())
+        {
+            total.eventTimes[objType] += profile.eventTimes[objType];
+            total.numEvents[objType] += profile.numEvents[objType];
+        }
+        total.numPathfinderCalls += profile.numPathfinderCalls;
+        total.numExpandedNodes += profile.numExpandedNodes;
+        for(unsigned i = 0; i < MAX_PLAYERS; i++)
+        {
+            total.aiRuns[i].length += profile.aiRuns[i].length;
+            maxAITimes[i] = std::max(maxAITimes[i], profile.aiRuns[i].length);
+        }
+    }
+    const auto numGFs = static_cast<double>(profiles.size());
+
+    text->AddString((boost::format(_("Last %1% GFs (%2% - %3%)")) % profiles.size() % profiles.front().gf
+                     % profiles.back().gf)
+                      .str(),
+                    COLOR_YELLOW);
+    text->AddString((boost::format(_("GF: %1$.2fms avg, %2$.2fms max (GF %3%)")) % (toMs(total.run.length) / numGFs)
+                     % toMs(slowestGF->run.length) % slowestGF->gf)
+                      .str(),
+                    COLOR_WHITE);
+    for(const auto phase : helpers::enumRange<SimulationPhase>())
+    {
+        text->AddString(
+          (boost::format("  %1%: %2$.2fms") % getName(phase) % (toMs(total.phaseTimes[phase]) / numGFs)).str(),
+          COLOR_WHITE);
+    }
+    text->AddString((boost::format(_("Pathfinding: %1$.1f calls, %2$.0f nodes per GF"))
+                     % (total.numPathfinderCalls / numGFs) % (total.numExpandedNodes / numGFs))
+                      .str(),
+                    COLOR_WHITE);
+
+    std::vector<GO_Type> objTypes;
+    for(const auto objType : helpers::enumRange<GO_Type>())
+    {
+        if(total.numEvents[objType] > 0u)
+            objTypes.push_back(objType);
+    }
+    const auto numShown = std::min<size_t>(objTypes.size(), numShownObjTypes);
+    std::partial_sort(objTypes.begin(), objTypes.begin() + numShown, objTypes.end(),
+                      [&total](GO_Type lhs, GO_Type rhs) { return total.eventTimes[lhs] > total.eventTimes[rhs]; });
+    text->AddString(_("Events with most time per GF:"), COLOR_YELLOW);
+    for(unsigned i = 0; i < numShown; i++)
+    {
+        const GO_Type objType = objTypes[i];
+        text->AddString((boost::format("  %1%: %2$.2fms (%3$.1f events)") % GFProfiler::GetName(objType)
+                         % (toMs(total.eventTimes[objType]) / numGFs) % (total.numEvents[objType] / numGFs))
+                          .str(),
+                        COLOR_WHITE);
+    }
+
+    bool hasAIs = false;
+    for(unsigned i = 0; i < MAX_PLAYERS; i++)
+    {
+        if(maxAITimes[i] == GFProfile::duration::zero())
+            continue;
+        if(!hasAIs)
+            text->AddString(_("AI time per GF:"), COLOR_YELLOW);
+        hasAIs = true;
+        text->AddString((boost::format(_("  Player %1%: %2$.2fms avg, %3$.2fms max")) % (i + 1)
+                         % (toMs(total.aiRuns[i].length) / numGFs) % toMs(maxAITimes[i]))
+                          .str(),
+                        COLOR_WHITE);
+    }
+}
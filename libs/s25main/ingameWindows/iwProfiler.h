@@ -0,0 +1,22 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "IngameWindow.h"
+
+class ctrlMultiline;
+
+/// Shows where the time of the last GFs was spent (see GFProfiler)
+class iwProfiler : public IngameWindow
+{
+public:
+    iwProfiler();
+
+private:
+    void Msg_Timer(unsigned ctrl_id) override;
+    void UpdateText();
+
+    ctrlMultiline* text;
+};
@@ -4,11 +4,15 @@
 
 #include "iwSkipGFs.h"
 #include "Loader.h"
+#include "Replay.h"
+#include "WindowManager.h"
 #include "controls/ctrlEdit.h"
+#include "desktops/dskReplaySeek.h"
 #include "network/GameClient.h"
 #include "gameData/const_gui_ids.h"
 #include "s25util/StringConversion.h"
 #include "s25util/colors.h"
+#include <memory>
 
 iwSkipGFs::iwSkipGFs(GameWorldView& gwv)
     : IngameWindow(CGI_SKIPGFS, IngameWindow::posLastOrCenter, Extent(300, 110), _("Skip GameFrames"),
@@ -29,7 +33,10 @@ iwSkipGFs::iwSkipGFs(GameWorldView& gwv)
 void iwSkipGFs::SkipGFs()
 {
     int gf = s25util::fromStringClassicDef(GetCtrl<ctrlEdit>(1)->GetText(), 0);
-    GAMECLIENT.SkipGF(gf, gwv);
+    if(gf >= 0 && GAMECLIENT.ShouldRestartReplayForSkip(gf))
+        WINDOWMANAGER.Switch(std::make_unique<dskReplaySeek>(GAMECLIENT.GetReplay()->GetPath(), gf));
+    else
+        GAMECLIENT.SkipGF(gf, gwv);
 }
 
 void iwSkipGFs::Msg_ButtonClick(const unsigned /*ctrl_id*/)
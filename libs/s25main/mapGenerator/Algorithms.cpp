@@ -36,7 +36,7 @@ void UpdateDistances(NodeMapBase<unsigned>& distances, std::queue<MapPoint>& que
 void FlattenForCastleBuilding(NodeMapBase<uint8_t>& heightMap, MapPoint pos)
 {
     const auto& neighbors = heightMap.GetNeighbours(pos);
-    const auto& farNeighbors = heightMap.GetPointsInRadius(pos, 2);
+    const auto farNeighbors = heightMap.PointsInRadius(pos, 2);
 
     const auto compareHeight = [&heightMap](const MapPoint& p1, const MapPoint& p2) {
         return heightMap[p1] < heightMap[p2];
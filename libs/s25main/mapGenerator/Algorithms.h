@@ -7,8 +7,11 @@
 #include "RttrForeachPt.h"
 #include "helpers/containerUtils.h"
 #include "mapGenerator/NodeMapUtilities.h"
+#include "mapGenerator/ParallelFor.h"
 #include "world/NodeMapBase.h"
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <queue>
 #include <set>
 #include <stdexcept>
@@ -28,7 +31,10 @@ auto join(const T& container)
 }
 
 /**
- * Smoothes the specified nodes with a smoothing kernel of the specified extent (radius).
+ * Smoothes the specified nodes with a smoothing kernel of the specified extent (radius). Each iteration replaces
+ * every node by the average of all nodes within the radius (including itself) of the previous iteration.
+ * The points of the kernel in each row are consecutive, so the sums are computed from prefix sums of the rows
+ * without storing the neighbors of the nodes. The rows are handled in parallel.
  *
  * @param iteration number of times to apply smoothing kernel to every node
  * @param radius extent of the smoothing kernel
@@ -38,27 +44,49 @@ template<typename T>
 void Smooth(unsigned iterations, unsigned radius, NodeMapBase<T>& nodes)
 {
     const MapExtent& size = nodes.GetSize();
-    std::vector<std::vector<MapPoint>> neighbors(size.x * size.y);
-
-    RTTR_FOREACH_PT(MapPoint, size)
-    {
-        neighbors[nodes.GetIdx(pt)] = nodes.GetPointsInRadius(pt, radius);
-    }
+    const int iRadius = static_cast<int>(radius);
+    const double numKernelPoints = nodes.PointsInRadius(MapPoint(0, 0), radius, true).size();
+    // Sums of the first x values of each row with x in [0, width]
+    const unsigned rowSumsSize = size.x + 1u;
+    std::vector<int64_t> rowSums(rowSumsSize * size.y);
+
+    // Sum of the values in row y starting at x (may be outside the map) with the given length (may wrap around)
+    const auto sumOfRow = [&rowSums, &size, rowSumsSize](int y, int x, unsigned length) {
+        y = (y % size.y + size.y) % size.y;
+        x = (x % size.x + size.x) % size.x;
+        const int64_t* sums = &rowSums[y * rowSumsSize];
+        int64_t result = (length / size.x) * sums[size.x];
+        const unsigned endX = x + length % size.x;
+        if(endX <= size.x)
+            result += sums[endX] - sums[x];
+        else
+            result += sums[size.x] - sums[x] + sums[endX - size.x];
+        return result;
+    };
 
     for(unsigned i = 0; i < iterations; ++i)
     {
-        RTTR_FOREACH_PT(MapPoint, size)
-        {
-            int sum = static_cast<int>(nodes[pt]);
-            const auto& neighborPoints = neighbors[nodes.GetIdx(pt)];
-
-            for(const MapPoint& p : neighborPoints)
+        ForEachRowParallel(size, [&](const MapCoord y) {
+            int64_t* sums = &rowSums[y * rowSumsSize];
+            sums[0] = 0;
+            for(MapPoint pt(0, y); pt.x < size.x; ++pt.x)
+                sums[pt.x + 1] = sums[pt.x] + static_cast<int64_t>(nodes[pt]);
+        });
+
+        // Only the row sums are read, so the nodes can be overwritten
+        ForEachPtParallel(size, [&](const MapPoint pt) {
+            int64_t sum = 0;
+            for(int dy = -iRadius; dy <= iRadius; ++dy)
             {
-                sum += static_cast<int>(nodes[p]);
+                // The kernel row starts at the point reached by going |dy| steps NW or SW (which go to the left from
+                // even rows only) and then the remaining steps W
+                const int absDy = std::abs(dy);
+                const int numEvenRows = (pt.y % 2 == 0) ? (absDy + 1) / 2 : absDy / 2;
+                const int startX = pt.x - numEvenRows - (iRadius - absDy);
+                sum += sumOfRow(pt.y + dy, startX, 2 * radius + 1 - absDy);
             }
-
-            nodes[pt] = static_cast<T>(round(static_cast<double>(sum) / (neighborPoints.size() + 1)));
-        }
+            nodes[pt] = static_cast<T>(round(static_cast<double>(sum) / numKernelPoints));
+        });
     }
 }
 
@@ -86,13 +114,12 @@ void Scale(NodeMapBase<T>& values, T minimum, T maximum)
 
     auto scaledRange = maximum - minimum;
 
-    RTTR_FOREACH_PT(MapPoint, values.GetSize())
-    {
+    ForEachPtParallel(values.GetSize(), [&](const MapPoint pt) {
         auto normalizer = static_cast<double>(values[pt] - actualMinimum) / actualRange;
         auto offset = round(normalizer * scaledRange);
 
         values[pt] = static_cast<T>(minimum + offset);
-    }
+    });
 }
 
 /**
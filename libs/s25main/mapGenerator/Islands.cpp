@@ -41,9 +41,7 @@ Island CreateIsland(Map& map, RandomUtility& rnd, unsigned size, unsigned minLan
 
         queue.pop();
 
-        const auto& points = map.z.GetPointsInRadius(currentPoint, minLandDist);
-
-        for(const MapPoint& pt : points)
+        for(const MapPoint pt : map.z.PointsInRadius(currentPoint, minLandDist))
         {
             if(distances[pt] >= 2 * minLandDist)
             {
@@ -0,0 +1,78 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "gameTypes/MapCoordinates.h"
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace rttr::mapGenerator {
+
+/**
+ * Calls the function for every row of a map of the specified size using multiple threads. The rows are split into
+ * blocks of consecutive rows, one per thread.
+ * Only use this if handling a row does not depend on other rows being handled before, e.g. if only the nodes of the
+ * row are written. Then the result is the same as for a sequential loop, independent of the number of threads.
+ * The first exception thrown by the function is rethrown after all threads finished.
+ *
+ * @param size size of the map
+ * @param func function taking the y coordinate of the row
+ */
+template<class T_Func>
+void ForEachRowParallel(const MapExtent& size, T_Func&& func)
+{
+    // Starting threads for only a few rows costs more than it saves
+    constexpr unsigned minRowsPerThread = 16;
+    const unsigned numThreads =
+      std::max(1u, std::min(std::thread::hardware_concurrency(), static_cast<unsigned>(size.y) / minRowsPerThread));
+    const unsigned rowsPerThread = (size.y + numThreads - 1) / numThreads;
+
+    std::vector<std::exception_ptr> errors(numThreads);
+    const auto handleRows = [&](const unsigned threadIdx) {
+        try
+        {
+            const unsigned endY = std::min<unsigned>(size.y, (threadIdx + 1) * rowsPerThread);
+            for(unsigned y = threadIdx * rowsPerThread; y < endY; ++y)
+                func(static_cast<MapCoord>(y));
+        } catch(...)
+        {
+            errors[threadIdx] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(numThreads - 1);
+    for(unsigned i = 1; i < numThreads; ++i)
+        threads.emplace_back(handleRows, i);
+    handleRows(0);
+    for(std::thread& thread : threads)
+        thread.join();
+
+    for(const std::exception_ptr& error : errors)
+    {
+        if(error)
+            std::rethrow_exception(error);
+    }
+}
+
+/**
+ * Calls the function for every point of a map of the specified size using multiple threads.
+ * Same restrictions as for ForEachRowParallel apply: The function must not depend on other points being handled.
+ *
+ * @param size size of the map
+ * @param func function taking the MapPoint
+ */
+template<class T_Func>
+void ForEachPtParallel(const MapExtent& size, T_Func&& func)
+{
+    ForEachRowParallel(size, [&func, width = size.x](const MapCoord y) {
+        for(MapPoint pt(0, y); pt.x < width; ++pt.x)
+            func(pt);
+    });
+}
+
+} // namespace rttr::mapGenerator
@@ -7,6 +7,7 @@
 #include "helpers/containerUtils.h"
 #include "helpers/make_array.h"
 #include "mapGenerator/Algorithms.h"
+#include "mapGenerator/ParallelFor.h"
 #include "mapGenerator/Terrain.h"
 #include "mapGenerator/TextureHelper.h"
 
@@ -64,7 +65,7 @@ void AddObjects(Map& map, RandomUtility& rnd, const MapSettings& settings)
     {
         if(harborOrHeadquarter(pt))
         {
-            auto suroundingArea = map.getTextures().GetPointsInRadiusWithCenter(pt, 5);
+            const auto suroundingArea = map.getTextures().PointsInRadius(pt, 5, true);
             excludedArea.insert(suroundingArea.begin(), suroundingArea.end());
         } else if(map.textureMap.Any(pt, IsSnowOrLava))
         {
@@ -108,8 +109,7 @@ void AddObjects(Map& map, RandomUtility& rnd, const MapSettings& settings)
     const auto mountainDepth = DistancesTo(map.size, mountainFoot);
     const auto mountainRange = GetRange(mountainDepth);
 
-    RTTR_FOREACH_PT(MapPoint, map.size)
-    {
+    ForEachPtParallel(map.size, [&](const MapPoint pt) {
         if(waterDistance[pt] > 0 && distanceToExcludedArea[pt] > 0)
         {
             if(mountainDistance[pt] > 0)
@@ -126,7 +126,7 @@ void AddObjects(Map& map, RandomUtility& rnd, const MapSettings& settings)
         {
             probabilities[pt] = 0;
         }
-    }
+    });
 
     const auto trees = CreateTrees(map.textureMap);
     const auto treeForPoint = [&mountainDistance, &waterDistance, &range, &trees](const MapPoint& pt) {
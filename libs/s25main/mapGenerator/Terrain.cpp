@@ -4,6 +4,7 @@
 
 #include "mapGenerator/Terrain.h"
 #include "mapGenerator/Algorithms.h"
+#include "mapGenerator/ParallelFor.h"
 #include "mapGenerator/TextureHelper.h"
 
 #include <algorithm>
@@ -18,14 +19,13 @@ void Restructure(Map& map, const std::function<bool(const MapPoint&)>& predicate
     const auto distances = DistancesTo(size, predicate);
     const auto maximum = *std::max_element(distances.begin(), distances.end());
 
-    RTTR_FOREACH_PT(MapPoint, size)
-    {
+    ForEachPtParallel(size, [&](const MapPoint pt) {
         // value between 0 and 1 - depending on the distance to focused area
         auto value = static_cast<double>(maximum - distances[pt]) / maximum;
 
         // combine weight, value and actual z-value
         z[pt] = static_cast<uint8_t>(round(std::pow(value, weight) * z[pt]));
-    }
+    });
 
     Scale(z, map.height.minimum, map.height.maximum);
 }
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "GameClient.h"
+#include "BackgroundSaver.h"
 #include "CreateServerInfo.h"
 #include "EventManager.h"
 #include "Game.h"
@@ -20,6 +21,7 @@
 #include "Savegame.h"
 #include "SerializedGameData.h"
 #include "Settings.h"
+#include "Timer.h"
 #include "ai/AIPlayer.h"
 #include "drivers/VideoDriverWrapper.h"
 #include "factories/AIFactory.h"
@@ -31,6 +33,7 @@
 #include "network/ClientInterface.h"
 #include "network/GameMessages.h"
 #include "network/GameServer.h"
+#include "network/WorldDigestBisection.h"
 #include "ogl/FontStyle.h"
 #include "ogl/glArchivItem_Bitmap.h"
 #include "ogl/glFont.h"
@@ -52,6 +55,7 @@
 #include "s25util/utf8.h"
 #include <boost/filesystem.hpp>
 #include <helpers/chronoIO.h>
+#include <algorithm>
 #include <memory>
 
 namespace {
@@ -80,7 +84,13 @@ void GameClient::ClientConfig::Clear()
     isHost = false;
 }
 
-GameClient::GameClient() : skiptogf(0), mainPlayer(0), state(ClientState::Stopped), ci(nullptr), replayMode(false) {}
+/// Number of NWFs to keep the world digest for. The server checks the checksums of the NWF while we may be in the next
+constexpr unsigned numWorldDigestSnapshots = 4;
+
+GameClient::GameClient()
+    : skiptogf(0), mainPlayer(0), state(ClientState::Stopped), ci(nullptr),
+      worldDigestSnapshots_(numWorldDigestSnapshots), replayMode(false)
+{}
 
 GameClient::~GameClient()
 {
@@ -208,6 +218,9 @@ void GameClient::Stop()
     if(state == ClientState::Stopped)
         return;
 
+    // Finish writing the autosave before the game is gone
+    CheckBackgroundSave(true);
+
     if(game)
         ExitGame();
     else if(state == ClientState::Connect || state == ClientState::Config)
@@ -224,6 +237,12 @@ void GameClient::Stop()
     {
         if(replayinfo->replay.IsRecording())
             replayinfo->replay.StopRecording();
+        else if(replayinfo->replay.IsReplaying() && replayinfo->keyframes.IsModified())
+        {
+            const bfs::path keyframesPath = ReplayKeyframes::GetFilePath(replayinfo->replay.GetPath());
+            if(!replayinfo->keyframes.Save(keyframesPath, replayinfo->replay))
+                LOG.write(_("Could not save replay keyframes to %1%\n")) % keyframesPath;
+        }
         replayinfo->replay.Close();
         replayinfo.reset();
     }
@@ -288,7 +307,7 @@ void GameClient::StartGame(const unsigned random_init)
     }
 
     // If we have a savegame, start at its first GF, else at 0
-    unsigned startGF = (mapinfo.type == MapType::Savegame) ? mapinfo.savegame->start_gf : 0;
+    unsigned startGF = mapinfo.savegame ? mapinfo.savegame->start_gf : 0;
     // Create the game
     game =
       std::make_shared<Game>(std::move(gameLobby->getSettings()), startGF,
@@ -381,6 +400,7 @@ void GameClient::ExitGame()
     nwfInfo.reset();
     // Clear remaining commands
     gameCommands_.clear();
+    worldDigestSnapshots_.clear();
 }
 
 unsigned GameClient::GetGFNumber() const
@@ -1270,6 +1290,31 @@ bool GameClient::OnGameMessage(const GameMessage_GetAsyncLog& /*msg*/)
     return true;
 }
 
+/**
+ *  Server requests the hashes of world regions to locate an async
+ */
+bool GameClient::OnGameMessage(const GameMessage_GetWorldDigest& msg)
+{
+    if(state != ClientState::Game)
+        return true;
+    std::vector<unsigned> partHashes;
+    const auto itSnapshot = helpers::find_if(worldDigestSnapshots_, [&msg](const WorldDigestSnapshot& snapshot) {
+        return snapshot.digest == msg.digest;
+    });
+    const WorldDigest& digest = game->world_.GetDigest();
+    const unsigned firstRegion = msg.firstRegion;
+    // No regions means all
+    const unsigned numRegions = msg.numRegions ? msg.numRegions : digest.GetRegionHashes().size();
+    const unsigned numParts = std::min(msg.numParts, numRegions);
+    if(itSnapshot != worldDigestSnapshots_.end())
+        partHashes = WorldDigestBisection::GetPartHashes(itSnapshot->regionHashes, firstRegion, numRegions, numParts);
+    if(partHashes.empty())
+        LOG.write(_("Could not find the world digest requested by the server\n"));
+    mainPlayer.sendMsgAsync(
+      new GameMessage_WorldDigest(firstRegion, numRegions, digest.GetRegionsPerRow(), std::move(partHashes)));
+    return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// testet ob ein Netwerkframe abgelaufen ist und führt dann ggf die Befehle aus
 void GameClient::ExecuteGameFrame()
@@ -1356,7 +1401,12 @@ void GameClient::ExecuteGameFrame()
             OnError(ClientError::InvalidMap);
         }
         if(skiptogf == GetGFNumber())
+        {
             skiptogf = 0;
+            // Stay at the target of the jump
+            if(replayMode)
+                framesinfo.isPaused = true;
+        }
     }
     framesinfo.frameTime = std::chrono::duration_cast<FramesInfo::milliseconds32_t>(currentTime - framesinfo.lastTime);
     // Check remaining time until next GF
@@ -1384,6 +1434,8 @@ void GameClient::ExecuteGameFrame()
 
 void GameClient::HandleAutosave()
 {
+    CheckBackgroundSave(false);
+
     // If inactive or during replay -> no autosave
     if(!SETTINGS.interface.autosave_interval || replayMode)
         return;
@@ -1391,21 +1443,61 @@ void GameClient::HandleAutosave()
     // Alle .... GF
     if(GetGFNumber() % SETTINGS.interface.autosave_interval == 0)
     {
+        if(!backgroundSaver)
+            backgroundSaver = std::make_unique<BackgroundSaver>();
+        // Skip this autosave if the last one is still being written. Happens only for very short intervals
+        if(backgroundSaver->IsSaving())
+        {
+            LOG.write("Skipping autosave at GF %1% as the previous one is still being written\n", LogTarget::File)
+              % GetGFNumber();
+            return;
+        }
+
         std::string filename;
         if(mapinfo.title.empty())
             filename = std::string(_("Auto-Save")) + ".sav";
         else
             filename = mapinfo.title + " (" + _("Auto-Save") + ").sav";
 
-        SaveToFile(RTTRCONFIG.ExpandPath(s25::folders::save) / filename);
+        mainPlayer.sendMsg(GameMessage_Chat(GetPlayerId(), ChatDestination::System, "Saving game..."));
+
+        try
+        {
+            // Only the snapshot has to be taken now, compressing and writing is done in the background
+            const Timer timer(true);
+            std::unique_ptr<Savegame> save = CreateSavegame();
+            const BackgroundSaver::duration snapshotTime = timer.getElapsed();
+            backgroundSaver->Start(std::move(save), RTTRCONFIG.ExpandPath(s25::folders::save) / filename,
+                                   mapinfo.title, snapshotTime);
+        } catch(std::exception& e)
+        {
+            SystemChat(std::string("Error during saving: ") + e.what());
+        }
     }
 }
 
+void GameClient::CheckBackgroundSave(const bool wait)
+{
+    if(!backgroundSaver)
+        return;
+    const auto result = wait ? backgroundSaver->WaitForResult() : backgroundSaver->FetchResult();
+    if(!result)
+        return;
+    if(result->success)
+    {
+        using std::chrono::duration_cast;
+        using std::chrono::milliseconds;
+        LOG.write("Autosave written to %1% (snapshot: %2%, writing: %3%)\n", LogTarget::File) % result->filepath
+          % helpers::withUnit(duration_cast<milliseconds>(result->snapshotTime))
+          % helpers::withUnit(duration_cast<milliseconds>(result->writeTime));
+    } else
+        SystemChat(std::string("Error during saving: ") + result->error);
+}
+
 /// Führt notwendige Dinge für nächsten GF aus
 void GameClient::NextGF(bool wasNWF)
 {
-    for(AIPlayer& ai : game->aiPlayers_)
-        ai.RunGF(GetGFNumber(), wasNWF);
+    game->RunAIs(GetGFNumber(), wasNWF);
     game->RunGF();
 }
 
@@ -1442,6 +1534,12 @@ void GameClient::OnGameStart()
     {
         framesinfo.isPaused = replayMode;
         game->Start(!!mapinfo.savegame);
+        // Continue a jump for which the replay was restarted from a keyframe
+        if(replayMode && replayinfo->startSkipGF > GetGFNumber())
+        {
+            skiptogf = replayinfo->startSkipGF;
+            framesinfo.isPaused = false;
+        }
     }
 }
 
@@ -1461,7 +1559,7 @@ void GameClient::StartReplayRecording(const unsigned random_init)
     }
 }
 
-bool GameClient::StartReplay(const boost::filesystem::path& path)
+bool GameClient::StartReplay(const boost::filesystem::path& path, const unsigned targetGF)
 {
     RTTR_Assert(state == ClientState::Stopped);
     mapinfo.Clear();
@@ -1477,6 +1575,12 @@ bool GameClient::StartReplay(const boost::filesystem::path& path)
     }
     replayinfo->filename = path.filename();
 
+    // Use keyframes from previous runs of this replay
+    const bfs::path keyframesPath = ReplayKeyframes::GetFilePath(path);
+    if(bfs::exists(keyframesPath) && !replayinfo->keyframes.Load(keyframesPath, replayinfo->replay))
+        LOG.write(_("Ignoring invalid or outdated replay keyframes %1%\n")) % keyframesPath;
+    const ReplayKeyframe* keyframe = targetGF ? replayinfo->keyframes.FindBefore(targetGF) : nullptr;
+
     gameLobby = std::make_shared<GameLobby>(true, true, replayinfo->replay.GetNumPlayers());
 
     for(unsigned i = 0; i < replayinfo->replay.GetNumPlayers(); ++i)
@@ -1543,15 +1647,29 @@ bool GameClient::StartReplay(const boost::filesystem::path& path)
 
     try
     {
+        if(keyframe)
+        {
+            // Start from the keyframe's snapshot instead of the start of the replay
+            mapinfo.savegame = std::make_unique<Savegame>();
+            mapinfo.savegame->start_gf = keyframe->gf;
+            ReplayKeyframes::GetSnapshot(*keyframe, mapinfo.savegame->sgd);
+        }
         StartGame(replayinfo->replay.getSeed());
-    } catch(SerializedGameData::Error& error)
+    } catch(std::runtime_error& error)
     {
         LOG.write(_("Error when loading game from replay: %s\n")) % error.what();
         OnError(ClientError::InvalidMap);
         return false;
     }
 
-    replayinfo->next_gf = replayinfo->replay.ReadGF();
+    if(keyframe)
+    {
+        RANDOM.ResetState(keyframe->rngState);
+        replayinfo->replay.SetReadPosition(keyframe->replayPos);
+        replayinfo->next_gf = keyframe->nextCmdGF;
+    } else
+        replayinfo->next_gf = replayinfo->replay.ReadGF();
+    replayinfo->startSkipGF = targetGF;
 
     return true;
 }
@@ -1660,6 +1778,19 @@ void GameClient::SkipGF(unsigned gf, GameWorldView& gwv)
     SetPause(true);
 }
 
+bool GameClient::ShouldRestartReplayForSkip(const unsigned gf) const
+{
+    if(!replayMode || !replayinfo || !game)
+        return false;
+    const unsigned curGF = GetGFNumber();
+    // Going back is only possible by restarting
+    if(gf < curGF)
+        return true;
+    // Restart only if that saves at least 1 keyframe interval
+    const ReplayKeyframe* keyframe = replayinfo->keyframes.FindBefore(gf);
+    return keyframe && keyframe->gf >= curGF + replayinfo->keyframes.GetInterval();
+}
+
 void GameClient::SystemChat(const std::string& text)
 {
     SystemChat(text, GetPlayerId());
@@ -1681,24 +1812,10 @@ bool GameClient::SaveToFile(const boost::filesystem::path& filepath)
     LOADER.GetImageN("resource", 33)->DrawFull(moonPos);
     VIDEODRIVER.SwapBuffers();
 
-    Savegame save;
-
-    WritePlayerInfo(save);
-
-    // GGS-Daten
-    save.ggs = game->ggs_;
-
-    save.start_gf = GetGFNumber();
-
-    // Enable/Disable debugging of savegames
-    save.sgd.debugMode = SETTINGS.global.debugMode;
-
     try
     {
-        // Spiel serialisieren
-        save.sgd.MakeSnapshot(*game);
-        // Und alles speichern
-        return save.Save(filepath, mapinfo.title);
+        // Spiel serialisieren und alles speichern
+        return CreateSavegame()->Save(filepath, mapinfo.title);
     } catch(std::exception& e)
     {
         SystemChat(std::string("Error during saving: ") + e.what());
@@ -1706,6 +1823,24 @@ bool GameClient::SaveToFile(const boost::filesystem::path& filepath)
     }
 }
 
+std::unique_ptr<Savegame> GameClient::CreateSavegame()
+{
+    auto save = std::make_unique<Savegame>();
+
+    WritePlayerInfo(*save);
+
+    // GGS-Daten
+    save->ggs = game->ggs_;
+
+    save->start_gf = GetGFNumber();
+
+    // Enable/Disable debugging of savegames
+    save->sgd.debugMode = SETTINGS.global.debugMode;
+
+    save->sgd.MakeSnapshot(*game);
+    return save;
+}
+
 void GameClient::ResetVisualSettings()
 {
     GetPlayer(GetPlayerId()).FillVisualSettings(visual_settings);
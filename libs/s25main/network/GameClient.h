@@ -20,6 +20,7 @@
 #include "gameTypes/TeamTypes.h"
 #include "gameTypes/VisualSettings.h"
 #include "s25util/Singleton.h"
+#include <boost/circular_buffer.hpp>
 #include <memory>
 #include <vector>
 
@@ -28,6 +29,7 @@ struct Info;
 }
 
 class AIPlayer;
+class BackgroundSaver;
 class ClientInterface;
 class Game;
 class GameEvent;
@@ -37,6 +39,7 @@ class GameWorldView;
 class NWFInfo;
 class Replay;
 class SavedFile;
+class Savegame;
 enum class ConnectState;
 struct CreateServerInfo;
 struct PlayerGameCommands;
@@ -141,8 +144,8 @@ public:
     // Used by tests (stinks, but what to do?)
     FramesInfo::milliseconds32_t GetGFLengthReq() { return framesinfo.gfLengthReq; }
 
-    /// Lädt ein Replay und startet dementsprechend das Spiel
-    bool StartReplay(const boost::filesystem::path& path);
+    /// Start playing the replay. If a target GF is given, start from the last keyframe before it and jump to it
+    bool StartReplay(const boost::filesystem::path& path, unsigned targetGF = 0);
 
     /// When a non-empty vector is given then an AI battle with the given AIs is started
     void SetAIBattlePlayers(std::vector<AI::Info> aiInfos);
@@ -169,6 +172,9 @@ public:
     unsigned GetTournamentModeDuration() const;
 
     void SkipGF(unsigned gf, GameWorldView& gwv);
+    /// Return true if a jump to the GF in the running replay needs (or benefits from) restarting it from a keyframe
+    /// via StartReplay instead of SkipGF
+    bool ShouldRestartReplayForSkip(unsigned gf) const;
 
     /// Changes the player ingame (for replay or debugging)
     void ChangePlayerIngame(unsigned char playerId1, unsigned char playerId2);
@@ -212,8 +218,10 @@ private:
 
     /// Führt notwendige Dinge für nächsten GF aus
     void NextGF(bool wasNWF);
-    /// Checks if its time for autosaving (if enabled) and does it
+    /// Checks if its time for autosaving (if enabled) and starts it in the background
     void HandleAutosave();
+    /// Report the result of a finished background save (if any). Waits for it if requested
+    void CheckBackgroundSave(bool wait);
 
     //  Netzwerknachrichten
     RTTR_IGNORE_OVERLOADED_VIRTUAL
@@ -254,6 +262,7 @@ private:
     bool OnGameMessage(const GameMessage_RemoveLua& msg) override;
 
     bool OnGameMessage(const GameMessage_GetAsyncLog& msg) override;
+    bool OnGameMessage(const GameMessage_GetWorldDigest& msg) override;
     RTTR_POP_DIAGNOSTIC
 
     /// Report the error and stop
@@ -274,6 +283,8 @@ private:
     /// Schreibt den Header der Replaydatei
     void StartReplayRecording(unsigned random_init);
     void WritePlayerInfo(SavedFile& file);
+    /// Create a savegame containing a snapshot of the current game
+    std::unique_ptr<Savegame> CreateSavegame();
 
 public:
     /// Virtuelle Werte der Einstellungsfenster, die aber noch nicht wirksam sind, nur um die Verzögerungen zu
@@ -319,12 +330,23 @@ private:
     /// GameCommands, die vom Client noch an den Server gesendet werden müssen
     std::vector<gc::GameCommandPtr> gameCommands_;
 
+    struct WorldDigestSnapshot
+    {
+        unsigned digest;
+        std::vector<unsigned> regionHashes;
+    };
+    /// Region hashes of the world digest of the last NWFs, so the server can locate an async in the world
+    boost::circular_buffer<WorldDigestSnapshot> worldDigestSnapshots_;
+
     unsigned char chapterCompleted = 0;
     bool campaignCompleted = false;
 
     std::unique_ptr<ReplayInfo> replayinfo;
     bool replayMode;
 
+    /// Writes the autosaves
+    std::unique_ptr<BackgroundSaver> backgroundSaver;
+
     /// Configured players for an AI battle.
     std::vector<AI::Info> aiBattlePlayers_;
 };
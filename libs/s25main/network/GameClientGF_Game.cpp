@@ -8,6 +8,7 @@
 #include "NWFInfo.h"
 #include "ReplayInfo.h"
 #include "ai/AIPlayer.h"
+#include "world/GameWorld.h"
 #include "network/GameClient.h"
 
 void GameClient::ExecuteNWF()
@@ -16,6 +17,9 @@ void GameClient::ExecuteNWF()
 
     AsyncChecksum checksum = AsyncChecksum::create(*game);
     const unsigned curGF = GetGFNumber();
+    // Keep the region hashes the checksum was created from
+    worldDigestSnapshots_.push_back(
+      WorldDigestSnapshot{checksum.worldDigest, game->world_.GetDigest().GetRegionHashes()});
 
     for(const NWFPlayerInfo& player : nwfInfo->getPlayerInfos())
     {
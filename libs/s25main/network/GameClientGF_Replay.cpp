@@ -20,6 +20,17 @@ void GameClient::ExecuteGameFrame_Replay()
 
     bool cmdsExecuted = false;
     auto& replay = replayinfo->replay;
+    // Take keyframes before executing the commands of this GF so the replay can be continued from there
+    if(replayinfo->keyframes.IsKeyframeDue(curGF))
+    {
+        try
+        {
+            replayinfo->keyframes.Add(*game, replay.GetReadPosition(), replayinfo->next_gf);
+        } catch(const std::exception& e)
+        {
+            LOG.write(_("Could not create replay keyframe at GF %1%: %2%\n")) % curGF % e.what();
+        }
+    }
     // Execute all commands from the replay for the current GF
     while(replayinfo->next_gf && replayinfo->next_gf == curGF)
     {
@@ -59,6 +59,8 @@ Message* GameMessage::create_game(unsigned short id)
         case NMS_REMOVE_LUA: msg = new GameMessage_RemoveLua(); break;
         case NMS_GET_ASYNC_LOG: msg = new GameMessage_GetAsyncLog(); break;
         case NMS_ASYNC_LOG: msg = new GameMessage_AsyncLog(); break;
+        case NMS_GET_WORLD_DIGEST: msg = new GameMessage_GetWorldDigest(); break;
+        case NMS_WORLD_DIGEST: msg = new GameMessage_WorldDigest(); break;
     }
 
     return msg;
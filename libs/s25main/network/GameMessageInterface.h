@@ -56,5 +56,6 @@ GENERATE_GAME_MESSAGE_INTERFACE(GameMessage_Ping, GameMessage_Pong,
                                 GameMessage_RemoveLua, GameMessage_Pause, GameMessage_SkipToGF,
                                 GameMessage_Server_NWFDone, GameMessage_GameCommand, GameMessage_Speed,
 
-                                GameMessage_GetAsyncLog, GameMessage_AsyncLog)
+                                GameMessage_GetAsyncLog, GameMessage_AsyncLog, GameMessage_GetWorldDigest,
+                                GameMessage_WorldDigest)
 RTTR_POP_DIAGNOSTIC
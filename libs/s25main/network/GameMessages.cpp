@@ -74,3 +74,21 @@ void GameMessage_Server_TypeOK::Deserialize(Serializer& ser)
     err_code = helpers::popEnum<StatusCode>(ser);
     version = ser.PopString();
 }
+
+void GameMessage_WorldDigest::Serialize(Serializer& ser) const
+{
+    GameMessage::Serialize(ser);
+    ser.PushUnsignedInt(firstRegion);
+    ser.PushUnsignedInt(numRegions);
+    ser.PushUnsignedInt(regionsPerRow);
+    helpers::pushContainer(ser, partHashes);
+}
+
+void GameMessage_WorldDigest::Deserialize(Serializer& ser)
+{
+    GameMessage::Deserialize(ser);
+    firstRegion = ser.PopUnsignedInt();
+    numRegions = ser.PopUnsignedInt();
+    regionsPerRow = ser.PopUnsignedInt();
+    helpers::popContainer(ser, partHashes);
+}
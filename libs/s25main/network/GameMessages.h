@@ -1060,3 +1060,73 @@ public:
         return callback->OnGameMessage(*this);
     }
 };
+
+/// Request of the hashes of a range of world regions (see WorldDigest) split into parts
+class GameMessage_GetWorldDigest : public GameMessage
+{
+public:
+    /// World digest of the NWF the hashes are requested for
+    uint32_t digest;
+    uint32_t firstRegion, numRegions, numParts;
+
+    GameMessage_GetWorldDigest() : GameMessage(NMS_GET_WORLD_DIGEST) {} //-V730
+    GameMessage_GetWorldDigest(uint32_t digest, uint32_t firstRegion, uint32_t numRegions, uint32_t numParts)
+        : GameMessage(NMS_GET_WORLD_DIGEST), digest(digest), firstRegion(firstRegion), numRegions(numRegions),
+          numParts(numParts)
+    {
+        LOG.writeToFile(">>> NMS_GET_WORLD_DIGEST(%u, %u, %u)\n") % firstRegion % numRegions % numParts;
+    }
+
+    void Serialize(Serializer& ser) const override
+    {
+        GameMessage::Serialize(ser);
+        ser.PushUnsignedInt(digest);
+        ser.PushUnsignedInt(firstRegion);
+        ser.PushUnsignedInt(numRegions);
+        ser.PushUnsignedInt(numParts);
+    }
+
+    void Deserialize(Serializer& ser) override
+    {
+        GameMessage::Deserialize(ser);
+        digest = ser.PopUnsignedInt();
+        firstRegion = ser.PopUnsignedInt();
+        numRegions = ser.PopUnsignedInt();
+        numParts = ser.PopUnsignedInt();
+    }
+
+    bool Run(GameMessageInterface* callback) const override
+    {
+        LOG.writeToFile("<<< NMS_GET_WORLD_DIGEST(%u, %u, %u)\n") % firstRegion % numRegions % numParts;
+        return callback->OnGameMessage(*this);
+    }
+};
+
+/// Answer to GameMessage_GetWorldDigest. The hashes are empty if the requested digest is unknown
+class GameMessage_WorldDigest : public GameMessage
+{
+public:
+    uint32_t firstRegion, numRegions;
+    /// Regions per row of the map, to get the position of a region
+    uint32_t regionsPerRow;
+    std::vector<unsigned> partHashes;
+
+    GameMessage_WorldDigest() : GameMessage(NMS_WORLD_DIGEST) {} //-V730
+    GameMessage_WorldDigest(uint32_t firstRegion, uint32_t numRegions, uint32_t regionsPerRow,
+                            std::vector<unsigned> partHashes)
+        : GameMessage(NMS_WORLD_DIGEST), firstRegion(firstRegion), numRegions(numRegions),
+          regionsPerRow(regionsPerRow), partHashes(std::move(partHashes))
+    {
+        LOG.writeToFile(">>> NMS_WORLD_DIGEST(%u, %u, %u)\n") % firstRegion % numRegions % this->partHashes.size();
+    }
+
+    void Serialize(Serializer& ser) const override;
+
+    void Deserialize(Serializer& ser) override;
+
+    bool Run(GameMessageInterface* callback) const override
+    {
+        LOG.writeToFile("<<< NMS_WORLD_DIGEST(%u, %u, %u)\n") % firstRegion % numRegions % partHashes.size();
+        return callback->OnGameMessage(*this);
+    }
+};
@@ -55,7 +55,9 @@ enum
     NMS_REMOVE_LUA,
 
     NMS_GET_ASYNC_LOG = 0x0600,
-    NMS_ASYNC_LOG
+    NMS_ASYNC_LOG,
+    NMS_GET_WORLD_DIGEST, // 4 digest, 4 firstRegion, 4 numRegions, 4 numParts
+    NMS_WORLD_DIGEST      // 4 firstRegion, 4 numRegions, x partHashes
 };
 
 /* Hinweise:
@@ -20,7 +20,9 @@
 #include "helpers/random.h"
 #include "network/CreateServerInfo.h"
 #include "network/GameMessages.h"
+#include "network/WorldDigestBisection.h"
 #include "random/randomIO.h"
+#include "world/WorldDigest.h"
 #include "gameTypes/LanGameInfo.h"
 #include "gameTypes/TeamTypes.h"
 #include "gameData/GameConsts.h"
@@ -413,6 +415,7 @@ void GameServer::Stop()
 
     // clear async logs
     asyncLogs.clear();
+    worldDigestBisection.reset();
 
     lanAnnouncer.Stop();
 
@@ -630,6 +633,9 @@ void GameServer::KickPlayer(uint8_t playerId, KickReason cause, uint32_t param)
     GameServerPlayer* player = GetNetworkPlayer(playerId);
     if(player)
         player->closeConnection();
+    // The player can't answer the running request for the world digest anymore
+    if(worldDigestBisection && worldDigestBisection->RemovePlayer(playerId))
+        CheckWorldDigestAnswers();
     // Non-existing or connecting player
     if(!playerInfo.isUsed())
         return;
@@ -742,11 +748,16 @@ void GameServer::ExecuteNWF()
             checksumHashes.push_back(nwfInfo.getPlayerCmds(player.playerId).checksum.getHash());
         SendToAll(GameMessage_Server_Async(checksumHashes));
 
-        // Request async logs
-        for(GameServerPlayer& player : networkPlayers)
+        if(HasWorldDigestAsync())
+            StartWorldDigestBisection();
+        else
         {
-            asyncLogs.push_back(AsyncLog(player.playerId, nwfInfo.getPlayerCmds(player.playerId).checksum));
-            player.sendMsgAsync(new GameMessage_GetAsyncLog());
+            // Request async logs
+            for(GameServerPlayer& player : networkPlayers)
+            {
+                asyncLogs.push_back(AsyncLog(player.playerId, nwfInfo.getPlayerCmds(player.playerId).checksum));
+                player.sendMsgAsync(new GameMessage_GetAsyncLog());
+            }
         }
     }
     const NWFServerInfo serverInfo = nwfInfo.getServerInfo();
@@ -796,6 +807,120 @@ bool GameServer::CheckForAsync()
     return isAsync;
 }
 
+bool GameServer::HasWorldDigestAsync() const
+{
+    const unsigned refDigest = nwfInfo.getPlayerCmds(networkPlayers.front().playerId).checksum.worldDigest;
+    if(refDigest == 0)
+        return false;
+    for(const GameServerPlayer& player : networkPlayers)
+    {
+        const unsigned curDigest = nwfInfo.getPlayerCmds(player.playerId).checksum.worldDigest;
+        if(curDigest != 0 && curDigest != refDigest)
+            return true;
+    }
+    return false;
+}
+
+void GameServer::StartWorldDigestBisection()
+{
+    RTTR_Assert(!networkPlayers.empty());
+    uint8_t refPlayerId = networkPlayers.front().playerId;
+    for(const GameServerPlayer& player : networkPlayers)
+    {
+        if(playerInfos[player.playerId].isHost)
+            refPlayerId = player.playerId;
+    }
+    worldDigestBisection = std::make_unique<WorldDigestBisection>(refPlayerId);
+    for(const GameServerPlayer& player : networkPlayers)
+        worldDigestBisection->AddPlayer(player.playerId, nwfInfo.getPlayerCmds(player.playerId).checksum);
+    LOG.write(_("World digests differ. Locating the async in the world...\n"));
+    RequestNextWorldDigestRange();
+}
+
+void GameServer::RequestNextWorldDigestRange()
+{
+    if(worldDigestBisection->IsFinished())
+    {
+        FinishWorldDigestBisection();
+        return;
+    }
+    for(const WorldDigestBisection::Request& request : worldDigestBisection->RequestNextRange())
+    {
+        GameServerPlayer* player = GetNetworkPlayer(request.playerId);
+        if(player && player->socket.isValid())
+        {
+            player->sendMsgAsync(new GameMessage_GetWorldDigest(request.digest, request.firstRegion,
+                                                                request.numRegions, request.numParts));
+        } else
+            worldDigestBisection->RemovePlayer(request.playerId);
+    }
+    // Don't wait if none of the players is left
+    CheckWorldDigestAnswers();
+}
+
+bool GameServer::OnGameMessage(const GameMessage_WorldDigest& msg)
+{
+    if(state != ServerState::Game)
+    {
+        KickPlayer(msg.senderPlayerID, KickReason::InvalidMsg, __LINE__);
+        return true;
+    }
+    if(!worldDigestBisection
+       || !worldDigestBisection->AddAnswer(msg.senderPlayerID, msg.firstRegion, msg.numRegions, msg.regionsPerRow,
+                                           msg.partHashes))
+    {
+        LOG.write(_("Received world digest from %1%, but did not expect it!\n")) % unsigned(msg.senderPlayerID);
+        return true;
+    }
+    CheckWorldDigestAnswers();
+    return true;
+}
+
+void GameServer::CheckWorldDigestAnswers()
+{
+    // Wait for all players which are still connected
+    if(!worldDigestBisection->HasAllAnswers())
+        return;
+    if(!worldDigestBisection->EvaluateAnswers())
+    {
+        LOG.write(_("Could not locate the async in the world: Reference world digest not available\n"));
+        FinishWorldDigestBisection();
+        return;
+    }
+    RequestNextWorldDigestRange();
+}
+
+void GameServer::FinishWorldDigestBisection()
+{
+    const WorldDigestBisection& bisection = *worldDigestBisection;
+    const unsigned regionSize = WorldDigest::regionSize;
+    for(const unsigned region : bisection.GetAsyncRegions())
+    {
+        const unsigned x = region % bisection.GetRegionsPerRow() * regionSize;
+        const unsigned y = region / bisection.GetRegionsPerRow() * regionSize;
+        LOG.write(_("Async in world region %1%: Nodes (%2%, %3%) to (%4%, %5%)\n")) % region % x % y
+          % (x + regionSize - 1) % (y + regionSize - 1);
+    }
+    if(bisection.HasPendingRanges())
+        LOG.write(_("More regions may differ, stopped after %1% regions\n")) % bisection.GetAsyncRegions().size();
+
+    // Kick all players that have a different checksum from the host
+    AsyncChecksum refChecksum;
+    for(const WorldDigestBisection::Player& player : bisection.GetPlayers())
+    {
+        if(player.playerId == bisection.GetRefPlayerId())
+            refChecksum = player.checksum;
+    }
+    // Copy as kicking may clear the bisection
+    const std::vector<WorldDigestBisection::Player> players = bisection.GetPlayers();
+    worldDigestBisection.reset();
+    for(const WorldDigestBisection::Player& player : players)
+    {
+        if(player.checksum != refChecksum)
+            KickPlayer(player.playerId, KickReason::Async, __LINE__);
+    }
+}
+
 void GameServer::CheckAndKickLaggingPlayers()
 {
     for(const GameServerPlayer& player : networkPlayers)
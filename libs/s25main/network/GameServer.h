@@ -17,6 +17,7 @@
 #include "s25util/LANDiscoveryService.h"
 #include "s25util/Singleton.h"
 #include <chrono>
+#include <memory>
 #include <vector>
 
 struct CreateServerInfo;
@@ -24,6 +25,7 @@ class GameMessage;
 class GameMessageWithPlayer;
 class GameMessage_GameCommand;
 class GameServerPlayer;
+class WorldDigestBisection;
 struct AIServerPlayer;
 
 class GameServer :
@@ -101,6 +103,7 @@ private:
     bool OnGameMessage(const GameMessage_GameCommand& msg) override;
     bool OnGameMessage(const GameMessage_Speed& msg) override;
     bool OnGameMessage(const GameMessage_AsyncLog& msg) override;
+    bool OnGameMessage(const GameMessage_WorldDigest& msg) override;
     bool OnGameMessage(const GameMessage_RemoveLua& msg) override;
     bool OnGameMessage(const GameMessage_Countdown& msg) override;
     bool OnGameMessage(const GameMessage_CancelCountdown& msg) override;
@@ -124,6 +127,14 @@ private:
     bool CheckForAsync();
     boost::filesystem::path SaveAsyncLog();
     void SendAsyncLog(const boost::filesystem::path& asyncLogFilePath);
+    /// Return true if the world digests of the players differ, so the async can be located in the world
+    bool HasWorldDigestAsync() const;
+    /// Locate the world regions that differ between the players by bisecting the world digests
+    void StartWorldDigestBisection();
+    void RequestNextWorldDigestRange();
+    /// Continue with the next range when all connected players answered the current one
+    void CheckWorldDigestAnswers();
+    void FinishWorldDigestBisection();
 
     void CheckAndKickLaggingPlayers();
     bool CheckForLaggingPlayers();
@@ -188,6 +199,8 @@ private:
     struct AsyncLog;
     /// AsyncLogs of all players
     std::vector<AsyncLog> asyncLogs;
+    /// Running bisection of the world digests, if any
+    std::unique_ptr<WorldDigestBisection> worldDigestBisection;
     /// Time at which the loading started
     std::chrono::steady_clock::time_point loadStartTime;
 
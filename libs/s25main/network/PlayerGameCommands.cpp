@@ -16,7 +16,8 @@ void PlayerGameCommands::Serialize(Serializer& ser) const
 
 void PlayerGameCommands::Deserialize(gc::Deserializer& ser)
 {
-    checksum.Deserialize(ser);
+    // The world digest was added in version 1
+    checksum.Deserialize(ser, ser.getDataVersion() >= 1);
 
     gcs.resize(ser.PopUnsignedInt());
     for(gc::GameCommandPtr& gc : gcs)
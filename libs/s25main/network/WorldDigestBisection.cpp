@@ -0,0 +1,131 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "WorldDigestBisection.h"
+#include "RTTR_Assert.h"
+#include "helpers/containerUtils.h"
+#include "world/WorldDigest.h"
+#include <algorithm>
+
+WorldDigestBisection::WorldDigestBisection(const uint8_t refPlayerId)
+    : refPlayerId_(refPlayerId), curRange_{0, 0}, regionsPerRow_(0)
+{
+    pendingRanges_.push_back(Range{0, 0});
+}
+
+void WorldDigestBisection::AddPlayer(const uint8_t playerId, const AsyncChecksum& checksum)
+{
+    Player player;
+    player.playerId = playerId;
+    player.checksum = checksum;
+    players_.push_back(player);
+}
+
+bool WorldDigestBisection::RemovePlayer(const uint8_t playerId)
+{
+    const auto itPlayer = FindPlayer(playerId);
+    if(itPlayer == players_.end() || !itPlayer->isConnected)
+        return false;
+    itPlayer->isConnected = false;
+    return !itPlayer->answered;
+}
+
+bool WorldDigestBisection::IsFinished() const
+{
+    return pendingRanges_.empty() || asyncRegions_.size() >= maxAsyncRegions;
+}
+
+std::vector<WorldDigestBisection::Request> WorldDigestBisection::RequestNextRange()
+{
+    RTTR_Assert(!IsFinished());
+    curRange_ = pendingRanges_.front();
+    pendingRanges_.pop_front();
+    const unsigned numParts = curRange_.numRegions == 0 ? maxParts : std::min(curRange_.numRegions, maxParts);
+    std::vector<Request> requests;
+    for(Player& player : players_)
+    {
+        player.answered = false;
+        player.partHashes.clear();
+        if(player.isConnected)
+        {
+            requests.push_back(Request{player.playerId, player.checksum.worldDigest, curRange_.firstRegion,
+                                       curRange_.numRegions, numParts});
+        }
+    }
+    return requests;
+}
+
+bool WorldDigestBisection::AddAnswer(const uint8_t playerId, const unsigned firstRegion, const unsigned numRegions,
+                                     const unsigned regionsPerRow, const std::vector<unsigned>& partHashes)
+{
+    const auto itPlayer = FindPlayer(playerId);
+    if(itPlayer == players_.end() || !itPlayer->isConnected || itPlayer->answered)
+        return false;
+    itPlayer->answered = true;
+    itPlayer->partHashes = partHashes;
+    if(playerId == refPlayerId_)
+    {
+        // Resolve the range of the initial request for the whole world
+        curRange_ = Range{firstRegion, numRegions};
+        regionsPerRow_ = regionsPerRow;
+    }
+    return true;
+}
+
+bool WorldDigestBisection::HasAllAnswers() const
+{
+    return !helpers::contains_if(players_,
+                                 [](const Player& player) { return player.isConnected && !player.answered; });
+}
+
+bool WorldDigestBisection::EvaluateAnswers()
+{
+    RTTR_Assert(HasAllAnswers());
+    const auto itRef = FindPlayer(refPlayerId_);
+    if(itRef == players_.end() || itRef->partHashes.empty())
+        return false;
+    const std::vector<unsigned>& refHashes = itRef->partHashes;
+    const auto numParts = static_cast<unsigned>(refHashes.size());
+    const Range& range = curRange_;
+    for(unsigned i = 0; i < numParts; i++)
+    {
+        bool isAsync = false;
+        for(const Player& player : players_)
+        {
+            // Players without matching answer (e.g. disconnected or world digest not available) are ignored
+            if(player.partHashes.size() == numParts && player.partHashes[i] != refHashes[i])
+                isAsync = true;
+        }
+        if(!isAsync)
+            continue;
+        const unsigned partStart = WorldDigest::GetPartStart(range.firstRegion, range.numRegions, numParts, i);
+        const unsigned partEnd = WorldDigest::GetPartStart(range.firstRegion, range.numRegions, numParts, i + 1);
+        if(partEnd - partStart == 1)
+            asyncRegions_.push_back(partStart);
+        else
+            pendingRanges_.push_back(Range{partStart, partEnd - partStart});
+    }
+    return true;
+}
+
+std::vector<WorldDigestBisection::Player>::iterator WorldDigestBisection::FindPlayer(const uint8_t playerId)
+{
+    return helpers::find_if(players_, [playerId](const Player& player) { return player.playerId == playerId; });
+}
+
+std::vector<unsigned> WorldDigestBisection::GetPartHashes(const std::vector<unsigned>& regionHashes,
+                                                          const unsigned firstRegion, const unsigned numRegions,
+                                                          const unsigned numParts)
+{
+    std::vector<unsigned> partHashes;
+    if(numParts == 0 || numParts > numRegions || firstRegion + numRegions > regionHashes.size())
+        return partHashes;
+    for(unsigned i = 0; i < numParts; i++)
+    {
+        const unsigned partStart = WorldDigest::GetPartStart(firstRegion, numRegions, numParts, i);
+        const unsigned partEnd = WorldDigest::GetPartStart(firstRegion, numRegions, numParts, i + 1);
+        partHashes.push_back(WorldDigest::CombineHashes(regionHashes, partStart, partEnd - partStart));
+    }
+    return partHashes;
+}
@@ -0,0 +1,91 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "AsyncChecksum.h"
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+/// Locates the world regions (see WorldDigest) that differ between the players after an async.
+/// The hashes of a range of regions are requested from all players split into parts and each differing part is split
+/// further until single regions remain. Network independent, the server sends the requests and passes the answers.
+class WorldDigestBisection
+{
+public:
+    /// Maximum number of parts a range of regions is split into per request
+    static constexpr unsigned maxParts = 16;
+    /// Stop after finding this many differing regions
+    static constexpr unsigned maxAsyncRegions = 16;
+
+    struct Player
+    {
+        uint8_t playerId;
+        AsyncChecksum checksum;
+        /// False if the player can't answer anymore (e.g. disconnected)
+        bool isConnected = true;
+        bool answered = false;
+        std::vector<unsigned> partHashes;
+    };
+    /// Hashes of the parts of a range of regions requested from a player
+    struct Request
+    {
+        uint8_t playerId;
+        /// World digest the player sent with the async NWF
+        unsigned digest;
+        /// numRegions == 0 means all regions
+        unsigned firstRegion, numRegions, numParts;
+    };
+
+    /// The hashes of the reference player are compared with all others. It should be added by AddPlayer
+    explicit WorldDigestBisection(uint8_t refPlayerId);
+
+    void AddPlayer(uint8_t playerId, const AsyncChecksum& checksum);
+    /// The player can't answer anymore. Return true if the current request was waiting for it
+    bool RemovePlayer(uint8_t playerId);
+
+    /// Return true if there are no ranges left to check or the maximum number of differing regions was found
+    bool IsFinished() const;
+    /// Start checking the next range. Return the requests to send to the connected players
+    std::vector<Request> RequestNextRange();
+    /// Store the answer of a player to the current request. Return false if none was expected from that player
+    bool AddAnswer(uint8_t playerId, unsigned firstRegion, unsigned numRegions, unsigned regionsPerRow,
+                   const std::vector<unsigned>& partHashes);
+    /// Return true if all connected players answered the current request
+    bool HasAllAnswers() const;
+    /// Compare the answers to the current request and queue the differing parts.
+    /// Return false if the reference player didn't send its hashes, so the bisection can't continue
+    bool EvaluateAnswers();
+
+    /// Regions found so far which differ between the players
+    const std::vector<unsigned>& GetAsyncRegions() const { return asyncRegions_; }
+    /// Regions per row of the map, to get the position of a region. Known after the first answer of the reference
+    unsigned GetRegionsPerRow() const { return regionsPerRow_; }
+    bool HasPendingRanges() const { return !pendingRanges_.empty(); }
+    uint8_t GetRefPlayerId() const { return refPlayerId_; }
+    const std::vector<Player>& GetPlayers() const { return players_; }
+
+    /// Hashes of the parts of the range of regions as answered to a request. Empty if the range is invalid
+    static std::vector<unsigned> GetPartHashes(const std::vector<unsigned>& regionHashes, unsigned firstRegion,
+                                               unsigned numRegions, unsigned numParts);
+
+private:
+    struct Range
+    {
+        /// numRegions == 0 means all regions
+        unsigned firstRegion, numRegions;
+    };
+
+    std::vector<Player>::iterator FindPlayer(uint8_t playerId);
+
+    uint8_t refPlayerId_;
+    std::vector<Player> players_;
+    /// Ranges of regions which need to be checked
+    std::deque<Range> pendingRanges_;
+    /// Range which is currently requested
+    Range curRange_;
+    unsigned regionsPerRow_;
+    std::vector<unsigned> asyncRegions_;
+};
@@ -76,6 +76,7 @@ void noFlag::Destroy()
     // Waren vernichten
     for(auto& ware : wares)
     {
+        world->ToggleWareAtFlag(pos, *ware);
         // Inventur entsprechend verringern
         ware->WareLost(player);
         ware->Destroy();
@@ -138,6 +139,7 @@ void noFlag::AddWare(std::unique_ptr<Ware> ware)
 {
     // First add ware, then tell carrier. So get the info from the ware first
     const RoadPathDirection nextDir = ware->GetNextDir();
+    world->ToggleWareAtFlag(pos, *ware);
     wares.push_back(std::move(ware));
 
     if(nextDir != RoadPathDirection::None)
@@ -179,6 +181,7 @@ std::unique_ptr<Ware> noFlag::SelectWare(const Direction roadDir, const bool swa
     {
         bestWare = std::move(wares[best_ware_index]);
         wares.erase(wares.begin() + best_ware_index);
+        world->ToggleWareAtFlag(pos, *bestWare);
     }
 
     // ggf. anderen Trägern Bescheid sagen, aber nicht dem, der die Ware aufgehoben hat!
@@ -288,6 +291,7 @@ void noFlag::Capture(const unsigned char new_owner)
     // Waren vernichten
     for(auto& ware : wares)
     {
+        world->ToggleWareAtFlag(pos, *ware);
         ware->WareLost(player);
         ware->Destroy();
     }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "noRoadNode.h"
+#include "helpers/PtrSpan.h"
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/MapTypes.h"
 #include <boost/container/static_vector.hpp>
@@ -41,6 +42,7 @@ public:
     void AddWare(std::unique_ptr<Ware> ware) override;
     /// Gibt die Anzahl der Waren zurück, die an der Flagge liegen.
     unsigned GetNumWares() const { return wares.size(); }
+    auto GetWares() const { return helpers::nonNullPtrSpan(wares); }
     /// Wählt eine Ware von einer Flagge aus (anhand der Transportreihenfolge), entfernt sie von der Flagge und gibt sie
     /// zurück.
     std::unique_ptr<Ware> SelectWare(Direction roadDir, bool swap_wares, const noFigure* carrier);
@@ -44,7 +44,7 @@ void noMovable::Walk()
     moving = false;
     const MapPoint oldPos = pos;
     pos = world->GetNeighbour(pos, curMoveDir);
-    world->AddFigure(pos, world->RemoveFigure(oldPos, *this));
+    world->MoveFigure(oldPos, pos, *this);
 }
 
 void noMovable::FaceDir(Direction newDir)
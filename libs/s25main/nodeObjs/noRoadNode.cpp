@@ -16,6 +16,8 @@ noRoadNode::noRoadNode(const NodalObjectType nop, const MapPoint pos, const unsi
     for(const auto dir : helpers::EnumRange<Direction>{})
         routes[dir] = nullptr;
     last_visit = 0;
+    componentVisit = 0;
+    distanceVisit = 0;
 }
 
 noRoadNode::~noRoadNode() = default;
@@ -61,6 +63,14 @@ noRoadNode::noRoadNode(SerializedGameData& sgd, const unsigned obj_id)
     }
 
     last_visit = 0;
+    componentVisit = 0;
+    distanceVisit = 0;
+}
+
+void noRoadNode::SetRoute(const Direction dir, RoadSegment* route)
+{
+    routes[dir] = route;
+    world->RoadGraphChanged();
 }
 
 void noRoadNode::UpgradeRoad(const Direction dir) const
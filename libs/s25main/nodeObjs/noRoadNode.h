@@ -34,6 +34,14 @@ public:
     mutable const noRoadNode* prev; //-V730_NOINIT
     /// Direction to previous node, includes SHIP_DIR
     mutable RoadPathDirection dir_; //-V730_NOINIT
+    /// Connected component of the road network for wares and the search it belongs to (see RoadPathFinder)
+    mutable unsigned component; //-V730_NOINIT
+    mutable unsigned componentVisit;
+    /// Costs of the ware distance search and the search they belong to (see RoadPathFinder)
+    mutable unsigned distanceCost; //-V730_NOINIT
+    mutable unsigned distanceVisit;
+    /// Index in the candidates of the nearest warehouse search or noWarehouseIdx (see RoadPathFinder)
+    mutable unsigned warehouseIdx; //-V730_NOINIT
 
     noRoadNode(NodalObjectType nop, MapPoint pos, unsigned char player);
     noRoadNode(SerializedGameData& sgd, unsigned obj_id);
@@ -43,7 +51,7 @@ public:
     void Serialize(SerializedGameData& sgd) const override;
 
     RoadSegment* GetRoute(const Direction dir) const { return routes[dir]; }
-    void SetRoute(const Direction dir, RoadSegment* route) { routes[dir] = route; }
+    void SetRoute(Direction dir, RoadSegment* route);
     const auto& getRoutes() const { return routes; }
     noRoadNode* GetNeighbour(Direction dir) const;
 
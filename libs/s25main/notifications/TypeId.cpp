@@ -4,4 +4,4 @@
 
 #include "TypeId.h"
 
-uint32_t TypeId::counter = 0;
+std::atomic<uint32_t> TypeId::counter{0};
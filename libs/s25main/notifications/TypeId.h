@@ -4,13 +4,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 
 /** Class for getting a unique Id per type: TypeId::value<int>()
-    Note: NOT constant over different program version and NOT thread safe */
+    Note: NOT constant over different program version */
 class TypeId
 {
-    static uint32_t counter;
+    static std::atomic<uint32_t> counter;
 
 public:
     template<typename T>
@@ -0,0 +1,151 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "TextureAtlasCache.h"
+#include "libsiedler2/ColorBGRA.h"
+#include "s25util/BinaryFile.h"
+#include <boost/filesystem/operations.hpp>
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+namespace bfs = boost::filesystem;
+
+namespace {
+constexpr std::array<char, 8> signature = {'R', 'T', 'T', 'R', 'T', 'A', 'C', '\0'};
+/// Bigger textures are not supported by any card, so the file must be corrupt
+constexpr unsigned maxAtlasSize = 1u << 15;
+
+unsigned getNumBytes(const TextureAtlas& atlas)
+{
+    return atlas.getSize().x * atlas.getSize().y * sizeof(libsiedler2::ColorBGRA);
+}
+} // namespace
+
+void TextureAtlasCache::KeyBuilder::add(const void* data, const size_t size)
+{
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for(size_t i = 0; i < size; ++i)
+    {
+        hash_ ^= bytes[i];
+        hash_ *= 1099511628211u;
+    }
+}
+
+void TextureAtlasCache::KeyBuilder::addFileInfo(const bfs::path& path)
+{
+    add(path.string());
+    boost::system::error_code ec;
+    if(bfs::is_directory(path, ec))
+    {
+        std::vector<bfs::path> entries;
+        for(bfs::directory_iterator it(path, ec), end; !ec && it != end; it.increment(ec))
+            entries.push_back(it->path());
+        // Iteration order is unspecified
+        std::sort(entries.begin(), entries.end());
+        for(const bfs::path& entry : entries)
+            addFileInfo(entry);
+    } else
+    {
+        const auto size = bfs::file_size(path, ec);
+        add(ec ? 0u : static_cast<uint64_t>(size));
+        const auto time = bfs::last_write_time(path, ec);
+        add(ec ? 0 : static_cast<int64_t>(time));
+    }
+}
+
+TextureAtlasCache::TextureAtlasCache(bfs::path filepath, const uint64_t key) : filepath_(std::move(filepath)), key_(key)
+{}
+
+boost::optional<std::vector<TextureAtlas>> TextureAtlasCache::load(const unsigned numItems) const
+{
+    boost::system::error_code ec;
+    if(!bfs::exists(filepath_, ec))
+        return boost::none;
+
+    BinaryFile file;
+    if(!file.Open(filepath_, OpenFileMode::Read))
+        return boost::none;
+    try
+    {
+        std::array<char, signature.size()> readSignature;
+        file.ReadRawData(readSignature.data(), readSignature.size());
+        if(readSignature != signature || file.ReadUnsignedShort() != version)
+            return boost::none;
+        uint64_t readKey;
+        file.ReadRawData(&readKey, sizeof(readKey));
+        if(readKey != key_ || file.ReadUnsignedInt() != numItems)
+            return boost::none;
+
+        std::vector<TextureAtlas> atlases;
+        const unsigned numAtlases = file.ReadUnsignedInt();
+        // Each atlas contains at least 1 item
+        if(numAtlases > numItems)
+            return boost::none;
+        atlases.reserve(numAtlases);
+        for(unsigned i = 0; i < numAtlases; i++)
+        {
+            const unsigned width = file.ReadUnsignedInt();
+            const unsigned height = file.ReadUnsignedInt();
+            const unsigned numPlacements = file.ReadUnsignedInt();
+            if(width > maxAtlasSize || height > maxAtlasSize || numPlacements > numItems)
+                return boost::none;
+            std::vector<TextureAtlas::Placement> placements(numPlacements);
+            for(TextureAtlas::Placement& placement : placements)
+            {
+                placement.itemIdx = file.ReadUnsignedInt();
+                placement.pos.x = file.ReadUnsignedInt();
+                placement.pos.y = file.ReadUnsignedInt();
+            }
+            TextureAtlas atlas{std::move(placements), libsiedler2::PixelBufferBGRA(width, height)};
+            file.ReadRawData(atlas.pixels.getPixelPtr(), getNumBytes(atlas));
+            atlases.emplace_back(std::move(atlas));
+        }
+        return atlases;
+    } catch(const std::exception&)
+    {
+        // Truncated file
+        return boost::none;
+    }
+}
+
+bool TextureAtlasCache::save(const std::vector<TextureAtlas>& atlases, const unsigned numItems) const
+{
+    boost::system::error_code ec;
+    bfs::create_directories(filepath_.parent_path(), ec);
+    // Write to a temporary file first so an interrupted write can't leave a broken cache
+    const bfs::path tmpFilepath = bfs::path(filepath_).concat(".tmp");
+    try
+    {
+        BinaryFile file;
+        if(!file.Open(tmpFilepath, OpenFileMode::Write))
+            return false;
+        file.WriteRawData(signature.data(), signature.size());
+        file.WriteUnsignedShort(version);
+        file.WriteRawData(&key_, sizeof(key_));
+        file.WriteUnsignedInt(numItems);
+        file.WriteUnsignedInt(atlases.size());
+        for(const TextureAtlas& atlas : atlases)
+        {
+            file.WriteUnsignedInt(atlas.getSize().x);
+            file.WriteUnsignedInt(atlas.getSize().y);
+            file.WriteUnsignedInt(atlas.placements.size());
+            for(const TextureAtlas::Placement& placement : atlas.placements)
+            {
+                file.WriteUnsignedInt(placement.itemIdx);
+                file.WriteUnsignedInt(placement.pos.x);
+                file.WriteUnsignedInt(placement.pos.y);
+            }
+            file.WriteRawData(atlas.pixels.getPixelPtr(), getNumBytes(atlas));
+        }
+        file.Close();
+    } catch(const std::exception&)
+    {
+        bfs::remove(tmpFilepath, ec);
+        return false;
+    }
+    bfs::rename(tmpFilepath, filepath_, ec);
+    return !ec;
+}
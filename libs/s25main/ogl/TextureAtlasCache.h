@@ -0,0 +1,55 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "ogl/glTexturePacker.h"
+#include <boost/filesystem/path.hpp>
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/// Stores texture atlases in a file so they don't need to be created on every start.
+/// The key identifies the data the atlases were created from. A file with a different key is outdated and ignored
+class TextureAtlasCache
+{
+public:
+    /// Builds the key from the source data (FNV-1a hash)
+    class KeyBuilder
+    {
+        uint64_t hash_ = 14695981039346656037u;
+
+    public:
+        void add(const void* data, size_t size);
+        void add(const std::string& value) { add(value.data(), value.size()); }
+        template<typename T>
+        std::enable_if_t<std::is_integral_v<T>> add(T value)
+        {
+            add(&value, sizeof(value));
+        }
+        /// Add path, size and modification time of the file or of all files in the folder
+        void addFileInfo(const boost::filesystem::path& path);
+        uint64_t get() const { return hash_; }
+    };
+
+    /// Increase when the file format or the drawing of the bitmaps to the atlases changes
+    static constexpr uint16_t version = 1;
+
+    TextureAtlasCache(boost::filesystem::path filepath, uint64_t key);
+
+    /// Read the atlases containing the given number of bitmaps.
+    /// Return nothing if the file does not exist, is outdated or invalid
+    boost::optional<std::vector<TextureAtlas>> load(unsigned numItems) const;
+    /// Write the atlases containing the given number of bitmaps. Return false on failure
+    bool save(const std::vector<TextureAtlas>& atlases, unsigned numItems) const;
+
+    const boost::filesystem::path& getFilepath() const { return filepath_; }
+
+private:
+    boost::filesystem::path filepath_;
+    uint64_t key_;
+};
@@ -192,6 +192,27 @@ void glSmartBitmap::drawTo(libsiedler2::PixelBufferBGRA& buffer, const Extent& b
     }
 }
 
+void glSmartBitmap::setTexCoords(const Extent& pos, const Extent& textureSize)
+{
+    const PointF texSize(textureSize);
+    Extent size = getRequiredTexSize();
+    if(hasPlayer)
+        size.x /= 2;
+
+    texCoords[0] = pos / texSize;
+    texCoords[2] = (pos + size) / texSize;
+    texCoords[1] = {texCoords[0].x, texCoords[2].y};
+    texCoords[3] = {texCoords[2].x, texCoords[0].y};
+
+    if(hasPlayer)
+    {
+        texCoords[4] = texCoords[3];
+        texCoords[6] = (pos + getRequiredTexSize()) / texSize;
+        texCoords[5] = {texCoords[4].x, texCoords[6].y};
+        texCoords[7] = {texCoords[6].x, texCoords[4].y};
+    }
+}
+
 void glSmartBitmap::generateTexture()
 {
     if(items.empty())
@@ -56,6 +56,8 @@ public:
         sharedTexture = (tex != 0);
     }
     unsigned getTexture() const { return texture; }
+    /// Set the texture coordinates for the bitmap being drawn at pos on a (shared) texture of the given size
+    void setTexCoords(const Extent& pos, const Extent& textureSize);
 
     void generateTexture();
     void DrawFull(const Position& dstPos, unsigned color = 0xFFFFFFFF) override { draw(dstPos, color); }
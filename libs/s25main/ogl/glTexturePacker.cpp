@@ -11,28 +11,17 @@
 #include <glad/glad.h>
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <utility>
 
-static bool isSizeGreater(glSmartBitmap* a, glSmartBitmap* b)
+bool glTexturePacker::packHelper(std::vector<unsigned>& itemIndices, const SizeChecker& isSizeSupported)
 {
-    const Extent sizeA = a->getRequiredTexSize();
-    const Extent sizeB = b->getRequiredTexSize();
-    return (sizeA.x * sizeA.y) > (sizeB.x * sizeB.y);
-}
-
-bool glTexturePacker::packHelper(std::vector<glSmartBitmap*>& list)
-{
-    glTexture texture;
-
-    if(!texture)
-        return false;
-
     // find space needed in total and biggest texture to store (as a start)
     Extent maxBmpSize(0, 0);
     unsigned total = 0;
-    for(glSmartBitmap* bmp : list)
+    for(const unsigned itemIdx : itemIndices)
     {
-        Extent texSize = bmp->getRequiredTexSize();
+        Extent texSize = items[itemIdx]->getRequiredTexSize();
         maxBmpSize = elMax(maxBmpSize, texSize);
 
         total += texSize.x * texSize.y;
@@ -41,13 +30,13 @@ bool glTexturePacker::packHelper(std::vector<glSmartBitmap*>& list)
     // most cards work much better with texture sizes of powers of two.
     maxBmpSize = VIDEODRIVER.calcPreferredTextureSize(maxBmpSize);
 
-    if(!texture.checkSize(maxBmpSize))
+    if(!isSizeSupported(maxBmpSize))
         return false;
 
     // maximum texture size reached?
     bool maxTex = false;
     std::vector<glTexturePackerNode*> tmpVec;
-    tmpVec.reserve(list.size());
+    tmpVec.reserve(itemIndices.size());
 
     Extent curSize = maxBmpSize;
     do
@@ -59,76 +48,149 @@ bool glTexturePacker::packHelper(std::vector<glSmartBitmap*>& list)
             auto root = std::make_unique<glTexturePackerNode>(curSize);
 
             // list to store bitmaps we could not fit in our current texture
-            std::vector<glSmartBitmap*> left;
-
-            libsiedler2::PixelBufferBGRA buffer(curSize.x, curSize.y);
+            std::vector<unsigned> left;
+            std::vector<TextureAtlas::Placement> placements;
+            placements.reserve(itemIndices.size());
 
             // try storing bitmaps in the big texture
-            for(glSmartBitmap* bmp : list)
+            for(const unsigned itemIdx : itemIndices)
             {
-                if(!root->insert(bmp, buffer, tmpVec))
+                Extent pos;
+                if(!root->insert(items[itemIdx]->getRequiredTexSize(), pos, tmpVec))
                 {
                     // inserting this bitmap failed? just remember it for next texture
-                    left.push_back(bmp);
+                    left.push_back(itemIdx);
                 } else
-                {
-                    // tell or glSmartBitmap, that it uses a shared texture (so it won't try to delete/free it)
-                    bmp->setSharedTexture(texture.get());
-                }
-            }
-            if((false))
-            {
-                bfs::path outFilepath = std::to_string(texture.get()) + "-" + std::to_string(curSize.x) + "x"
-                                        + std::to_string(curSize.y) + ".bmp";
-                saveBitmap(buffer, outFilepath);
+                    placements.push_back(TextureAtlas::Placement{itemIdx, pos});
             }
             // free texture packer, as it is not needed any more
-            root->destroy(list.size());
+            root->destroy(itemIndices.size());
             root.reset();
 
-            if(!texture.uploadData(buffer))
-                return false;
-
-            if(left.empty()) // nothing left, just generate texture and return success
-            {
-                textures.emplace_back(std::move(texture));
-                return true;
-            } else if(maxTex) // maximum texture size reached and something still left
+            if(left.empty() || maxTex)
             {
-                textures.emplace_back(std::move(texture));
-                // recursively generate textures for what is left
-                return packHelper(left);
+                // Layout is final -> draw the bitmaps
+                TextureAtlas atlas{std::move(placements), libsiedler2::PixelBufferBGRA(curSize.x, curSize.y)};
+                for(const TextureAtlas::Placement& placement : atlas.placements)
+                    items[placement.itemIdx]->drawTo(atlas.pixels, placement.pos);
+                if((false))
+                {
+                    bfs::path outFilepath = std::to_string(atlases.size()) + "-" + std::to_string(curSize.x) + "x"
+                                            + std::to_string(curSize.y) + ".bmp";
+                    saveBitmap(atlas.pixels, outFilepath);
+                }
+                atlases.emplace_back(std::move(atlas));
+
+                if(left.empty()) // nothing left, done
+                    return true;
+                // maximum texture size reached and something still left
+                // -> recursively generate textures for what is left
+                return packHelper(left, isSizeSupported);
             }
 
             // our pre-estimated size if the big texture was not enough for the algorithm to fit all textures in
-            // delete buffer and try again with an increased big texture
-            left.clear();
+            // try again with an increased big texture
         }
 
         // increase width or height, try whether opengl is able to handle textures that big
         const auto newSize =
           (curSize.x <= curSize.y) ? Extent(curSize.x * 2, curSize.y) : Extent(curSize.x, curSize.y * 2);
-        if(!texture.checkSize(newSize))
+        if(!isSizeSupported(newSize))
             maxTex = true;
         else
             curSize = newSize;
     } while(true);
 }
 
+void glTexturePacker::applyTexCoords()
+{
+    for(const TextureAtlas& atlas : atlases)
+    {
+        for(const TextureAtlas::Placement& placement : atlas.placements)
+            items[placement.itemIdx]->setTexCoords(placement.pos, atlas.getSize());
+    }
+}
+
 bool glTexturePacker::pack()
 {
-    std::sort(items.begin(), items.end(), isSizeGreater);
+    return createAtlases() && upload();
+}
+
+bool glTexturePacker::createAtlases()
+{
+    const glTexture texture;
+    return createAtlases([&texture](const Extent& size) { return texture.checkSize(size); });
+}
 
-    if(packHelper(items))
-        return true;
+bool glTexturePacker::createAtlases(const SizeChecker& isSizeSupported)
+{
+    atlases.clear();
+
+    // Biggest first. Stable sorting so the same bitmaps always lead to the same layout
+    std::vector<unsigned> itemIndices(items.size());
+    std::iota(itemIndices.begin(), itemIndices.end(), 0u);
+    std::stable_sort(itemIndices.begin(), itemIndices.end(), [this](const unsigned lhs, const unsigned rhs) {
+        const Extent sizeLhs = items[lhs]->getRequiredTexSize();
+        const Extent sizeRhs = items[rhs]->getRequiredTexSize();
+        return (sizeLhs.x * sizeLhs.y) > (sizeRhs.x * sizeRhs.y);
+    });
+
+    if(!packHelper(itemIndices, isSizeSupported))
+    {
+        atlases.clear();
+        return false;
+    }
+    applyTexCoords();
+    return true;
+}
 
-    // reset glSmartBitmap textures
-    for(glSmartBitmap* bmp : items)
-        bmp->setSharedTexture(0);
+bool glTexturePacker::setAtlases(std::vector<TextureAtlas> newAtlases)
+{
+    atlases.clear();
 
-    textures.clear();
+    std::vector<bool> isPlaced(items.size(), false);
+    for(const TextureAtlas& atlas : newAtlases)
+    {
+        for(const TextureAtlas::Placement& placement : atlas.placements)
+        {
+            if(placement.itemIdx >= items.size() || isPlaced[placement.itemIdx])
+                return false;
+            const Extent itemEnd = placement.pos + items[placement.itemIdx]->getRequiredTexSize();
+            if(itemEnd.x > atlas.getSize().x || itemEnd.y > atlas.getSize().y)
+                return false;
+            isPlaced[placement.itemIdx] = true;
+        }
+    }
+    if(std::find(isPlaced.begin(), isPlaced.end(), false) != isPlaced.end())
+        return false;
+
+    atlases = std::move(newAtlases);
+    applyTexCoords();
+    return true;
+}
 
-    return false;
+bool glTexturePacker::upload()
+{
+    for(const TextureAtlas& atlas : atlases)
+    {
+        glTexture texture;
+        if(!texture.uploadData(atlas.pixels))
+        {
+            // reset glSmartBitmap textures
+            for(glSmartBitmap* bmp : items)
+                bmp->setSharedTexture(0);
+            textures.clear();
+            atlases.clear();
+            return false;
+        }
+        // tell or glSmartBitmap, that it uses a shared texture (so it won't try to delete/free it)
+        for(const TextureAtlas::Placement& placement : atlas.placements)
+            items[placement.itemIdx]->setSharedTexture(texture.get());
+        textures.emplace_back(std::move(texture));
+    }
+    // Data is on the GPU now
+    atlases.clear();
+    return true;
 }
 
 glTexture::glTexture() : handle(VIDEODRIVER.GenerateTexture()), size(0, 0)
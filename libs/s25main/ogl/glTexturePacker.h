@@ -5,13 +5,27 @@
 #pragma once
 
 #include "Point.h"
+#include "libsiedler2/PixelBufferBGRA.h"
+#include <functional>
 #include <vector>
 
 class glSmartBitmap;
 
-namespace libsiedler2 {
-class PixelBufferBGRA;
-}
+/// A texture containing multiple bitmaps. Created without OpenGL so it can be stored and uploaded later
+struct TextureAtlas
+{
+    struct Placement
+    {
+        /// Index of the bitmap in the order they were added to the packer
+        unsigned itemIdx;
+        /// Position of the bitmap on the texture
+        Extent pos;
+    };
+    std::vector<Placement> placements;
+    libsiedler2::PixelBufferBGRA pixels;
+
+    Extent getSize() const { return Extent(pixels.getWidth(), pixels.getHeight()); }
+};
 
 class glTexture
 {
@@ -35,16 +49,37 @@ public:
     bool uploadData(const libsiedler2::PixelBufferBGRA&);
 };
 
+/// Packs many bitmaps into few big textures (atlases) to avoid texture switches when drawing.
+/// Creating the atlases (layout and pixel data) is separate from uploading them, so they can be cached
 class glTexturePacker
 {
+public:
+    /// Return whether a texture of the given size can be used
+    using SizeChecker = std::function<bool(const Extent&)>;
+
 private:
     std::vector<glTexture> textures;
     std::vector<glSmartBitmap*> items;
+    std::vector<TextureAtlas> atlases;
 
-    bool packHelper(std::vector<glSmartBitmap*>& list);
+    bool packHelper(std::vector<unsigned>& itemIndices, const SizeChecker& isSizeSupported);
+    void applyTexCoords();
 
 public:
+    /// Create the atlases and upload them
     bool pack();
     void add(glSmartBitmap& bmp) { items.push_back(&bmp); }
+    unsigned getNumItems() const { return static_cast<unsigned>(items.size()); }
+
+    /// Create the atlases for the added bitmaps. Uses OpenGL to check the maximum texture size if none is given
+    bool createAtlases();
+    bool createAtlases(const SizeChecker& isSizeSupported);
+    /// Use the given (e.g. cached) atlases which must contain each added bitmap exactly once.
+    /// Return false if they don't match the bitmaps
+    bool setAtlases(std::vector<TextureAtlas> newAtlases);
+    const std::vector<TextureAtlas>& getAtlases() const { return atlases; }
+    /// Upload the atlases as textures and use them for the bitmaps. The pixel data is released afterwards
+    bool upload();
+
     const auto& getTextures() const { return textures; }
 };
@@ -0,0 +1,123 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "pathfinding/ClusterGraph.h"
+#include "world/MapBase.h"
+#include <algorithm>
+#include <functional>
+
+ClusterGraph::ClusterGraph(const MapBase& world) : world_(world), numClusters_(0, 0), bfsCurVisit_(0), curVisit_(0) {}
+
+void ClusterGraph::Init(const MapExtent& mapSize)
+{
+    const Extent size(mapSize);
+    numClusters_ = Extent((size.x + clusterSize - 1) / clusterSize, (size.y + clusterSize - 1) / clusterSize);
+    clusters_.clear();
+    clusters_.resize(numClusters_.x * numClusters_.y);
+    invalidClusters_.resize(clusters_.size());
+    for(unsigned i = 0; i < clusters_.size(); i++)
+        invalidClusters_[i] = i;
+    const unsigned numNodes = size.x * size.y;
+    entranceIdx_.clear();
+    entranceIdx_.resize(numNodes, invalidDistance);
+    bfsLastVisited_.clear();
+    bfsLastVisited_.resize(numNodes, 0);
+    bfsDistance_.resize(numNodes);
+    bfsCurVisit_ = 0;
+    nodes_.clear();
+    nodes_.resize(numNodes);
+    curVisit_ = 0;
+}
+
+unsigned ClusterGraph::GetClusterIdx(const MapPoint pt) const
+{
+    return (pt.y / clusterSize) * numClusters_.x + pt.x / clusterSize;
+}
+
+void ClusterGraph::Invalidate(const MapPoint pt)
+{
+    for(const unsigned clusterIdx : GetClustersAround(pt))
+    {
+        Cluster& cluster = clusters_[clusterIdx];
+        if(!cluster.isInvalid)
+        {
+            cluster.isInvalid = true;
+            invalidClusters_.push_back(clusterIdx);
+        }
+    }
+}
+
+MapPoint ClusterGraph::GetPoint(const unsigned idx) const
+{
+    const unsigned width = world_.GetWidth();
+    return MapPoint(idx % width, idx / width);
+}
+
+std::vector<unsigned> ClusterGraph::GetAdjacentClusters(const unsigned clusterIdx) const
+{
+    const int cx = clusterIdx % numClusters_.x;
+    const int cy = clusterIdx / numClusters_.x;
+    std::vector<unsigned> result;
+    for(int dy = -1; dy <= 1; dy++)
+    {
+        for(int dx = -1; dx <= 1; dx++)
+        {
+            // Map wraps around
+            const unsigned x = (cx + dx + numClusters_.x) % numClusters_.x;
+            const unsigned y = (cy + dy + numClusters_.y) % numClusters_.y;
+            const unsigned idx = y * numClusters_.x + x;
+            if(idx != clusterIdx)
+                result.push_back(idx);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+std::vector<unsigned> ClusterGraph::GetClustersAround(const MapPoint pt) const
+{
+    std::vector<unsigned> result;
+    result.push_back(GetClusterIdx(pt));
+    for(const MapPoint nb : world_.GetNeighbours(pt))
+        result.push_back(GetClusterIdx(nb));
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void ClusterGraph::IncreaseBFSVisit()
+{
+    if(bfsCurVisit_ == std::numeric_limits<unsigned>::max())
+    {
+        std::fill(bfsLastVisited_.begin(), bfsLastVisited_.end(), 0);
+        bfsCurVisit_ = 1;
+    } else
+        bfsCurVisit_++;
+}
+
+void ClusterGraph::IncreaseVisit()
+{
+    if(curVisit_ == std::numeric_limits<unsigned>::max())
+    {
+        for(AbstractNode& node : nodes_)
+            node.lastVisited = node.lastDestVisit = 0;
+        curVisit_ = 1;
+    } else
+        curVisit_++;
+}
+
+void ClusterGraph::AddToOpenList(const unsigned idx, const unsigned distance, const unsigned prev, const MapPoint dest)
+{
+    AbstractNode& node = nodes_[idx];
+    if(node.lastVisited == curVisit_ && node.distance <= distance)
+        return;
+    node.lastVisited = curVisit_;
+    node.distance = distance;
+    node.estimatedDistance = distance + world_.CalcDistance(GetPoint(idx), dest);
+    node.prev = prev;
+    // Outdated entries are skipped when popped. Ties are broken by the index to be deterministic
+    openList_.emplace_back(node.estimatedDistance, idx);
+    std::push_heap(openList_.begin(), openList_.end(), std::greater<>());
+}
@@ -0,0 +1,119 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "gameTypes/MapCoordinates.h"
+#include <limits>
+#include <utility>
+#include <vector>
+
+class MapBase;
+
+/// Abstraction of the map used for hierarchical path finding (HPA*).
+/// The map is split into square clusters. All passable transitions between 2 adjacent clusters are grouped into
+/// entrances (connected runs of transitions) and each entrance is represented by 1 or 2 transitions.
+/// The distances between all entrance nodes inside a cluster are precomputed, so long paths can be searched on this
+/// much smaller graph and only need to be refined between consecutive entrances.
+/// Clusters are invalidated by changes of the map and rebuilt on the next search.
+/// The template functions are in ClusterGraphImpl.h and must always be called with the same node checker for a graph
+class ClusterGraph
+{
+public:
+    /// Width and height of a cluster in nodes
+    static constexpr unsigned clusterSize = 16;
+    static constexpr unsigned invalidDistance = std::numeric_limits<unsigned>::max();
+
+    /// Point on an abstract path together with its distance from the start
+    struct Waypoint
+    {
+        MapPoint pt;
+        unsigned distance;
+    };
+
+    explicit ClusterGraph(const MapBase& world);
+    /// Reset for a map of the given size. All clusters are invalid afterwards
+    void Init(const MapExtent& mapSize);
+    /// Mark the clusters containing the point or its neighbours as invalid
+    void Invalidate(MapPoint pt);
+    bool HasInvalidClusters() const { return !invalidClusters_.empty(); }
+    unsigned GetNumClusters() const { return static_cast<unsigned>(clusters_.size()); }
+    unsigned GetClusterIdx(MapPoint pt) const;
+
+    /// Rebuild all invalid clusters and their neighbours
+    template<class TNodeChecker>
+    void Update(const TNodeChecker& nodeChecker);
+    /// Find the shortest path from start to dest on the abstract graph. The checker semantics match
+    /// FreePathFinder::FindPath.
+    /// Return the length of the path or invalidDistance if dest is not reachable.
+    /// waypoints contains the points of the path including start and dest
+    template<class TNodeChecker>
+    unsigned FindPath(MapPoint start, MapPoint dest, const TNodeChecker& nodeChecker, std::vector<Waypoint>& waypoints);
+
+private:
+    struct Cluster
+    {
+        /// Map indices of the entrance nodes in this cluster (sorted)
+        std::vector<unsigned> entrances;
+        /// For each entrance the map indices of the nodes in other clusters reachable with 1 step
+        std::vector<std::vector<unsigned>> transitions;
+        /// Distance inside the cluster from entrance i to j stored at i * entrances.size() + j
+        std::vector<unsigned> distances;
+        bool isInvalid = true;
+    };
+    /// Passable transition from a node in one cluster to a node in another cluster
+    struct Crossing
+    {
+        unsigned from, to;
+    };
+    struct AbstractNode
+    {
+        unsigned lastVisited = 0;
+        unsigned distance;
+        unsigned estimatedDistance;
+        unsigned prev;
+        unsigned lastDestVisit = 0;
+        unsigned destDistance;
+    };
+
+    const MapBase& world_;
+    Extent numClusters_;
+    std::vector<Cluster> clusters_;
+    std::vector<unsigned> invalidClusters_;
+    /// Index into the entrances of the nodes cluster for each node or invalidDistance if it is no entrance
+    std::vector<unsigned> entranceIdx_;
+
+    // Data for the searches. Reset by increasing the visit counter
+    std::vector<unsigned> bfsLastVisited_, bfsDistance_;
+    std::vector<MapPoint> bfsQueue_;
+    unsigned bfsCurVisit_;
+    std::vector<AbstractNode> nodes_;
+    unsigned curVisit_;
+    std::vector<std::pair<unsigned, unsigned>> openList_;
+
+    MapPoint GetPoint(unsigned idx) const;
+    /// Return all clusters touching the given one, sorted and excluding itself
+    std::vector<unsigned> GetAdjacentClusters(unsigned clusterIdx) const;
+    /// Return the clusters of the point and its neighbours (sorted)
+    std::vector<unsigned> GetClustersAround(MapPoint pt) const;
+    void IncreaseBFSVisit();
+    void IncreaseVisit();
+    bool WasReachedByBFS(unsigned idx) const { return bfsLastVisited_[idx] == bfsCurVisit_; }
+
+    template<class TNodeChecker>
+    void BuildCluster(unsigned clusterIdx, const TNodeChecker& nodeChecker);
+    /// Get the representative crossings from cluster1 to cluster2 (cluster1 < cluster2)
+    template<class TNodeChecker>
+    void GetCrossings(unsigned cluster1, unsigned cluster2, const TNodeChecker& nodeChecker,
+                      std::vector<Crossing>& result);
+    /// Return true if both points are equal or the edge between them can be used
+    template<class TNodeChecker>
+    bool AreConnected(MapPoint pt1, MapPoint pt2, const TNodeChecker& nodeChecker) const;
+    /// Calculate the distances from start to all nodes in the given clusters. The nodes reached are marked as visited.
+    /// Nodes equal to exemptPt are not checked (destination) but the search does not continue from there
+    template<class TNodeChecker>
+    void ClusterBFS(MapPoint start, const std::vector<unsigned>& allowedClusters, const TNodeChecker& nodeChecker,
+                    MapPoint exemptPt);
+    void AddToOpenList(unsigned idx, unsigned distance, unsigned prev, MapPoint dest);
+};
@@ -0,0 +1,287 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "GFProfiler.h"
+#include "RTTR_Assert.h"
+#include "helpers/EnumRange.h"
+#include "helpers/containerUtils.h"
+#include "pathfinding/ClusterGraph.h"
+#include "world/MapBase.h"
+#include <algorithm>
+#include <functional>
+
+template<class TNodeChecker>
+void ClusterGraph::Update(const TNodeChecker& nodeChecker)
+{
+    if(invalidClusters_.empty())
+        return;
+    // Entrances are shared with the adjacent clusters, so those need to be rebuilt too
+    std::vector<unsigned> clustersToBuild;
+    for(const unsigned clusterIdx : invalidClusters_)
+    {
+        clustersToBuild.push_back(clusterIdx);
+        for(const unsigned adjacentCluster : GetAdjacentClusters(clusterIdx))
+            clustersToBuild.push_back(adjacentCluster);
+    }
+    invalidClusters_.clear();
+    std::sort(clustersToBuild.begin(), clustersToBuild.end());
+    clustersToBuild.erase(std::unique(clustersToBuild.begin(), clustersToBuild.end()), clustersToBuild.end());
+    for(const unsigned clusterIdx : clustersToBuild)
+        BuildCluster(clusterIdx, nodeChecker);
+}
+
+template<class TNodeChecker>
+void ClusterGraph::BuildCluster(const unsigned clusterIdx, const TNodeChecker& nodeChecker)
+{
+    Cluster& cluster = clusters_[clusterIdx];
+    for(const unsigned entrance : cluster.entrances)
+        entranceIdx_[entrance] = invalidDistance;
+
+    // Gather all transitions as (node in this cluster, node in other cluster)
+    std::vector<std::pair<unsigned, unsigned>> links;
+    std::vector<Crossing> crossings;
+    for(const unsigned otherCluster : GetAdjacentClusters(clusterIdx))
+    {
+        crossings.clear();
+        // Always calculate them in the same direction, so both clusters agree on the entrances
+        if(clusterIdx < otherCluster)
+        {
+            GetCrossings(clusterIdx, otherCluster, nodeChecker, crossings);
+            for(const Crossing& crossing : crossings)
+                links.emplace_back(crossing.from, crossing.to);
+        } else
+        {
+            GetCrossings(otherCluster, clusterIdx, nodeChecker, crossings);
+            for(const Crossing& crossing : crossings)
+                links.emplace_back(crossing.to, crossing.from);
+        }
+    }
+    std::sort(links.begin(), links.end());
+    links.erase(std::unique(links.begin(), links.end()), links.end());
+
+    cluster.entrances.clear();
+    cluster.transitions.clear();
+    for(const auto& link : links)
+    {
+        if(cluster.entrances.empty() || cluster.entrances.back() != link.first)
+        {
+            entranceIdx_[link.first] = static_cast<unsigned>(cluster.entrances.size());
+            cluster.entrances.push_back(link.first);
+            cluster.transitions.emplace_back();
+        }
+        cluster.transitions.back().push_back(link.second);
+    }
+
+    const unsigned numEntrances = static_cast<unsigned>(cluster.entrances.size());
+    cluster.distances.resize(numEntrances * numEntrances);
+    const std::vector<unsigned> allowedClusters(1, clusterIdx);
+    for(unsigned i = 0; i < numEntrances; i++)
+    {
+        const MapPoint startPt = GetPoint(cluster.entrances[i]);
+        ClusterBFS(startPt, allowedClusters, nodeChecker, startPt);
+        for(unsigned j = 0; j < numEntrances; j++)
+        {
+            const unsigned entrance = cluster.entrances[j];
+            cluster.distances[i * numEntrances + j] =
+              WasReachedByBFS(entrance) ? bfsDistance_[entrance] : invalidDistance;
+        }
+    }
+    cluster.isInvalid = false;
+}
+
+template<class TNodeChecker>
+bool ClusterGraph::AreConnected(const MapPoint pt1, const MapPoint pt2, const TNodeChecker& nodeChecker) const
+{
+    if(pt1 == pt2)
+        return true;
+    for(const auto dir : helpers::EnumRange<Direction>{})
+    {
+        if(world_.GetNeighbour(pt1, dir) == pt2)
+            return nodeChecker.IsEdgeOk(pt1, dir);
+    }
+    return false;
+}
+
+template<class TNodeChecker>
+void ClusterGraph::GetCrossings(const unsigned cluster1, const unsigned cluster2, const TNodeChecker& nodeChecker,
+                                std::vector<Crossing>& result)
+{
+    RTTR_Assert(cluster1 < cluster2);
+    const MapPoint origin((cluster1 % numClusters_.x) * clusterSize, (cluster1 / numClusters_.x) * clusterSize);
+    const MapPoint end(std::min<unsigned>(origin.x + clusterSize, world_.GetWidth()),
+                       std::min<unsigned>(origin.y + clusterSize, world_.GetHeight()));
+
+    // Runs of crossings where each is connected to the previous one on both sides
+    std::vector<Crossing> run;
+    const auto finishRun = [&run, &result]() {
+        if(run.empty())
+            return;
+        // Use both ends of long entrances to avoid detours
+        if(run.size() >= 6)
+        {
+            result.push_back(run.front());
+            result.push_back(run.back());
+        } else
+            result.push_back(run[run.size() / 2]);
+        run.clear();
+    };
+
+    MapPoint pt;
+    for(pt.y = origin.y; pt.y < end.y; ++pt.y)
+    {
+        for(pt.x = origin.x; pt.x < end.x; ++pt.x)
+        {
+            bool isNodeOk = false;
+            bool isNodeChecked = false;
+            for(const auto dir : helpers::EnumRange<Direction>{})
+            {
+                const MapPoint nb = world_.GetNeighbour(pt, dir);
+                if(GetClusterIdx(nb) != cluster2)
+                    continue;
+                if(!isNodeChecked)
+                {
+                    isNodeOk = nodeChecker.IsNodeOk(pt);
+                    isNodeChecked = true;
+                }
+                if(!isNodeOk)
+                    break;
+                if(!nodeChecker.IsNodeOk(nb) || !nodeChecker.IsEdgeOk(pt, dir))
+                    continue;
+                if(!run.empty()
+                   && (!AreConnected(GetPoint(run.back().from), pt, nodeChecker)
+                       || !AreConnected(GetPoint(run.back().to), nb, nodeChecker)))
+                {
+                    finishRun();
+                }
+                run.push_back(Crossing{world_.GetIdx(pt), world_.GetIdx(nb)});
+            }
+        }
+    }
+    finishRun();
+}
+
+template<class TNodeChecker>
+void ClusterGraph::ClusterBFS(const MapPoint start, const std::vector<unsigned>& allowedClusters,
+                              const TNodeChecker& nodeChecker, const MapPoint exemptPt)
+{
+    IncreaseBFSVisit();
+    bfsQueue_.clear();
+    const unsigned startIdx = world_.GetIdx(start);
+    bfsLastVisited_[startIdx] = bfsCurVisit_;
+    bfsDistance_[startIdx] = 0;
+    bfsQueue_.push_back(start);
+    for(unsigned i = 0; i < bfsQueue_.size(); i++)
+    {
+        const MapPoint curPt = bfsQueue_[i];
+        const unsigned nextDistance = bfsDistance_[world_.GetIdx(curPt)] + 1;
+        for(const auto dir : helpers::EnumRange<Direction>{})
+        {
+            const MapPoint nb = world_.GetNeighbour(curPt, dir);
+            const unsigned nbIdx = world_.GetIdx(nb);
+            if(WasReachedByBFS(nbIdx) || !helpers::contains(allowedClusters, GetClusterIdx(nb)))
+                continue;
+            const bool isExempt = nb == exemptPt;
+            if(!isExempt && !nodeChecker.IsNodeOk(nb))
+                continue;
+            if(!nodeChecker.IsEdgeOk(curPt, dir))
+                continue;
+            bfsLastVisited_[nbIdx] = bfsCurVisit_;
+            bfsDistance_[nbIdx] = nextDistance;
+            if(!isExempt)
+                bfsQueue_.push_back(nb);
+        }
+    }
+}
+
+template<class TNodeChecker>
+unsigned ClusterGraph::FindPath(const MapPoint start, const MapPoint dest, const TNodeChecker& nodeChecker,
+                                std::vector<Waypoint>& waypoints)
+{
+    Update(nodeChecker);
+
+    const unsigned startIdx = world_.GetIdx(start);
+    const unsigned destIdx = world_.GetIdx(dest);
+    IncreaseVisit();
+    openList_.clear();
+
+    // Connect the destination to the entrances around it.
+    // Include the clusters of its neighbours in case it is not reachable from inside its own cluster.
+    // Note: Edges are symmetric so searching backwards yields the same distances
+    const std::vector<unsigned> destClusters = GetClustersAround(dest);
+    ClusterBFS(dest, destClusters, nodeChecker, dest);
+    for(const unsigned clusterIdx : destClusters)
+    {
+        for(const unsigned entrance : clusters_[clusterIdx].entrances)
+        {
+            if(WasReachedByBFS(entrance))
+            {
+                nodes_[entrance].lastDestVisit = curVisit_;
+                nodes_[entrance].destDistance = bfsDistance_[entrance];
+            }
+        }
+    }
+
+    // Connect the start in the same way
+    unsigned bestDistance = invalidDistance;
+    unsigned bestPrev = startIdx;
+    const std::vector<unsigned> startClusters = GetClustersAround(start);
+    ClusterBFS(start, startClusters, nodeChecker, dest);
+    if(WasReachedByBFS(destIdx))
+        bestDistance = bfsDistance_[destIdx];
+    for(const unsigned clusterIdx : startClusters)
+    {
+        for(const unsigned entrance : clusters_[clusterIdx].entrances)
+        {
+            if(WasReachedByBFS(entrance))
+                AddToOpenList(entrance, bfsDistance_[entrance], startIdx, dest);
+        }
+    }
+
+    // A* on the entrance nodes
+    while(!openList_.empty())
+    {
+        std::pop_heap(openList_.begin(), openList_.end(), std::greater<>());
+        const auto entry = openList_.back();
+        openList_.pop_back();
+        RTTR_PROFILE_EXPANDED_NODE();
+        const AbstractNode& node = nodes_[entry.second];
+        if(entry.first != node.estimatedDistance)
+            continue;
+        if(entry.first >= bestDistance)
+            break;
+        const unsigned curIdx = entry.second;
+        const unsigned curDistance = node.distance;
+
+        if(node.lastDestVisit == curVisit_ && curDistance + node.destDistance < bestDistance)
+        {
+            bestDistance = curDistance + node.destDistance;
+            bestPrev = curIdx;
+        }
+
+        const Cluster& cluster = clusters_[GetClusterIdx(GetPoint(curIdx))];
+        const unsigned localIdx = entranceIdx_[curIdx];
+        const unsigned numEntrances = static_cast<unsigned>(cluster.entrances.size());
+        for(unsigned i = 0; i < numEntrances; i++)
+        {
+            const unsigned distance = cluster.distances[localIdx * numEntrances + i];
+            if(i != localIdx && distance != invalidDistance)
+                AddToOpenList(cluster.entrances[i], curDistance + distance, curIdx, dest);
+        }
+        for(const unsigned other : cluster.transitions[localIdx])
+            AddToOpenList(other, curDistance + 1, curIdx, dest);
+    }
+
+    waypoints.clear();
+    if(bestDistance == invalidDistance)
+        return invalidDistance;
+
+    waypoints.push_back(Waypoint{dest, bestDistance});
+    for(unsigned curIdx = bestPrev; curIdx != startIdx; curIdx = nodes_[curIdx].prev)
+        waypoints.push_back(Waypoint{GetPoint(curIdx), nodes_[curIdx].distance});
+    waypoints.push_back(Waypoint{start, 0});
+    std::reverse(waypoints.begin(), waypoints.end());
+    return bestDistance;
+}
@@ -4,9 +4,13 @@
 
 #include "pathfinding/FreePathFinder.h"
 #include "EventManager.h"
+#include "GFProfiler.h"
 #include "RttrForeachPt.h"
+#include "SimulationPhaseTimes.h"
 #include "helpers/containerUtils.h"
+#include "pathfinding/ClusterGraph.h"
 #include "pathfinding/NewNode.h"
+#include "pathfinding/PathfindingLock.h"
 #include "pathfinding/PathfindingPoint.h"
 #include "world/GameWorldBase.h"
 #include "s25util/Log.h"
@@ -15,41 +19,68 @@
 /// FreePathFinder implementation
 //////////////////////////////////////////////////////////////////////////
 
-/// MapNodes
-using MapNodes = std::vector<NewNode>;
-using FreePathNodes = std::vector<FreePathNode>;
-MapNodes nodes;
-FreePathNodes fpNodes;
+FreePathFinder::FreePathFinder(GameWorldBase& gwb) : gwb_(gwb), currentVisit(0), size_(0, 0) {}
+
+FreePathFinder::~FreePathFinder() = default;
 
 void FreePathFinder::Init(const MapExtent& mapSize)
 {
     currentVisit = 0;
     size_ = Extent(mapSize);
     // Reset nodes
-    nodes.clear();
-    fpNodes.clear();
-    nodes.resize(size_.x * size_.y);
-    fpNodes.resize(nodes.size());
+    nodes_.clear();
+    fpNodes_.clear();
+    nodes_.resize(size_.x * size_.y);
+    fpNodes_.resize(nodes_.size());
     RTTR_FOREACH_PT(MapPoint, size_)
     {
         const unsigned idx = gwb_.GetIdx(pt);
-        nodes[idx].mapPt = pt;
-        fpNodes[idx].lastVisited = 0;
-        fpNodes[idx].mapPt = pt;
+        nodes_[idx].mapPt = pt;
+        fpNodes_[idx].lastVisited = 0;
+        fpNodes_[idx].mapPt = pt;
+    }
+    if(humanClusters_)
+    {
+        humanClusters_->Init(mapSize);
+        shipClusters_->Init(mapSize);
     }
 }
 
+void FreePathFinder::SetHierarchicalPathfinding(const bool enabled)
+{
+    if(enabled == IsHierarchicalPathfindingEnabled())
+        return;
+    if(enabled)
+    {
+        humanClusters_ = std::make_unique<ClusterGraph>(gwb_);
+        shipClusters_ = std::make_unique<ClusterGraph>(gwb_);
+        humanClusters_->Init(MapExtent(size_));
+        shipClusters_->Init(MapExtent(size_));
+    } else
+    {
+        humanClusters_.reset();
+        shipClusters_.reset();
+    }
+}
+
+void FreePathFinder::NodeChanged(const MapPoint pt)
+{
+    // Ships only depend on the terrain which does not change
+    if(humanClusters_)
+        humanClusters_->Invalidate(pt);
+}
+
 void FreePathFinder::IncreaseCurrentVisit()
 {
     // if the counter reaches its maxium, tidy up
     if(currentVisit == std::numeric_limits<unsigned>::max())
     {
-        for(auto& node : nodes)
+        for(auto& node : nodes_)
         {
             node.lastVisited = 0;
             node.lastVisitedEven = 0;
         }
-        for(auto& fpNode : fpNodes)
+        for(auto& fpNode : fpNodes_)
         {
             fpNode.lastVisited = 0;
         }
@@ -65,6 +96,9 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
                                                    FP_Node_OK_Callback IsNodeOKAlternate,
                                                    FP_Node_OK_Callback IsNodeToDestOk, const void* param)
 {
+    SimulationPhaseTimer timer(SimulationPhase::Pathfinding);
+    RTTR_PROFILE_PATHFINDER_CALL();
+    PathfindingLock lock(gwb_);
     if(start == dest)
     {
         // Path where start==goal should never happen
@@ -95,9 +129,9 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
     unsigned startId = gwb_.GetIdx(start);
     todo.push_back(PathfindingPoint(startId, gwb_.CalcDistance(start, dest), 0));
     // And init it
-    nodes[startId].prevEven = INVALID_PREV;
-    nodes[startId].lastVisitedEven = currentVisit;
-    nodes[startId].wayEven = 0;
+    nodes_[startId].prevEven = INVALID_PREV;
+    nodes_[startId].lastVisitedEven = currentVisit;
+    nodes_[startId].wayEven = 0;
     // LOG.write(("pf: from %i, %i to %i, %i \n", x_start, y_start, x_dest, y_dest);
 
     // Start at random dir (so different jobs may use different roads)
@@ -122,6 +156,7 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
         PathfindingPoint best = *todo.begin();
         // Knoten behandelt --> raus aus der todo Liste
         todo.erase(todo.begin());
+        RTTR_PROFILE_EXPANDED_NODE();
 
         // printf("x: %u y: %u\n", best.x, best.y);
 
@@ -138,7 +173,7 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
         {
             // Ziel erreicht!
             // Return the values if requested
-            const unsigned routeLen = prevStepEven ? nodes[bestId].wayEven : nodes[bestId].way;
+            const unsigned routeLen = prevStepEven ? nodes_[bestId].wayEven : nodes_[bestId].way;
             if(length)
                 *length = routeLen;
             if(route)
@@ -149,11 +184,11 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
             for(unsigned z = routeLen - 1; bestId != startId; --z)
             {
                 if(route)
-                    (*route)[z] = alternate ? nodes[bestId].dirEven : nodes[bestId].dir;
+                    (*route)[z] = alternate ? nodes_[bestId].dirEven : nodes_[bestId].dir;
                 if(firstDir && z == 0)
-                    *firstDir = nodes[bestId].dirEven;
+                    *firstDir = nodes_[bestId].dirEven;
 
-                bestId = alternate ? nodes[bestId].prevEven : nodes[bestId].prev;
+                bestId = alternate ? nodes_[bestId].prevEven : nodes_[bestId].prev;
                 alternate = !alternate;
             }
 
@@ -162,7 +197,7 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
         }
 
         // Maximaler Weg schon erreicht ? In dem Fall brauchen wir keine weiteren Knoten von diesem aus bilden
-        if((prevStepEven && nodes[bestId].wayEven == maxLength) || (!prevStepEven && nodes[bestId].way == maxLength))
+        if((prevStepEven && nodes_[bestId].wayEven == maxLength) || (!prevStepEven && nodes_[bestId].way == maxLength))
             continue;
 
         // LOG.write(("pf get neighbor nodes %i, %i id: %i \n", best.x, best.y, best_id);
@@ -170,14 +205,14 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
         for(const auto dir : helpers::enumRange(startDir))
         {
             // Koordinaten des entsprechenden umliegenden Punktes bilden
-            MapPoint neighbourPos = gwb_.GetNeighbour(nodes[bestId].mapPt, dir);
+            MapPoint neighbourPos = gwb_.GetNeighbour(nodes_[bestId].mapPt, dir);
 
             // ID des umliegenden Knotens bilden
             unsigned nbId = gwb_.GetIdx(neighbourPos);
 
             // Knoten schon auf dem Feld gebildet ?
-            if((prevStepEven && nodes[nbId].lastVisited == currentVisit)
-               || (!prevStepEven && nodes[nbId].lastVisitedEven == currentVisit))
+            if((prevStepEven && nodes_[nbId].lastVisited == currentVisit)
+               || (!prevStepEven && nodes_[nbId].lastVisitedEven == currentVisit))
             {
                 continue;
             }
@@ -193,21 +228,21 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
                 {
                     if(!IsNodeOKAlternate(gwb_, neighbourPos, dir, param))
                         continue;
-                    MapPoint p = nodes[bestId].mapPt;
+                    MapPoint p = nodes_[bestId].mapPt;
 
                     std::vector<MapPoint> evenLocationsOnRoute;
                     bool alternate = false;
                     unsigned back_id = bestId;
-                    for(unsigned i = nodes[bestId].way - 1; i > 1;
+                    for(unsigned i = nodes_[bestId].way - 1; i > 1;
                         i--) // backtrack the plannend route and check if another "even" position is too close
                     {
-                        Direction pdir = alternate ? nodes[back_id].dirEven : nodes[back_id].dir;
+                        Direction pdir = alternate ? nodes_[back_id].dirEven : nodes_[back_id].dir;
                         p = gwb_.GetNeighbour(p, pdir + 3u);
                         if(i % 2 == 0) // even step
                         {
                             evenLocationsOnRoute.push_back(p);
                         }
-                        back_id = alternate ? nodes[back_id].prevEven : nodes[back_id].prev;
+                        back_id = alternate ? nodes_[back_id].prevEven : nodes_[back_id].prev;
                         alternate = !alternate;
                     }
                     bool tooClose =
@@ -234,16 +269,16 @@ bool FreePathFinder::FindPathAlternatingConditions(const MapPoint start, const M
             unsigned way;
             if(prevStepEven)
             {
-                nodes[nbId].lastVisited = currentVisit;
-                way = nodes[nbId].way = nodes[bestId].wayEven + 1;
-                nodes[nbId].dir = dir;
-                nodes[nbId].prev = bestId;
+                nodes_[nbId].lastVisited = currentVisit;
+                way = nodes_[nbId].way = nodes_[bestId].wayEven + 1;
+                nodes_[nbId].dir = dir;
+                nodes_[nbId].prev = bestId;
             } else
             {
-                nodes[nbId].lastVisitedEven = currentVisit;
-                way = nodes[nbId].wayEven = nodes[bestId].way + 1;
-                nodes[nbId].dirEven = dir;
-                nodes[nbId].prevEven = bestId;
+                nodes_[nbId].lastVisitedEven = currentVisit;
+                way = nodes_[nbId].wayEven = nodes_[bestId].way + 1;
+                nodes_[nbId].dirEven = dir;
+                nodes_[nbId].prevEven = bestId;
             }
 
             todo.push_back(PathfindingPoint(nbId, gwb_.CalcDistance(neighbourPos, dest), way));
@@ -6,9 +6,13 @@
 
 #include "gameTypes/Direction.h"
 #include "gameTypes/MapCoordinates.h"
+#include <memory>
 #include <vector>
 
+class ClusterGraph;
 class GameWorldBase;
+struct FreePathNode;
+struct NewNode;
 
 using FP_Node_OK_Callback = bool (*)(const GameWorldBase&, const MapPoint, const Direction, const void*);
 
@@ -21,11 +25,26 @@ class FreePathFinder
     GameWorldBase& gwb_;
     unsigned currentVisit;
     Extent size_;
+    /// Search state per map node. Owned by the instance so pathfinders of different worlds are independent
+    std::vector<NewNode> nodes_;
+    std::vector<FreePathNode> fpNodes_;
+    /// Cluster graphs for hierarchical path finding. Only set if enabled
+    std::unique_ptr<ClusterGraph> humanClusters_, shipClusters_;
 
 public:
-    FreePathFinder(GameWorldBase& gwb) : gwb_(gwb), currentVisit(0), size_(0, 0) {}
+    FreePathFinder(GameWorldBase& gwb);
+    ~FreePathFinder();
     void Init(const MapExtent& mapSize);
 
+    /// Enable or disable hierarchical path finding for long routes of humans and ships.
+    /// The routes found may differ from the regular search, so this must be the same for all players of a game
+    void SetHierarchicalPathfinding(bool enabled);
+    bool IsHierarchicalPathfindingEnabled() const { return humanClusters_ != nullptr; }
+    ClusterGraph* GetHumanClusters() const { return humanClusters_.get(); }
+    ClusterGraph* GetShipClusters() const { return shipClusters_.get(); }
+    /// Called when the object or roads of a node changed which may change the passability for humans
+    void NodeChanged(MapPoint pt);
+
     /// Wegfindung in freiem Terrain - Template version. Users need to include FreePathFinderImpl.h
     /// TNodeChecker must implement: bool IsNodeOk(MapPoint pt, unsigned char dirFromPrevPt) and bool
     /// IsNodeToDestOk(MapPoint pt, unsigned char dirFromPrevPt)
@@ -33,6 +52,13 @@ public:
     bool FindPath(MapPoint start, MapPoint dest, bool randomRoute, unsigned maxLength, std::vector<Direction>* route,
                   unsigned* length, Direction* firstDir, const TNodeChecker& nodeChecker);
 
+    /// Like FindPath but searches long routes on the abstract graph of the clusters first and refines the result.
+    /// The route is (near) optimal and found much faster. Users need to include FreePathFinderImpl.h
+    template<class TNodeChecker>
+    bool FindPathHierarchical(MapPoint start, MapPoint dest, bool randomRoute, unsigned maxLength,
+                              std::vector<Direction>* route, unsigned* length, Direction* firstDir,
+                              const TNodeChecker& nodeChecker, ClusterGraph& clusters);
+
     bool FindPathAlternatingConditions(MapPoint start, MapPoint dest, bool randomRoute, unsigned maxLength,
                                        std::vector<Direction>* route, unsigned* length, Direction* firstDir,
                                        FP_Node_OK_Callback IsNodeOK, FP_Node_OK_Callback IsNodeOKAlternate,
@@ -5,16 +5,17 @@
 #pragma once
 
 #include "EventManager.h"
+#include "GFProfiler.h"
+#include "SimulationPhaseTimes.h"
+#include "pathfinding/ClusterGraphImpl.h"
 #include "pathfinding/FreePathFinder.h"
 #include "pathfinding/NewNode.h"
 #include "pathfinding/OpenListBinaryHeap.h"
 #include "pathfinding/OpenListPrioQueue.h"
+#include "pathfinding/PathfindingLock.h"
 #include "pathfinding/PathfindingPoint.h"
 #include "world/GameWorldBase.h"
 
-using FreePathNodes = std::vector<FreePathNode>;
-extern FreePathNodes fpNodes;
-
 struct NodePtrCmpGreater
 {
     bool operator()(const FreePathNode* const lhs, const FreePathNode* const rhs) const
@@ -42,7 +43,10 @@ bool FreePathFinder::FindPath(const MapPoint start, const MapPoint dest, bool ra
                               std::vector<Direction>* route, unsigned* length, Direction* firstDir,
                               const TNodeChecker& nodeChecker)
 {
+    SimulationPhaseTimer timer(SimulationPhase::Pathfinding);
+    RTTR_PROFILE_PATHFINDER_CALL();
     RTTR_Assert(start != dest);
+    PathfindingLock lock(gwb_);
 
     // increase currentVisit, so we don't have to clear the visited-states at every run
     IncreaseCurrentVisit();
@@ -50,8 +54,8 @@ bool FreePathFinder::FindPath(const MapPoint start, const MapPoint dest, bool ra
     QueueImpl todo;
     const unsigned startId = gwb_.GetIdx(start);
     const unsigned destId = gwb_.GetIdx(dest);
-    FreePathNode& startNode = fpNodes[startId];
-    FreePathNode& destNode = fpNodes[destId];
+    FreePathNode& startNode = fpNodes_[startId];
+    FreePathNode& destNode = fpNodes_[destId];
 
     // Anfangsknoten einfügen Und mit entsprechenden Werten füllen
     startNode.targetDistance = gwb_.CalcDistance(start, dest);
@@ -71,6 +75,7 @@ bool FreePathFinder::FindPath(const MapPoint start, const MapPoint dest, bool ra
     {
         // Knoten mit den geringsten Wegkosten auswählen
         FreePathNode& best = *todo.pop();
+        RTTR_PROFILE_EXPANDED_NODE();
 
         // Ziel schon erreicht?
         if(&best == &destNode)
@@ -112,7 +117,7 @@ bool FreePathFinder::FindPath(const MapPoint start, const MapPoint dest, bool ra
 
             // ID des umliegenden Knotens bilden
             unsigned nbId = gwb_.GetIdx(neighbourPos);
-            FreePathNode& neighbour = fpNodes[nbId];
+            FreePathNode& neighbour = fpNodes_[nbId];
 
             // Don't try to go back where we came from (would also bail out in the conditions below)
             if(best.prev == &neighbour)
@@ -164,6 +169,60 @@ bool FreePathFinder::FindPath(const MapPoint start, const MapPoint dest, bool ra
     return false;
 }
 
+template<class TNodeChecker>
+bool FreePathFinder::FindPathHierarchical(const MapPoint start, const MapPoint dest, bool randomRoute,
+                                          unsigned maxLength, std::vector<Direction>* route, unsigned* length,
+                                          Direction* firstDir, const TNodeChecker& nodeChecker, ClusterGraph& clusters)
+{
+    SimulationPhaseTimer timer(SimulationPhase::Pathfinding);
+    RTTR_Assert(start != dest);
+    PathfindingLock lock(gwb_);
+
+    // Short routes are faster with the regular search
+    if(gwb_.CalcDistance(start, dest) < 2 * ClusterGraph::clusterSize)
+        return FindPath(start, dest, randomRoute, maxLength, route, length, firstDir, nodeChecker);
+
+    std::vector<ClusterGraph::Waypoint> waypoints;
+    const unsigned abstractLength = clusters.FindPath(start, dest, nodeChecker, waypoints);
+    // The abstract path is only near optimal, so there might still be a path short enough.
+    // If there is none the graph might not match the current state of the map, e.g. due to a change not (yet) passed to
+    // NodeChanged. The regular search is always correct, so use it
+    if(abstractLength == ClusterGraph::invalidDistance || abstractLength > maxLength)
+        return FindPath(start, dest, randomRoute, maxLength, route, length, firstDir, nodeChecker);
+
+    // Refine each part of the path. Their length is known, which limits the search
+    if(route)
+        route->clear();
+    std::vector<Direction> segmentRoute;
+    unsigned totalLength = 0;
+    for(unsigned i = 1; i < waypoints.size(); i++)
+    {
+        const ClusterGraph::Waypoint& from = waypoints[i - 1];
+        const ClusterGraph::Waypoint& to = waypoints[i];
+        if(from.pt == to.pt)
+            continue;
+        // The searches between the waypoints don't check their destination, so check the intermediate ones here
+        const bool isIntermediate = i + 1 < waypoints.size();
+        unsigned segmentLength;
+        Direction segmentDir;
+        if((isIntermediate && !nodeChecker.IsNodeOk(to.pt))
+           || !FindPath(from.pt, to.pt, randomRoute, to.distance - from.distance, route ? &segmentRoute : nullptr,
+                        &segmentLength, &segmentDir, nodeChecker))
+        {
+            // The graph does not match the current state of the map, so use the regular search as above
+            return FindPath(start, dest, randomRoute, maxLength, route, length, firstDir, nodeChecker);
+        }
+        if(firstDir && totalLength == 0)
+            *firstDir = segmentDir;
+        if(route)
+            route->insert(route->end(), segmentRoute.begin(), segmentRoute.end());
+        totalLength += segmentLength;
+    }
+    if(length)
+        *length = totalLength;
+    return true;
+}
+
 /// Ermittelt, ob eine freie Route noch passierbar ist und gibt den Endpunkt der Route zurück
 template<class TNodeChecker>
 bool FreePathFinder::CheckRoute(const MapPoint start, const std::vector<Direction>& route, unsigned pos,
@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include "RTTR_Assert.h"
+#include <cstddef>
 #include <vector>
 
 struct GetEstimateFromPtr
@@ -0,0 +1,41 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "pathfinding/PathfindingLock.h"
+#include "RTTR_Assert.h"
+#include "world/GameWorldBase.h"
+
+namespace {
+thread_local bool isAIThread = false;
+thread_local bool holdsLock = false;
+} // namespace
+
+PathfindingLock::PathfindingLock(const GameWorldBase& world) : mutex_(nullptr)
+{
+    if(!isAIThread || holdsLock)
+        return;
+    mutex_ = &world.GetPathfindingMutex();
+    mutex_->lock();
+    holdsLock = true;
+}
+
+PathfindingLock::~PathfindingLock()
+{
+    if(!mutex_)
+        return;
+    holdsLock = false;
+    mutex_->unlock();
+}
+
+PathfindingLock::AIThreadScope::AIThreadScope()
+{
+    RTTR_Assert(!isAIThread);
+    isAIThread = true;
+}
+
+PathfindingLock::AIThreadScope::~AIThreadScope()
+{
+    RTTR_Assert(!holdsLock);
+    isAIThread = false;
+}
@@ -0,0 +1,35 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <mutex>
+
+class GameWorldBase;
+
+/// Taken by the path finders for each search as they store their state in the world, so only 1 search may run at a
+/// time. The game itself never searches while the AIs run concurrently (see AIThreadPool), so the mutex of the world
+/// is only locked on threads marked by AIThreadScope. Nested searches on the same thread lock it only once.
+class PathfindingLock
+{
+public:
+    explicit PathfindingLock(const GameWorldBase& world);
+    ~PathfindingLock();
+    PathfindingLock(const PathfindingLock&) = delete;
+    PathfindingLock& operator=(const PathfindingLock&) = delete;
+
+    /// Marks the current thread as running AIs concurrently with other threads while it exists
+    class AIThreadScope
+    {
+    public:
+        AIThreadScope();
+        ~AIThreadScope();
+        AIThreadScope(const AIThreadScope&) = delete;
+        AIThreadScope& operator=(const AIThreadScope&) = delete;
+    };
+
+private:
+    /// Locked mutex or nullptr if no lock was required
+    std::mutex* mutex_;
+};
@@ -4,14 +4,18 @@
 
 #include "RoadPathFinder.h"
 #include "EventManager.h"
+#include "GFProfiler.h"
 #include "RttrForeachPt.h"
+#include "SimulationPhaseTimes.h"
+#include "buildings/nobBaseWarehouse.h"
 #include "buildings/nobHarborBuilding.h"
 #include "pathfinding/OpenListPrioQueue.h"
-#include "pathfinding/OpenListVector.h"
+#include "pathfinding/PathfindingLock.h"
 #include "world/GameWorldBase.h"
 #include "nodeObjs/noRoadNode.h"
 #include "gameData/GameConsts.h"
 #include "s25util/Log.h"
+#include <algorithm>
 
 /// Comparison operator for road nodes that returns true if lhs > rhs (descending order)
 struct RoadNodeComperatorGreater
@@ -30,8 +34,6 @@ struct RoadNodeComperatorGreater
 };
 
 using QueueImpl = OpenListPrioQueue<const noRoadNode*, RoadNodeComperatorGreater>;
-using VecImpl = OpenListVector<const noRoadNode*>;
-VecImpl todo;
 
 // Namespace with all functors usable as additional cost functors
 namespace AdditonalCosts {
@@ -48,6 +50,18 @@ struct Carrier
         return curNode.GetPunishmentPoints(nextDir);
     }
 };
+
+/// Costs for busy carriers at the other end of the road, i.e. for searches against the direction of the ware
+struct CarrierAtNeighbour
+{
+    unsigned operator()(const noRoadNode& curNode, const Direction nextDir) const
+    {
+        const RoadSegment& route = *curNode.GetRoute(nextDir);
+        const bool curIsF1 = route.GetF1() == &curNode;
+        const noRoadNode& neighbour = curIsF1 ? *route.GetF2() : *route.GetF1();
+        return neighbour.GetPunishmentPoints(route.GetDir(curIsF1, 0));
+    }
+};
 } // namespace AdditonalCosts
 
 // Namespace with all functors usable as segment constraint functors
@@ -100,6 +114,63 @@ struct And : private T_Func1, private T_Func2
 };
 } // namespace SegmentConstraints
 
+namespace {
+/// Only flags and harbors can be passed, other buildings are only connected to their flag
+bool isTransitNode(const noRoadNode& node)
+{
+    const GO_Type got = node.GetGOT();
+    return got == GO_Type::Flag || got == GO_Type::NobHarborbuilding;
+}
+
+/// Call visit(neighbour, cost, dir) for every node reachable from node over a road allowed by isSegmentAllowed and for
+/// the destinations of the ship connections of a harbor.
+/// The cost is the road length plus addCosts(node, dir) or the costs of the ship connection.
+/// prevNode is skipped as going back never results in lower costs
+template<class T_AdditionalCosts, class T_SegmentConstraints, class T_Visit>
+void forEachNeighbour(const noRoadNode& node, const noRoadNode* const prevNode, const T_AdditionalCosts& addCosts,
+                      const T_SegmentConstraints& isSegmentAllowed, T_Visit&& visit)
+{
+    const helpers::EnumArray<RoadSegment*, Direction> routes = node.getRoutes();
+    for(const auto dir : helpers::EnumRange<Direction>{})
+    {
+        const RoadSegment* route = routes[dir];
+        if(!route)
+            continue;
+
+        // Check the 2 flags, one is the current node, so we need the other
+        noRoadNode& neighbour = (route->GetF1() == &node) ? *route->GetF2() : *route->GetF1();
+        // this eliminates 1/6 of all nodes and avoids cost calculation and further checks
+        if(&neighbour == prevNode || !isSegmentAllowed(*route))
+            continue;
+
+        visit(neighbour, route->GetLength() + addCosts(node, dir), toRoadPathDirection(dir));
+    }
+
+    // For harbors also consider ship connections. Those have the same costs in both directions
+    if(node.GetGOT() != GO_Type::NobHarborbuilding)
+        return;
+    for(const auto& sc : static_cast<const nobHarborBuilding&>(node).GetShipConnections())
+        visit(*sc.dest, sc.way_costs, RoadPathDirection::Ship);
+}
+} // namespace
+
+void RoadPathFinder::IncreaseCurrentVisit()
+{
+    currentVisit++;
+
+    // if the counter reaches its maximum, tidy up
+    if(currentVisit == std::numeric_limits<unsigned>::max())
+    {
+        RTTR_FOREACH_PT(MapPoint, gwb_.GetSize())
+        {
+            auto* const node = gwb_.GetSpecObj<noRoadNode>(pt);
+            if(node)
+                node->last_visit = 0;
+        }
+        currentVisit = 1;
+    }
+}
+
 /// Wegfinden ( A* ), O(v lg v) --> Wegfindung auf Stra�en
 template<class T_AdditionalCosts, class T_SegmentConstraints>
 bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goal, const unsigned max,
@@ -107,6 +178,9 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
                                   unsigned* const length, RoadPathDirection* const firstDir,
                                   MapPoint* const firstNodePos)
 {
+    SimulationPhaseTimer timer(SimulationPhase::Pathfinding);
+    RTTR_PROFILE_PATHFINDER_CALL();
+    PathfindingLock lock(gwb_);
     if(&start == &goal)
     {
         // Path where start==goal should never happen
@@ -125,22 +199,10 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
     }
 
     // increase current_visit_on_roads, so we don't have to clear the visited-states at every run
-    currentVisit++;
-
-    // if the counter reaches its maximum, tidy up
-    if(currentVisit == std::numeric_limits<unsigned>::max())
-    {
-        RTTR_FOREACH_PT(MapPoint, gwb_.GetSize())
-        {
-            auto* const node = gwb_.GetSpecObj<noRoadNode>(pt);
-            if(node)
-                node->last_visit = 0;
-        }
-        currentVisit = 1;
-    }
+    IncreaseCurrentVisit();
 
     // Add start node
-    todo.clear();
+    todo_.clear();
 
     const MapPoint goalPos = goal.GetPos();
     start.targetDistance = gwb_.CalcDistance(start.GetPos(), goalPos);
@@ -150,12 +212,13 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
     start.cost = 0;
     start.dir_ = RoadPathDirection::None;
 
-    todo.push(&start);
+    todo_.push(&start);
 
-    while(!todo.empty())
+    while(!todo_.empty())
     {
         // Get node with current least estimate
-        const noRoadNode& best = *todo.pop();
+        const noRoadNode& best = *todo_.pop();
+        RTTR_PROFILE_EXPANDED_NODE();
 
         // Reached goal
         if(&best == &goal)
@@ -181,106 +244,42 @@ bool RoadPathFinder::FindPathImpl(const noRoadNode& start, const noRoadNode& goa
             return true;
         }
 
-        const helpers::EnumArray<RoadSegment*, Direction> routes = best.getRoutes();
-        const noRoadNode* prevNode = best.prev;
-
-        // Nachbarflagge bzw. Wege in allen 6 Richtungen verfolgen
-        for(const auto dir : helpers::EnumRange<Direction>{})
-        {
-            const auto* route = routes[dir];
-            if(!route)
-                continue;
-
-            // Check the 2 flags, one is the current node, so we need the other
-            noRoadNode* neighbour = route->GetF1();
-            if(neighbour == &best)
-                neighbour = route->GetF2();
-
-            // this eliminates 1/6 of all nodes and avoids cost calculation and further checks,
-            if(neighbour == prevNode)
-                continue;
-
-            // No paths over buildings
-            if(dir == Direction::NorthWest && neighbour != &goal)
-            {
-                // Flags and harbors are allowed
-                const GO_Type got = neighbour->GetGOT();
-                if(got != GO_Type::Flag && got != GO_Type::NobHarborbuilding)
-                    continue;
-            }
-
-            // evtl verboten?
-            if(!isSegmentAllowed(*route))
-                continue;
-
-            unsigned cost = best.cost + route->GetLength();
-            cost += addCosts(best, dir);
-
-            if(cost > max)
-                continue;
-
-            // Was node already visited?
-            if(neighbour->last_visit == currentVisit)
-            {
-                // Update node if costs are lower
-                if(cost < neighbour->cost)
-                {
-                    neighbour->cost = cost;
-                    neighbour->estimate = neighbour->targetDistance + cost;
-                    neighbour->prev = &best;
-                    neighbour->dir_ = toRoadPathDirection(dir);
-                    todo.rearrange(neighbour);
-                }
-            } else
-            {
-                // Not visited yet -> Add to list
-                neighbour->cost = cost;
-                neighbour->targetDistance = gwb_.CalcDistance(neighbour->GetPos(), goalPos);
-                neighbour->estimate = neighbour->targetDistance + cost;
-                neighbour->last_visit = currentVisit;
-                neighbour->prev = &best;
-                neighbour->dir_ = toRoadPathDirection(dir);
-
-                todo.push(neighbour);
-            }
-        }
-
-        // For harbors also consider ship connections
-        if(best.GetGOT() != GO_Type::NobHarborbuilding)
-            continue;
-        for(const auto& sc : static_cast<const nobHarborBuilding&>(best).GetShipConnections())
-        {
-            unsigned cost = best.cost + sc.way_costs;
-
-            if(cost > max)
-                continue;
-
-            noRoadNode& dest = *sc.dest;
-            // Was node already visited?
-            if(dest.last_visit == currentVisit)
-            {
-                // Update node if costs are lower
-                if(cost < dest.cost)
-                {
-                    dest.cost = cost;
-                    dest.estimate = dest.targetDistance + cost;
-                    dest.prev = &best;
-                    dest.dir_ = RoadPathDirection::Ship;
-                    todo.rearrange(&dest);
-                }
-            } else
-            {
-                // Not visited yet -> Add to list
-                dest.cost = cost;
-                dest.targetDistance = gwb_.CalcDistance(dest.GetPos(), goalPos);
-                dest.estimate = dest.targetDistance + cost;
-                dest.last_visit = currentVisit;
-                dest.prev = &best;
-                dest.dir_ = RoadPathDirection::Ship;
-
-                todo.push(&dest);
-            }
-        }
+        forEachNeighbour(
+          best, best.prev, addCosts, isSegmentAllowed,
+          [this, &best, &goal, &goalPos, max](noRoadNode& neighbour, unsigned cost, const RoadPathDirection dir) {
+              // No paths over buildings
+              if(dir == RoadPathDirection::NorthWest && &neighbour != &goal && !isTransitNode(neighbour))
+                  return;
+
+              cost += best.cost;
+              if(cost > max)
+                  return;
+
+              // Was node already visited?
+              if(neighbour.last_visit == currentVisit)
+              {
+                  // Update node if costs are lower
+                  if(cost < neighbour.cost)
+                  {
+                      neighbour.cost = cost;
+                      neighbour.estimate = neighbour.targetDistance + cost;
+                      neighbour.prev = &best;
+                      neighbour.dir_ = dir;
+                      todo_.rearrange(&neighbour);
+                  }
+              } else
+              {
+                  // Not visited yet -> Add to list
+                  neighbour.cost = cost;
+                  neighbour.targetDistance = gwb_.CalcDistance(neighbour.GetPos(), goalPos);
+                  neighbour.estimate = neighbour.targetDistance + cost;
+                  neighbour.last_visit = currentVisit;
+                  neighbour.prev = &best;
+                  neighbour.dir_ = dir;
+
+                  todo_.push(&neighbour);
+              }
+          });
     }
 
     // Liste leer und kein Ziel erreicht --> kein Weg
@@ -334,3 +333,250 @@ bool RoadPathFinder::PathExists(const noRoadNode& start, const noRoadNode& goal,
                                 SegmentConstraints::AvoidRoadType<RoadType::Water>());
     }
 }
+
+namespace {
+struct DistanceEntryGreater
+{
+    template<class T>
+    bool operator()(const T& lhs, const T& rhs) const
+    {
+        return lhs.cost > rhs.cost;
+    }
+};
+} // namespace
+
+void RoadPathFinder::StartWareDistanceSearch(const noRoadNode& start)
+{
+    PathfindingLock lock(gwb_);
+    distanceSearchVisit_++;
+
+    // if the counter reaches its maximum, tidy up
+    if(distanceSearchVisit_ == std::numeric_limits<unsigned>::max())
+    {
+        RTTR_FOREACH_PT(MapPoint, gwb_.GetSize())
+        {
+            auto* const node = gwb_.GetSpecObj<noRoadNode>(pt);
+            if(node)
+                node->distanceVisit = 0;
+        }
+        distanceSearchVisit_ = 1;
+    }
+
+    distanceSearchStart_ = &start;
+    distanceSearchTodo_.clear();
+
+    start.distanceVisit = distanceSearchVisit_;
+    start.distanceCost = 0;
+    distanceSearchTodo_.push_back(DistanceEntry{0, &start});
+}
+
+/// Dijkstra which is continued on every call.
+/// It uses the same edges and costs as FindPathImpl for wares, so the results are the same as for separate searches.
+/// The node data and open list are only used by this search, so other searches may be done between the calls
+bool RoadPathFinder::GetWareDistance(const noRoadNode& goal, const unsigned max, unsigned& length)
+{
+    SimulationPhaseTimer timer(SimulationPhase::Pathfinding);
+    RTTR_PROFILE_PATHFINDER_CALL();
+    PathfindingLock lock(gwb_);
+    RTTR_Assert(distanceSearchStart_);
+    if(&goal == distanceSearchStart_)
+    {
+        // Same as FindPath
+        RTTR_Assert(false);
+        length = 0;
+        return true;
+    }
+
+    while(!distanceSearchTodo_.empty() && distanceSearchTodo_.front().cost <= max)
+    {
+        // Costs of the goal are final if no node with less costs is left
+        if(goal.distanceVisit == distanceSearchVisit_ && goal.distanceCost <= distanceSearchTodo_.front().cost)
+            break;
+
+        std::pop_heap(distanceSearchTodo_.begin(), distanceSearchTodo_.end(), DistanceEntryGreater());
+        const DistanceEntry entry = distanceSearchTodo_.back();
+        distanceSearchTodo_.pop_back();
+        RTTR_PROFILE_EXPANDED_NODE();
+        const noRoadNode& best = *entry.node;
+        // Outdated entry
+        if(entry.cost != best.distanceCost)
+            continue;
+
+        // No paths over buildings. They can only be reached from their flag (NorthWest) so only flags and harbors need
+        // to be expanded
+        if(&best != distanceSearchStart_ && !isTransitNode(best))
+            continue;
+
+        forEachNeighbour(best, nullptr, AdditonalCosts::Carrier(), SegmentConstraints::None(),
+                         [this, &best](const noRoadNode& node, unsigned cost, RoadPathDirection) {
+                             cost += best.distanceCost;
+                             if(node.distanceVisit == distanceSearchVisit_ && node.distanceCost <= cost)
+                                 return;
+                             node.distanceVisit = distanceSearchVisit_;
+                             node.distanceCost = cost;
+                             distanceSearchTodo_.push_back(DistanceEntry{cost, &node});
+                             std::push_heap(distanceSearchTodo_.begin(), distanceSearchTodo_.end(),
+                                            DistanceEntryGreater());
+                         });
+    }
+
+    if(goal.distanceVisit == distanceSearchVisit_ && goal.distanceCost <= max)
+    {
+        length = goal.distanceCost;
+        return true;
+    }
+    return false;
+}
+
+/// Dijkstra from the start which stops when all warehouses with the least costs are found.
+/// In reverse mode (!toWarehouse) the costs of the edges are those of the opposite direction
+nobBaseWarehouse* RoadPathFinder::FindNearestWarehouse(const noRoadNode& start,
+                                                       const std::vector<nobBaseWarehouse*>& warehouses,
+                                                       const bool toWarehouse, const bool wareMode,
+                                                       const RoadSegment* const forbidden, unsigned* const length)
+{
+    SimulationPhaseTimer timer(SimulationPhase::Pathfinding);
+    RTTR_PROFILE_PATHFINDER_CALL();
+    PathfindingLock lock(gwb_);
+    IncreaseCurrentVisit();
+    warehouseSearchTodo_.clear();
+
+    // Mark the candidates, all other nodes get noWarehouseIdx when they are reached first
+    constexpr unsigned noWarehouseIdx = std::numeric_limits<unsigned>::max();
+    for(unsigned i = 0; i < warehouses.size(); i++)
+    {
+        const noRoadNode& warehouse = *warehouses[i];
+        // Keep the first one on duplicates
+        if(warehouse.last_visit == currentVisit)
+            continue;
+        warehouse.last_visit = currentVisit;
+        warehouse.cost = std::numeric_limits<unsigned>::max();
+        warehouse.warehouseIdx = i;
+    }
+
+    const auto addNode = [this](const noRoadNode& node, unsigned cost) {
+        if(node.last_visit == currentVisit)
+        {
+            if(node.cost <= cost)
+                return;
+        } else
+        {
+            node.last_visit = currentVisit;
+            node.warehouseIdx = noWarehouseIdx;
+        }
+        node.cost = cost;
+        warehouseSearchTodo_.push_back(DistanceEntry{cost, &node});
+        std::push_heap(warehouseSearchTodo_.begin(), warehouseSearchTodo_.end(), DistanceEntryGreater());
+    };
+    // Costs for busy carriers are added at the node the ware is waiting at
+    const auto addCosts = [wareMode, toWarehouse](const noRoadNode& node, const Direction dir) {
+        if(!wareMode)
+            return 0u;
+        return toWarehouse ? AdditonalCosts::Carrier()(node, dir) : AdditonalCosts::CarrierAtNeighbour()(node, dir);
+    };
+    const auto isSegmentAllowed = [forbidden, wareMode](const RoadSegment& route) {
+        return &route != forbidden && (wareMode || route.GetRoadType() != RoadType::Water);
+    };
+
+    addNode(start, 0);
+    unsigned bestIdx = noWarehouseIdx;
+    unsigned bestCost = std::numeric_limits<unsigned>::max();
+    while(!warehouseSearchTodo_.empty())
+    {
+        std::pop_heap(warehouseSearchTodo_.begin(), warehouseSearchTodo_.end(), DistanceEntryGreater());
+        const DistanceEntry entry = warehouseSearchTodo_.back();
+        warehouseSearchTodo_.pop_back();
+        // All warehouses with the least costs were found
+        if(entry.cost > bestCost)
+            break;
+        RTTR_PROFILE_EXPANDED_NODE();
+        const noRoadNode& best = *entry.node;
+        // Outdated entry
+        if(entry.cost != best.cost)
+            continue;
+
+        if(best.warehouseIdx != noWarehouseIdx)
+        {
+            // Prefer the first one in the list on equal costs
+            if(best.warehouseIdx < bestIdx)
+            {
+                bestIdx = best.warehouseIdx;
+                bestCost = best.cost;
+            }
+            continue;
+        }
+        // No paths over buildings, only flags and harbors can be passed
+        if(&best != &start && !isTransitNode(best))
+            continue;
+
+        forEachNeighbour(best, nullptr, addCosts, isSegmentAllowed,
+                         [&addNode, &best](const noRoadNode& node, unsigned cost, RoadPathDirection) {
+                             addNode(node, best.cost + cost);
+                         });
+    }
+
+    if(length)
+        *length = bestCost;
+    return (bestIdx != noWarehouseIdx) ? warehouses[bestIdx] : nullptr;
+}
+
+void RoadPathFinder::ResetWareComponents()
+{
+    PathfindingLock lock(gwb_);
+    componentVisit_++;
+    numComponents_ = 0;
+
+    // if the counter reaches its maximum, tidy up
+    if(componentVisit_ == std::numeric_limits<unsigned>::max())
+    {
+        RTTR_FOREACH_PT(MapPoint, gwb_.GetSize())
+        {
+            auto* const node = gwb_.GetSpecObj<noRoadNode>(pt);
+            if(node)
+                node->componentVisit = 0;
+        }
+        componentVisit_ = 1;
+    }
+}
+
+bool RoadPathFinder::IsConnectedForWares(const noRoadNode& start, const noRoadNode& goal)
+{
+    PathfindingLock lock(gwb_);
+    RTTR_Assert(componentVisit_ > 0); // ResetWareComponents not called
+    if(&start == &goal)
+        return true;
+    if(start.componentVisit != componentVisit_)
+        LabelWareComponent(start);
+    // Goal was either labeled together with the start or is not reachable from it
+    return goal.componentVisit == componentVisit_ && goal.component == start.component;
+}
+
+/// Flood fill with the same edges as FindPathImpl for wares
+void RoadPathFinder::LabelWareComponent(const noRoadNode& start)
+{
+    SimulationPhaseTimer timer(SimulationPhase::Pathfinding);
+    const unsigned component = ++numComponents_;
+    const auto addNode = [this, component](const noRoadNode& node) {
+        if(node.componentVisit == componentVisit_)
+            return;
+        node.componentVisit = componentVisit_;
+        node.component = component;
+        componentTodo_.push_back(&node);
+    };
+
+    componentTodo_.clear();
+    addNode(start);
+    while(!componentTodo_.empty())
+    {
+        const noRoadNode& node = *componentTodo_.back();
+        componentTodo_.pop_back();
+        RTTR_PROFILE_EXPANDED_NODE();
+
+        // No paths over buildings. They can only be reached from their flag and are only connected to it
+        if(&node != &start && !isTransitNode(node))
+            continue;
+
+        forEachNeighbour(node, nullptr, AdditonalCosts::None(), SegmentConstraints::None(),
+                         [&addNode](const noRoadNode& neighbour, unsigned, RoadPathDirection) { addNode(neighbour); });
+    }
+}
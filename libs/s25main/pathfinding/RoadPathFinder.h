@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include "pathfinding/OpenListVector.h"
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/RoadPathDirection.h"
 #include <limits>
+#include <vector>
 
 class GameWorldBase;
+class nobBaseWarehouse;
 class noRoadNode;
 class RoadSegment;
 
@@ -16,9 +19,31 @@ class RoadPathFinder
 {
     GameWorldBase& gwb_;
     unsigned currentVisit;
+    /// Open list of FindPathImpl
+    OpenListVector<const noRoadNode*> todo_;
+
+    /// Open list entry of the ware distance and warehouse searches
+    struct DistanceEntry
+    {
+        unsigned cost;
+        const noRoadNode* node;
+    };
+    /// State of the ware distance search
+    const noRoadNode* distanceSearchStart_;
+    unsigned distanceSearchVisit_;
+    std::vector<DistanceEntry> distanceSearchTodo_;
+    std::vector<DistanceEntry> warehouseSearchTodo_;
+
+    /// State of the labeling of connected components
+    unsigned componentVisit_;
+    unsigned numComponents_;
+    std::vector<const noRoadNode*> componentTodo_;
 
 public:
-    RoadPathFinder(GameWorldBase& gwb) : gwb_(gwb), currentVisit(0) {}
+    RoadPathFinder(GameWorldBase& gwb)
+        : gwb_(gwb), currentVisit(0), distanceSearchStart_(nullptr), distanceSearchVisit_(0), componentVisit_(0),
+          numComponents_(0)
+    {}
 
     /// Calculates the best path from start to goal
     /// Outputs are only valid if true is returned!
@@ -43,7 +68,34 @@ public:
     bool PathExists(const noRoadNode& start, const noRoadNode& goal, bool allowWaterRoads,
                     unsigned max = std::numeric_limits<unsigned>::max(), const RoadSegment* forbidden = nullptr);
 
+    /// Start a search for the costs of ware paths from start to many goals. Use GetWareDistance to query them.
+    /// Not affected by other searches of this pathfinder
+    void StartWareDistanceSearch(const noRoadNode& start);
+    /// Get the costs of the path from the start of the distance search to the goal if they are at most max.
+    /// Equivalent to FindPath(start, goal, true, max, nullptr, length) but all queries continue the same search
+    bool GetWareDistance(const noRoadNode& goal, unsigned max, unsigned& length);
+
+    /// Find the warehouse with the least costs of the path from start (toWarehouse) or to start (!toWarehouse)
+    /// with a single search for all warehouses.
+    /// Same result as calling FindPath for each warehouse and taking the first one with the least costs.
+    ///
+    /// @param wareMode, forbidden See FindPath
+    /// @param length If != nullptr will receive the final costs
+    nobBaseWarehouse* FindNearestWarehouse(const noRoadNode& start, const std::vector<nobBaseWarehouse*>& warehouses,
+                                           bool toWarehouse, bool wareMode, const RoadSegment* forbidden = nullptr,
+                                           unsigned* length = nullptr);
+
+    /// Forget the connected components of the road network determined by IsConnectedForWares.
+    /// Required whenever the road network changed
+    void ResetWareComponents();
+    /// Check if there is a path for wares between the 2 nodes. Same as FindPath(start, goal, true) succeeding.
+    /// The whole connected component of the start is determined on first use so further queries are cheap
+    /// until the next ResetWareComponents. Not affected by other searches of this pathfinder
+    bool IsConnectedForWares(const noRoadNode& start, const noRoadNode& goal);
+
 private:
+    void IncreaseCurrentVisit();
+    void LabelWareComponent(const noRoadNode& start);
     template<class T_AdditionalCosts, class T_SegmentConstraints>
     bool FindPathImpl(const noRoadNode& start, const noRoadNode& goal, unsigned max, T_AdditionalCosts addCosts,
                       T_SegmentConstraints isSegmentAllowed, unsigned* length = nullptr,
@@ -0,0 +1,62 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "RoadRouteCache.h"
+#include <algorithm>
+
+const RoadRouteCache::Route* RoadRouteCache::Get(const unsigned roadGraphEpoch, const unsigned startId,
+                                                 const unsigned goalId)
+{
+    if(roadGraphEpoch != epoch_)
+    {
+        Clear();
+        epoch_ = roadGraphEpoch;
+    }
+    GoalTable* table = FindTable(goalId);
+    if(table)
+    {
+        table->numUses++;
+        const auto it = table->nextHops.find(startId);
+        if(it != table->nextHops.end())
+        {
+            numHits_++;
+            return &it->second;
+        }
+    }
+    numMisses_++;
+    return nullptr;
+}
+
+void RoadRouteCache::Add(const unsigned startId, const unsigned goalId, const Route& route)
+{
+    GoalTable* table = FindTable(goalId);
+    if(!table)
+    {
+        if(tables_.size() < maxGoals)
+            table = &tables_.emplace_back();
+        else
+        {
+            // Replace the least used goal
+            table = &*std::min_element(tables_.begin(), tables_.end(), [](const GoalTable& lhs, const GoalTable& rhs) {
+                return lhs.numUses < rhs.numUses;
+            });
+            table->nextHops.clear();
+        }
+        table->goalId = goalId;
+        table->numUses = 1;
+    }
+    table->nextHops[startId] = route;
+}
+
+void RoadRouteCache::Clear()
+{
+    tables_.clear();
+}
+
+RoadRouteCache::GoalTable* RoadRouteCache::FindTable(const unsigned goalId)
+{
+    const auto it =
+      std::find_if(tables_.begin(), tables_.end(), [goalId](const GoalTable& table) { return table.goalId == goalId; });
+    return it != tables_.end() ? &*it : nullptr;
+}
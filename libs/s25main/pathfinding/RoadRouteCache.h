@@ -0,0 +1,54 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "gameTypes/MapCoordinates.h"
+#include "gameTypes/RoadPathDirection.h"
+#include <unordered_map>
+#include <vector>
+
+/// Next hops of human paths on roads towards the most used goals of a player.
+/// For each goal a table maps the start node to the result of the road pathfinder for this pair.
+/// The tables are only filled with results of searches, so using the cache never changes the chosen paths.
+/// All of them become invalid when the road network changes which is detected by its epoch (see GameWorldBase)
+class RoadRouteCache
+{
+public:
+    struct Route
+    {
+        /// RoadPathDirection::None if there is no path
+        RoadPathDirection firstDir;
+        MapPoint firstNodePos;
+        unsigned length;
+    };
+
+    /// Maximum number of goals with a table. The least used one is replaced by new goals
+    static constexpr unsigned maxGoals = 32;
+
+    /// Get the route from the start to the goal (object ids of the nodes) or nullptr if it is not known
+    const Route* Get(unsigned roadGraphEpoch, unsigned startId, unsigned goalId);
+    /// Store the route after a search. Must be called with the epoch of the last call to Get
+    void Add(unsigned startId, unsigned goalId, const Route& route);
+    void Clear();
+
+    unsigned GetNumHits() const { return numHits_; }
+    unsigned GetNumMisses() const { return numMisses_; }
+    void ResetCounters() { numHits_ = numMisses_ = 0; }
+
+private:
+    struct GoalTable
+    {
+        unsigned goalId;
+        /// Number of requests for this goal since the table was created
+        unsigned numUses;
+        std::unordered_map<unsigned, Route> nextHops;
+    };
+
+    unsigned epoch_ = 0;
+    std::vector<GoalTable> tables_;
+    unsigned numHits_ = 0, numMisses_ = 0;
+
+    GoalTable* FindTable(unsigned goalId);
+};
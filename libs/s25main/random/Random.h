@@ -6,7 +6,6 @@
 
 #include "RTTR_Assert.h"
 #include "random/XorShift.h"
-#include "s25util/Singleton.h"
 #include <array>
 #include <cstddef>
 #include <limits>
@@ -30,7 +29,7 @@ struct RandomContext
 ///        http://www.boost.org/doc/libs/1_61_0/doc/html/boost_random/reference.html#boost_random.reference.concepts.pseudo_random_number_generator
 /// Additionally it must implement Serialize and Deserialize functions and provide a static GetName function
 template<class T_PRNG>
-class Random : public Singleton<Random<T_PRNG>>
+class Random
 {
 public:
     /// The used random number generator type
@@ -58,6 +57,9 @@ public:
     };
 
     Random();
+    /// Return the instance used by the current thread.
+    /// So games running on different threads (see GameObject::Context) have their own RNG
+    static Random& inst();
     /// Initialize the rng with a given seed
     void Init(const uint64_t& seed);
     /// Reset the Random class to start from a given state
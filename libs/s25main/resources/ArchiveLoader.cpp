@@ -69,8 +69,6 @@ std::map<uint16_t, uint16_t> extractBobMapping(libsiedler2::Archiv& archive, con
 libsiedler2::Archiv ArchiveLoader::loadFile(const fs::path& filePath,
                                             const libsiedler2::ArchivItem_Palette* palette) const
 {
-    logger_.write(_("Loading %1%: ")) % filePath;
-
     libsiedler2::Archiv archive;
     if(int ec = libsiedler2::Load(filePath, archive, palette))
         throw LoadError(libsiedler2::getErrorString(ec));
@@ -81,9 +79,7 @@ libsiedler2::Archiv ArchiveLoader::loadFile(const fs::path& filePath,
 libsiedler2::Archiv ArchiveLoader::loadDirectory(const fs::path& filePath,
                                                  const libsiedler2::ArchivItem_Palette* palette) const
 {
-    logger_.write(_("Loading directory %s\n")) % filePath;
     std::vector<libsiedler2::FileEntry> files = libsiedler2::ReadFolderInfo(filePath);
-    logger_.write(_("  Loading %1% entries: ")) % files.size();
 
     libsiedler2::Archiv archive;
 
@@ -114,12 +110,18 @@ libsiedler2::Archiv ArchiveLoader::loadFileOrDir(const fs::path& filePath,
 
         using namespace std::chrono;
         // TODO: Change translations and use chronoIO
-        logger_.write(_("done in %ums\n")) % duration_cast<milliseconds>(timer.getElapsed()).count();
+        const auto elapsedMs = duration_cast<milliseconds>(timer.getElapsed()).count();
+        std::lock_guard<std::mutex> lock(logMutex_);
+        if(is_directory(fileStatus))
+            logger_.write(_("Loaded directory %1% (%2% entries) in %3%ms\n")) % filePath % result.size() % elapsedMs;
+        else
+            logger_.write(_("Loaded %1% in %2%ms\n")) % filePath % elapsedMs;
 
         return result;
     } catch(const LoadError& e)
     {
-        logger_.write(_("failed: %1%\n")) % e.what();
+        std::lock_guard<std::mutex> lock(logMutex_);
+        logger_.write(_("Loading %1% failed: %2%\n")) % filePath % e.what();
         throw LoadError();
     }
 }
@@ -177,7 +179,10 @@ libsiedler2::Archiv ArchiveLoader::load(const ResolvedFile& file, const libsiedl
         } catch(const LoadError& e)
         {
             if(e.what() != std::string())
+            {
+                std::lock_guard<std::mutex> lock(logMutex_);
                 logger_.write("Exception caught: %1%\n") % e.what();
+            }
             throw LoadError();
         }
     }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <boost/filesystem/path.hpp>
+#include <mutex>
 #include <stdexcept>
 
 class Log;
@@ -24,6 +25,7 @@ public:
     explicit LoadError(T&&... args);
 };
 
+/// Loads archives. Can be used from multiple threads at the same time to load different archives
 class ArchiveLoader
 {
 public:
@@ -37,12 +39,14 @@ public:
     static void mergeArchives(libsiedler2::Archiv& targetArchiv, libsiedler2::Archiv& otherArchiv);
 
 private:
-    /// Load a single file, logs a message without trailing newline on start and throws a LoadError on error.
+    /// Load a single file. Throws a LoadError on error.
     libsiedler2::Archiv loadFile(const boost::filesystem::path& filePath,
                                  const libsiedler2::ArchivItem_Palette* palette) const;
-    /// Load a single file, logs a message without trailing newline on start and throws a LoadError on error.
+    /// Load all files in the directory. Throws a LoadError on error.
     libsiedler2::Archiv loadDirectory(const boost::filesystem::path& filePath,
                                       const libsiedler2::ArchivItem_Palette* palette) const;
 
     Log& logger_;
+    /// Each message is written as a whole line while holding this, so messages of different threads don't mix
+    mutable std::mutex logMutex_;
 };
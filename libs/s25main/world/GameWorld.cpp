@@ -8,14 +8,13 @@
 #include "GamePlayer.h"
 #include "GlobalGameSettings.h"
 #include "RttrForeachPt.h"
+#include "SimulationPhaseTimes.h"
 #include "TradePathCache.h"
 #include "addons/const_addons.h"
 #include "buildings/noBuildingSite.h"
 #include "buildings/nobMilitary.h"
-#include "buildings/nobUsual.h"
 #include "figures/nofAttacker.h"
 #include "figures/nofPassiveSoldier.h"
-#include "figures/nofScout_Free.h"
 #include "helpers/containerUtils.h"
 #include "helpers/mathFuncs.h"
 #include "helpers/reverse.h"
@@ -29,6 +28,7 @@
 #include "postSystem/PostMsgWithBuilding.h"
 #include "world/MapGeometry.h"
 #include "world/TerritoryRegion.h"
+#include "world/VisionMap.h"
 #include "nodeObjs/noFighting.h"
 #include "nodeObjs/noFlag.h"
 #include "nodeObjs/noShip.h"
@@ -304,23 +304,42 @@ void GameWorld::RecalcBorderStones(Position startPt, Extent areaSize)
     std::vector<uint8_t> neighbors(areaSize.x * areaSize.y, 0);
 #endif
 
+    // Border nodes of each player in the current row and the row below it (for the half-way stones to there)
+    const TerritoryBitmaps& territory = GetTerritoryBitmaps();
+    std::vector<std::vector<TerritoryBitmaps::Word>> borderRows(GetNumPlayers()), nextBorderRows(GetNumPlayers());
+    const auto calcBorderRows = [this, &territory](std::vector<std::vector<TerritoryBitmaps::Word>>& rows,
+                                                   const MapCoord y) {
+        for(unsigned i = 0; i < GetNumPlayers(); ++i)
+            territory.GetBorderRow(i + 1, y, rows[i]);
+    };
+
     RTTR_FOREACH_PT(Position, areaSize)
     {
         // Make map point
         const MapPoint curMapPt = MakeMapPoint(pt + startPt);
+        const MapCoord nextY = GetNeighbour(curMapPt, Direction::SouthEast).y;
+        if(pt.x == 0)
+        {
+            if(pt.y == 0)
+                calcBorderRows(nextBorderRows, curMapPt.y);
+            std::swap(borderRows, nextBorderRows);
+            calcBorderRows(nextBorderRows, nextY);
+        }
         const unsigned char owner = GetNode(curMapPt).owner;
         BoundaryStones& boundaryStones = GetBoundaryStones(curMapPt);
 
         // Is this a border node?
-        if(owner && IsBorderNode(curMapPt, owner))
+        if(owner && TerritoryBitmaps::IsSet(borderRows[owner - 1], curMapPt.x))
         {
             // Check which neighbors are also border nodes and place the half-way stones to them
-            for(const auto bPos : helpers::EnumRange<BorderStonePos>{})
+            boundaryStones[BorderStonePos::OnPoint] = owner;
+            for(const auto bPos : {BorderStonePos::HalfEast, BorderStonePos::HalfSouthEast,
+                                   BorderStonePos::HalfSouthWest})
             {
-                if(bPos == BorderStonePos::OnPoint || IsBorderNode(GetNeighbour(curMapPt, toDirection(bPos)), owner))
-                    boundaryStones[bPos] = owner;
-                else
-                    boundaryStones[bPos] = 0;
+                // Neighbours are in the same row (east) or the next one
+                const MapPoint nb = GetNeighbour(curMapPt, toDirection(bPos));
+                const auto& nbBorderRow = (nb.y == curMapPt.y) ? borderRows[owner - 1] : nextBorderRows[owner - 1];
+                boundaryStones[bPos] = TerritoryBitmaps::IsSet(nbBorderRow, nb.x) ? owner : 0;
             }
 
 #ifdef PREVENT_BORDER_STONE_BLOCKING
@@ -392,26 +411,28 @@ void GameWorld::RecalcTerritory(const noBaseBuilding& building, TerritoryChangeR
     const TerritoryRegion region = CreateTerritoryRegion(building, militaryRadius + ADD_RADIUS, reason);
 
     std::vector<MapPoint> ptsWithChangedOwners;
+    // Territory sizes are counted on the bitmaps before and after the change
+    const MapPoint regionStartPt = MakeMapPoint(region.startPt);
+    const MapExtent regionSize(region.size);
     std::vector<int> sizeChanges(GetNumPlayers());
+    for(unsigned i = 0; i < GetNumPlayers(); ++i)
+        sizeChanges[i] = -static_cast<int>(GetTerritoryBitmaps().CountOwned(i + 1, regionStartPt, regionSize));
 
-    // Copy owners from territory region to map and do the bookkeeping
+    // Copy owners from territory region to map
     RTTR_FOREACH_PT(Position, region.size)
     {
         const MapPoint curMapPt = MakeMapPoint(pt + region.startPt);
-        const uint8_t oldOwner = GetNode(curMapPt).owner;
         const uint8_t newOwner = region.GetOwner(pt);
 
         // If nothing changed, there is nothing to do (ownerChanged was already initialized)
-        if(oldOwner == newOwner)
+        if(GetNode(curMapPt).owner == newOwner)
             continue;
 
         SetOwner(curMapPt, newOwner);
         ptsWithChangedOwners.push_back(curMapPt);
-        if(newOwner != 0)
-            sizeChanges[newOwner - 1]++;
-        if(oldOwner != 0)
-            sizeChanges[oldOwner - 1]--;
     }
+    for(unsigned i = 0; i < GetNumPlayers(); ++i)
+        sizeChanges[i] += GetTerritoryBitmaps().CountOwned(i + 1, regionStartPt, regionSize);
 
     const std::vector<MapPoint> ptsToHandle = GetAllNeighboursUnion(ptsWithChangedOwners);
 
@@ -1041,97 +1062,9 @@ bool GameWorld::IsValidPointForFighting(MapPoint pt, const nofActiveSoldier& sol
 bool GameWorld::IsPointCompletelyVisible(const MapPoint& pt, unsigned char player,
                                          const noBaseBuilding* exception) const
 {
-    sortedMilitaryBlds buildings = LookForMilitaryBuildings(pt, 3);
-
-    // Sichtbereich von Militärgebäuden
-    for(const nobBaseMilitary* milBld : buildings)
-    {
-        if(milBld->GetPlayer() == player && milBld != exception)
-        {
-            // Prüfen, obs auch unbesetzt ist
-            if(milBld->GetGOT() == GO_Type::NobMilitary)
-            {
-                if(static_cast<const nobMilitary*>(milBld)->IsNewBuilt())
-                    continue;
-            }
-
-            if(CalcDistance(pt, milBld->GetPos()) <= unsigned(milBld->GetMilitaryRadius() + VISUALRANGE_MILITARY))
-                return true;
-        }
-    }
-
-    // Sichtbereich von Hafenbaustellen
-    for(const noBuildingSite* bldSite : harbor_building_sites_from_sea)
-    {
-        if(bldSite->GetPlayer() == player && bldSite != exception)
-        {
-            if(CalcDistance(pt, bldSite->GetPos()) <= unsigned(HARBOR_RADIUS + VISUALRANGE_MILITARY))
-                return true;
-        }
-    }
-
-    // Sichtbereich von Spähtürmen
-    for(const nobUsual* bld : GetPlayer(player).GetBuildingRegister().GetBuildings(BuildingType::LookoutTower)) //-V807
-    {
-        // Ist Späturm überhaupt besetzt?
-        if(!bld->HasWorker())
-            continue;
-
-        // Nicht die Ausnahme wählen
-        if(bld == exception)
-            continue;
-
-        // Liegt Spähturm innerhalb des Sichtradius?
-        if(CalcDistance(pt, bld->GetPos()) <= VISUALRANGE_LOOKOUTTOWER)
-            return true;
-    }
-
-    // Check scouts and soldiers
-    const unsigned range = std::max(VISUALRANGE_SCOUT, VISUALRANGE_SOLDIER);
-    if(CheckPointsInRadius(
-         pt, range,
-         [this, player](auto pt, auto distance) { return this->IsScoutingFigureOnNode(pt, player, distance); }, true))
-    {
-        return true;
-    }
-    return IsPointScoutedByShip(pt, player);
-}
-
-bool GameWorld::IsScoutingFigureOnNode(const MapPoint& pt, unsigned player, unsigned distance) const
-{
-    static_assert(VISUALRANGE_SCOUT >= VISUALRANGE_SOLDIER, "Visual range changed. Check loop below!");
-
-    // Späher/Soldaten in der Nähe prüfen und direkt auf dem Punkt
-    for(const noBase& obj : GetFigures(pt))
-    {
-        const GO_Type got = obj.GetGOT();
-        // Check for scout. Note: no need to check for distance as scouts have higher distance than soldiers
-        if(got == GO_Type::NofScoutFree)
-        {
-            // Prüfen, ob er auch am Erkunden ist und an der Position genau und ob es vom richtigen Spieler ist
-            if(static_cast<const nofScout_Free&>(obj).GetPlayer() == player)
-                return true;
-            else
-                continue;
-        } else if(distance <= VISUALRANGE_SOLDIER)
-        {
-            // Soldaten?
-            if(got == GO_Type::NofAttacker || got == GO_Type::NofAggressivedefender)
-            {
-                if(static_cast<const nofActiveSoldier&>(obj).GetPlayer() == player)
-                    return true;
-            }
-            // Kämpfe (wo auch Soldaten drin sind)
-            else if(got == GO_Type::Fighting)
-            {
-                // Prüfen, ob da ein Soldat vom angegebenen Spieler dabei ist
-                if(static_cast<const noFighting&>(obj).IsSoldierOfPlayer(player))
-                    return true;
-            }
-        }
-    }
-
-    return false;
+    // Military buildings, harbor building sites, lookout towers, scouts and soldiers are counted in the vision map.
+    // Ships are few and move every GF so they are checked directly
+    return GetVisionMap().IsVisible(pt, player, exception) || IsPointScoutedByShip(pt, player);
 }
 
 bool GameWorld::IsPointScoutedByShip(const MapPoint& pt, unsigned player) const
@@ -1149,7 +1082,7 @@ bool GameWorld::IsPointScoutedByShip(const MapPoint& pt, unsigned player) const
 void GameWorld::RecalcVisibility(const MapPoint pt, const unsigned char player, const noBaseBuilding* const exception)
 {
     /// Zustand davor merken
-    Visibility visibility_before = GetNode(pt).fow[player].visibility;
+    Visibility visibility_before = GetFoWNode(pt, player).visibility;
 
     /// Herausfinden, ob vollständig sichtbar
     bool visible = IsPointCompletelyVisible(pt, player, exception);
@@ -1189,16 +1122,16 @@ void GameWorld::MakeVisible(const MapPoint pt, const unsigned char player)
 void GameWorld::RecalcVisibilitiesAroundPoint(const MapPoint pt, const MapCoord radius, const unsigned char player,
                                               const noBaseBuilding* const exception)
 {
-    std::vector<MapPoint> pts = GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& pt : pts)
-        RecalcVisibility(pt, player, exception);
+    SimulationPhaseTimer timer(SimulationPhase::Visibility);
+    for(const MapPoint curPt : PointsInRadius(pt, radius, true))
+        RecalcVisibility(curPt, player, exception);
 }
 
 /// Setzt die Sichtbarkeiten um einen Punkt auf sichtbar (aus Performancegründen Alternative zu oberem)
 void GameWorld::MakeVisibleAroundPoint(const MapPoint pt, const MapCoord radius, const unsigned char player)
 {
-    std::vector<MapPoint> pts = GetPointsInRadiusWithCenter(pt, radius);
-    for(const MapPoint& curPt : pts)
+    SimulationPhaseTimer timer(SimulationPhase::Visibility);
+    for(const MapPoint curPt : PointsInRadius(pt, radius, true))
         MakeVisible(curPt, player);
 }
 
@@ -1207,6 +1140,7 @@ void GameWorld::MakeVisibleAroundPoint(const MapPoint pt, const MapCoord radius,
 void GameWorld::RecalcMovingVisibilities(const MapPoint pt, const unsigned char player, const MapCoord radius,
                                          const Direction moving_dir, MapPoint* enemy_territory)
 {
+    SimulationPhaseTimer timer(SimulationPhase::Visibility);
     // Neue Sichtbarkeiten zuerst setzen
     // Zum Eckpunkt der beiden neuen sichtbaren Kanten gehen
     MapPoint t(pt);
@@ -1223,7 +1157,7 @@ void GameWorld::RecalcMovingVisibilities(const MapPoint pt, const unsigned char
         // Sichtbarkeit und für FOW-Gebiet vorherigen Besitzer merken
         // (d.h. der dort  zuletzt war, als es für Spieler player sichtbar war)
         Visibility old_vis = CalcVisiblityWithAllies(tt, player);
-        unsigned char old_owner = GetNode(tt).fow[player].owner;
+        unsigned char old_owner = GetFoWNode(tt, player).owner;
         MakeVisible(tt, player);
         // Neues feindliches Gebiet entdeckt?
         // Muss vorher undaufgedeckt oder FOW gewesen sein, aber in dem Fall darf dort vorher noch kein
@@ -1247,7 +1181,7 @@ void GameWorld::RecalcMovingVisibilities(const MapPoint pt, const unsigned char
         // Sichtbarkeit und für FOW-Gebiet vorherigen Besitzer merken
         // (d.h. der dort  zuletzt war, als es für Spieler player sichtbar war)
         Visibility old_vis = CalcVisiblityWithAllies(tt, player);
-        unsigned char old_owner = GetNode(tt).fow[player].owner;
+        unsigned char old_owner = GetFoWNode(tt, player).owner;
         MakeVisible(tt, player);
         // Neues feindliches Gebiet entdeckt?
         // Muss vorher undaufgedeckt oder FOW gewesen sein, aber in dem Fall darf dort vorher noch kein
@@ -1401,10 +1335,18 @@ bool GameWorld::FoundColony(const unsigned harbor_point, const unsigned char pla
     return true;
 }
 
+void GameWorld::AddHarborBuildingSiteFromSea(noBuildingSite* building_site)
+{
+    harbor_building_sites_from_sea.push_back(building_site);
+    GetVisionMap().AddObjectViewer(*building_site, building_site->GetPos(), HARBOR_RADIUS + VISUALRANGE_MILITARY,
+                                   building_site->GetPlayer());
+}
+
 void GameWorld::RemoveHarborBuildingSiteFromSea(noBuildingSite* building_site)
 {
     RTTR_Assert(building_site->GetBuildingType() == BuildingType::HarborBuilding);
     harbor_building_sites_from_sea.remove(building_site);
+    GetVisionMap().RemoveObjectViewer(*building_site);
 }
 
 bool GameWorld::IsHarborBuildingSiteFromSea(const noBuildingSite* building_site) const
@@ -38,9 +38,6 @@ class GameWorld : public GameWorldBase
     bool HasRemovableObjForRoad(MapPoint pt) const;
 
     bool IsPointCompletelyVisible(const MapPoint& pt, unsigned char player, const noBaseBuilding* exception) const;
-    /// Return if there is a scout (or an attacking soldier) of this player at that node with a visual range of at most
-    /// the given distance. Excludes scouting ships!
-    bool IsScoutingFigureOnNode(const MapPoint& pt, unsigned player, unsigned distance) const;
     /// Return true, if the point is explored by any ship of the player
     bool IsPointScoutedByShip(const MapPoint& pt, unsigned player) const;
     /// Berechnet die Sichtbarkeit eines Punktes neu für den angegebenen Spieler
@@ -157,10 +154,7 @@ public:
     /// Gründet vom Schiff aus eine neue Kolonie, gibt true zurück bei Erfolg
     bool FoundColony(unsigned harbor_point, unsigned char player, unsigned short seaId);
     /// Registriert eine Baustelle eines Hafens, die vom Schiff aus gesetzt worden ist
-    void AddHarborBuildingSiteFromSea(noBuildingSite* building_site)
-    {
-        harbor_building_sites_from_sea.push_back(building_site);
-    }
+    void AddHarborBuildingSiteFromSea(noBuildingSite* building_site);
     /// Removes it. It is allowed to be called with a regular harbor building site (no-op in that case)
     void RemoveHarborBuildingSiteFromSea(noBuildingSite* building_site);
     /// Gibt zurück, ob eine bestimmte Baustellen eine Baustelle ist, die vom Schiff aus errichtet wurde
@@ -170,6 +164,7 @@ public:
 
     /// Writeable access to node. Use only for initial map setup!
     MapNode& GetNodeWriteable(MapPoint pt);
+    FoWNode& GetFoWNodeWriteable(MapPoint pt, unsigned player) { return GetFoWNodeInt(pt, player); }
     /// Recalculates where border stones should be done after a change in the given region
     void RecalcBorderStones(Position startPt, Extent areaSize);
 
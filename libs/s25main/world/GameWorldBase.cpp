@@ -12,8 +12,10 @@
 #include "SoundManager.h"
 #include "TradePathCache.h"
 #include "addons/const_addons.h"
+#include "buildings/noBuildingSite.h"
 #include "buildings/nobHarborBuilding.h"
 #include "buildings/nobMilitary.h"
+#include "buildings/nobUsual.h"
 #include "figures/nofPassiveSoldier.h"
 #include "helpers/EnumRange.h"
 #include "helpers/containerUtils.h"
@@ -22,16 +24,19 @@
 #include "notifications/PlayerNodeNote.h"
 #include "pathfinding/FreePathFinder.h"
 #include "pathfinding/RoadPathFinder.h"
+#include "world/VisionMap.h"
 #include "nodeObjs/noFlag.h"
 #include "gameData/BuildingProperties.h"
 #include "gameData/GameConsts.h"
+#include "gameData/MilitaryConsts.h"
 #include "gameData/TerrainDesc.h"
 #include <utility>
 
 GameWorldBase::GameWorldBase(std::vector<GamePlayer> players, const GlobalGameSettings& gameSettings, EventManager& em)
-    : roadPathFinder(new RoadPathFinder(*this)), freePathFinder(new FreePathFinder(*this)), players(std::move(players)),
-      gameSettings(gameSettings), em(em), soundManager(std::make_unique<SoundManager>()), lua(nullptr),
-      cheats(std::make_unique<Cheats>(*this)), gi(nullptr)
+    : World(players.size()), roadPathFinder(new RoadPathFinder(*this)), roadGraphEpoch(0),
+      freePathFinder(new FreePathFinder(*this)), visionMap(std::make_unique<VisionMap>(*this)),
+      players(std::move(players)), gameSettings(gameSettings), em(em), soundManager(std::make_unique<SoundManager>()),
+      lua(nullptr), cheats(std::make_unique<Cheats>(*this)), gi(nullptr)
 {}
 
 GameWorldBase::~GameWorldBase() = default;
@@ -41,12 +46,54 @@ void GameWorldBase::Init(const MapExtent& mapSize, DescIdx<LandscapeDesc> lt)
     RTTR_Assert(GetDescription().terrain.size() > 0); // Must have game data initialized
     World::Init(mapSize, lt);
     freePathFinder->Init(mapSize);
+    visionMap->Init(mapSize, GetNumPlayers());
 }
 
 void GameWorldBase::InitAfterLoad()
 {
     RTTR_FOREACH_PT(MapPoint, GetSize())
         RecalcBQ(pt);
+    RecalcVisionMap();
+    RecalcDigest();
+    // Loaded road nodes may reuse object ids of nodes cached before
+    RoadGraphChanged();
+}
+
+void GameWorldBase::RecalcVisionMap()
+{
+    visionMap->Clear();
+    for(unsigned i = 0; i < GetNumPlayers(); ++i)
+    {
+        const auto player = static_cast<unsigned char>(i);
+        const BuildingRegister& buildings = GetPlayer(i).GetBuildingRegister();
+        for(const nobMilitary* bld : buildings.GetMilitaryBuildings())
+        {
+            if(!bld->IsNewBuilt())
+                visionMap->AddObjectViewer(*bld, bld->GetPos(), bld->GetMilitaryRadius() + VISUALRANGE_MILITARY,
+                                           player);
+        }
+        for(const nobHarborBuilding* bld : buildings.GetHarbors())
+            visionMap->AddObjectViewer(*bld, bld->GetPos(), bld->GetMilitaryRadius() + VISUALRANGE_MILITARY, player);
+        for(const nobBaseWarehouse* bld : buildings.GetStorehouses())
+        {
+            if(bld->GetGOT() == GO_Type::NobHq)
+                visionMap->AddObjectViewer(*bld, bld->GetPos(), bld->GetMilitaryRadius() + VISUALRANGE_MILITARY,
+                                           player);
+        }
+        for(const nobUsual* bld : buildings.GetBuildings(BuildingType::LookoutTower))
+        {
+            if(bld->HasWorker())
+                visionMap->AddObjectViewer(*bld, bld->GetPos(), VISUALRANGE_LOOKOUTTOWER, player);
+        }
+    }
+    for(const noBuildingSite* bldSite : harbor_building_sites_from_sea)
+        visionMap->AddObjectViewer(*bldSite, bldSite->GetPos(), HARBOR_RADIUS + VISUALRANGE_MILITARY,
+                                   bldSite->GetPlayer());
+    RTTR_FOREACH_PT(MapPoint, GetSize())
+    {
+        for(const noBase& fig : GetFigures(pt))
+            visionMap->AddFigure(pt, fig);
+    }
 }
 
 GamePlayer& GameWorldBase::GetPlayer(const unsigned id)
@@ -283,6 +330,26 @@ void GameWorldBase::AltitudeChanged(const MapPoint pt)
     GetNotifications().publish(NodeNote(NodeNote::Altitude, pt));
 }
 
+void GameWorldBase::NodeChanged(const MapPoint pt)
+{
+    freePathFinder->NodeChanged(pt);
+}
+
+void GameWorldBase::FigureAdded(const MapPoint pt, const noBase& fig)
+{
+    visionMap->AddFigure(pt, fig);
+}
+
+void GameWorldBase::FigureRemoved(const MapPoint pt, const noBase& fig)
+{
+    visionMap->RemoveFigure(pt, fig);
+}
+
+void GameWorldBase::FigureMoved(const MapPoint from, const MapPoint to, const noBase& fig)
+{
+    visionMap->MoveFigure(from, to, fig);
+}
+
 void GameWorldBase::RecalcBQAroundPoint(const MapPoint pt)
 {
     RecalcBQ(pt);
@@ -301,8 +368,7 @@ void GameWorldBase::RecalcBQAroundPointBig(const MapPoint pt)
 
 Visibility GameWorldBase::CalcVisiblityWithAllies(const MapPoint pt, const unsigned char player) const
 {
-    const MapNode& node = GetNode(pt);
-    Visibility best_visibility = node.fow[player].visibility;
+    Visibility best_visibility = GetFoWNode(pt, player).visibility;
 
     if(best_visibility == Visibility::Visible)
         return best_visibility;
@@ -316,8 +382,8 @@ Visibility GameWorldBase::CalcVisiblityWithAllies(const MapPoint pt, const unsig
         {
             if(i != player && curPlayer.IsAlly(i))
             {
-                if(node.fow[i].visibility > best_visibility)
-                    best_visibility = node.fow[i].visibility;
+                if(GetFoWNode(pt, i).visibility > best_visibility)
+                    best_visibility = GetFoWNode(pt, i).visibility;
             }
         }
     }
@@ -590,7 +656,7 @@ unsigned GameWorldBase::GetNumSoldiersForSeaAttackAtSea(const unsigned char play
     std::vector<nobHarborBuilding::SeaAttackerBuilding> buildings;
     unsigned attackercount = 0;
     // Angrenzende Häfen des Angreifers an den entsprechenden Meeren herausfinden
-    const std::list<nobHarborBuilding*>& harbors = GetPlayer(player_attacker).GetBuildingRegister().GetHarbors();
+    const std::vector<nobHarborBuilding*>& harbors = GetPlayer(player_attacker).GetBuildingRegister().GetHarbors();
     for(auto* harbor : harbors)
     {
         // Bestimmen, ob Hafen an einem der Meere liegt, über die sich auch die gegnerischen
@@ -646,7 +712,7 @@ GameWorldBase::GetSoldiersForSeaAttack(const unsigned char player_attacker, cons
     std::vector<nobHarborBuilding::SeaAttackerBuilding> buildings;
 
     // Angrenzende Häfen des Angreifers an den entsprechenden Meeren herausfinden
-    const std::list<nobHarborBuilding*>& harbors = GetPlayer(player_attacker).GetBuildingRegister().GetHarbors();
+    const std::vector<nobHarborBuilding*>& harbors = GetPlayer(player_attacker).GetBuildingRegister().GetHarbors();
     for(auto* harbor : harbors)
     {
         // Bestimmen, ob Hafen an einem der Meere liegt, über die sich auch die gegnerischen
@@ -714,8 +780,8 @@ void GameWorldBase::RecalcBQ(const MapPoint pt)
 
 void GameWorldBase::SetComputerBarrier(const MapPoint& pt, unsigned radius)
 {
-    for(const auto& pt : GetPointsInRadiusWithCenter(pt, radius))
-        ptsInsideComputerBarriers.insert(pt);
+    for(const MapPoint curPt : PointsInRadius(pt, radius, true))
+        ptsInsideComputerBarriers.insert(curPt);
 }
 
 bool GameWorldBase::IsInsideComputerBarrier(const MapPoint& pt) const
@@ -13,6 +13,7 @@
 #include "postSystem/PostManager.h"
 #include "world/World.h"
 #include <memory>
+#include <mutex>
 #include <set>
 #include <vector>
 
@@ -29,6 +30,7 @@ class nofPassiveSoldier;
 class RoadPathFinder;
 class SoundManager;
 class TradePathCache;
+class VisionMap;
 
 constexpr Direction getOppositeDir(const RoadDir roadDir) noexcept
 {
@@ -52,7 +54,12 @@ constexpr Direction toDirection(const RoadDir roadDir) noexcept
 class GameWorldBase : public World
 {
     std::unique_ptr<RoadPathFinder> roadPathFinder;
+    /// Increased on every change of the road network. Invalidates the road route caches of the players
+    unsigned roadGraphEpoch;
     std::unique_ptr<FreePathFinder> freePathFinder;
+    /// The path finders store their state in the world, so only 1 search may run at a time (see PathfindingLock)
+    mutable std::mutex pathfindingMutex;
+    std::unique_ptr<VisionMap> visionMap;
     PostManager postManager;
     mutable NotificationManager notifications;
 
@@ -127,7 +134,13 @@ public:
     bool FindShipPath(MapPoint start, MapPoint dest, unsigned maxDistance, std::vector<Direction>* route,
                       unsigned* length);
     RoadPathFinder& GetRoadPathFinder() const { return *roadPathFinder; }
+    /// Must be called whenever the routes of a road node or the harbors of a player change
+    void RoadGraphChanged() { ++roadGraphEpoch; }
+    unsigned GetRoadGraphEpoch() const { return roadGraphEpoch; }
     FreePathFinder& GetFreePathFinder() const { return *freePathFinder; }
+    /// Mutex to lock when searching paths from multiple threads (see PathfindingLock)
+    std::mutex& GetPathfindingMutex() const { return pathfindingMutex; }
+    VisionMap& GetVisionMap() const { return *visionMap; }
 
     /// Return flag that is on road at given point. dir will be set to the direction of the road from the returned flag
     /// prevDir (if set) will be skipped when searching for the road points
@@ -235,8 +248,15 @@ protected:
     void VisibilityChanged(MapPoint pt, unsigned player, Visibility oldVis, Visibility newVis) override;
     /// Called, when the altitude of a point was changed
     void AltitudeChanged(MapPoint pt) override;
+    /// Called when the object or a road at a point was changed
+    void NodeChanged(MapPoint pt) override;
+    void FigureAdded(MapPoint pt, const noBase& fig) override;
+    void FigureRemoved(MapPoint pt, const noBase& fig) override;
+    void FigureMoved(MapPoint from, MapPoint to, const noBase& fig) override;
 
 private:
+    /// Add the viewers of all vision sources to the vision map (e.g. after loading a savegame)
+    void RecalcVisionMap();
     /// Returns the harbor ID of the next matching harbor in the given direction (0 = None)
     /// T_IsHarborOk must be a predicate taking a harbor Id and returning a bool if the harbor is valid to return
     template<typename T_IsHarborOk>
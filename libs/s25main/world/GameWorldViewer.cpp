@@ -309,8 +309,7 @@ const FOWObject* GameWorldViewer::GetYoungestFOWObject(const MapPoint pos) const
 /// with the local player via team view
 const FoWNode& GameWorldViewer::GetYoungestFOWNode(const MapPoint pos) const
 {
-    const MapNode& node = GetWorld().GetNode(pos);
-    const FoWNode* bestNode = &node.fow[playerId_];
+    const FoWNode* bestNode = &GetWorld().GetFoWNode(pos, playerId_);
     unsigned youngest_time = bestNode->last_update_time;
 
     // Shared team view enabled?
@@ -323,7 +322,7 @@ const FoWNode& GameWorldViewer::GetYoungestFOWNode(const MapPoint pos) const
             if(!player.IsAlly(i))
                 continue;
             // Has the player FOW at this point at all?
-            const FoWNode* curNode = &node.fow[i];
+            const FoWNode* curNode = &GetWorld().GetFoWNode(pos, i);
             if(curNode->visibility == Visibility::FogOfWar)
             {
                 // Younger than the youngest or no object at all?
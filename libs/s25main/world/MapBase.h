@@ -11,6 +11,8 @@
 #include "gameTypes/MapCoordinates.h"
 #include "gameTypes/ShipDirection.h"
 #include <array>
+#include <cstddef>
+#include <iterator>
 #include <vector>
 
 struct AlwaysTrue
@@ -30,6 +32,74 @@ template<typename T_TransformPt>
 using GetPointsResult_t = std::vector<decltype(std::declval<T_TransformPt>()(MapPoint{}, unsigned{}))>;
 }
 
+class MapBase;
+
+/// Range of the points in a radius around a center point, optionally restricted to rings with a minimum radius.
+/// The points are computed while iterating, so no memory is allocated.
+/// Order is the same as for MapBase::GetPointsInRadius: Center (if included), then ring by ring starting at the west
+class MapPointsInRadius
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = MapPoint;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const MapPoint*;
+        using reference = const MapPoint&;
+
+        iterator() = default;
+
+        reference operator*() const { return curPt_; }
+        pointer operator->() const { return &curPt_; }
+        /// Distance of the current point to the center
+        unsigned GetRadius() const { return curRadius_; }
+        iterator& operator++();
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        /// Only iterators of the same range are comparable
+        bool operator==(const iterator& rhs) const
+        {
+            return curRadius_ == rhs.curRadius_ && ringIdx_ == rhs.ringIdx_;
+        }
+        bool operator!=(const iterator& rhs) const { return !(*this == rhs); }
+
+    private:
+        friend class MapPointsInRadius;
+        iterator(const MapBase& map, MapPoint center, unsigned minRadius, unsigned maxRadius);
+        /// Go to the first point of the next ring
+        void NextRing();
+
+        const MapBase* map_ = nullptr;
+        /// First (western most) point of the current ring and the current point
+        MapPoint curStartPt_, curPt_;
+        unsigned curRadius_ = 0, maxRadius_ = 0;
+        /// Index of the current point on the current ring
+        unsigned ringIdx_ = 0;
+    };
+    using const_iterator = iterator;
+
+    MapPointsInRadius(const MapBase& map, MapPoint center, unsigned minRadius, unsigned maxRadius)
+        : map_(map), center_(center), minRadius_(minRadius), maxRadius_(maxRadius)
+    {}
+
+    iterator begin() const { return iterator(map_, center_, minRadius_, maxRadius_); }
+    iterator end() const;
+    /// Number of points in the range
+    unsigned size() const;
+    bool empty() const { return minRadius_ > maxRadius_; }
+
+private:
+    const MapBase& map_;
+    MapPoint center_;
+    unsigned minRadius_, maxRadius_;
+};
+
 /// Base class for a map. A map has a size and functions for getting from one point to another in that map
 class MapBase
 {
@@ -84,6 +154,18 @@ public:
     {
         return GetPointsInRadius(pt, radius, ReturnMapPoint{}, AlwaysTrue{}, true);
     }
+    /// Return a range of all points in a radius around pt (excluding pt unless includePt is true)
+    /// Same as GetPointsInRadius(WithCenter) but without allocating memory.
+    /// Usage: for(const MapPoint p : PointsInRadius(pt, radius))
+    MapPointsInRadius PointsInRadius(MapPoint pt, unsigned radius, bool includePt = false) const
+    {
+        return MapPointsInRadius(*this, pt, includePt ? 0 : 1, radius);
+    }
+    /// Return a range of all points with exactly the given distance to pt
+    MapPointsInRadius PointsOnRing(MapPoint pt, unsigned radius) const
+    {
+        return MapPointsInRadius(*this, pt, radius, radius);
+    }
     /// Returns true, if the IsValid functor returns true for any point in the given radius
     /// If includePt is true, then the point itself is also checked
     template<class T_IsValidPt>
@@ -115,6 +197,65 @@ inline unsigned MapBase::GetIdx(const MapPoint pt) const
     return static_cast<unsigned>(pt.y) * size_.x + pt.x;
 }
 
+inline MapPointsInRadius::iterator::iterator(const MapBase& map, const MapPoint center, const unsigned minRadius,
+                                             const unsigned maxRadius)
+    : map_(&map), curStartPt_(center), curPt_(center), curRadius_(minRadius), maxRadius_(maxRadius)
+{
+    if(curRadius_ > maxRadius_)
+    {
+        // Empty range -> end
+        curRadius_ = maxRadius_ + 1;
+        return;
+    }
+    for(unsigned r = 0; r < minRadius; ++r)
+        curStartPt_ = map.GetNeighbour(curStartPt_, Direction::West);
+    curPt_ = curStartPt_;
+}
+
+inline MapPointsInRadius::iterator& MapPointsInRadius::iterator::operator++()
+{
+    // The center is a ring with only 1 point
+    if(curRadius_ == 0)
+    {
+        NextRing();
+        return *this;
+    }
+    // Go r steps in one direction, turn right and repeat. Start going NE from the west most point
+    const Direction dir = Direction::NorthEast + ringIdx_ / curRadius_;
+    if(++ringIdx_ == 6u * curRadius_)
+        NextRing();
+    else
+        curPt_ = map_->GetNeighbour(curPt_, dir);
+    return *this;
+}
+
+inline void MapPointsInRadius::iterator::NextRing()
+{
+    ringIdx_ = 0;
+    if(++curRadius_ > maxRadius_)
+        return;
+    // Go one level/hull to the left
+    curStartPt_ = map_->GetNeighbour(curStartPt_, Direction::West);
+    curPt_ = curStartPt_;
+}
+
+inline MapPointsInRadius::iterator MapPointsInRadius::end() const
+{
+    iterator result;
+    result.curRadius_ = maxRadius_ + 1;
+    return result;
+}
+
+inline unsigned MapPointsInRadius::size() const
+{
+    if(empty())
+        return 0;
+    // Every ring with radius r > 0 has 6 * r points, so with the gauss formula there are 3 * r * (r + 1) points
+    // in the rings 1..r
+    const unsigned firstRing = (minRadius_ == 0) ? 1 : minRadius_;
+    return (minRadius_ == 0 ? 1u : 0u) + 3u * (maxRadius_ * (maxRadius_ + 1) - (firstRing - 1) * firstRing);
+}
+
 template<int T_maxResults, class T_TransformPt, class T_IsValidPt>
 detail::GetPointsResult_t<T_TransformPt> MapBase::GetPointsInRadius(const MapPoint pt, unsigned radius,
                                                                     T_TransformPt&& transformPt, T_IsValidPt&& isValid,
@@ -119,10 +119,10 @@ void MapLoader::SetMapExplored(World& world)
     RTTR_FOREACH_PT(MapPoint, world.GetSize())
     {
         // For every player
-        for(unsigned i = 0; i < MAX_PLAYERS; ++i)
+        for(unsigned i = 0; i < world.GetNumFoWPlayers(); ++i)
         {
             // If we have FoW here, save it
-            if(world.GetNode(pt).fow[i].visibility == Visibility::FogOfWar)
+            if(world.GetFoWNode(pt, i).visibility == Visibility::FogOfWar)
                 world.SaveFOWNode(pt, i, 0);
         }
     }
@@ -198,13 +198,14 @@ bool MapLoader::InitNodes(const libsiedler2::ArchivItem_Map& map, Exploration ex
         }
 
         // FOW-Zeug initialisieren
-        for(auto& fow : node.fow)
+        for(unsigned i = 0; i < world_.GetNumFoWPlayers(); ++i)
         {
+            FoWNode& fow = world_.GetFoWNodeInt(pt, i);
             fow = FoWNode();
             fow.visibility = fowVisibility;
         }
 
-        RTTR_Assert(node.figures.empty());
+        RTTR_Assert(world_.GetFigures(pt).empty());
     }
     return true;
 }
@@ -22,10 +22,13 @@ void MapSerializer::Serialize(const GameWorldBase& world, SerializedGameData& sg
     sgd.PushUnsignedInt(GameObject::GetObjIDCounter());
 
     // Alle Weltpunkte serialisieren
-    const unsigned numPlayers = world.GetNumPlayers();
-    for(const auto& node : world.nodes)
+    RTTR_Assert(world.GetNumFoWPlayers() == world.GetNumPlayers());
+    std::vector<const FoWNode*> fow(world.GetNumFoWPlayers());
+    for(unsigned idx = 0; idx < world.nodes.size(); ++idx)
     {
-        node.Serialize(sgd, numPlayers, world.GetDescription());
+        for(unsigned player = 0; player < fow.size(); ++player)
+            fow[player] = &world.fowNodes[player][idx];
+        world.nodes[idx].Serialize(sgd, world.GetDescription(), fow, world.figures[idx]);
     }
 
     // Katapultsteine serialisieren
@@ -121,10 +124,14 @@ void MapSerializer::Deserialize(GameWorldBase& world, SerializedGameData& sgd, G
     }
     // Alle Weltpunkte
     MapPoint curPos(0, 0);
-    const unsigned numPlayers = world.GetNumPlayers();
-    for(auto& node : world.nodes)
+    RTTR_Assert(world.GetNumFoWPlayers() == world.GetNumPlayers());
+    std::vector<FoWNode*> fow(world.GetNumFoWPlayers());
+    for(unsigned idx = 0; idx < world.nodes.size(); ++idx)
     {
-        node.Deserialize(sgd, numPlayers, world.GetDescription(), landscapeTerrains);
+        for(unsigned player = 0; player < fow.size(); ++player)
+            fow[player] = &world.fowNodes[player][idx];
+        MapNode& node = world.nodes[idx];
+        node.Deserialize(sgd, world.GetDescription(), landscapeTerrains, fow, world.figures[idx]);
         if(node.harborId)
         {
             HarborPos p(curPos);
@@ -137,6 +144,7 @@ void MapSerializer::Deserialize(GameWorldBase& world, SerializedGameData& sgd, G
             curPos.y++;
         }
     }
+    world.RecalcTerritoryBitmaps();
 
     // Katapultsteine deserialisieren
     sgd.PopObjectContainer(world.catapult_stones, GO_Type::Catapultstone);
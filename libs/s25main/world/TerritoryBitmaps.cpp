@@ -0,0 +1,165 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "TerritoryBitmaps.h"
+#include <RTTR_Assert.h>
+#include <algorithm>
+#include <bitset>
+
+namespace {
+using Word = TerritoryBitmaps::Word;
+constexpr unsigned bitsPerWord = TerritoryBitmaps::bitsPerWord;
+
+bool isSet(const Word* row, const unsigned x)
+{
+    return ((row[x / bitsPerWord] >> (x % bitsPerWord)) & 1u) != 0;
+}
+
+/// Word idx of the row shifted such that bit x contains bit x-1 (the west neighbour), wrapping around at width
+Word fromWest(const Word* row, const unsigned idx, const unsigned width)
+{
+    const Word carry = idx > 0 ? row[idx - 1] >> (bitsPerWord - 1) : Word(isSet(row, width - 1));
+    return (row[idx] << 1) | carry;
+}
+
+/// Word idx of the row shifted such that bit x contains bit x+1 (the east neighbour), wrapping around at width
+Word fromEast(const Word* row, const unsigned idx, const unsigned numWords, const unsigned width)
+{
+    Word result = row[idx] >> 1;
+    if(idx + 1 < numWords)
+        result |= row[idx + 1] << (bitsPerWord - 1);
+    else
+        result |= (row[0] & 1u) << ((width - 1) % bitsPerWord);
+    return result;
+}
+
+/// Mask of bits [first, first + num) of a word
+Word getMask(const unsigned first, const unsigned num)
+{
+    const Word bits = (num >= bitsPerWord) ? ~Word(0) : (Word(1) << num) - 1u;
+    return bits << first;
+}
+} // namespace
+
+void TerritoryBitmaps::Init(const MapExtent& mapSize)
+{
+    size_ = mapSize;
+    wordsPerRow_ = (mapSize.x + bitsPerWord - 1) / bitsPerWord;
+    Clear();
+}
+
+void TerritoryBitmaps::Clear()
+{
+    for(std::vector<Word>& bitmap : bitmaps_)
+        bitmap.clear();
+}
+
+void TerritoryBitmaps::ChangeOwner(const MapPoint pt, const unsigned char oldOwner, const unsigned char newOwner)
+{
+    if(oldOwner == newOwner)
+        return;
+    const unsigned idx = pt.y * wordsPerRow_ + pt.x / bitsPerWord;
+    const Word mask = Word(1) << (pt.x % bitsPerWord);
+    if(oldOwner)
+    {
+        RTTR_Assert(IsOwned(pt, oldOwner));
+        bitmaps_[oldOwner - 1][idx] &= ~mask;
+    }
+    if(newOwner)
+    {
+        std::vector<Word>& bitmap = bitmaps_[newOwner - 1];
+        if(bitmap.empty())
+            bitmap.resize(wordsPerRow_ * size_.y);
+        bitmap[idx] |= mask;
+    }
+}
+
+bool TerritoryBitmaps::IsOwned(const MapPoint pt, const unsigned char owner) const
+{
+    RTTR_Assert(owner > 0 && owner <= bitmaps_.size());
+    const std::vector<Word>& bitmap = bitmaps_[owner - 1];
+    return !bitmap.empty() && isSet(GetRow(bitmap, pt.y), pt.x);
+}
+
+bool TerritoryBitmaps::IsInterior(const MapPoint pt, const unsigned char owner) const
+{
+    RTTR_Assert(owner > 0 && owner <= bitmaps_.size());
+    const std::vector<Word>& bitmap = bitmaps_[owner - 1];
+    if(bitmap.empty())
+        return false;
+    const MapCoord xW = (pt.x == 0 ? size_.x : pt.x) - 1;
+    const MapCoord xE = (pt.x + 1 == size_.x) ? 0 : pt.x + 1;
+    const MapCoord yN = (pt.y == 0 ? size_.y : pt.y) - 1;
+    const MapCoord yS = (pt.y + 1 == size_.y) ? 0 : pt.y + 1;
+    // Every 2nd row is shifted by half a node, see MapBase::GetNeighbour
+    const MapCoord xNWSW = (pt.y & 1) ? pt.x : xW;
+    const MapCoord xNESE = (pt.y & 1) ? xE : pt.x;
+    const Word* row = GetRow(bitmap, pt.y);
+    const Word* rowN = GetRow(bitmap, yN);
+    const Word* rowS = GetRow(bitmap, yS);
+    return isSet(row, pt.x) && isSet(row, xW) && isSet(row, xE) && isSet(rowN, xNWSW) && isSet(rowN, xNESE)
+           && isSet(rowS, xNWSW) && isSet(rowS, xNESE);
+}
+
+void TerritoryBitmaps::GetBorderRow(const unsigned char owner, const MapCoord y, std::vector<Word>& result) const
+{
+    RTTR_Assert(owner > 0 && owner <= bitmaps_.size());
+    result.assign(wordsPerRow_, 0);
+    const std::vector<Word>& bitmap = bitmaps_[owner - 1];
+    if(bitmap.empty())
+        return;
+    const unsigned width = size_.x;
+    const Word* row = GetRow(bitmap, y);
+    const Word* rowN = GetRow(bitmap, (y == 0 ? size_.y : y) - 1);
+    const Word* rowS = GetRow(bitmap, (y + 1u == size_.y) ? 0 : y + 1);
+    const bool isOddRow = (y & 1) != 0;
+    for(unsigned i = 0; i < wordsPerRow_; i++)
+    {
+        // Nodes whose west and east neighbours are owned
+        Word interior = row[i] & fromWest(row, i, width) & fromEast(row, i, wordsPerRow_, width);
+        // The neighbours in the rows above and below are at x and x-1 for even rows and x and x+1 for odd rows
+        for(const Word* otherRow : {rowN, rowS})
+        {
+            interior &= otherRow[i]
+                        & (isOddRow ? fromEast(otherRow, i, wordsPerRow_, width) : fromWest(otherRow, i, width));
+        }
+        result[i] = row[i] & ~interior;
+    }
+}
+
+unsigned TerritoryBitmaps::CountOwned(const unsigned char owner, const MapPoint start, MapExtent areaSize) const
+{
+    RTTR_Assert(owner > 0 && owner <= bitmaps_.size());
+    const std::vector<Word>& bitmap = bitmaps_[owner - 1];
+    if(bitmap.empty())
+        return 0;
+    // Don't count nodes twice if the area is bigger than the map
+    areaSize = elMin(areaSize, size_);
+    unsigned result = 0;
+    for(unsigned i = 0; i < areaSize.y; i++)
+    {
+        const Word* row = GetRow(bitmap, (start.y + i) % size_.y);
+        const unsigned numToEnd = std::min<unsigned>(areaSize.x, size_.x - start.x);
+        result += CountOwnedInRow(row, start.x, numToEnd);
+        // Rest wraps around to the start of the row
+        if(numToEnd < areaSize.x)
+            result += CountOwnedInRow(row, 0, areaSize.x - numToEnd);
+    }
+    return result;
+}
+
+unsigned TerritoryBitmaps::CountOwnedInRow(const Word* row, const MapCoord firstX, const unsigned numNodes) const
+{
+    unsigned result = 0;
+    unsigned x = firstX;
+    const unsigned endX = firstX + numNodes;
+    while(x < endX)
+    {
+        const unsigned bit = x % bitsPerWord;
+        const unsigned num = std::min(bitsPerWord - bit, endX - x);
+        result += std::bitset<bitsPerWord>(row[x / bitsPerWord] & getMask(bit, num)).count();
+        x += num;
+    }
+    return result;
+}
@@ -0,0 +1,48 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "gameTypes/MapCoordinates.h"
+#include "gameData/MaxPlayers.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+/// Nodes owned by each player stored as 1 bit per node in rows of 64 bit words, kept in sync with MapNode::owner.
+/// Allows checking whole rows for border nodes with a few bitwise operations per 64 nodes
+/// instead of looking at the owners of all neighbours of every single node.
+class TerritoryBitmaps
+{
+public:
+    using Word = uint64_t;
+    static constexpr unsigned bitsPerWord = 64;
+
+    void Init(const MapExtent& mapSize);
+    void Clear();
+
+    /// Update for a node whose owner changed (0 = no owner)
+    void ChangeOwner(MapPoint pt, unsigned char oldOwner, unsigned char newOwner);
+    bool IsOwned(MapPoint pt, unsigned char owner) const;
+    /// Return true if the node and all its neighbours are owned by the owner
+    bool IsInterior(MapPoint pt, unsigned char owner) const;
+    /// Get the nodes of the row owned by the owner with at least one neighbour not owned by them (1 bit per node)
+    void GetBorderRow(unsigned char owner, MapCoord y, std::vector<Word>& result) const;
+    /// Number of nodes in the given area owned by the owner. The area may wrap around the map borders
+    unsigned CountOwned(unsigned char owner, MapPoint start, MapExtent areaSize) const;
+
+    static bool IsSet(const std::vector<Word>& row, MapCoord x)
+    {
+        return ((row[x / bitsPerWord] >> (x % bitsPerWord)) & 1u) != 0;
+    }
+
+private:
+    MapExtent size_;
+    unsigned wordsPerRow_ = 0;
+    /// Bitmaps of all players (index owner - 1). Empty if the player never owned a node
+    std::array<std::vector<Word>, MAX_PLAYERS> bitmaps_;
+
+    const Word* GetRow(const std::vector<Word>& bitmap, MapCoord y) const { return &bitmap[y * wordsPerRow_]; }
+    unsigned CountOwnedInRow(const Word* row, MapCoord firstX, unsigned numNodes) const;
+};
@@ -5,7 +5,6 @@
 #include "world/TerritoryRegion.h"
 #include "GamePlayer.h"
 #include "MapGeometry.h"
-#include "ReturnMapPointWithRadius.h"
 #include "buildings/noBaseBuilding.h"
 #include "buildings/nobMilitary.h"
 #include "helpers/EnumRange.h"
@@ -151,9 +150,9 @@ void TerritoryRegion::CalcTerritoryOfBuilding(const noBaseBuilding& building)
     AdjustNode(bldPos, building.GetPlayer(), 0,
                nullptr); // no need to check barriers here. this point is on our territory.
 
-    const auto pts = world.GetPointsInRadius(bldPos, radius, ReturnMapPointWithRadius{});
-    for(const auto& ptWithRadius : pts)
-        AdjustNode(ptWithRadius.first, building.GetPlayer(), ptWithRadius.second, allowedArea);
+    const MapPointsInRadius pts = world.PointsInRadius(bldPos, radius);
+    for(auto it = pts.begin(); it != pts.end(); ++it)
+        AdjustNode(*it, building.GetPlayer(), it.GetRadius(), allowedArea);
 }
 
 uint8_t TerritoryRegion::SafeGetOwner(const Position& pt) const
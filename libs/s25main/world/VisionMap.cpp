@@ -0,0 +1,174 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "world/VisionMap.h"
+#include "RttrForeachPt.h"
+#include "SimulationPhaseTimes.h"
+#include "figures/nofActiveSoldier.h"
+#include "figures/nofScout_Free.h"
+#include "world/MapBase.h"
+#include "nodeObjs/noFighting.h"
+#include "gameData/MilitaryConsts.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+void changeNumViewers(uint16_t& numViewers, const bool add)
+{
+    if(add)
+    {
+        RTTR_Assert(numViewers < std::numeric_limits<uint16_t>::max());
+        ++numViewers;
+    } else
+    {
+        RTTR_Assert(numViewers > 0);
+        --numViewers;
+    }
+}
+} // namespace
+
+VisionMap::VisionMap(const MapBase& world) : world_(world) {}
+
+void VisionMap::Init(const MapExtent& mapSize, const unsigned numPlayers)
+{
+    numViewers_.clear();
+    numViewers_.resize(numPlayers, std::vector<uint16_t>(prodOfComponents(mapSize), 0));
+    objectViewers_.clear();
+}
+
+void VisionMap::Clear()
+{
+    for(auto& playerViewers : numViewers_)
+        std::fill(playerViewers.begin(), playerViewers.end(), 0);
+    objectViewers_.clear();
+}
+
+void VisionMap::AddObjectViewer(const GameObject& obj, const MapPoint pt, const unsigned radius,
+                                const unsigned char player)
+{
+    const bool inserted = objectViewers_.emplace(obj.GetObjId(), ObjectViewer{pt, radius, player}).second;
+    RTTR_Assert(inserted);
+    if(inserted)
+        AddViewer(pt, radius, player);
+}
+
+void VisionMap::RemoveObjectViewer(const GameObject& obj)
+{
+    const auto it = objectViewers_.find(obj.GetObjId());
+    if(it == objectViewers_.end())
+        return;
+    const ObjectViewer viewer = it->second;
+    objectViewers_.erase(it);
+    RemoveViewer(viewer.pt, viewer.radius, viewer.player);
+}
+
+bool VisionMap::HasObjectViewer(const GameObject& obj) const
+{
+    return objectViewers_.find(obj.GetObjId()) != objectViewers_.end();
+}
+
+unsigned VisionMap::GetNumViewers(const MapPoint pt, const unsigned char player) const
+{
+    RTTR_Assert(player < numViewers_.size());
+    return numViewers_[player][world_.GetIdx(pt)];
+}
+
+bool VisionMap::IsVisible(const MapPoint pt, const unsigned char player, const GameObject* const exception) const
+{
+    unsigned numViewers = GetNumViewers(pt, player);
+    if(exception && numViewers > 0)
+    {
+        const auto it = objectViewers_.find(exception->GetObjId());
+        if(it != objectViewers_.end() && it->second.player == player
+           && world_.CalcDistance(pt, it->second.pt) <= it->second.radius)
+            --numViewers;
+    }
+    return numViewers > 0;
+}
+
+void VisionMap::ChangeViewers(const MapPoint center, const unsigned radius, const unsigned char player, const bool add)
+{
+    SimulationPhaseTimer timer(SimulationPhase::Visibility);
+    RTTR_Assert(player < numViewers_.size());
+    std::vector<uint16_t>& playerViewers = numViewers_[player];
+    const auto changeViewer = [this, &playerViewers, add](const MapPoint curPt, unsigned /*distance*/) {
+        changeNumViewers(playerViewers[world_.GetIdx(curPt)], add);
+        return false;
+    };
+    // On small maps the hulls around the point overlap due to wrapping, so check each point exactly once instead
+    const MapExtent size = world_.GetSize();
+    if(2 * radius < std::min(size.x, size.y))
+        world_.CheckPointsInRadius(center, radius, changeViewer, true);
+    else
+    {
+        RTTR_FOREACH_PT(MapPoint, size)
+        {
+            if(world_.CalcDistance(center, pt) <= radius)
+                changeViewer(pt, 0);
+        }
+    }
+}
+
+void VisionMap::ChangeViewersOnRing(const MapPoint center, const MapPoint other, const unsigned radius,
+                                    const unsigned char player, const bool add)
+{
+    SimulationPhaseTimer timer(SimulationPhase::Visibility);
+    RTTR_Assert(player < numViewers_.size());
+    std::vector<uint16_t>& playerViewers = numViewers_[player];
+    for(const MapPoint pt : world_.PointsOnRing(center, radius))
+    {
+        if(world_.CalcDistance(pt, other) > radius)
+            changeNumViewers(playerViewers[world_.GetIdx(pt)], add);
+    }
+}
+
+template<class T_Func>
+void VisionMap::ForEachFigureViewer(const noBase& figure, T_Func&& func) const
+{
+    switch(figure.GetGOT())
+    {
+        case GO_Type::NofScoutFree:
+            func(VISUALRANGE_SCOUT, static_cast<const nofScout_Free&>(figure).GetPlayer());
+            break;
+        case GO_Type::NofAttacker:
+        case GO_Type::NofAggressivedefender:
+            func(VISUALRANGE_SOLDIER, static_cast<const nofActiveSoldier&>(figure).GetPlayer());
+            break;
+        case GO_Type::Fighting:
+            // Both fighters see the fight, even after one of them has won and left
+            for(unsigned char player = 0; player < numViewers_.size(); ++player)
+            {
+                if(static_cast<const noFighting&>(figure).IsSoldierOfPlayer(player))
+                    func(VISUALRANGE_SOLDIER, player);
+            }
+            break;
+        default: break;
+    }
+}
+
+void VisionMap::ChangeFigureViewers(const MapPoint pt, const noBase& figure, const bool add)
+{
+    ForEachFigureViewer(figure, [this, pt, add](const unsigned radius, const unsigned char player) {
+        ChangeViewers(pt, radius, player, add);
+    });
+}
+
+void VisionMap::MoveFigure(const MapPoint from, const MapPoint to, const noBase& figure)
+{
+    const MapExtent size = world_.GetSize();
+    const bool isStep = world_.CalcDistance(from, to) == 1u;
+    ForEachFigureViewer(figure, [this, from, to, size, isStep](const unsigned radius, const unsigned char player) {
+        // Only the nodes on the outer ring can enter or leave the range on a single step.
+        // On small maps the rings overlap due to wrapping, so update the whole range there
+        if(isStep && 2 * (radius + 1) < std::min(size.x, size.y))
+        {
+            ChangeViewersOnRing(from, to, radius, player, false);
+            ChangeViewersOnRing(to, from, radius, player, true);
+        } else
+        {
+            ChangeViewers(from, radius, player, false);
+            ChangeViewers(to, radius, player, true);
+        }
+    });
+}
@@ -0,0 +1,71 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "gameTypes/MapCoordinates.h"
+#include <cstdint>
+#include <map>
+#include <vector>
+
+class GameObject;
+class MapBase;
+class noBase;
+
+/// Counts for each player and node the number of vision sources ("viewers") seeing that node.
+/// A viewer sees all nodes within its radius (see MapBase::CalcDistance).
+/// Viewers are added and removed when the source is created, moved or destroyed so that checking if a node is seen
+/// by a player is a simple lookup instead of searching the surroundings for buildings and figures.
+class VisionMap
+{
+public:
+    explicit VisionMap(const MapBase& world);
+    /// Reset for a map of the given size. There are no viewers afterwards
+    void Init(const MapExtent& mapSize, unsigned numPlayers);
+    /// Remove all viewers
+    void Clear();
+
+    /// Add a viewer seeing all nodes within the radius around pt
+    void AddViewer(MapPoint pt, unsigned radius, unsigned char player) { ChangeViewers(pt, radius, player, true); }
+    /// Remove a viewer previously added with the same parameters
+    void RemoveViewer(MapPoint pt, unsigned radius, unsigned char player) { ChangeViewers(pt, radius, player, false); }
+    /// Add a viewer belonging to an object (e.g. a building) which can be excluded in IsVisible.
+    /// An object can have at most 1 viewer
+    void AddObjectViewer(const GameObject& obj, MapPoint pt, unsigned radius, unsigned char player);
+    /// Remove the viewer of the object. No-op if it has none
+    void RemoveObjectViewer(const GameObject& obj);
+    bool HasObjectViewer(const GameObject& obj) const;
+    /// Add/Remove the viewers of a figure on the given node. Does nothing for figures which do not scout
+    void AddFigure(MapPoint pt, const noBase& figure) { ChangeFigureViewers(pt, figure, true); }
+    void RemoveFigure(MapPoint pt, const noBase& figure) { ChangeFigureViewers(pt, figure, false); }
+    /// Move the viewers of a figure. Same as RemoveFigure(from) and AddFigure(to) but for neighbouring points only
+    /// the nodes entering or leaving the range are updated
+    void MoveFigure(MapPoint from, MapPoint to, const noBase& figure);
+
+    unsigned GetNumViewers(MapPoint pt, unsigned char player) const;
+    /// Return true if the point is seen by any viewer of the player except the one of the exception object
+    bool IsVisible(MapPoint pt, unsigned char player, const GameObject* exception = nullptr) const;
+
+private:
+    struct ObjectViewer
+    {
+        MapPoint pt;
+        unsigned radius;
+        unsigned char player;
+    };
+
+    const MapBase& world_;
+    /// Number of viewers for each player and node
+    std::vector<std::vector<uint16_t>> numViewers_;
+    /// Viewers of objects by their object id
+    std::map<unsigned, ObjectViewer> objectViewers_;
+
+    void ChangeViewers(MapPoint pt, unsigned radius, unsigned char player, bool add);
+    /// Change the viewers of all nodes which are in the range around center but not around other
+    void ChangeViewersOnRing(MapPoint center, MapPoint other, unsigned radius, unsigned char player, bool add);
+    void ChangeFigureViewers(MapPoint pt, const noBase& figure, bool add);
+    /// Call func(radius, player) for each viewer of the figure
+    template<class T_Func>
+    void ForEachFigureViewer(const noBase& figure, T_Func&& func) const;
+};
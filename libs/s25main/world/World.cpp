@@ -10,16 +10,18 @@
 #endif
 #include "FOWObjects.h"
 #include "RoadSegment.h"
+#include "RttrForeachPt.h"
+#include "Ware.h"
 #include "enum_cast.hpp"
 #include "helpers/containerUtils.h"
-#include "helpers/pointerContainerUtils.h"
 #include "gameTypes/ShipDirection.h"
 #include "gameData/TerrainDesc.h"
+#include <algorithm>
 #include <memory>
 #include <set>
 #include <stdexcept>
 
-World::World() : noNodeObj(nullptr) {}
+World::World(const unsigned numPlayers) : fowNodes(numPlayers), noNodeObj(nullptr) {}
 
 World::~World()
 {
@@ -66,8 +68,8 @@ void World::Unload()
         deletePtr(node.obj);
 
     // Figuren vernichten
-    for(auto& node : nodes)
-        node.figures.clear();
+    for(auto& nodeFigures : figures)
+        nodeFigures.clear_and_dispose(std::default_delete<noBase>());
 
     catapult_stones.clear();
     harbor_pos.clear();
@@ -80,10 +82,18 @@ void World::Resize(const MapExtent& newSize)
 {
     MapBase::Resize(newSize);
     nodes.clear();
+    for(auto& playerFoWNodes : fowNodes)
+        playerFoWNodes.clear();
+    figures.clear();
     militarySquares.Clear();
+    digest_.Init(GetSize());
+    territoryBitmaps_.Init(GetSize());
     if(GetSize().x > 0)
     {
         nodes.resize(prodOfComponents(GetSize()));
+        for(auto& playerFoWNodes : fowNodes)
+            playerFoWNodes.resize(nodes.size());
+        figures.resize(nodes.size());
         militarySquares.Init(GetSize());
     }
 }
@@ -92,21 +102,36 @@ noBase& World::AddFigureImpl(const MapPoint pt, std::unique_ptr<noBase> fig)
 {
     RTTR_Assert(fig);
 
-    auto& figures = GetNodeInt(pt).figures;
-#if RTTR_ENABLE_ASSERTS
-    RTTR_Assert(!helpers::containsPtr(figures, fig.get()));
-    for(const MapPoint nb : GetNeighbours(pt))
-        RTTR_Assert(!helpers::containsPtr(GetNode(nb).figures, fig.get())); // Added figure that is in surrounding?
-#endif
+    // Figure already on this or another node?
+    RTTR_Assert(!static_cast<const FigureListHook&>(*fig).is_linked());
 
-    noBase& result = *fig;
-    figures.push_back(std::move(fig));
+    noBase& result = *fig.release();
+    figures[GetIdx(pt)].push_back(result);
+    digest_.Toggle(pt, WorldDigest::Kind::Figure, result.GetObjId());
+    FigureAdded(pt, result);
     return result;
 }
 
 noBase* World::RemoveFigureImpl(const MapPoint pt, noBase& fig)
 {
-    return helpers::extractPtr(GetNodeInt(pt).figures, &fig).release();
+    RTTR_Assert(HasFigureAt(pt, fig));
+    auto& nodeFigures = figures[GetIdx(pt)];
+    // Keeps the order of the remaining figures
+    nodeFigures.erase(nodeFigures.iterator_to(fig));
+    digest_.Toggle(pt, WorldDigest::Kind::Figure, fig.GetObjId());
+    FigureRemoved(pt, fig);
+    return &fig;
+}
+
+void World::MoveFigure(const MapPoint from, const MapPoint to, noBase& fig)
+{
+    RTTR_Assert(HasFigureAt(from, fig));
+    auto& fromFigures = figures[GetIdx(from)];
+    fromFigures.erase(fromFigures.iterator_to(fig));
+    digest_.Toggle(from, WorldDigest::Kind::Figure, fig.GetObjId());
+    figures[GetIdx(to)].push_back(fig);
+    digest_.Toggle(to, WorldDigest::Kind::Figure, fig.GetObjId());
+    FigureMoved(from, to, fig);
 }
 
 noBase* World::GetNO(const MapPoint pt)
@@ -132,6 +157,8 @@ void World::SetNO(const MapPoint pt, noBase* obj, const bool replace /* = false*
     RTTR_Assert(!dynamic_cast<noMovable*>(obj)); // It should be a static, non-movable object
 #endif
     GetNodeInt(pt).obj = obj;
+    digest_.SetObject(pt, obj ? obj->GetObjId() : 0);
+    NodeChanged(pt);
 }
 
 void World::DestroyNO(const MapPoint pt, const bool checkExists /* = true*/)
@@ -142,6 +169,8 @@ void World::DestroyNO(const MapPoint pt, const bool checkExists /* = true*/)
         // Destroy may remove the NO already from the map or replace it (e.g. building -> fire)
         // So remove from map, then destroy and free
         GetNodeInt(pt).obj = nullptr;
+        digest_.SetObject(pt, 0);
+        NodeChanged(pt);
         obj->Destroy();
         deletePtr(obj);
     } else
@@ -173,7 +202,7 @@ void World::SetReserved(const MapPoint pt, const bool reserved)
 
 void World::SetVisibility(const MapPoint pt, unsigned char player, Visibility vis, unsigned fowTime)
 {
-    FoWNode& node = GetNodeInt(pt).fow[player];
+    FoWNode& node = GetFoWNodeInt(pt, player);
     Visibility oldVis = node.visibility;
     if(oldVis == vis)
         return;
@@ -199,14 +228,46 @@ void World::ChangeAltitude(const MapPoint pt, const unsigned char altitude)
     AltitudeChanged(pt);
 }
 
+void World::RecalcDigest()
+{
+    digest_.Clear();
+    RTTR_FOREACH_PT(MapPoint, GetSize())
+    {
+        const MapNode& node = GetNode(pt);
+        digest_.Change(pt, WorldDigest::Kind::Owner, 0, node.owner);
+        digest_.SetObject(pt, node.obj ? node.obj->GetObjId() : 0);
+        for(const noBase& figure : GetFigures(pt))
+            digest_.Toggle(pt, WorldDigest::Kind::Figure, figure.GetObjId());
+        if(node.obj && node.obj->GetGOT() == GO_Type::Flag)
+        {
+            for(const Ware& ware : static_cast<const noFlag*>(node.obj)->GetWares())
+                ToggleWareAtFlag(pt, ware);
+        }
+    }
+}
+
+void World::ToggleWareAtFlag(const MapPoint pt, const Ware& ware)
+{
+    digest_.Toggle(pt, WorldDigest::Kind::Ware, ware.GetObjId());
+}
+
+void World::RecalcTerritoryBitmaps()
+{
+    territoryBitmaps_.Clear();
+    RTTR_FOREACH_PT(MapPoint, GetSize())
+        territoryBitmaps_.ChangeOwner(pt, 0, GetNode(pt).owner);
+}
+
 bool World::IsPlayerTerritory(const MapPoint pt, const unsigned char owner) const
 {
     const unsigned char ptOwner = GetNode(pt).owner;
 
     if(owner != 0 && ptOwner != owner)
         return false;
+    if(ptOwner != 0)
+        return territoryBitmaps_.IsInterior(pt, ptOwner);
 
-    // Neighbour nodes must belong to this player
+    // Neighbour nodes must not belong to any player
     for(const MapPoint nb : GetNeighbours(pt))
     {
         if(GetNode(nb).owner != ptOwner)
@@ -241,7 +302,9 @@ BuildingQuality World::AdjustBQ(const MapPoint pt, unsigned char player, Buildin
 
 bool World::HasFigureAt(const MapPoint pt, const noBase& figure) const
 {
-    return helpers::containsPtr(GetNode(pt).figures, &figure);
+    const auto& nodeFigures = figures[GetIdx(pt)];
+    return std::any_of(nodeFigures.begin(), nodeFigures.end(),
+                       [&figure](const noBase& curFigure) { return &curFigure == &figure; });
 }
 
 WalkTerrain World::GetTerrain(MapPoint pt, Direction dir) const
@@ -312,7 +375,7 @@ helpers::EnumArray<DescIdx<TerrainDesc>, Direction> World::GetTerrainsAround(Map
 
 void World::SaveFOWNode(const MapPoint pt, const unsigned player, unsigned curTime)
 {
-    FoWNode& fow = GetNodeInt(pt).fow[player];
+    FoWNode& fow = GetFoWNodeInt(pt, player);
     fow.last_update_time = curTime;
 
     // FOW-Objekt erzeugen
@@ -386,7 +449,7 @@ PointRoad World::GetPointRoad(MapPoint pt, Direction dir) const
 PointRoad World::GetPointFOWRoad(MapPoint pt, Direction dir, const unsigned char viewing_player) const
 {
     const RoadDir rDir = toRoadDir(pt, dir);
-    return GetNode(pt).fow[viewing_player].roads[rDir];
+    return GetFoWNode(pt, viewing_player).roads[rDir];
 }
 
 void World::AddCatapultStone(CatapultStone* cs)
@@ -460,6 +523,7 @@ unsigned short World::GetSeaFromCoastalPoint(const MapPoint pt) const
 void World::SetRoad(const MapPoint pt, RoadDir roadDir, PointRoad type)
 {
     GetNodeInt(pt).roads[roadDir] = type;
+    NodeChanged(pt);
 }
 
 bool World::SetBQ(const MapPoint pt, BuildingQuality bq)
@@ -487,9 +551,9 @@ void World::RecalcShadow(const MapPoint pt)
 
 void World::MakeWholeMapVisibleForAllPlayers()
 {
-    for(auto& mapNode : nodes)
+    for(auto& playerFoWNodes : fowNodes)
     {
-        for(auto& fowNode : mapNode.fow)
+        for(auto& fowNode : playerFoWNodes)
         {
             fowNode.visibility = Visibility::Visible;
             fowNode.object.reset();
@@ -5,9 +5,10 @@
 #pragma once
 
 #include "enum_cast.hpp"
-#include "helpers/PtrSpan.h"
 #include "world/MapBase.h"
 #include "world/MilitarySquares.h"
+#include "world/TerritoryBitmaps.h"
+#include "world/WorldDigest.h"
 #include "gameTypes/Direction.h"
 #include "gameTypes/GO_Type.h"
 #include "gameTypes/HarborPos.h"
@@ -15,6 +16,7 @@
 #include "gameTypes/MapNode.h"
 #include "gameTypes/MapTypes.h"
 #include "gameData/DescIdx.h"
+#include "gameData/MaxPlayers.h"
 #include "gameData/WorldDescription.h"
 #include <list>
 #include <memory>
@@ -24,6 +26,7 @@ struct LandscapeDesc;
 class CatapultStone;
 class noBase;
 class noBuildingSite;
+class Ware;
 enum class ShipDirection : uint8_t;
 
 struct WalkTerrain
@@ -52,6 +55,11 @@ class World : public MapBase
 
     /// Eigenschaften von einem Punkt auf der Map
     std::vector<MapNode> nodes;
+    /// How each player sees the nodes in FoW (indexed by player and node).
+    /// Separate from the nodes as only needed for single nodes and only for the actual players
+    std::vector<std::vector<FoWNode>> fowNodes;
+    /// Figures on each node
+    std::vector<MapNode::Figures> figures;
 
     std::vector<Sea> seas;
 
@@ -61,6 +69,8 @@ class World : public MapBase
     WorldDescription description_;
 
     std::unique_ptr<noBase> noNodeObj;
+    WorldDigest digest_;
+    TerritoryBitmaps territoryBitmaps_;
     void Resize(const MapExtent& newSize) override final;
     noBase& AddFigureImpl(MapPoint pt, std::unique_ptr<noBase> fig);
     /// Implementation of RemoveFigure. Returned pointer must be wrapped in an owning pointer
@@ -75,7 +85,8 @@ public:
     std::list<CatapultStone*> catapult_stones;
     MilitarySquares militarySquares;
 
-    World();
+    /// Create a world storing the FoW for the given number of players
+    explicit World(unsigned numPlayers = MAX_PLAYERS);
     virtual ~World();
 
     /// Initialize the world
@@ -93,6 +104,10 @@ public:
     const MapNode& GetNode(MapPoint pt) const;
     /// Return the neighboring node
     const MapNode& GetNeighbourNode(MapPoint pt, Direction dir) const;
+    /// Return how the player sees the node in FoW
+    const FoWNode& GetFoWNode(MapPoint pt, unsigned player) const;
+    /// Return the number of players whose FoW is stored
+    unsigned GetNumFoWPlayers() const { return fowNodes.size(); }
 
     // Add a figure to a node (taking ownership) and returns a reference to it
     template<typename T>
@@ -107,6 +122,8 @@ public:
     }
     template<typename T>
     std::unique_ptr<T> RemoveFigure(MapPoint pt, T*& fig) = delete;
+    /// Move a figure to another node. Same as RemoveFigure followed by AddFigure but reported as a single change
+    void MoveFigure(MapPoint from, MapPoint to, noBase& fig);
     /// Return the NO from that point or a "nothing"-object if there is none
     noBase* GetNO(MapPoint pt);
     /// Return the NO from that point or a "nothing"-object if there is none
@@ -121,7 +138,12 @@ public:
     GO_Type GetGOT(MapPoint pt) const;
     void ReduceResource(MapPoint pt);
     void SetResource(const MapPoint pt, Resource newResource) { GetNodeInt(pt).resources = newResource; }
-    void SetOwner(const MapPoint pt, unsigned char newOwner) { GetNodeInt(pt).owner = newOwner; }
+    void SetOwner(const MapPoint pt, unsigned char newOwner)
+    {
+        digest_.Change(pt, WorldDigest::Kind::Owner, GetNode(pt).owner, newOwner);
+        territoryBitmaps_.ChangeOwner(pt, GetNode(pt).owner, newOwner);
+        GetNodeInt(pt).owner = newOwner;
+    }
     void SetReserved(MapPoint pt, bool reserved);
     /// Sets the visibility and fires a Visibility Changed event if different
     /// fowTime is only used if visibility gets changed to FoW
@@ -129,6 +151,18 @@ public:
 
     void ChangeAltitude(MapPoint pt, unsigned char altitude);
 
+    /// Hash of the world state for async detection
+    const WorldDigest& GetDigest() const { return digest_; }
+    /// Recalculate the digest from scratch. Required after the nodes were set directly, e.g. when loading
+    void RecalcDigest();
+    /// Add or remove the ware lying at the flag at the given point from the digest
+    void ToggleWareAtFlag(MapPoint pt, const Ware& ware);
+
+    /// Nodes owned by each player
+    const TerritoryBitmaps& GetTerritoryBitmaps() const { return territoryBitmaps_; }
+    /// Recalculate the territory bitmaps from the owners of the nodes. Required after the nodes were set directly
+    void RecalcTerritoryBitmaps();
+
     // Make whole map visible with no additional checks or notices
     void MakeWholeMapVisibleForAllPlayers();
 
@@ -141,8 +175,26 @@ public:
     /// Incorporates node ownership into the given BQ
     BuildingQuality AdjustBQ(MapPoint pt, unsigned char player, BuildingQuality nodeBQ) const;
 
-    /// Return the figures currently on the node
-    auto GetFigures(const MapPoint pt) const { return helpers::nonNullPtrSpan(GetNode(pt).figures); }
+    /// View of the figures on a node. Stays valid when figures are added or removed
+    class FiguresView
+    {
+        MapNode::Figures& figures_;
+
+    public:
+        explicit FiguresView(MapNode::Figures& figures) : figures_(figures) {}
+        auto begin() const { return figures_.begin(); }
+        auto end() const { return figures_.end(); }
+        noBase& front() const { return figures_.front(); }
+        bool empty() const { return figures_.empty(); }
+        /// Linear in the number of figures
+        size_t size() const { return figures_.size(); }
+    };
+    /// Return the figures currently on the node.
+    /// Only the list is protected, the figures themselves can be changed (e.g. drawn) through a const world
+    FiguresView GetFigures(const MapPoint pt) const
+    {
+        return FiguresView(const_cast<MapNode::Figures&>(figures[GetIdx(pt)]));
+    }
     bool HasFigureAt(MapPoint pt, const noBase& figure) const;
 
     /// Return a specific object or nullptr
@@ -235,9 +287,17 @@ protected:
     /// Internal method for access to nodes with write access
     MapNode& GetNodeInt(MapPoint pt);
     MapNode& GetNeighbourNodeInt(MapPoint pt, Direction dir);
+    FoWNode& GetFoWNodeInt(MapPoint pt, unsigned player);
 
     /// Notify derived classes of changed altitude
     virtual void AltitudeChanged(MapPoint pt) = 0;
+    /// Notify derived classes of a changed object or road at the point
+    virtual void NodeChanged(MapPoint pt) = 0;
+    /// Notify derived classes of a figure added to or removed from the point
+    virtual void FigureAdded(MapPoint pt, const noBase& fig) = 0;
+    virtual void FigureRemoved(MapPoint pt, const noBase& fig) = 0;
+    /// Notify derived classes of a figure moved from one point to another
+    virtual void FigureMoved(MapPoint from, MapPoint to, const noBase& fig) = 0;
     /// Notify derived classes of changed visibility
     virtual void VisibilityChanged(MapPoint pt, unsigned player, Visibility oldVis, Visibility newVis) = 0;
     /// Sets the road for the given (road) direction
@@ -264,6 +324,18 @@ inline MapNode& World::GetNodeInt(const MapPoint pt)
     return nodes[GetIdx(pt)];
 }
 
+inline const FoWNode& World::GetFoWNode(const MapPoint pt, const unsigned player) const
+{
+    RTTR_Assert(player < fowNodes.size());
+    return fowNodes[player][GetIdx(pt)];
+}
+
+inline FoWNode& World::GetFoWNodeInt(const MapPoint pt, const unsigned player)
+{
+    RTTR_Assert(player < fowNodes.size());
+    return fowNodes[player][GetIdx(pt)];
+}
+
 inline const MapNode& World::GetNeighbourNode(const MapPoint pt, Direction dir) const
 {
     return GetNode(GetNeighbour(pt, dir));
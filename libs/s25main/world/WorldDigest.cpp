@@ -0,0 +1,90 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "WorldDigest.h"
+#include "enum_cast.hpp"
+#include <RTTR_Assert.h>
+#include <algorithm>
+
+namespace {
+/// Finalizer of splitmix64 which spreads every input bit over the whole result
+uint64_t mix(uint64_t value)
+{
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9u;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebu;
+    return value ^ (value >> 31);
+}
+
+unsigned hashValue(const MapPoint pt, const WorldDigest::Kind kind, const unsigned value)
+{
+    const uint64_t key =
+      (static_cast<uint64_t>(rttr::enum_cast(kind)) << 32) | (static_cast<uint64_t>(pt.y) << 16) | pt.x;
+    const uint64_t hash = mix(mix(key) ^ value);
+    return static_cast<unsigned>(hash ^ (hash >> 32));
+}
+} // namespace
+
+void WorldDigest::Init(const MapExtent& mapSize)
+{
+    size_ = mapSize;
+    regionsPerRow_ = (mapSize.x + regionSize - 1) / regionSize;
+    const unsigned numRows = (mapSize.y + regionSize - 1) / regionSize;
+    regionHashes_.assign(regionsPerRow_ * numRows, 0);
+    objIds_.assign(prodOfComponents(mapSize), 0);
+    hash_ = 0;
+}
+
+void WorldDigest::Clear()
+{
+    std::fill(regionHashes_.begin(), regionHashes_.end(), 0);
+    std::fill(objIds_.begin(), objIds_.end(), 0);
+    hash_ = 0;
+}
+
+void WorldDigest::Toggle(const MapPoint pt, const Kind kind, const unsigned value)
+{
+    const unsigned hash = hashValue(pt, kind, value);
+    regionHashes_[GetRegion(pt)] ^= hash;
+    hash_ ^= hash;
+}
+
+void WorldDigest::Change(const MapPoint pt, const Kind kind, const unsigned oldValue, const unsigned newValue)
+{
+    if(oldValue == newValue)
+        return;
+    if(oldValue)
+        Toggle(pt, kind, oldValue);
+    if(newValue)
+        Toggle(pt, kind, newValue);
+}
+
+void WorldDigest::SetObject(const MapPoint pt, const unsigned objId)
+{
+    unsigned& curObjId = objIds_[static_cast<unsigned>(pt.y) * size_.x + pt.x];
+    Change(pt, Kind::Object, curObjId, objId);
+    curObjId = objId;
+}
+
+unsigned WorldDigest::GetRegion(const MapPoint pt) const
+{
+    RTTR_Assert(pt.x < size_.x && pt.y < size_.y);
+    return (pt.y / regionSize) * regionsPerRow_ + pt.x / regionSize;
+}
+
+unsigned WorldDigest::CombineHashes(const std::vector<unsigned>& regionHashes, const unsigned firstRegion,
+                                    const unsigned numRegions)
+{
+    RTTR_Assert(firstRegion + numRegions <= regionHashes.size());
+    unsigned result = 0;
+    for(unsigned i = firstRegion; i < firstRegion + numRegions; i++)
+        result ^= regionHashes[i];
+    return result;
+}
+
+unsigned WorldDigest::GetPartStart(const unsigned firstRegion, const unsigned numRegions, const unsigned numParts,
+                                   const unsigned part)
+{
+    RTTR_Assert(numParts > 0 && part <= numParts);
+    return firstRegion + static_cast<unsigned>(static_cast<uint64_t>(numRegions) * part / numParts);
+}
@@ -0,0 +1,58 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "gameTypes/MapCoordinates.h"
+#include <cstdint>
+#include <vector>
+
+/// Hash of the world state (node owners, objects, figures and wares at flags) used to detect asyncs.
+/// The map is split into square regions. The hash of a region is the XOR of the hashes of all values of its nodes,
+/// so it is updated in O(1) when a value is added or removed without looking at the rest of the world.
+/// Values of 0 (no owner, no object) are not stored, so an empty world has a hash of 0.
+class WorldDigest
+{
+public:
+    enum class Kind : uint8_t
+    {
+        Owner,
+        Object,
+        Figure,
+        Ware
+    };
+    /// Width and height of a region in nodes
+    static constexpr unsigned regionSize = 16;
+
+    void Init(const MapExtent& mapSize);
+    /// Remove all values
+    void Clear();
+
+    /// Add or remove a value of a node. Doing this twice with the same value removes it again
+    void Toggle(MapPoint pt, Kind kind, unsigned value);
+    /// Replace a single value of a node (e.g. the owner)
+    void Change(MapPoint pt, Kind kind, unsigned oldValue, unsigned newValue);
+    /// Set the id of the object at the node (0 for none)
+    void SetObject(MapPoint pt, unsigned objId);
+
+    /// Combined hash of all regions
+    unsigned GetHash() const { return hash_; }
+    const std::vector<unsigned>& GetRegionHashes() const { return regionHashes_; }
+    unsigned GetRegionsPerRow() const { return regionsPerRow_; }
+    unsigned GetRegion(MapPoint pt) const;
+
+    /// Combined hash of the given range of regions
+    static unsigned CombineHashes(const std::vector<unsigned>& regionHashes, unsigned firstRegion, unsigned numRegions);
+    /// First region of a part when splitting the range of regions into numParts parts of (nearly) equal size.
+    /// Use part == numParts to get the end of the range
+    static unsigned GetPartStart(unsigned firstRegion, unsigned numRegions, unsigned numParts, unsigned part);
+
+private:
+    MapExtent size_;
+    unsigned regionsPerRow_ = 0;
+    std::vector<unsigned> regionHashes_;
+    /// Id of the object per node, so it doesn't need to be accessed when it is replaced (it may be destroyed already)
+    std::vector<unsigned> objIds_;
+    unsigned hash_ = 0;
+};
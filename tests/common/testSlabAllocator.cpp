@@ -0,0 +1,110 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "helpers/SlabAllocator.h"
+#include <boost/test/unit_test.hpp>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+using helpers::SlabAllocator;
+
+BOOST_AUTO_TEST_SUITE(SlabAllocatorSuite)
+
+BOOST_AUTO_TEST_CASE(SizeClasses)
+{
+    BOOST_TEST(SlabAllocator::getSizeClass(1) == 0u);
+    BOOST_TEST(SlabAllocator::getSizeClass(SlabAllocator::granularity) == 0u);
+    BOOST_TEST(SlabAllocator::getSizeClass(SlabAllocator::granularity + 1) == 1u);
+    BOOST_TEST(SlabAllocator::getSizeClass(SlabAllocator::maxBlockSize) == SlabAllocator::numSizeClasses - 1u);
+    for(size_t size = 1; size <= SlabAllocator::maxBlockSize; size++)
+    {
+        const size_t blockSize = SlabAllocator::getBlockSize(SlabAllocator::getSizeClass(size));
+        BOOST_TEST(blockSize >= size);
+        BOOST_TEST(blockSize < size + SlabAllocator::granularity);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AllocateAndReuse)
+{
+    SlabAllocator allocator;
+    constexpr size_t size = 40;
+    const size_t sizeClass = SlabAllocator::getSizeClass(size);
+    std::vector<void*> blocks;
+    for(int i = 0; i < 1000; i++)
+    {
+        blocks.push_back(allocator.allocate(size));
+        BOOST_TEST(reinterpret_cast<std::uintptr_t>(blocks.back()) % SlabAllocator::granularity == 0u);
+    }
+    BOOST_TEST(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+    const SlabAllocator::Stats& stats = allocator.getStats(sizeClass);
+    BOOST_TEST(stats.numAllocations == 1000u);
+    BOOST_TEST(stats.numUsed == 1000u);
+    BOOST_TEST(stats.maxUsed == 1000u);
+    BOOST_TEST(stats.capacity >= 1000u);
+    const size_t capacity = stats.capacity;
+    BOOST_TEST(allocator.getReservedBytes() == capacity * SlabAllocator::getBlockSize(sizeClass));
+
+    // Freed memory is reused for any size of the same class
+    allocator.deallocate(blocks[3], size);
+    BOOST_TEST(stats.numUsed == 999u);
+    BOOST_TEST(allocator.allocate(size - 1) == blocks[3]);
+    BOOST_TEST(stats.numAllocations == 1001u);
+    BOOST_TEST(stats.maxUsed == 1000u);
+    BOOST_TEST(stats.capacity == capacity);
+    // Other classes are independent
+    void* otherBlock = allocator.allocate(size + SlabAllocator::granularity);
+    BOOST_TEST(allocator.getStats(sizeClass + 1).numUsed == 1u);
+    allocator.deallocate(otherBlock, size + SlabAllocator::granularity);
+
+    for(void* block : blocks)
+        allocator.deallocate(block, size);
+    BOOST_TEST(stats.numUsed == 0u);
+    BOOST_TEST(stats.maxUsed == 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(LargeBlocks)
+{
+    SlabAllocator allocator;
+    constexpr size_t size = SlabAllocator::maxBlockSize + 1;
+    void* block = allocator.allocate(size);
+    BOOST_TEST(allocator.getLargeStats().numUsed == 1u);
+    BOOST_TEST(allocator.getReservedBytes() == 0u);
+    allocator.deallocate(block, size);
+    BOOST_TEST(allocator.getLargeStats().numUsed == 0u);
+    BOOST_TEST(allocator.getLargeStats().numAllocations == 1u);
+}
+
+BOOST_AUTO_TEST_CASE(ForEachUsedBlock)
+{
+    SlabAllocator allocator;
+    std::map<void*, size_t> usedBlocks;
+    for(int i = 0; i < 500; i++)
+    {
+        const size_t size = 8 + (i % 5) * 30;
+        void* block = allocator.allocate(size);
+        if(i % 3 == 0)
+            allocator.deallocate(block, size);
+        else
+            usedBlocks[block] = size;
+    }
+    std::map<void*, size_t> visitedBlocks;
+    allocator.forEachUsedBlock([&visitedBlocks](void* block, size_t blockSize) {
+        BOOST_TEST(visitedBlocks.emplace(block, blockSize).second);
+    });
+    BOOST_TEST_REQUIRE(visitedBlocks.size() == usedBlocks.size());
+    for(const auto& usedBlock : usedBlocks)
+    {
+        const auto it = visitedBlocks.find(usedBlock.first);
+        BOOST_TEST_REQUIRE((it != visitedBlocks.end()));
+        BOOST_TEST(it->second == SlabAllocator::getBlockSize(SlabAllocator::getSizeClass(usedBlock.second)));
+        allocator.deallocate(usedBlock.first, usedBlock.second);
+    }
+    visitedBlocks.clear();
+    allocator.forEachUsedBlock([&visitedBlocks](void* block, size_t blockSize) { visitedBlocks[block] = blockSize; });
+    BOOST_TEST(visitedBlocks.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
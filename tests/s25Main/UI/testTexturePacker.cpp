@@ -3,14 +3,21 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "CollisionDetection.h"
+#include "PointOutput.h"
+#include "ogl/TextureAtlasCache.h"
 #include "ogl/glSmartBitmap.h"
 #include "ogl/glTexturePacker.h"
 #include "uiHelper/uiHelpers.hpp"
 #include "libsiedler2/ArchivItem_Bitmap_Raw.h"
 #include "libsiedler2/PixelBufferBGRA.h"
+#include <rttr/test/TmpFolder.hpp>
+#include <rttr/test/random.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/nowide/fstream.hpp>
 #include <boost/test/unit_test.hpp>
 #include <Rect.h>
 #include <array>
+#include <vector>
 
 BOOST_FIXTURE_TEST_SUITE(TexturePacker, uiHelper::Fixture)
 
@@ -61,4 +68,126 @@ BOOST_AUTO_TEST_CASE(SizeAndPosCorrect)
     }
 }
 
+BOOST_AUTO_TEST_CASE(AtlasesCreatedSeparateFromUpload)
+{
+    std::array<libsiedler2::ArchivItem_Bitmap_Raw, 5> bmps;
+    std::array<glSmartBitmap, 5> smartBmps;
+    glTexturePacker packer;
+    for(unsigned i = 0; i < bmps.size(); ++i)
+    {
+        libsiedler2::PixelBufferBGRA buffer(30, 28 + i, libsiedler2::ColorBGRA(0xFF000000 + i));
+        bmps[i].create(buffer);
+        smartBmps[i].add(&bmps[i]);
+        packer.add(smartBmps[i]);
+    }
+    // Allow only small textures so multiple atlases are required
+    const auto isSizeSupported = [](const Extent& size) { return size.x <= 64u && size.y <= 64u; };
+    BOOST_TEST_REQUIRE(packer.createAtlases(isSizeSupported));
+    BOOST_TEST(packer.getTextures().empty());
+    const std::vector<TextureAtlas> atlases = packer.getAtlases();
+    BOOST_TEST_REQUIRE(atlases.size() == 2u);
+
+    std::vector<unsigned> numPlacements(bmps.size());
+    for(const TextureAtlas& atlas : atlases)
+    {
+        BOOST_TEST(isSizeSupported(atlas.getSize()));
+        for(const TextureAtlas::Placement& placement : atlas.placements)
+        {
+            BOOST_TEST_REQUIRE(placement.itemIdx < bmps.size());
+            numPlacements[placement.itemIdx]++;
+            // Bitmap is drawn at its position
+            const auto color = atlas.pixels.get(atlas.pixels.calcIdx(placement.pos.x, placement.pos.y));
+            BOOST_TEST(color.asValue() == 0xFF000000 + placement.itemIdx);
+            const glSmartBitmap& bmp = smartBmps[placement.itemIdx];
+            BOOST_TEST(bmp.texCoords[0] == PointF(placement.pos) / PointF(atlas.getSize()));
+            BOOST_TEST(!bmp.isGenerated());
+        }
+    }
+    for(const unsigned num : numPlacements)
+        BOOST_TEST(num == 1u);
+
+    // Atlases can be reused for the same bitmaps if they contain every bitmap exactly once
+    glTexturePacker packer2;
+    for(glSmartBitmap& bmp : smartBmps)
+        packer2.add(bmp);
+    std::vector<TextureAtlas> invalidAtlases = atlases;
+    invalidAtlases[0].placements.pop_back();
+    BOOST_TEST(!packer2.setAtlases(invalidAtlases));
+    invalidAtlases[0].placements.push_back(invalidAtlases[1].placements.front());
+    BOOST_TEST(!packer2.setAtlases(invalidAtlases));
+    invalidAtlases = atlases;
+    invalidAtlases[0].placements.front().pos = Extent(60, 60);
+    BOOST_TEST(!packer2.setAtlases(invalidAtlases));
+    BOOST_TEST_REQUIRE(packer2.setAtlases(atlases));
+
+    BOOST_TEST_REQUIRE(packer2.upload());
+    BOOST_TEST(packer2.getAtlases().empty());
+    BOOST_TEST_REQUIRE(packer2.getTextures().size() == atlases.size());
+    for(unsigned i = 0; i < atlases.size(); i++)
+    {
+        for(const TextureAtlas::Placement& placement : atlases[i].placements)
+            BOOST_TEST(smartBmps[placement.itemIdx].getTexture() == packer2.getTextures()[i].get());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(AtlasCacheRoundtrip)
+{
+    rttr::test::TmpFolder tmp;
+    std::vector<TextureAtlas> atlases;
+    atlases.push_back(TextureAtlas{{{1, Extent(0, 0)}, {0, Extent(3, 0)}}, libsiedler2::PixelBufferBGRA(8, 4)});
+    atlases.push_back(TextureAtlas{{{2, Extent(1, 2)}}, libsiedler2::PixelBufferBGRA(2, 16)});
+    for(TextureAtlas& atlas : atlases)
+    {
+        for(unsigned i = 0; i < atlas.getSize().x * atlas.getSize().y; i++)
+            atlas.pixels.set(i, libsiedler2::ColorBGRA(rttr::test::randomValue<uint32_t>()));
+    }
+
+    const TextureAtlasCache cache(tmp / "cache" / "atlases.dat", 42);
+    BOOST_TEST(!cache.load(3));
+    BOOST_TEST_REQUIRE(cache.save(atlases, 3));
+    const auto loaded = cache.load(3);
+    BOOST_TEST_REQUIRE(!!loaded);
+    BOOST_TEST_REQUIRE(loaded->size() == atlases.size());
+    for(unsigned i = 0; i < atlases.size(); i++)
+    {
+        const TextureAtlas& expected = atlases[i];
+        const TextureAtlas& actual = (*loaded)[i];
+        BOOST_TEST(actual.getSize() == expected.getSize());
+        BOOST_TEST_REQUIRE(actual.placements.size() == expected.placements.size());
+        for(unsigned j = 0; j < expected.placements.size(); j++)
+        {
+            BOOST_TEST(actual.placements[j].itemIdx == expected.placements[j].itemIdx);
+            BOOST_TEST(actual.placements[j].pos == expected.placements[j].pos);
+        }
+        for(unsigned j = 0; j < expected.getSize().x * expected.getSize().y; j++)
+            BOOST_TEST(actual.pixels.get(j).asValue() == expected.pixels.get(j).asValue());
+    }
+
+    // Created for other bitmaps or other source data
+    BOOST_TEST(!cache.load(4));
+    BOOST_TEST(!TextureAtlasCache(cache.getFilepath(), 43).load(3));
+    // Truncated
+    boost::filesystem::resize_file(cache.getFilepath(), boost::filesystem::file_size(cache.getFilepath()) - 1);
+    BOOST_TEST(!cache.load(3));
+}
+
+BOOST_AUTO_TEST_CASE(AtlasCacheKeyDependsOnFiles)
+{
+    rttr::test::TmpFolder tmp;
+    const auto calcKey = [&tmp]() {
+        TextureAtlasCache::KeyBuilder key;
+        key.add(true);
+        key.addFileInfo(tmp.get());
+        return key.get();
+    };
+    boost::nowide::ofstream(tmp / "a.lst") << "foo";
+    const uint64_t key = calcKey();
+    BOOST_TEST(calcKey() == key);
+    boost::nowide::ofstream(tmp / "a.lst") << "foobar";
+    const uint64_t keyChanged = calcKey();
+    BOOST_TEST(keyChanged != key);
+    boost::nowide::ofstream(tmp / "b.lst") << "foobar";
+    BOOST_TEST(calcKey() != keyChanged);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -6,21 +6,27 @@
 #include "PlayerInfo.h"
 #include "network/GameClient.h"
 #include "ogl/glAllocator.h"
+#include "pathfinding/FreePathFinder.h"
 #include "world/MapLoader.h"
 #include "libsiedler2/libsiedler2.h"
 #include <rttr/test/Fixture.hpp>
 #include <benchmark/benchmark.h>
 #include <array>
+#include <string>
 #include <test/testConfig.h>
 #include <utility>
 
-constexpr std::array<std::tuple<const char*, MapPoint, MapPoint>, 7> routes = {{{"Simple 1", {85, 147}, {87, 150}},
-                                                                                {"Simple 2", {85, 147}, {85, 152}},
-                                                                                {"Simple 3", {85, 147}, {79, 149}},
-                                                                                {"Medium 1", {85, 147}, {77, 163}},
-                                                                                {"Medium 2", {85, 147}, {79, 127}},
-                                                                                {"Hard", {21, 200}, {42, 188}},
-                                                                                {"Water", {152, 66}, {198, 34}}}};
+constexpr std::array<std::tuple<const char*, MapPoint, MapPoint>, 10> routes = {{{"Simple 1", {85, 147}, {87, 150}},
+                                                                                 {"Simple 2", {85, 147}, {85, 152}},
+                                                                                 {"Simple 3", {85, 147}, {79, 149}},
+                                                                                 {"Medium 1", {85, 147}, {77, 163}},
+                                                                                 {"Medium 2", {85, 147}, {79, 127}},
+                                                                                 {"Hard", {21, 200}, {42, 188}},
+                                                                                 {"Long 1", {85, 147}, {21, 200}},
+                                                                                 {"Long 2", {42, 188}, {79, 127}},
+                                                                                 {"Long 3", {87, 150}, {42, 188}},
+                                                                                 {"Water", {152, 66}, {198, 34}}}};
+constexpr size_t firstShipRoute = 9;
 
 static void BM_PathFinding(benchmark::State& state)
 {
@@ -36,19 +42,35 @@ static void BM_PathFinding(benchmark::State& state)
     if(!loader.Load(rttr::test::rttrBaseDir / "data/RTTR/MAPS/NEW/AM_FANGDERZEIT.SWD"))
         state.SkipWithError("Map failed to load");
 
-    const auto& curValues = routes[static_cast<size_t>(state.range())];
-    state.SetLabel(std::get<0>(curValues));
+    const auto routeIdx = static_cast<size_t>(state.range(0));
+    const bool useHierarchical = state.range(1) != 0;
+    const auto& curValues = routes[routeIdx];
+    state.SetLabel(std::string(std::get<0>(curValues)) + (useHierarchical ? " (hierarchical)" : " (flat)"));
     const MapPoint start = std::get<1>(curValues);
     const MapPoint goal = std::get<2>(curValues);
+    world.GetFreePathFinder().SetHierarchicalPathfinding(useHierarchical);
 
+    const auto findPath = [&]() {
+        return routeIdx < firstShipRoute ? world.FindHumanPath(start, goal).has_value() :
+                                           world.FindShipPath(start, goal, 600, nullptr, nullptr);
+    };
+    // Build the cluster graph before measuring
+    findPath();
     for(auto _ : state)
     {
-        const bool result = state.range() < 6 ? world.FindHumanPath(start, goal).has_value() :
-                                                world.FindShipPath(start, goal, 600, nullptr, nullptr);
+        const bool result = findPath();
         benchmark::DoNotOptimize(result);
     }
 }
-BENCHMARK(BM_PathFinding)->DenseRange(0, routes.size() - 1);
+static void PathFindingArguments(benchmark::internal::Benchmark* b)
+{
+    for(int i = 0; i < static_cast<int>(routes.size()); i++)
+    {
+        b->Args({i, 0});
+        b->Args({i, 1});
+    }
+}
+BENCHMARK(BM_PathFinding)->Apply(PathFindingArguments);
 
 constexpr std::array<std::tuple<const char*, unsigned>, 3> maps = {
   {{"AM_FANGDERZEIT", 7}, {"TueranTuer", 2}, {"Suedameri", 5}}};
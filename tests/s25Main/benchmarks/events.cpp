@@ -0,0 +1,83 @@
+// Copyright (C) 2005 - 2021 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "EventManager.h"
+#include "GameEvent.h"
+#include "GameObject.h"
+#include <benchmark/benchmark.h>
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace {
+class BenchObject : public GameObject
+{
+    EventManager& em;
+    std::array<const GameEvent*, 3> events;
+
+public:
+    explicit BenchObject(EventManager& em) : em(em)
+    {
+        // Short, medium and long running events similar to a walking figure in a building
+        events = {em.AddEvent(this, 20), em.AddEvent(this, 2000), em.AddEvent(this, 500000)};
+    }
+    void Destroy() override
+    {
+        for(const GameEvent*& ev : events)
+            em.RemoveEvent(ev);
+    }
+    // LCOV_EXCL_START
+    void Serialize(SerializedGameData&) const override {}
+    GO_Type GetGOT() const final { return GO_Type::Staticobject; }
+    // LCOV_EXCL_STOP
+};
+} // namespace
+
+static void BM_KillObjects(benchmark::State& state)
+{
+    const auto numObjects = static_cast<unsigned>(state.range(0));
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        auto em = std::make_unique<EventManager>(0);
+        // Objects staying alive, so there are other events in the queue
+        std::vector<std::unique_ptr<BenchObject>> survivors;
+        for(unsigned i = 0; i < numObjects; i++)
+            survivors.push_back(std::make_unique<BenchObject>(*em));
+        std::vector<BenchObject*> victims;
+        for(unsigned i = 0; i < numObjects; i++)
+            victims.push_back(new BenchObject(*em));
+        state.ResumeTiming();
+
+        for(BenchObject* obj : victims)
+            em->AddToKillList(obj);
+        em->ExecuteNextGF();
+
+        state.PauseTiming();
+        em.reset();
+        survivors.clear();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_KillObjects)->Arg(100)->Arg(1000)->Arg(10000);
+
+static void BM_AddAndExecuteEvents(benchmark::State& state)
+{
+    const auto numObjects = static_cast<unsigned>(state.range(0));
+    EventManager em(0);
+    std::vector<std::unique_ptr<BenchObject>> objects;
+    for(unsigned i = 0; i < numObjects; i++)
+        objects.push_back(std::make_unique<BenchObject>(em));
+    for(auto _ : state)
+    {
+        for(unsigned i = 0; i < numObjects; i++)
+            em.AddEvent(objects[i].get(), 1 + i % 50);
+        for(unsigned i = 0; i < 50; i++)
+            em.ExecuteNextGF();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    em.Clear();
+}
+BENCHMARK(BM_AddAndExecuteEvents)->Arg(1000)->Arg(10000);
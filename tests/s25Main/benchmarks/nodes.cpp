@@ -0,0 +1,127 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "Game.h"
+#include "PlayerInfo.h"
+#include "RttrForeachPt.h"
+#include "figures/nofCarrier.h"
+#include "lua/GameDataLoader.h"
+#include "ogl/glAllocator.h"
+#include "world/GameWorld.h"
+#include "gameData/TerrainDesc.h"
+#include "libsiedler2/libsiedler2.h"
+#include <rttr/test/Fixture.hpp>
+#include <benchmark/benchmark.h>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr MapExtent mapSize(256, 256);
+
+/// Create a flat world with the given number of players where the first one owns the whole map
+std::unique_ptr<Game> createFlatWorld(const unsigned numPlayers)
+{
+    std::vector<PlayerInfo> players(numPlayers);
+    for(PlayerInfo& player : players)
+        player.ps = PlayerState::Occupied;
+    auto game = std::make_unique<Game>(GlobalGameSettings(), 0, players);
+    GameWorld& world = game->world_;
+    loadGameData(world.GetDescriptionWriteable());
+    world.Init(mapSize);
+    DescIdx<TerrainDesc> t(0);
+    const WorldDescription& desc = world.GetDescription();
+    for(; t.value < desc.terrain.size(); t.value++)
+    {
+        if(desc.get(t).Is(ETerrain::Buildable) && desc.get(t).kind == TerrainKind::Land)
+            break;
+    }
+    RTTR_FOREACH_PT(MapPoint, mapSize)
+    {
+        MapNode& node = world.GetNodeWriteable(pt);
+        node.t1 = node.t2 = t;
+        world.SetOwner(pt, 1);
+    }
+    world.InitAfterLoad();
+    return game;
+}
+} // namespace
+
+/// Recalculate the BQ of all nodes which reads the terrain, objects and owners of each node and its surrounding.
+/// The number of players should not matter as their FoW is not stored in the nodes
+static void BM_RecalcBQ(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    libsiedler2::setAllocator(new GlAllocator);
+
+    const auto game = createFlatWorld(static_cast<unsigned>(state.range(0)));
+    GameWorld& world = game->world_;
+    for(auto _ : state)
+    {
+        RTTR_FOREACH_PT(MapPoint, mapSize)
+            world.RecalcBQ(pt);
+    }
+    state.SetItemsProcessed(state.iterations() * prodOfComponents(mapSize));
+}
+BENCHMARK(BM_RecalcBQ)->Arg(2)->Arg(8)->Unit(benchmark::kMillisecond);
+
+/// Find paths for figures between varying points far away from each other
+static void BM_FindHumanPath(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    libsiedler2::setAllocator(new GlAllocator);
+
+    const auto game = createFlatWorld(static_cast<unsigned>(state.range(0)));
+    const GameWorld& world = game->world_;
+    MapPoint start(0, 0);
+    for(auto _ : state)
+    {
+        const MapPoint goal((start.x + mapSize.x / 3) % mapSize.x, (start.y + mapSize.y / 3) % mapSize.y);
+        benchmark::DoNotOptimize(world.FindHumanPath(start, goal, std::numeric_limits<unsigned>::max()));
+        start.x = (start.x + 37) % mapSize.x;
+        if(start.x < 37)
+            start.y = (start.y + 1) % mapSize.y;
+    }
+}
+BENCHMARK(BM_FindHumanPath)->Arg(2)->Arg(8);
+
+/// Let carriers walk east by one node each, moving them between the figure lists of the nodes.
+/// Then look at the other figures on the new node as the walking code does to find figures to wait for
+static void BM_WalkCarriers(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    libsiedler2::setAllocator(new GlAllocator);
+
+    const auto game = createFlatWorld(2);
+    GameWorld& world = game->world_;
+    const auto numCarriers = static_cast<unsigned>(state.range(0));
+    std::vector<std::pair<nofCarrier*, MapPoint>> carriers;
+    carriers.reserve(numCarriers);
+    for(unsigned i = 0; i < numCarriers; i++)
+    {
+        // Spread over the map with some nodes having multiple carriers
+        const MapPoint pt((i * 7) % mapSize.x, (i * 13) % mapSize.y);
+        auto& carrier = world.AddFigure(pt, std::make_unique<nofCarrier>(CarrierType::Normal, pt, 0, nullptr, nullptr));
+        carriers.emplace_back(&carrier, pt);
+    }
+    for(auto _ : state)
+    {
+        for(auto& carrier : carriers)
+        {
+            const MapPoint newPos = world.GetNeighbour(carrier.second, Direction::East);
+            world.AddFigure(newPos, world.RemoveFigure(carrier.second, *carrier.first));
+            carrier.second = newPos;
+            unsigned numMoving = 0;
+            for(const noBase& figure : world.GetFigures(newPos))
+            {
+                if(figure.IsMoving())
+                    numMoving++;
+            }
+            benchmark::DoNotOptimize(numMoving);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * numCarriers);
+}
+BENCHMARK(BM_WalkCarriers)->Arg(10000);
@@ -0,0 +1,59 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "world/MapBase.h"
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr MapExtent mapSize(256, 256);
+
+/// Next center point to use, so the benchmark is not working on the same (cached) points all the time
+MapPoint nextCenter(MapPoint pt)
+{
+    pt.x = (pt.x + 37) % mapSize.x;
+    if(pt.x < 37)
+        pt.y = (pt.y + 1) % mapSize.y;
+    return pt;
+}
+} // namespace
+
+/// Visit all points in a radius (including the center) around varying points
+/// either by getting a vector of points (GetPointsInRadiusWithCenter) or by iterating over the range (PointsInRadius)
+static void BM_PointsInRadius(benchmark::State& state)
+{
+    MapBase world;
+    world.Resize(mapSize);
+    const auto radius = static_cast<unsigned>(state.range(0));
+    const bool useVector = state.range(1) != 0;
+    state.SetLabel(useVector ? "vector" : "range");
+
+    MapPoint center(0, 0);
+    for(auto _ : state)
+    {
+        unsigned sum = 0;
+        if(useVector)
+        {
+            for(const MapPoint pt : world.GetPointsInRadiusWithCenter(center, radius))
+                sum += pt.x + pt.y;
+        } else
+        {
+            for(const MapPoint pt : world.PointsInRadius(center, radius, true))
+                sum += pt.x + pt.y;
+        }
+        benchmark::DoNotOptimize(sum);
+        center = nextCenter(center);
+    }
+    state.SetItemsProcessed(state.iterations() * world.PointsInRadius(center, radius, true).size());
+}
+static void PointsInRadiusArguments(benchmark::internal::Benchmark* b)
+{
+    for(const int radius : {1, 2, 5, 10, 20})
+    {
+        b->Args({radius, 1});
+        b->Args({radius, 0});
+    }
+}
+BENCHMARK(BM_PointsInRadius)->Apply(PointsInRadiusArguments);
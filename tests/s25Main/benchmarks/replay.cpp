@@ -0,0 +1,192 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "EventManager.h"
+#include "Game.h"
+#include "GameObject.h"
+#include "GamePlayer.h"
+#include "PlayerInfo.h"
+#include "Replay.h"
+#include "SimulationPhaseTimes.h"
+#include "ai/AIPlayer.h"
+#include "factories/AIFactory.h"
+#include "helpers/EnumArray.h"
+#include "helpers/EnumRange.h"
+#include "helpers/SlabAllocator.h"
+#include "network/PlayerGameCommands.h"
+#include "ogl/glAllocator.h"
+#include "random/Random.h"
+#include "variant.h"
+#include "world/GameWorld.h"
+#include "world/MapLoader.h"
+#include "gameTypes/MapInfo.h"
+#include "libsiedler2/libsiedler2.h"
+#include "s25util/tmpFile.h"
+#include <rttr/test/Fixture.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <test/testConfig.h>
+#include <utility>
+
+// Replays from tests/testData also used by the autoplay test
+constexpr std::array<const char*, 2> replays = {{"200kGFs.rpl", "SeaMap300kGfs.rpl"}};
+
+static size_t getNumAllocations(const helpers::SlabAllocator& allocator)
+{
+    size_t result = allocator.getLargeStats().numAllocations;
+    for(size_t i = 0; i < helpers::SlabAllocator::numSizeClasses; i++)
+        result += allocator.getStats(i).numAllocations;
+    return result;
+}
+
+/// Plays the first GFs of a stored replay without GUI and reports the simulated GFs per second.
+/// Additionally the time spent in the phases of the simulation is reported (in ms, phases overlap).
+/// The hits and misses of the road route caches of the players show how many path searches of figures were saved.
+/// The allocations of game objects and events while simulating and the memory of the slabs holding them are reported
+/// too.
+/// If requested the AIs are run too (their commands are discarded as the replay already contains them)
+static void BM_PlayReplay(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    libsiedler2::setAllocator(new GlAllocator);
+
+    const char* replayName = replays[static_cast<size_t>(state.range(0))];
+    const auto numGFs = static_cast<unsigned>(state.range(1));
+    const bool runAIs = state.range(2) != 0;
+    state.SetLabel(std::string(replayName) + (runAIs ? " (with AIs)" : ""));
+
+    helpers::EnumArray<SimulationPhaseTimes::duration, SimulationPhase> totalPhaseTimes{};
+    unsigned totalGFs = 0;
+    unsigned routeCacheHits = 0, routeCacheMisses = 0;
+    size_t objAllocations = 0, maxReservedBytes = 0;
+    size_t eventAllocations = 0, maxEventReservedBytes = 0;
+    for(auto _ : state)
+    {
+        state.PauseTiming();
+        Replay replay;
+        MapInfo mapInfo;
+        if(!replay.LoadHeader(rttr::test::rttrBaseDir / "tests" / "testData" / replayName)
+           || !replay.LoadGameData(mapInfo) || mapInfo.savegame)
+        {
+            state.SkipWithError("Replay failed to load");
+            break;
+        }
+        TmpFile mapfile;
+        mapfile.close();
+        if(!mapInfo.mapData.DecompressToFile(mapfile.filePath))
+        {
+            state.SkipWithError("Map failed to decompress");
+            break;
+        }
+
+        std::vector<PlayerInfo> players;
+        for(unsigned i = 0; i < replay.GetNumPlayers(); i++)
+            players.emplace_back(replay.GetPlayer(i));
+        Game game(replay.ggs, /*startGF*/ 0, players);
+        RANDOM.Init(replay.getSeed());
+        GameWorld& world = game.world_;
+        for(unsigned i = 0; i < world.GetNumPlayers(); ++i)
+            world.GetPlayer(i).MakeStartPacts();
+        MapLoader loader(world);
+        if(!loader.Load(mapfile.filePath))
+        {
+            state.SkipWithError("Map failed to load");
+            break;
+        }
+        world.SetupResources();
+        if(runAIs)
+        {
+            for(unsigned i = 0; i < world.GetNumPlayers(); ++i)
+            {
+                if(world.GetPlayer(i).ps == PlayerState::AI)
+                    game.AddAIPlayer(AIFactory::Create(world.GetPlayer(i).aiInfo, i, world));
+            }
+        }
+        world.InitAfterLoad();
+
+        auto nextGF = replay.ReadGF();
+        const helpers::SlabAllocator& objAllocator = GameObject::GetContext().objAllocator;
+        const size_t startObjAllocations = getNumAllocations(objAllocator);
+        const helpers::SlabAllocator& eventAllocator = GameObject::GetContext().eventAllocator;
+        const size_t startEventAllocations = getNumAllocations(eventAllocator);
+        SimulationPhaseTimes::Reset();
+        SimulationPhaseTimes::Enable(true);
+        state.ResumeTiming();
+
+        while(game.em_->GetCurrentGF() < numGFs)
+        {
+            const unsigned curGF = game.em_->GetCurrentGF();
+            while(nextGF && *nextGF == curGF)
+            {
+                const auto cmd = replay.ReadCommand();
+                if(const auto* gameCmd = get_if<Replay::GameCommand>(&cmd))
+                {
+                    for(const gc::GameCommandPtr& gc : gameCmd->cmds.gcs)
+                        gc->Execute(world, gameCmd->player);
+                }
+                nextGF = replay.ReadGF();
+            }
+            if(runAIs)
+            {
+                // Same NWF length as in ai-battle
+                const bool isNWF = curGF % 20 == 0;
+                if(isNWF)
+                {
+                    for(AIPlayer& ai : game.aiPlayers_)
+                        ai.FetchGameCommands();
+                }
+                game.RunAIs(curGF, isNWF);
+            }
+            game.RunGF();
+        }
+
+        state.PauseTiming();
+        SimulationPhaseTimes::Enable(false);
+        for(const auto phase : helpers::enumRange<SimulationPhase>())
+            totalPhaseTimes[phase] += SimulationPhaseTimes::GetTime(phase);
+        totalGFs += game.em_->GetCurrentGF();
+        objAllocations += getNumAllocations(objAllocator) - startObjAllocations;
+        maxReservedBytes = std::max(maxReservedBytes, objAllocator.getReservedBytes());
+        eventAllocations += getNumAllocations(eventAllocator) - startEventAllocations;
+        maxEventReservedBytes = std::max(maxEventReservedBytes, eventAllocator.getReservedBytes());
+        for(unsigned i = 0; i < world.GetNumPlayers(); ++i)
+        {
+            routeCacheHits += world.GetPlayer(i).GetRoadRouteCache().GetNumHits();
+            routeCacheMisses += world.GetPlayer(i).GetRoadRouteCache().GetNumMisses();
+        }
+        state.ResumeTiming();
+    }
+
+    state.counters["GFs"] = benchmark::Counter(totalGFs, benchmark::Counter::kIsRate);
+    // Paths of figures on roads taken from the route caches or searched
+    state.counters["RouteCacheHits"] = benchmark::Counter(routeCacheHits, benchmark::Counter::kAvgIterations);
+    state.counters["RouteCacheMisses"] = benchmark::Counter(routeCacheMisses, benchmark::Counter::kAvgIterations);
+    state.counters["ObjAllocations"] = benchmark::Counter(objAllocations, benchmark::Counter::kAvgIterations);
+    state.counters["ObjSlabs[KiB]"] = benchmark::Counter(maxReservedBytes / 1024.);
+    state.counters["EventAllocations"] = benchmark::Counter(eventAllocations, benchmark::Counter::kAvgIterations);
+    state.counters["EventSlabs[KiB]"] = benchmark::Counter(maxEventReservedBytes / 1024.);
+    for(const auto phase : helpers::enumRange<SimulationPhase>())
+    {
+        const auto ms = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(totalPhaseTimes[phase]);
+        state.counters[std::string(getName(phase)) + "[ms]"] =
+          benchmark::Counter(ms.count(), benchmark::Counter::kAvgIterations);
+    }
+}
+static void PlayReplayArguments(benchmark::internal::Benchmark* b)
+{
+    for(int i = 0; i < static_cast<int>(replays.size()); i++)
+    {
+        b->Args({i, 20000, 0});
+        b->Args({i, 20000, 1});
+    }
+}
+BENCHMARK(BM_PlayReplay)
+  ->Apply(PlayReplayArguments)
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime()
+  ->Iterations(1);
@@ -0,0 +1,161 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "FindWhConditions.h"
+#include "Game.h"
+#include "GamePlayer.h"
+#include "PlayerInfo.h"
+#include "RttrForeachPt.h"
+#include "buildings/nobBaseWarehouse.h"
+#include "factories/BuildingFactory.h"
+#include "lua/GameDataLoader.h"
+#include "ogl/glAllocator.h"
+#include "pathfinding/RoadPathFinder.h"
+#include "world/GameWorld.h"
+#include "nodeObjs/noFlag.h"
+#include "gameData/TerrainDesc.h"
+#include "libsiedler2/libsiedler2.h"
+#include <rttr/test/Fixture.hpp>
+#include <benchmark/benchmark.h>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+constexpr MapExtent mapSize(128, 128);
+/// Distance between 2 flags of the road grid
+constexpr unsigned flagDistance = 4;
+
+/// Create a flat world owned by player 0 covered by a grid of roads with the given number of storehouses at its flags.
+/// Return the flags of the grid
+std::vector<const noFlag*> createRoadGrid(GameWorld& world, const unsigned numWarehouses)
+{
+    loadGameData(world.GetDescriptionWriteable());
+    world.Init(mapSize);
+    DescIdx<TerrainDesc> t(0);
+    const WorldDescription& desc = world.GetDescription();
+    for(; t.value < desc.terrain.size(); t.value++)
+    {
+        if(desc.get(t).Is(ETerrain::Buildable) && desc.get(t).kind == TerrainKind::Land)
+            break;
+    }
+    RTTR_FOREACH_PT(MapPoint, mapSize)
+    {
+        MapNode& node = world.GetNodeWriteable(pt);
+        node.t1 = node.t2 = t;
+        world.SetOwner(pt, 1);
+    }
+    world.InitAfterLoad();
+    RTTR_FOREACH_PT(MapPoint, mapSize)
+        world.RecalcBQ(pt);
+
+    // Flags on even rows so going SouthEast and SouthWest alternating leads straight down
+    std::vector<MapPoint> flagPts;
+    for(MapCoord y = flagDistance / 2; y < mapSize.y; y += flagDistance)
+    {
+        for(MapCoord x = flagDistance / 2; x < mapSize.x; x += flagDistance)
+        {
+            world.SetFlag(MapPoint(x, y), 0);
+            flagPts.push_back(MapPoint(x, y));
+        }
+    }
+    const std::vector<Direction> eastRoute(flagDistance, Direction::East);
+    std::vector<Direction> southRoute;
+    for(unsigned i = 0; i < flagDistance / 2; i++)
+    {
+        southRoute.push_back(Direction::SouthEast);
+        southRoute.push_back(Direction::SouthWest);
+    }
+    for(const MapPoint pt : flagPts)
+    {
+        world.BuildRoad(0, false, pt, eastRoute);
+        world.BuildRoad(0, false, pt, southRoute);
+    }
+
+    std::vector<const noFlag*> flags;
+    for(const MapPoint pt : flagPts)
+        flags.push_back(world.GetSpecObj<noFlag>(pt));
+    // Spread the storehouses pseudo-randomly but deterministic over the grid
+    for(unsigned i = 0; i < numWarehouses; i++)
+    {
+        const MapPoint flagPt = flagPts[(i * 7919u) % flagPts.size()];
+        BuildingFactory::CreateBuilding(world, BuildingType::Storehouse, world.GetNeighbour(flagPt, Direction::NorthWest),
+                                        0, Nation::Romans);
+    }
+    return flags;
+}
+
+/// Previous implementation of GamePlayer::FindWarehouse: One search per warehouse
+nobBaseWarehouse* findWarehouseSeparately(const GameWorld& world, const noRoadNode& start, bool toWarehouse,
+                                          bool wareMode)
+{
+    nobBaseWarehouse* best = nullptr;
+    unsigned bestLength = std::numeric_limits<unsigned>::max();
+    for(nobBaseWarehouse* wh : world.GetPlayer(0).GetBuildingRegister().GetStorehouses())
+    {
+        if(world.CalcDistance(start.GetPos(), wh->GetPos()) > bestLength)
+            continue;
+        unsigned length;
+        if(world.GetRoadPathFinder().FindPath(toWarehouse ? start : *wh, toWarehouse ? *wh : start, wareMode,
+                                              bestLength, nullptr, &length)
+           && (length < bestLength || !best))
+        {
+            bestLength = length;
+            best = wh;
+        }
+    }
+    return best;
+}
+} // namespace
+
+/// Search the nearest warehouse from every flag of a road grid with the given number of warehouses
+/// either with one search per warehouse (as before) or a single search for all of them
+static void BM_FindWarehouse(benchmark::State& state)
+{
+    rttr::test::Fixture f;
+    libsiedler2::setAllocator(new GlAllocator);
+
+    const auto numWarehouses = static_cast<unsigned>(state.range(0));
+    const bool separateSearches = state.range(1) != 0;
+    const bool wareMode = state.range(2) != 0;
+    state.SetLabel(std::string(separateSearches ? "separate searches" : "single search")
+                   + (wareMode ? ", wares" : ", figures"));
+
+    std::vector<PlayerInfo> players(1);
+    players[0].ps = PlayerState::Occupied;
+    Game game(GlobalGameSettings(), 0, players);
+    GameWorld& world = game.world_;
+    const std::vector<const noFlag*> flags = createRoadGrid(world, numWarehouses);
+    const GamePlayer& player = world.GetPlayer(0);
+    if(player.GetBuildingRegister().GetStorehouses().size() != numWarehouses
+       || !player.FindWarehouse(*flags.back(), FW::NoCondition(), true, false))
+    {
+        state.SkipWithError("Road grid not created");
+        return;
+    }
+
+    unsigned curFlagIdx = 0;
+    for(auto _ : state)
+    {
+        const noFlag& start = *flags[curFlagIdx];
+        curFlagIdx = (curFlagIdx + 1) % flags.size();
+        // Wares are sent to warehouses, figures come from them
+        const nobBaseWarehouse* wh = separateSearches ?
+                                       findWarehouseSeparately(world, start, wareMode, wareMode) :
+                                       player.FindWarehouse(start, FW::NoCondition(), wareMode, wareMode);
+        benchmark::DoNotOptimize(wh);
+    }
+}
+static void FindWarehouseArguments(benchmark::internal::Benchmark* b)
+{
+    for(const int numWarehouses : {1, 5, 20, 50})
+    {
+        for(const int separateSearches : {1, 0})
+        {
+            b->Args({numWarehouses, separateSearches, 0});
+            b->Args({numWarehouses, separateSearches, 1});
+        }
+    }
+}
+BENCHMARK(BM_FindWarehouse)->Apply(FindWarehouseArguments);
@@ -2,9 +2,12 @@
 //
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "AsyncChecksum.h"
+#include "GameObject.h"
 #include "PointOutput.h"
 #include "RttrForeachPt.h"
 #include "ai/AIPlayer.h"
+#include "ai/AIThreadPool.h"
 #include "ai/aijh/AIPlayerJH.h"
 #include "buildings/noBuilding.h"
 #include "buildings/noBuildingSite.h"
@@ -15,6 +18,8 @@
 #include "helpers/containerUtils.h"
 #include "network/GameMessage_Chat.h"
 #include "notifications/NodeNote.h"
+#include "pathfinding/PathfindingLock.h"
+#include "random/Random.h"
 #include "worldFixtures/WorldWithGCExecution.h"
 #include "nodeObjs/noFlag.h"
 #include "nodeObjs/noTree.h"
@@ -23,14 +28,20 @@
 #include "gameData/MilitaryConsts.h"
 #include "rttr/test/random.hpp"
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <memory>
+#include <mutex>
 #include <set>
+#include <stdexcept>
 
 namespace {
 // We need border land
 using BiggerWorldWithGCExecution = WorldWithGCExecution<1, 24, 22>;
 using EmptyWorldFixture1P = WorldFixture<CreateEmptyWorld, 1>;
 using EmptyWorldFixture2P = WorldFixture<CreateEmptyWorld, 2>;
+using EmptyWorldFixture4P = WorldFixture<CreateEmptyWorld, 4>;
 
 template<class T_Col>
 inline bool containsBldType(const T_Col& collection, BuildingType type)
@@ -59,6 +70,56 @@ struct MockAI final : public AIPlayer
     void OnChatMessage(unsigned /*sendPlayerId*/, ChatDestination, const std::string& /*msg*/) override {}
     // LCOV_EXCL_STOP
 };
+
+struct CountingAI final : public AIPlayer
+{
+    CountingAI(unsigned char playerId, const GameWorldBase& gwb) : AIPlayer(playerId, gwb, AI::Level::Easy) {}
+    std::atomic<unsigned> numRuns{0};
+    unsigned lastGF = 0;
+    const GameWorld* contextWorld = nullptr;
+    bool throwOnRun = false;
+    void RunGF(unsigned gf, bool /*gfisnwf*/) override
+    {
+        lastGF = gf;
+        contextWorld = GameObject::GetContext().world;
+        ++numRuns;
+        if(throwOnRun)
+            throw std::runtime_error("AI failed");
+    }
+    // LCOV_EXCL_START
+    void OnChatMessage(unsigned /*sendPlayerId*/, ChatDestination, const std::string& /*msg*/) override {}
+    // LCOV_EXCL_STOP
+};
+
+/// Let 2 AIs play on an empty world for the given number of GFs and return the checksum of the game
+AsyncChecksum runAIGame(const unsigned seed, const unsigned numGFs)
+{
+    RANDOM.Init(seed);
+    Game game(GlobalGameSettings(), std::make_unique<TestEventManager>(),
+              std::vector<PlayerInfo>(2, EmptyWorldFixture2P::GetPlayer()));
+    GameWorld& world = game.world_;
+    if(!CreateEmptyWorld(MapExtent(40, 20))(world))
+        throw std::runtime_error("World creation failed");
+    for(unsigned char i = 0; i < world.GetNumPlayers(); i++)
+        game.AddAIPlayer(AIFactory::Create(AI::Info(AI::Type::Default, AI::Level::Hard), i, world));
+    game.Start(false);
+    while(game.em_->GetCurrentGF() < numGFs)
+    {
+        const unsigned gf = game.em_->GetCurrentGF();
+        const bool isNWF = gf % 20 == 0;
+        if(isNWF)
+        {
+            for(AIPlayer& ai : game.aiPlayers_)
+            {
+                for(const gc::GameCommandPtr& gc : ai.FetchGameCommands())
+                    gc->Execute(world, ai.GetPlayerId());
+            }
+        }
+        game.RunAIs(gf, isNWF);
+        game.RunGF();
+    }
+    return AsyncChecksum::create(game);
+}
 } // namespace
 
 // Note game command execution is emulated to be like the ones send via network:
@@ -109,6 +170,89 @@ BOOST_FIXTURE_TEST_CASE(AIChat, EmptyWorldFixture2P)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(AIThreadPoolRunsEachAIOnce, EmptyWorldFixture4P)
+{
+    std::vector<std::unique_ptr<CountingAI>> ais;
+    std::vector<AIPlayer*> aiPtrs;
+    for(unsigned char i = 0; i < world.GetNumPlayers(); i++)
+    {
+        ais.push_back(std::make_unique<CountingAI>(i, world));
+        aiPtrs.push_back(ais.back().get());
+    }
+    for(const unsigned numThreads : {0u, 1u, 3u, 8u})
+    {
+        AIThreadPool pool(numThreads);
+        BOOST_TEST(pool.GetNumThreads() == std::max(numThreads, 1u));
+        for(unsigned gf = 1; gf <= 50; gf++)
+        {
+            pool.RunGF(aiPtrs, gf, gf % 10 == 0);
+            for(const auto& ai : ais)
+            {
+                BOOST_TEST_REQUIRE(ai->lastGF == gf);
+                // Workers use the world of the game
+                BOOST_TEST_REQUIRE(ai->contextWorld == &world);
+            }
+        }
+    }
+    for(const auto& ai : ais)
+        BOOST_TEST(ai->numRuns == 4u * 50u);
+
+    // Exceptions are passed on after all AIs ran
+    AIThreadPool pool(3);
+    ais[1]->throwOnRun = true;
+    BOOST_CHECK_THROW(pool.RunGF(aiPtrs, 51, false), std::runtime_error);
+    for(const auto& ai : ais)
+        BOOST_TEST(ai->lastGF == 51u);
+    // And the pool is still usable
+    ais[1]->throwOnRun = false;
+    pool.RunGF(aiPtrs, 52, false);
+    for(const auto& ai : ais)
+        BOOST_TEST(ai->numRuns == 4u * 50u + 2u);
+}
+
+BOOST_FIXTURE_TEST_CASE(PathfindingIsLockedOnAIThreads, EmptyWorldFixture1P)
+{
+    std::mutex& mutex = world.GetPathfindingMutex();
+    const auto isLocked = [&mutex]() {
+        return std::async(std::launch::async, [&mutex]() {
+                   if(!mutex.try_lock())
+                       return true;
+                   mutex.unlock();
+                   return false;
+               })
+          .get();
+    };
+    // The game itself never searches concurrently
+    {
+        PathfindingLock lock(world);
+        BOOST_TEST(!isLocked());
+    }
+    PathfindingLock::AIThreadScope aiThreadScope;
+    {
+        PathfindingLock lock(world);
+        BOOST_TEST(isLocked());
+        // Nested searches lock only once
+        {
+            PathfindingLock nestedLock(world);
+            BOOST_TEST(isLocked());
+        }
+        BOOST_TEST(isLocked());
+    }
+    BOOST_TEST(!isLocked());
+BOOST_AUTO_TEST_CASE(GamesOnDifferentThreadsAreIndependent)
+{
+    constexpr unsigned numGFs = 1000;
+    const AsyncChecksum expected1 = runAIGame(42, numGFs);
+    const AsyncChecksum expected2 = runAIGame(1337, numGFs);
+    BOOST_TEST_REQUIRE(expected1 != expected2);
+
+    // Same results when running both games at the same time
+    auto game1 = std::async(std::launch::async, runAIGame, 42, numGFs);
+    auto game2 = std::async(std::launch::async, runAIGame, 1337, numGFs);
+    BOOST_TEST(game1.get() == expected1);
+    BOOST_TEST(game2.get() == expected2);
+}
+
 BOOST_FIXTURE_TEST_CASE(KeepBQUpdated, BiggerWorldWithGCExecution)
 {
     // Place some trees to reduce BQ at some points
@@ -315,7 +459,7 @@ void forceExpansion(const GamePlayer& player, GameWorld& world)
 }
 
 void runUntilMilitaryBuildingSiteFound(TestEventManager& em, unsigned curPlayer, GameWorld& world,
-                                       const std::list<noBuildingSite*>& bldSites)
+                                       const std::vector<noBuildingSite*>& bldSites)
 {
     auto ai = AIFactory::Create(AI::Info(AI::Type::Default, AI::Level::Hard), curPlayer, world);
     for(unsigned gf = 0; gf < 2000;)
@@ -338,13 +338,13 @@ BOOST_FIXTURE_TEST_CASE(StartAttack, AttackFixture<>)
     AddSoldiers(milBld1Pos, 1, 0);
     BOOST_TEST_REQUIRE(!milBld1->IsNewBuilt());
     // Try to attack invisible bld -> Fail
-    MapNode& node = world.GetNodeWriteable(milBld1Pos);
-    node.fow[0].visibility = Visibility::FogOfWar;
+    FoWNode& fowNode = world.GetFoWNodeWriteable(milBld1Pos, 0);
+    fowNode.visibility = Visibility::FogOfWar;
     BOOST_TEST_REQUIRE(world.CalcVisiblityWithAllies(milBld1Pos, curPlayer) == Visibility::FogOfWar);
     TestFailingAttack(gwv, milBld1Pos, attackSrc);
 
     // Attack it
-    node.fow[0].visibility = Visibility::Visible;
+    fowNode.visibility = Visibility::Visible;
     BOOST_TEST_REQUIRE(attackSrc.GetNumTroops() == 6u);
     auto itTroops = attackSrc.GetTroops().begin();
     for(int i = 0; i < 3; i++, ++itTroops)
@@ -12,11 +12,14 @@
 #include "figures/nofScout_Free.h"
 #include "notifications/ResourceNote.h"
 #include "worldFixtures/WorldWithGCExecution.h"
+#include "world/VisionMap.h"
 #include "nodeObjs/noFlag.h"
 #include "nodeObjs/noSign.h"
 #include "gameTypes/GameTypesOutput.h"
+#include "gameData/MilitaryConsts.h"
 #include "rttr/test/random.hpp"
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <vector>
 
 BOOST_AUTO_TEST_SUITE(FigureTests)
@@ -102,6 +105,48 @@ BOOST_FIXTURE_TEST_CASE(ScoutScouts, EmptyWorldFixture1PBig)
     BOOST_TEST(countVisibleNodes() == prodOfComponents(world.GetSize()));
 }
 
+BOOST_FIXTURE_TEST_CASE(VisionMapFollowsScout, EmptyWorldFixture1PBig)
+{
+    const MapPoint hqFlagPos = world.GetNeighbour(world.GetPlayer(0).GetHQPos(), Direction::SouthEast);
+    auto& scout = world.AddFigure(
+      hqFlagPos, std::make_unique<nofScout_Free>(hqFlagPos, 0, world.GetSpecObj<noRoadNode>(hqFlagPos)));
+    scout.ActAtFirst();
+    const VisionMap& visionMap = world.GetVisionMap();
+    const MapPoint hqPos = world.GetPlayer(0).GetHQPos();
+    // Besides the HQ the scout must be the only viewer and see everything in its range around its current position
+    const auto checkViewers = [&]() {
+        std::vector<MapPoint> scoutPositions;
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            for(const noBase& figure : world.GetFigures(pt))
+            {
+                if(figure.GetGOT() == GO_Type::NofScoutFree)
+                    scoutPositions.push_back(pt);
+            }
+        }
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            auto numViewers = static_cast<unsigned>(
+              std::count_if(scoutPositions.begin(), scoutPositions.end(), [&](const MapPoint scoutPos) {
+                  return world.CalcDistance(pt, scoutPos) <= VISUALRANGE_SCOUT;
+              }));
+            if(world.CalcDistance(pt, hqPos) <= HQ_RADIUS + VISUALRANGE_MILITARY)
+                numViewers++;
+            BOOST_TEST_REQUIRE(visionMap.GetNumViewers(pt, 0) == numViewers);
+        }
+        return !scoutPositions.empty();
+    };
+    BOOST_TEST_REQUIRE(checkViewers());
+    for(unsigned i = 0; i < 20; i++)
+    {
+        RTTR_SKIP_GFS(30);
+        checkViewers();
+    }
+    // Recalculating from scratch (as after loading) yields the same result
+    world.InitAfterLoad();
+    checkViewers();
+}
+
 using EmptyWorldFixture1P = WorldFixture<CreateEmptyWorld, 1>;
 
 BOOST_FIXTURE_TEST_CASE(GeologistPlacesSigns, EmptyWorldFixture1P)
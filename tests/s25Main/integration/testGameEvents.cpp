@@ -128,6 +128,54 @@ BOOST_AUTO_TEST_CASE(Reschedule)
     BOOST_TEST_REQUIRE(obj.handledEventIds.size() == 1u);
 }
 
+BOOST_AUTO_TEST_CASE(EventOrderForLongDelays)
+{
+    TestEventManager evMgr(0);
+    TestEventHandler obj;
+    // Events in the far future are stored differently but must keep the order in which they were added
+    const std::vector<unsigned> targetGFs = {1500, 3000, 500000, 300000, 3000, 1500, 2049, 2048};
+    for(unsigned i = 0; i < targetGFs.size(); i++)
+        evMgr.AddEvent(&obj, targetGFs[i], i);
+    for(unsigned i = 1; i <= 1200; i++)
+        evMgr.ExecuteNextGF();
+    BOOST_TEST_REQUIRE(obj.handledEventIds.empty());
+    // Same GFs as before, must be executed after the earlier events
+    evMgr.AddEvent(&obj, 300, 8);
+    evMgr.AddEvent(&obj, 1800, 9);
+    evMgr.AddEvent(&obj, 300000 - 1200, 10);
+    evMgr.AddEvent(&obj, 500000 - 1200, 11);
+
+    const std::vector<unsigned> expectedIds = {0, 5, 8, 7, 6, 1, 4, 9, 3, 10, 2, 11};
+    std::vector<unsigned> queuedIds;
+    for(const GameEvent* ev : evMgr.GetEvents())
+        queuedIds.push_back(ev->id);
+    BOOST_TEST(queuedIds == expectedIds, boost::test_tools::per_element());
+
+    while(evMgr.GetNumActiveEvents() > 0u)
+        evMgr.ExecuteNextEvent();
+    BOOST_TEST(evMgr.GetCurrentGF() == 500000u);
+    BOOST_TEST(obj.handledEventIds == expectedIds, boost::test_tools::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(RemoveFarEvents)
+{
+    TestEventManager evMgr(0);
+    TestEventHandler obj;
+    const GameEvent* nearEv = evMgr.AddEvent(&obj, 10, 1);
+    const GameEvent* farEv = evMgr.AddEvent(&obj, 5000, 2);
+    const GameEvent* distantEv = evMgr.AddEvent(&obj, 1000000, 3);
+    evMgr.AddEvent(&obj, 1000000, 4);
+    BOOST_TEST_REQUIRE(evMgr.GetNumActiveEvents() == 4u);
+    evMgr.RemoveEvent(farEv);
+    evMgr.RemoveEvent(distantEv);
+    evMgr.RemoveEvent(nearEv);
+    BOOST_TEST(!farEv);
+    BOOST_TEST_REQUIRE(evMgr.GetNumActiveEvents() == 1u);
+    BOOST_TEST_REQUIRE(evMgr.ExecuteNextEvent() == 1000000u);
+    BOOST_TEST_REQUIRE(obj.handledEventIds == std::vector<unsigned>{4});
+    BOOST_TEST(!evMgr.ObjectHasEvents(obj));
+}
+
 class TestLogKill final : public GameObject
 {
 public:
@@ -209,6 +257,26 @@ BOOST_AUTO_TEST_CASE(RemoveEvent)
     BOOST_TEST(!evMgr.ObjectHasEvents(obj));
 }
 
+BOOST_AUTO_TEST_CASE(EventsAreCountedInAllocationStats)
+{
+    EventManager evMgr(0);
+    TestEventHandler obj;
+    const GameObject::AllocationStats origStats = GameObject::GetEventAllocationStats();
+    const GameEvent* ev = evMgr.AddEvent(&obj, 5, 42);
+    evMgr.AddEvent(&obj, 10, 43);
+    const GameObject::AllocationStats stats = GameObject::GetEventAllocationStats();
+    BOOST_TEST(stats.numObjects == origStats.numObjects + 2u);
+    BOOST_TEST(stats.numBytes >= origStats.numBytes + 2u * sizeof(GameEvent));
+    // Removed and executed events are freed
+    evMgr.RemoveEvent(ev);
+    BOOST_TEST(GameObject::GetEventAllocationStats().numObjects == origStats.numObjects + 1u);
+    for(unsigned i = 0; i < 10; i++)
+        evMgr.ExecuteNextGF();
+    BOOST_TEST_REQUIRE(obj.handledEventIds.size() == 1u);
+    BOOST_TEST(GameObject::GetEventAllocationStats().numObjects == origStats.numObjects);
+    BOOST_TEST(GameObject::GetEventAllocationStats().numBytes == origStats.numBytes);
+}
+
 #if RTTR_ENABLE_ASSERTS
 BOOST_AUTO_TEST_CASE(InvalidEvent)
 {
@@ -2,10 +2,21 @@
 //
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "FindWhConditions.h"
+#include "GamePlayer.h"
+#include "PointOutput.h"
 #include "RttrForeachPt.h"
+#include "buildings/nobBaseWarehouse.h"
+#include "factories/BuildingFactory.h"
 #include "helpers/OptionalIO.h"
+#include "helpers/containerUtils.h"
+#include "pathfinding/ClusterGraphImpl.h"
+#include "pathfinding/FreePathFinder.h"
+#include "pathfinding/PathConditionHuman.h"
+#include "pathfinding/RoadPathFinder.h"
 #include "worldFixtures/CreateEmptyWorld.h"
 #include "worldFixtures/WorldFixture.h"
+#include "nodeObjs/noFlag.h"
 #include "nodeObjs/noGranite.h"
 #include "gameTypes/GameTypesOutput.h"
 #include "gameData/GameConsts.h"
@@ -13,6 +24,8 @@
 #include <rttr/test/testHelpers.hpp>
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/test/unit_test.hpp>
+#include <limits>
+#include <memory>
 #include <vector>
 
 // Tests are designed to check for every possible direction and terrain distribution
@@ -24,6 +37,8 @@ BOOST_AUTO_TEST_SUITE(PathfindingSuite)
 namespace {
 using WorldFixtureEmpty0P = WorldFixture<CreateEmptyWorld, 0>;
 using WorldFixtureEmpty1P = WorldFixture<CreateEmptyWorld, 1>;
+using WorldFixtureEmptyBig = WorldFixture<CreateEmptyWorld, 0, 80, 64>;
+using WorldFixtureEmpty1PBig = WorldFixture<CreateEmptyWorld, 1, 24, 20>;
 
 /// Sets all terrain to the given terrain
 void clearWorld(GameWorld& world, DescIdx<TerrainDesc> terrain)
@@ -35,6 +50,13 @@ void clearWorld(GameWorld& world, DescIdx<TerrainDesc> terrain)
     }
 }
 
+/// The map wraps around, so block the column at the map border to make walls elsewhere split the map
+void setBorderWall(GameWorld& world)
+{
+    for(MapPoint pt(0, 0); pt.y < world.GetHeight(); ++pt.y)
+        world.SetNO(pt, new noGranite(GraniteType::One, 1));
+}
+
 void setupTestcase1(GameWorld& world, const MapPoint& startPt, DescIdx<TerrainDesc> tBlue, DescIdx<TerrainDesc> tWhite)
 {
     // test case 1: Everything is covered in blue terrain (e.g. water) which is walkable on the shore
@@ -290,4 +312,434 @@ BOOST_FIXTURE_TEST_CASE(BlockedPaths, WorldFixtureEmpty0P)
     BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, surroundingPts2[0]));
 }
 
+BOOST_FIXTURE_TEST_CASE(HierarchicalPaths, WorldFixtureEmptyBig)
+{
+    // Wall of stones with a gap
+    setBorderWall(world);
+    const MapCoord wallX = 40;
+    const MapPoint gapPt(wallX, 10);
+    for(MapPoint pt(wallX, 0); pt.y < world.GetHeight(); ++pt.y)
+    {
+        if(pt != gapPt)
+            world.SetNO(pt, new noGranite(GraniteType::One, 1));
+    }
+    const MapPoint startPt(10, 50);
+    const MapPoint endPt(70, 50);
+    unsigned flatLength;
+    BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, endPt, 0xFFFFFFFF, false, &flatLength));
+
+    world.GetFreePathFinder().SetHierarchicalPathfinding(true);
+    unsigned length;
+    std::vector<Direction> route;
+    BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, endPt, 0xFFFFFFFF, false, &length, &route));
+    // Path is near optimal
+    BOOST_TEST(length >= flatLength);
+    BOOST_TEST(length <= flatLength * 11 / 10);
+    BOOST_TEST_REQUIRE(route.size() == length);
+    MapPoint curPt = startPt;
+    bool passedGap = false;
+    for(const Direction dir : route)
+    {
+        curPt = world.GetNeighbour(curPt, dir);
+        passedGap |= curPt == gapPt;
+    }
+    BOOST_TEST(curPt == endPt);
+    BOOST_TEST(passedGap);
+    // Too short limit
+    BOOST_TEST(!world.FindHumanPath(startPt, endPt, flatLength - 1));
+
+    // Changes are detected
+    world.SetNO(gapPt, new noGranite(GraniteType::One, 1));
+    BOOST_TEST(!world.FindHumanPath(startPt, endPt));
+    world.DestroyNO(gapPt);
+    BOOST_TEST(world.FindHumanPath(startPt, endPt, 0xFFFFFFFF, false, &length));
+    BOOST_TEST(length >= flatLength);
+    BOOST_TEST(length <= flatLength * 11 / 10);
+
+    world.GetFreePathFinder().SetHierarchicalPathfinding(false);
+    BOOST_TEST(world.FindHumanPath(startPt, endPt, 0xFFFFFFFF, false, &length));
+    BOOST_TEST(length == flatLength);
+}
+
+BOOST_FIXTURE_TEST_CASE(HierarchicalPathsWithOutdatedGraph, WorldFixtureEmptyBig)
+{
+    DescIdx<TerrainDesc> tWater(0);
+    for(; tWater.value < world.GetDescription().terrain.size(); tWater.value++)
+    {
+        if(!world.GetDescription().get(tWater).Is(ETerrain::Walkable)
+           && !world.GetDescription().get(tWater).Is(ETerrain::Unreachable))
+            break;
+    }
+    const DescIdx<TerrainDesc> tLand = world.GetNode(MapPoint(0, 0)).t1;
+    // Band of water with a gap of land
+    const auto setWall = [this, tWater, tLand](const MapCoord gapY) {
+        for(MapPoint pt(38, 0); pt.x <= 42; ++pt.x)
+        {
+            for(pt.y = 0; pt.y < world.GetHeight(); ++pt.y)
+            {
+                MapNode& node = world.GetNodeWriteable(pt);
+                node.t1 = node.t2 = (pt.y + 2 >= gapY && pt.y <= gapY + 2) ? tLand : tWater;
+            }
+        }
+    };
+    setBorderWall(world);
+    const MapPoint startPt(10, 50);
+    const MapPoint endPt(70, 50);
+    setWall(50);
+    world.GetFreePathFinder().SetHierarchicalPathfinding(true);
+    BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, endPt));
+
+    // Terrain changes are not reported, so the graph still has the old gap which is on the direct route.
+    // The path over the new gap must be found anyway
+    setWall(20);
+    unsigned length;
+    std::vector<Direction> route;
+    BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, endPt, 0xFFFFFFFF, false, &length, &route));
+    BOOST_TEST_REQUIRE(route.size() == length);
+    MapPoint curPt = startPt;
+    for(const Direction dir : route)
+        curPt = world.GetNeighbour(curPt, dir);
+    BOOST_TEST(curPt == endPt);
+
+    world.GetFreePathFinder().SetHierarchicalPathfinding(false);
+    unsigned flatLength;
+    BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, endPt, 0xFFFFFFFF, false, &flatLength));
+    BOOST_TEST(length >= flatLength);
+    BOOST_TEST(length <= flatLength * 11 / 10);
+}
+
+BOOST_FIXTURE_TEST_CASE(HierarchicalPathsWithUnreportedObjects, WorldFixtureEmptyBig)
+{
+    // Wall of stones on a cluster border with a gap. The gap is the only entrance into the clusters behind the wall
+    setBorderWall(world);
+    const MapCoord wallX = 3 * ClusterGraph::clusterSize;
+    const MapPoint gapPt(wallX, 10);
+    for(MapPoint pt(wallX, 0); pt.y < world.GetHeight(); ++pt.y)
+    {
+        if(pt != gapPt)
+            world.SetNO(pt, new noGranite(GraniteType::One, 1));
+    }
+    const MapPoint startPt(10, 50);
+    const MapPoint endPt(70, 50);
+    unsigned flatLength;
+    BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, endPt, 0xFFFFFFFF, false, &flatLength));
+    world.GetFreePathFinder().SetHierarchicalPathfinding(true);
+    BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, endPt));
+    std::vector<ClusterGraph::Waypoint> waypoints;
+    ClusterGraph& clusters = *world.GetFreePathFinder().GetHumanClusters();
+    BOOST_TEST_REQUIRE(clusters.FindPath(startPt, endPt, PathConditionHuman(world), waypoints)
+                       != ClusterGraph::invalidDistance);
+    const auto isGap = [gapPt](const ClusterGraph::Waypoint& waypoint) { return waypoint.pt == gapPt; };
+    BOOST_TEST_REQUIRE(helpers::contains_if(waypoints, isGap));
+
+    // Block the gap without telling the path finder. The refinement must not pass the blocked waypoint
+    auto granite = std::make_unique<noGranite>(GraniteType::One, 1);
+    world.GetNodeWriteable(gapPt).obj = granite.get();
+    BOOST_TEST(!world.FindHumanPath(startPt, endPt));
+    world.GetFreePathFinder().NodeChanged(gapPt);
+    BOOST_TEST(!world.FindHumanPath(startPt, endPt));
+
+    // Open it again without telling the path finder. The graph has no path but the regular search finds it
+    world.GetNodeWriteable(gapPt).obj = nullptr;
+    unsigned length;
+    BOOST_TEST_REQUIRE(world.FindHumanPath(startPt, endPt, 0xFFFFFFFF, false, &length));
+    BOOST_TEST(length == flatLength);
+}
+
+BOOST_FIXTURE_TEST_CASE(WareDistances, WorldFixtureEmpty1PBig)
+{
+    const MapPoint hqPos = world.GetPlayer(0).GetHQPos();
+    const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SouthEast);
+    // Network with a loop and a dead end
+    const auto buildRoad = [this](MapPoint start, Direction dir, unsigned length) {
+        MapPoint end = start;
+        for(unsigned i = 0; i < length; i++)
+            end = world.GetNeighbour(end, dir);
+        if(!world.GetSpecObj<noFlag>(end))
+            world.SetFlag(end, 0);
+        world.BuildRoad(0, false, start, std::vector<Direction>(length, dir));
+        return end;
+    };
+    const MapPoint flagA = buildRoad(hqFlagPos, Direction::East, 4);
+    const MapPoint flagB = buildRoad(flagA, Direction::SouthEast, 2);
+    const MapPoint flagC = buildRoad(hqFlagPos, Direction::SouthEast, 2);
+    BOOST_TEST_REQUIRE(buildRoad(flagC, Direction::East, 4) == flagB);
+    const MapPoint flagD = buildRoad(hqFlagPos, Direction::West, 2);
+
+    const std::vector<MapPoint> nodePts{hqPos, hqFlagPos, flagA, flagB, flagC, flagD};
+    const std::vector<unsigned> maxCosts{0, 5, 20, 600, std::numeric_limits<unsigned>::max(), 3};
+    RoadPathFinder& pathFinder = world.GetRoadPathFinder();
+    for(const MapPoint startPt : nodePts)
+    {
+        const auto& start = *world.GetSpecObj<noRoadNode>(startPt);
+        // Results of separate searches
+        std::vector<std::pair<bool, unsigned>> expected;
+        for(const MapPoint goalPt : nodePts)
+        {
+            if(goalPt == startPt)
+                continue;
+            for(const unsigned maxCost : maxCosts)
+            {
+                unsigned length = 0;
+                const bool found = world.FindPathForWareOnRoads(start, *world.GetSpecObj<noRoadNode>(goalPt), &length,
+                                                                nullptr, maxCost)
+                                   != RoadPathDirection::None;
+                expected.emplace_back(found, found ? length : 0);
+            }
+        }
+        pathFinder.StartWareDistanceSearch(start);
+        auto itExpected = expected.begin();
+        for(const MapPoint goalPt : nodePts)
+        {
+            if(goalPt == startPt)
+                continue;
+            // Other searches in between must not change the results
+            unsigned otherLength;
+            world.FindPathForWareOnRoads(*world.GetSpecObj<noRoadNode>(goalPt), start, &otherLength);
+            pathFinder.ResetWareComponents();
+            pathFinder.IsConnectedForWares(*world.GetSpecObj<noRoadNode>(goalPt), start);
+            for(const unsigned maxCost : maxCosts)
+            {
+                unsigned length = 0;
+                const bool found = pathFinder.GetWareDistance(*world.GetSpecObj<noRoadNode>(goalPt), maxCost, length);
+                BOOST_TEST(found == itExpected->first);
+                if(found)
+                    BOOST_TEST(length == itExpected->second);
+                ++itExpected;
+            }
+        }
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(NearestWarehouse, WorldFixtureEmpty1PBig)
+{
+    GamePlayer& player = world.GetPlayer(0);
+    const MapPoint hqPos = player.GetHQPos();
+    const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SouthEast);
+    const auto buildRoad = [this](MapPoint start, Direction dir, unsigned length) {
+        MapPoint end = start;
+        for(unsigned i = 0; i < length; i++)
+            end = world.GetNeighbour(end, dir);
+        if(!world.GetSpecObj<noFlag>(end))
+            world.SetFlag(end, 0);
+        world.BuildRoad(0, false, start, std::vector<Direction>(length, dir));
+        return end;
+    };
+    // Network with a loop and 2 storehouses: At the end of the east road and at the dead end in the west
+    const MapPoint flagA = buildRoad(hqFlagPos, Direction::East, 4);
+    const MapPoint flagB = buildRoad(flagA, Direction::SouthEast, 2);
+    const MapPoint flagC = buildRoad(hqFlagPos, Direction::SouthEast, 2);
+    BOOST_TEST_REQUIRE(buildRoad(flagC, Direction::East, 4) == flagB);
+    const MapPoint flagD = buildRoad(hqFlagPos, Direction::West, 2);
+    auto* whA = static_cast<nobBaseWarehouse*>(BuildingFactory::CreateBuilding(
+      world, BuildingType::Storehouse, world.GetNeighbour(flagA, Direction::NorthWest), 0, Nation::Romans));
+    auto* whD = static_cast<nobBaseWarehouse*>(BuildingFactory::CreateBuilding(
+      world, BuildingType::Storehouse, world.GetNeighbour(flagD, Direction::NorthWest), 0, Nation::Romans));
+    auto* hq = world.GetSpecObj<nobBaseWarehouse>(hqPos);
+    BOOST_TEST_REQUIRE(hq);
+
+    const std::vector<MapPoint> startPts{hqPos, whA->GetPos(), hqFlagPos, flagA, flagB, flagC, flagD};
+    // Different orders to check the tie breaking
+    const std::vector<std::vector<nobBaseWarehouse*>> whLists{
+      {hq, whA, whD}, {whD, whA, hq}, {whA, whD}, {whD, whA}, {whD}};
+    RoadPathFinder& pathFinder = world.GetRoadPathFinder();
+    for(const MapPoint startPt : startPts)
+    {
+        const auto& start = *world.GetSpecObj<noRoadNode>(startPt);
+        for(const auto& warehouses : whLists)
+        {
+            for(const bool toWarehouse : {true, false})
+            {
+                for(const bool wareMode : {true, false})
+                {
+                    // Result of a separate search for each warehouse
+                    nobBaseWarehouse* expectedWh = nullptr;
+                    unsigned expectedLength = std::numeric_limits<unsigned>::max();
+                    for(nobBaseWarehouse* wh : warehouses)
+                    {
+                        unsigned length = 0;
+                        if(wh == &start)
+                            length = 0;
+                        else if(!pathFinder.FindPath(toWarehouse ? start : *wh, toWarehouse ? *wh : start, wareMode,
+                                                     std::numeric_limits<unsigned>::max(), nullptr, &length))
+                            continue;
+                        if(length < expectedLength)
+                        {
+                            expectedWh = wh;
+                            expectedLength = length;
+                        }
+                    }
+                    unsigned length = 0;
+                    BOOST_TEST(pathFinder.FindNearestWarehouse(start, warehouses, toWarehouse, wareMode, nullptr,
+                                                               &length)
+                               == expectedWh);
+                    BOOST_TEST(length == expectedLength);
+                }
+            }
+        }
+    }
+    // The player uses all warehouses in registration order
+    BOOST_TEST(player.FindWarehouse(*world.GetSpecObj<noRoadNode>(flagD), FW::NoCondition(), true, false) == whD);
+    BOOST_TEST(player.FindWarehouse(*world.GetSpecObj<noRoadNode>(flagB), FW::NoCondition(), false, true) == whA);
+    // Avoiding the road into the storehouse leads to the HQ instead
+    const RoadSegment* roadToWhD = world.GetSpecObj<noFlag>(flagD)->GetRoute(Direction::NorthWest);
+    BOOST_TEST_REQUIRE(roadToWhD);
+    unsigned length = 0;
+    BOOST_TEST(player.FindWarehouse(*world.GetSpecObj<noRoadNode>(flagD), FW::NoCondition(), true, false, &length,
+                                    roadToWhD)
+               == hq);
+    BOOST_TEST(length == 3u);
+}
+
+BOOST_FIXTURE_TEST_CASE(WareComponents, WorldFixtureEmpty1PBig)
+{
+    const MapPoint hqPos = world.GetPlayer(0).GetHQPos();
+    const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SouthEast);
+    const auto buildRoad = [this](MapPoint start, Direction dir, unsigned length) {
+        MapPoint end = start;
+        for(unsigned i = 0; i < length; i++)
+            end = world.GetNeighbour(end, dir);
+        if(!world.GetSpecObj<noFlag>(end))
+            world.SetFlag(end, 0);
+        world.BuildRoad(0, false, start, std::vector<Direction>(length, dir));
+        return end;
+    };
+    // Loop with a storehouse and a dead end with another storehouse
+    const MapPoint flagA = buildRoad(hqFlagPos, Direction::East, 4);
+    const MapPoint flagB = buildRoad(flagA, Direction::SouthEast, 2);
+    const MapPoint flagC = buildRoad(hqFlagPos, Direction::SouthEast, 2);
+    BOOST_TEST_REQUIRE(buildRoad(flagC, Direction::East, 4) == flagB);
+    const MapPoint flagD = buildRoad(hqFlagPos, Direction::West, 2);
+    const MapPoint flagE = buildRoad(flagD, Direction::West, 2);
+    const MapPoint whA = world.GetNeighbour(flagA, Direction::NorthWest);
+    const MapPoint whE = world.GetNeighbour(flagE, Direction::NorthWest);
+    BuildingFactory::CreateBuilding(world, BuildingType::Storehouse, whA, 0, Nation::Romans);
+    BuildingFactory::CreateBuilding(world, BuildingType::Storehouse, whE, 0, Nation::Romans);
+    // Unconnected flag
+    const MapPoint flagF(hqFlagPos.x, hqFlagPos.y - 6);
+    world.SetFlag(flagF, 0);
+
+    const std::vector<MapPoint> nodePts{hqPos, hqFlagPos, flagA, flagB, flagC, flagD, flagE, flagF, whA, whE};
+    RoadPathFinder& pathFinder = world.GetRoadPathFinder();
+    const auto checkComponents = [&]() {
+        pathFinder.ResetWareComponents();
+        for(const MapPoint startPt : nodePts)
+        {
+            const auto& start = *world.GetSpecObj<noRoadNode>(startPt);
+            for(const MapPoint goalPt : nodePts)
+            {
+                const auto& goal = *world.GetSpecObj<noRoadNode>(goalPt);
+                const bool expected = startPt == goalPt || pathFinder.PathExists(start, goal, true);
+                BOOST_TEST_INFO("Start: " << startPt << " Goal: " << goalPt);
+                BOOST_TEST(pathFinder.IsConnectedForWares(start, goal) == expected);
+                // Other searches don't change the components
+                pathFinder.PathExists(goal, start, true);
+            }
+        }
+    };
+    checkComponents();
+    BOOST_TEST(!pathFinder.IsConnectedForWares(*world.GetSpecObj<noRoadNode>(hqPos),
+                                               *world.GetSpecObj<noRoadNode>(flagF)));
+
+    // Remove a road of the loop -> Still connected
+    world.GetSpecObj<noFlag>(flagA)->DestroyRoad(Direction::SouthEast);
+    checkComponents();
+    BOOST_TEST(pathFinder.IsConnectedForWares(*world.GetSpecObj<noRoadNode>(flagB),
+                                              *world.GetSpecObj<noRoadNode>(whA)));
+    // Cut off the dead end
+    world.GetSpecObj<noFlag>(flagD)->DestroyRoad(Direction::West);
+    checkComponents();
+    BOOST_TEST(!pathFinder.IsConnectedForWares(*world.GetSpecObj<noRoadNode>(hqPos),
+                                               *world.GetSpecObj<noRoadNode>(whE)));
+    BOOST_TEST(pathFinder.IsConnectedForWares(*world.GetSpecObj<noRoadNode>(whE),
+                                              *world.GetSpecObj<noRoadNode>(flagE)));
+}
+
+BOOST_FIXTURE_TEST_CASE(HumanRouteCache, WorldFixtureEmpty1PBig)
+{
+    GamePlayer& player = world.GetPlayer(0);
+    const MapPoint hqPos = player.GetHQPos();
+    const MapPoint hqFlagPos = world.GetNeighbour(hqPos, Direction::SouthEast);
+    const auto buildRoad = [this](MapPoint start, Direction dir, unsigned length) {
+        MapPoint end = start;
+        for(unsigned i = 0; i < length; i++)
+            end = world.GetNeighbour(end, dir);
+        if(!world.GetSpecObj<noFlag>(end))
+            world.SetFlag(end, 0);
+        world.BuildRoad(0, false, start, std::vector<Direction>(length, dir));
+        return end;
+    };
+    // Network with a loop and a dead end
+    const MapPoint flagA = buildRoad(hqFlagPos, Direction::East, 4);
+    const MapPoint flagB = buildRoad(flagA, Direction::SouthEast, 2);
+    const MapPoint flagC = buildRoad(hqFlagPos, Direction::SouthEast, 2);
+    BOOST_TEST_REQUIRE(buildRoad(flagC, Direction::East, 4) == flagB);
+    const MapPoint flagD = buildRoad(hqFlagPos, Direction::West, 2);
+    // Unconnected flag
+    MapPoint flagE = flagD;
+    for(unsigned i = 0; i < 2; i++)
+        flagE = world.GetNeighbour(flagE, Direction::West);
+    world.SetFlag(flagE, 0);
+
+    const std::vector<MapPoint> nodePts{hqPos, hqFlagPos, flagA, flagB, flagC, flagD, flagE};
+    RoadPathFinder& pathFinder = world.GetRoadPathFinder();
+    RoadRouteCache& routeCache = player.GetRoadRouteCache();
+    // The cached results must be the same as those of the pathfinder
+    const auto checkRoutes = [&](bool expectCached) {
+        routeCache.ResetCounters();
+        unsigned numSearches = 0;
+        for(const MapPoint startPt : nodePts)
+        {
+            const auto& start = *world.GetSpecObj<noRoadNode>(startPt);
+            for(const MapPoint goalPt : nodePts)
+            {
+                if(goalPt == startPt)
+                    continue;
+                const auto& goal = *world.GetSpecObj<noRoadNode>(goalPt);
+                unsigned expectedLength = 0;
+                RoadPathDirection expectedDir = RoadPathDirection::None;
+                MapPoint expectedFirstPt = MapPoint::Invalid();
+                const bool found = pathFinder.FindPath(start, goal, false, std::numeric_limits<unsigned>::max(),
+                                                       nullptr, &expectedLength, &expectedDir, &expectedFirstPt);
+                unsigned length = 0;
+                MapPoint firstPt = MapPoint::Invalid();
+                BOOST_TEST_INFO("Start: " << startPt << " Goal: " << goalPt);
+                BOOST_TEST(world.FindHumanPathOnRoads(start, goal, &length, &firstPt)
+                           == (found ? expectedDir : RoadPathDirection::None));
+                if(found)
+                {
+                    BOOST_TEST(length == expectedLength);
+                    BOOST_TEST(firstPt == expectedFirstPt);
+                }
+                numSearches++;
+            }
+        }
+        BOOST_TEST(routeCache.GetNumHits() == (expectCached ? numSearches : 0u));
+        BOOST_TEST(routeCache.GetNumMisses() == (expectCached ? 0u : numSearches));
+    };
+    checkRoutes(false);
+    checkRoutes(true);
+
+    // Removing a road of the loop leads to other routes
+    world.GetSpecObj<noFlag>(flagA)->DestroyRoad(Direction::SouthEast);
+    checkRoutes(false);
+    checkRoutes(true);
+    // Connecting the unconnected flag
+    BOOST_TEST_REQUIRE(buildRoad(flagD, Direction::West, 2) == flagE);
+    BOOST_TEST_REQUIRE(world.GetSpecObj<noFlag>(flagE)->GetRoute(Direction::East));
+    checkRoutes(false);
+    // Upgrading a road also changes the road network
+    world.GetSpecObj<noFlag>(hqFlagPos)->UpgradeRoad(Direction::East);
+    checkRoutes(false);
+
+    // Searches avoiding a road are not cached
+    routeCache.ResetCounters();
+    const RoadSegment* roadToB = world.GetSpecObj<noFlag>(flagB)->GetRoute(Direction::West);
+    BOOST_TEST_REQUIRE(roadToB);
+    BOOST_TEST(world.FindHumanPathOnRoads(*world.GetSpecObj<noRoadNode>(flagB), *world.GetSpecObj<noRoadNode>(hqPos),
+                                          nullptr, nullptr, roadToB)
+               == RoadPathDirection::None);
+    BOOST_TEST(routeCache.GetNumHits() + routeCache.GetNumMisses() == 0u);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
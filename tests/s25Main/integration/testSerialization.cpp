@@ -2,11 +2,14 @@
 //
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "AsyncChecksum.h"
+#include "BackgroundSaver.h"
 #include "GameCommands.h"
 #include "GameEvent.h"
 #include "GamePlayer.h"
 #include "PointOutput.h"
 #include "Replay.h"
+#include "ReplayKeyframes.h"
 #include "RttrForeachPt.h"
 #include "Savegame.h"
 #include "SerializedGameData.h"
@@ -21,6 +24,7 @@
 #include "helpers/format.hpp"
 #include "network/GameMessage_Chat.h"
 #include "network/PlayerGameCommands.h"
+#include "random/Random.h"
 #include "worldFixtures/CreateEmptyWorld.h"
 #include "worldFixtures/MockLocalGameState.h"
 #include "worldFixtures/WorldFixture.h"
@@ -36,6 +40,7 @@
 #include <boost/filesystem/operations.hpp>
 #include <boost/test/unit_test.hpp>
 #include <memory>
+#include <thread>
 
 // LCOV_EXCL_START
 BOOST_TEST_DONT_PRINT_LOG_VALUE(Resource)
@@ -57,6 +62,10 @@ struct RandWorldFixture : public WorldFixture<CreateEmptyWorld, 4>
             worldNode.reserved = rttr::test::randomValue(0, 1) == 0;
             worldNode.seaId = rttr::test::randomValue(0, 20);
             worldNode.harborId = rttr::test::randomValue(0, 20);
+            const unsigned fowPlayer = rttr::test::randomValue(0u, world.GetNumPlayers() - 1u);
+            FoWNode& fowNode = world.GetFoWNodeWriteable(pt, fowPlayer);
+            fowNode.visibility = Visibility::FogOfWar;
+            fowNode.last_update_time = rttr::test::randomValue(0u, 100u);
         }
         world.InitAfterLoad();
         world.GetPlayer(0).name = "Human";
@@ -318,6 +327,10 @@ BOOST_FIXTURE_TEST_CASE(BaseSaveLoad, RandWorldFixture)
             BOOST_TEST(newEm.GetCurrentGF() == em.GetCurrentGF());
             BOOST_TEST(GameObject::GetNumObjs() == origObjNum);
             BOOST_TEST(GameObject::GetObjIDCounter() == origObjIdNum);
+            // Incrementally updated digest must match the one calculated for the loaded world
+            BOOST_TEST(newWorld.GetDigest().GetHash() == world.GetDigest().GetHash());
+            BOOST_TEST(newWorld.GetDigest().GetRegionHashes() == world.GetDigest().GetRegionHashes(),
+                       boost::test_tools::per_element());
             std::vector<const GameEvent*> worldEvs = em.GetEvents();
             std::vector<const GameEvent*> loadEvs = newEm.GetEvents();
             BOOST_TEST(worldEvs.size() == loadEvs.size());
@@ -345,6 +358,15 @@ BOOST_FIXTURE_TEST_CASE(BaseSaveLoad, RandWorldFixture)
                     BOOST_TEST(loadNode.seaId == worldNode.seaId);
                     BOOST_TEST(loadNode.harborId == worldNode.harborId);
                     BOOST_TEST((loadNode.obj != nullptr) == (worldNode.obj != nullptr));
+                    BOOST_TEST(newWorld.GetNumFoWPlayers() == world.GetNumPlayers());
+                    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+                    {
+                        const FoWNode& worldFoWNode = world.GetFoWNode(pt, i);
+                        const FoWNode& loadFoWNode = newWorld.GetFoWNode(pt, i);
+                        BOOST_TEST(loadFoWNode.visibility == worldFoWNode.visibility);
+                        BOOST_TEST(loadFoWNode.last_update_time == worldFoWNode.last_update_time);
+                    }
+                    BOOST_TEST(newWorld.GetFigures(pt).size() == world.GetFigures(pt).size());
                 }
             const auto* newUsual = newWorld.GetSpecObj<nobUsual>(usualBldPos);
             BOOST_TEST_REQUIRE(newUsual);
@@ -534,6 +556,106 @@ BOOST_FIXTURE_TEST_CASE(BrokenReplayWithMap, ReplayMapFixture)
     CheckReplayCmds(loadReplay, cmds);
 }
 
+BOOST_FIXTURE_TEST_CASE(ConvertReplay, ReplayMapFixture)
+{
+    GlobalGameSettings ggs;
+    Game game(ggs, 0u, players);
+    const PlayerGameCommands cmds = GetTestCommands().create(game).result;
+    TmpFile oldFile(".rpl"), newFile(".rpl");
+    BOOST_TEST_REQUIRE(oldFile.isValid());
+    oldFile.close();
+    newFile.close();
+    bfs::remove(oldFile.filePath);
+    bfs::remove(newFile.filePath);
+    {
+        // Unfinished recording, i.e. the commands are stored uncompressed as in old replays
+        Replay replay;
+        for(const BasePlayerInfo& player : players)
+            replay.AddPlayer(player);
+        BOOST_TEST_REQUIRE(replay.StartRecording(oldFile.filePath, map, 815));
+        AddReplayCmds(replay, cmds);
+    }
+
+    Replay replay;
+    BOOST_TEST_REQUIRE(replay.Convert(oldFile.filePath, newFile.filePath));
+    BOOST_TEST(!replay.IsRecording());
+    // No overwrite
+    BOOST_TEST(!replay.Convert(oldFile.filePath, newFile.filePath));
+
+    Replay loadReplay;
+    BOOST_TEST_REQUIRE(loadReplay.LoadHeader(newFile.filePath));
+    BOOST_TEST(loadReplay.GetMapName() == map.title);
+    BOOST_TEST(loadReplay.GetPlayerNames().size() == 3u);
+    BOOST_TEST(loadReplay.GetLastGF() == 5u);
+    MapInfo newMap;
+    BOOST_TEST_REQUIRE(loadReplay.LoadGameData(newMap));
+    BOOST_TEST_REQUIRE(loadReplay.GetNumPlayers() == 4u);
+    BOOST_TEST(loadReplay.getSeed() == 815u);
+    BOOST_TEST(newMap.filepath == map.filepath);
+    BOOST_TEST(newMap.mapData.data == map.mapData.data, boost::test_tools::per_element());
+    BOOST_TEST(newMap.luaData.data == map.luaData.data, boost::test_tools::per_element());
+    CheckReplayCmds(loadReplay, cmds);
+}
+
+BOOST_FIXTURE_TEST_CASE(ReplayCommandBlocks, ReplayMapFixture)
+{
+    TmpFile tmpFile(".rpl");
+    BOOST_TEST_REQUIRE(tmpFile.isValid());
+    tmpFile.close();
+    bfs::remove(tmpFile.filePath);
+
+    // Commands spread over multiple blocks including multiple commands per GF and GFs without commands
+    std::vector<std::pair<unsigned, std::string>> recordedCmds;
+    for(unsigned gf = 0; gf < 3 * Replay::commandBlockGFs + 10; gf += rttr::test::randomValue(1u, 50u))
+    {
+        for(unsigned i = rttr::test::randomValue(1u, 3u); i > 0; i--)
+            recordedCmds.emplace_back(gf, std::to_string(gf) + "_" + std::to_string(i));
+    }
+    {
+        Replay replay;
+        for(const BasePlayerInfo& player : players)
+            replay.AddPlayer(player);
+        BOOST_TEST_REQUIRE(replay.StartRecording(tmpFile.filePath, map, 42));
+        for(const auto& cmd : recordedCmds)
+            replay.AddChatCommand(cmd.first, 1, ChatDestination::All, cmd.second);
+        replay.UpdateLastGF(recordedCmds.back().first + 1);
+        BOOST_TEST_REQUIRE(replay.StopRecording());
+    }
+
+    Replay replay;
+    MapInfo newMap;
+    BOOST_TEST_REQUIRE(replay.LoadHeader(tmpFile.filePath));
+    BOOST_TEST_REQUIRE(replay.LoadGameData(newMap));
+    // Read position before the GF of each command and the one at the end
+    std::vector<unsigned> positions;
+    for(const auto& cmd : recordedCmds)
+    {
+        positions.push_back(replay.GetReadPosition());
+        BOOST_TEST_REQUIRE(replay.ReadGF() == cmd.first);
+        BOOST_TEST(get<Replay::ChatCommand>(replay.ReadCommand()).msg == cmd.second);
+    }
+    BOOST_TEST(!replay.ReadGF());
+    const unsigned endPos = replay.GetReadPosition();
+    // Continuing at a stored position works like in GameClient: The GF of the next command is already read
+    for(unsigned i = 0; i < 20; i++)
+    {
+        const auto cmdIdx = rttr::test::randomValue<size_t>(0u, recordedCmds.size() - 1u);
+        replay.SetReadPosition(positions[cmdIdx]);
+        BOOST_TEST_REQUIRE(replay.ReadGF() == recordedCmds[cmdIdx].first);
+        const unsigned pos = replay.GetReadPosition();
+        replay.SetReadPosition(positions[0]);
+        replay.SetReadPosition(pos);
+        for(size_t j = cmdIdx; j < std::min(cmdIdx + 5u, recordedCmds.size()); j++)
+        {
+            if(j != cmdIdx)
+                BOOST_TEST_REQUIRE(replay.ReadGF() == recordedCmds[j].first);
+            BOOST_TEST(get<Replay::ChatCommand>(replay.ReadCommand()).msg == recordedCmds[j].second);
+        }
+    }
+    replay.SetReadPosition(endPos);
+    BOOST_TEST(!replay.ReadGF());
+}
+
 BOOST_FIXTURE_TEST_CASE(ReplayWithSavegame, RandWorldFixture)
 {
     MapInfo map;
@@ -633,6 +755,188 @@ BOOST_FIXTURE_TEST_CASE(ReplayWithSavegame, RandWorldFixture)
     }
 }
 
+BOOST_FIXTURE_TEST_CASE(SaveAndLoadReplayKeyframes, RandWorldFixture)
+{
+    MapInfo map;
+    map.type = MapType::Savegame;
+    map.title = "MapTitle";
+    map.savegame = std::make_unique<Savegame>();
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+        map.savegame->AddPlayer(world.GetPlayer(i));
+    map.savegame->ggs = ggs;
+    map.savegame->start_gf = em.GetCurrentGF();
+    map.savegame->sgd.MakeSnapshot(*game);
+
+    const auto recordReplay = [&](TmpFile& file, unsigned seed) {
+        BOOST_TEST_REQUIRE(file.isValid());
+        file.close();
+        bfs::remove(file.filePath);
+        Replay replay;
+        for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+            replay.AddPlayer(world.GetPlayer(i));
+        BOOST_TEST_REQUIRE(replay.StartRecording(file.filePath, map, seed));
+        AddReplayCmds(replay, GetTestCommands().create(*game).result);
+        BOOST_TEST_REQUIRE(replay.StopRecording());
+    };
+    TmpFile replayFile(".rpl"), otherReplayFile(".rpl");
+    recordReplay(replayFile, 815);
+    recordReplay(otherReplayFile, 816);
+    Replay replay, otherReplay;
+    BOOST_TEST_REQUIRE(replay.LoadHeader(replayFile.filePath));
+    BOOST_TEST_REQUIRE(otherReplay.LoadHeader(otherReplayFile.filePath));
+
+    ReplayKeyframes keyframes(10);
+    BOOST_TEST(!keyframes.IsKeyframeDue(0));
+    BOOST_TEST(!keyframes.IsKeyframeDue(5));
+    BOOST_TEST(keyframes.IsKeyframeDue(20));
+    BOOST_TEST(!keyframes.FindBefore(100));
+
+    RTTR_SKIP_GFS(10);
+    const unsigned keyframeGF = em.GetCurrentGF();
+    RANDOM.Init(rttr::test::randomValue<uint64_t>());
+    keyframes.Add(*game, 1234, 42);
+    BOOST_TEST(!keyframes.IsKeyframeDue(keyframeGF));
+    BOOST_TEST(keyframes.IsModified());
+    SerializedGameData expectedSgd;
+    expectedSgd.MakeSnapshot(*game);
+
+    BOOST_TEST(ReplayKeyframes::GetFilePath(replayFile.filePath).extension() == ".rplk");
+    TmpFile keyframesFile(".rplk");
+    keyframesFile.close();
+    BOOST_TEST_REQUIRE(keyframes.Save(keyframesFile.filePath, replay));
+    BOOST_TEST(!keyframes.IsModified());
+
+    ReplayKeyframes loadedKeyframes;
+    BOOST_TEST_REQUIRE(loadedKeyframes.Load(keyframesFile.filePath, replay));
+    BOOST_TEST(loadedKeyframes.GetInterval() == 10u);
+    BOOST_TEST(loadedKeyframes.GetNumKeyframes() == 1u);
+    BOOST_TEST(!loadedKeyframes.FindBefore(keyframeGF - 1));
+    for(const unsigned gf : {keyframeGF, keyframeGF + 1, keyframeGF + 100})
+    {
+        const ReplayKeyframe* keyframe = loadedKeyframes.FindBefore(gf);
+        BOOST_TEST_REQUIRE(keyframe);
+        BOOST_TEST(keyframe->gf == keyframeGF);
+    }
+    const ReplayKeyframe& keyframe = *loadedKeyframes.FindBefore(keyframeGF);
+    BOOST_TEST(keyframe.replayPos == 1234u);
+    BOOST_TEST(keyframe.nextCmdGF == 42u);
+    BOOST_TEST((keyframe.rngState == RANDOM.GetCurrentState()));
+    SerializedGameData sgd;
+    ReplayKeyframes::GetSnapshot(keyframe, sgd);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(sgd.GetData(), sgd.GetData() + sgd.GetLength(), expectedSgd.GetData(),
+                                    expectedSgd.GetData() + expectedSgd.GetLength());
+
+    // Keyframes of other replays are not used
+    BOOST_TEST(!loadedKeyframes.Load(keyframesFile.filePath, otherReplay));
+    BOOST_TEST(loadedKeyframes.GetNumKeyframes() == 0u);
+}
+
+BOOST_FIXTURE_TEST_CASE(SeekToGFViaReplayKeyframe, RandWorldFixture)
+{
+    // Some animals and fires so the game (and the RNG) changes each GF
+    const MapPoint hqPos = world.GetPlayer(0).GetHQPos();
+    for(const auto& offset : {Position(4, 0), Position(-4, 2), Position(0, 5), Position(3, -4)})
+    {
+        const MapPoint pt = world.MakeMapPoint(hqPos + offset);
+        world.AddFigure(pt, std::make_unique<noAnimal>(Species::Deer, pt)).StartLiving();
+    }
+    for(const auto& offset : {Position(7, 0), Position(8, 0), Position(-6, 4)})
+    {
+        const MapPoint pt = world.MakeMapPoint(hqPos + offset);
+        if(world.GetNode(pt).obj)
+            continue;
+        world.SetNO(pt, new noFire(pt, false));
+        world.RecalcBQAroundPoint(pt);
+    }
+
+    ReplayKeyframes keyframes(20);
+    for(unsigned gf = 0; gf < 50; gf++)
+    {
+        if(keyframes.IsKeyframeDue(em.GetCurrentGF()))
+            keyframes.Add(*game, 0, std::nullopt);
+        em.ExecuteNextGF();
+    }
+    BOOST_TEST_REQUIRE(keyframes.GetNumKeyframes() >= 2u);
+    const unsigned targetGF = em.GetCurrentGF();
+    const AsyncChecksum expectedChecksum = AsyncChecksum::create(*game);
+    SerializedGameData expectedSgd;
+    expectedSgd.MakeSnapshot(*game);
+
+    // Jump back to the target by restarting at the last keyframe before it, like the replay seek does
+    const ReplayKeyframe* keyframe = keyframes.FindBefore(targetGF);
+    BOOST_TEST_REQUIRE(keyframe);
+    BOOST_TEST_REQUIRE(keyframe->gf < targetGF);
+    SerializedGameData sgd;
+    ReplayKeyframes::GetSnapshot(*keyframe, sgd);
+    MockLocalGameState lgs;
+    em.Clear();
+    world.Unload();
+    sgd.ReadSnapshot(*game, lgs);
+    world.InitAfterLoad();
+    RANDOM.ResetState(keyframe->rngState);
+    BOOST_TEST_REQUIRE(em.GetCurrentGF() == keyframe->gf);
+    BOOST_TEST(AsyncChecksum::create(*game) != expectedChecksum);
+
+    while(em.GetCurrentGF() < targetGF)
+        em.ExecuteNextGF();
+    BOOST_TEST(AsyncChecksum::create(*game) == expectedChecksum);
+    SerializedGameData seekedSgd;
+    seekedSgd.MakeSnapshot(*game);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(seekedSgd.GetData(), seekedSgd.GetData() + seekedSgd.GetLength(),
+                                    expectedSgd.GetData(), expectedSgd.GetData() + expectedSgd.GetLength());
+}
+
+BOOST_FIXTURE_TEST_CASE(SaveInBackground, RandWorldFixture)
+{
+    RTTR_SKIP_GFS(10);
+    auto save = std::make_unique<Savegame>();
+    for(unsigned i = 0; i < world.GetNumPlayers(); i++)
+        save->AddPlayer(world.GetPlayer(i));
+    save->ggs = ggs;
+    save->start_gf = em.GetCurrentGF();
+    save->sgd.MakeSnapshot(*game);
+    SerializedGameData expectedSgd;
+    expectedSgd.MakeSnapshot(*game);
+
+    TmpFile tmpFile(".sav");
+    BOOST_TEST_REQUIRE(tmpFile.isValid());
+    tmpFile.close();
+
+    BackgroundSaver saver;
+    BOOST_TEST(!saver.IsSaving());
+    BOOST_TEST(!saver.WaitForResult());
+    BOOST_TEST_REQUIRE(saver.Start(std::move(save), tmpFile.filePath, "MapTitle", std::chrono::milliseconds(42)));
+    BOOST_TEST(saver.IsSaving());
+    // Only 1 save at a time
+    BOOST_TEST(!saver.Start(std::make_unique<Savegame>(), tmpFile.filePath, "MapTitle", {}));
+
+    const auto result = saver.WaitForResult();
+    BOOST_TEST_REQUIRE(result.has_value());
+    BOOST_TEST(!saver.IsSaving());
+    BOOST_TEST(!saver.FetchResult());
+    BOOST_TEST(result->success);
+    BOOST_TEST(result->error.empty());
+    BOOST_TEST(result->filepath == tmpFile.filePath);
+    BOOST_TEST((result->snapshotTime == std::chrono::milliseconds(42)));
+
+    Savegame loadSave;
+    BOOST_TEST_REQUIRE(loadSave.Load(tmpFile.filePath, SaveGameDataToLoad::All));
+    BOOST_TEST(loadSave.GetMapName() == "MapTitle");
+    BOOST_TEST(loadSave.start_gf == em.GetCurrentGF());
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(loadSave.sgd.GetData(), loadSave.sgd.GetData() + loadSave.sgd.GetLength(),
+                                    expectedSgd.GetData(), expectedSgd.GetData() + expectedSgd.GetLength());
+
+    // Errors are reported in the result
+    BOOST_TEST_REQUIRE(
+      saver.Start(std::make_unique<Savegame>(), tmpFile.filePath / "invalid" / "file.sav", "MapTitle", {}));
+    BOOST_TEST_REQUIRE(saver.IsSaving());
+    std::optional<BackgroundSaver::Result> errorResult;
+    while(!(errorResult = saver.FetchResult()))
+        std::this_thread::yield();
+    BOOST_TEST(!errorResult->success);
+    BOOST_TEST(!errorResult->error.empty());
+}
+
 BOOST_FIXTURE_TEST_CASE(SerializeHunter, EmptyWorldFixture1P)
 {
     SerializedGameData sgd;
@@ -7,20 +7,28 @@
 #include "PointOutput.h"
 #include "RttrConfig.h"
 #include "RttrForeachPt.h"
+#include "Ware.h"
+#include "buildings/nobBaseWarehouse.h"
 #include "files.h"
 #include "lua/GameDataLoader.h"
 #include "worldFixtures/CreateEmptyWorld.h"
 #include "worldFixtures/MockLocalGameState.h"
 #include "worldFixtures/WorldFixture.h"
 #include "world/MapLoader.h"
+#include "world/VisionMap.h"
+#include "world/WorldDigest.h"
 #include "nodeObjs/noBase.h"
+#include "nodeObjs/noFlag.h"
 #include "gameTypes/GameTypesOutput.h"
+#include "gameData/MilitaryConsts.h"
 #include "libsiedler2/ArchivItem_Map.h"
 #include "libsiedler2/ArchivItem_Map_Header.h"
 #include "rttr/test/LogAccessor.hpp"
 #include "s25util/tmpFile.h"
 #include <boost/filesystem/path.hpp>
 #include <boost/test/unit_test.hpp>
+#include <memory>
+#include <thread>
 #include <vector>
 
 struct MapTestFixture
@@ -72,6 +80,7 @@ struct LoadWorldAndS2MapCreator : MapTestFixture
 using WorldLoadedWithS2MapFixture = WorldFixture<LoadWorldAndS2MapCreator>;
 using WorldLoaded1PFixture = WorldFixture<LoadWorldFromFileCreator, 1>;
 using WorldFixtureEmpty1P = WorldFixture<CreateEmptyWorld, 1>;
+using WorldFixtureEmpty1PBig = WorldFixture<CreateEmptyWorld, 1, 40, 40>;
 } // namespace
 
 BOOST_FIXTURE_TEST_CASE(LoadWorld, WorldFixture<UninitializedWorldCreator>)
@@ -247,6 +256,175 @@ BOOST_FIXTURE_TEST_CASE(NONothingOnEmptyNode, WorldFixtureEmpty1P)
     BOOST_TEST(world.GetGOT(emptySpot) == GO_Type::Nothing);
 }
 
+BOOST_FIXTURE_TEST_CASE(VisionMapCountsViewers, WorldFixtureEmpty1P)
+{
+    VisionMap visionMap(world);
+    visionMap.Init(world.GetSize(), world.GetNumPlayers());
+    const MapPoint center(world.GetSize().x / 2, world.GetSize().y / 2);
+    visionMap.AddViewer(center, 2, 0);
+    visionMap.AddViewer(center, 1, 0);
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+    {
+        const unsigned distance = world.CalcDistance(pt, center);
+        const unsigned expectedViewers = (distance <= 2 ? 1u : 0u) + (distance <= 1 ? 1u : 0u);
+        BOOST_TEST(visionMap.GetNumViewers(pt, 0) == expectedViewers);
+        BOOST_TEST(visionMap.IsVisible(pt, 0) == (expectedViewers > 0));
+    }
+    visionMap.RemoveViewer(center, 2, 0);
+    visionMap.RemoveViewer(center, 1, 0);
+    // Radius exceeds the map size -> Every node is seen exactly once although the radius wraps around
+    visionMap.AddViewer(center, 20, 0);
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        BOOST_TEST(visionMap.GetNumViewers(pt, 0) == 1u);
+    visionMap.RemoveViewer(center, 20, 0);
+    RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        BOOST_TEST(visionMap.GetNumViewers(pt, 0) == 0u);
+
+    // Viewers of objects can be excluded
+    const noBase& hq = *world.GetNO(world.GetPlayer(0).GetHQPos());
+    visionMap.AddObjectViewer(hq, center, 3, 0);
+    BOOST_TEST(visionMap.HasObjectViewer(hq));
+    BOOST_TEST(visionMap.IsVisible(center, 0));
+    BOOST_TEST(!visionMap.IsVisible(center, 0, &hq));
+    visionMap.AddViewer(center, 1, 0);
+    BOOST_TEST(visionMap.IsVisible(center, 0, &hq));
+    visionMap.RemoveObjectViewer(hq);
+    BOOST_TEST(!visionMap.HasObjectViewer(hq));
+    BOOST_TEST(visionMap.GetNumViewers(center, 0) == 1u);
+    BOOST_TEST(visionMap.GetNumViewers(world.MakeMapPoint(Position(center) + Position(3, 0)), 0) == 0u);
+}
+
+BOOST_FIXTURE_TEST_CASE(VisionMapContainsHQ, WorldFixtureEmpty1PBig)
+{
+    const MapPoint hqPos = world.GetPlayer(0).GetHQPos();
+    const auto* hq = world.GetSpecObj<nobBaseWarehouse>(hqPos);
+    BOOST_TEST_REQUIRE(hq);
+    const VisionMap& visionMap = world.GetVisionMap();
+    const auto checkViewers = [&](const unsigned numHQViewers) {
+        RTTR_FOREACH_PT(MapPoint, world.GetSize())
+        {
+            const bool inRange = world.CalcDistance(pt, hqPos) <= HQ_RADIUS + VISUALRANGE_MILITARY;
+            BOOST_TEST_REQUIRE(visionMap.GetNumViewers(pt, 0) == (inRange ? numHQViewers : 0u));
+        }
+    };
+    checkViewers(1);
+    const MapPoint edgePt = world.MakeMapPoint(Position(hqPos) + Position(HQ_RADIUS + VISUALRANGE_MILITARY, 0));
+    BOOST_TEST(visionMap.IsVisible(edgePt, 0));
+    BOOST_TEST(!visionMap.IsVisible(edgePt, 0, hq));
+    // Recalculating from scratch (as after loading) finds the HQ too
+    world.InitAfterLoad();
+    checkViewers(1);
+
+    world.DestroyNO(hqPos);
+    checkViewers(0);
+}
+
+namespace {
+/// Check that the incrementally updated digest matches a freshly calculated one and return its hash
+unsigned checkDigest(GameWorld& world)
+{
+    const WorldDigest digest = world.GetDigest();
+    world.RecalcDigest();
+    BOOST_TEST(world.GetDigest().GetHash() == digest.GetHash());
+    BOOST_TEST(world.GetDigest().GetRegionHashes() == digest.GetRegionHashes(), boost::test_tools::per_element());
+    BOOST_TEST(WorldDigest::CombineHashes(digest.GetRegionHashes(), 0, digest.GetRegionHashes().size())
+               == digest.GetHash());
+    return digest.GetHash();
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_CASE(WorldDigestIsUpdated, WorldFixtureEmpty1P)
+{
+    const unsigned origHash = checkDigest(world);
+    BOOST_TEST(origHash != 0u);
+    const MapPoint hqPos = world.GetPlayer(0).GetHQPos();
+    const MapPoint flagPt = world.MakeMapPoint(hqPos + Position(4, 2));
+    const unsigned flagRegion = world.GetDigest().GetRegion(flagPt);
+    const unsigned origRegionHash = world.GetDigest().GetRegionHashes()[flagRegion];
+
+    // Owner
+    const unsigned char owner = world.GetNode(flagPt).owner;
+    world.SetOwner(flagPt, owner + 1);
+    BOOST_TEST(checkDigest(world) != origHash);
+    BOOST_TEST(world.GetDigest().GetRegionHashes()[flagRegion] != origRegionHash);
+    world.SetOwner(flagPt, owner);
+    BOOST_TEST(checkDigest(world) == origHash);
+
+    // Object and ware at flag
+    world.SetFlag(flagPt, 0);
+    const unsigned flagHash = checkDigest(world);
+    BOOST_TEST(flagHash != origHash);
+    auto* flag = world.GetSpecObj<noFlag>(flagPt);
+    BOOST_TEST_REQUIRE(flag);
+    auto* hq = world.GetSpecObj<nobBaseWarehouse>(hqPos);
+    const std::vector<unsigned> regionHashes = world.GetDigest().GetRegionHashes();
+    auto ware = std::make_unique<Ware>(GoodType::Flour, hq, flag);
+    ware->WaitAtFlag(flag);
+    flag->AddWare(std::move(ware));
+    BOOST_TEST(checkDigest(world) != flagHash);
+    // Only the region of the flag is affected
+    for(unsigned i = 0; i < regionHashes.size(); i++)
+        BOOST_TEST((world.GetDigest().GetRegionHashes()[i] == regionHashes[i]) == (i != flagRegion));
+
+    // Removing everything restores the original digest
+    world.DestroyFlag(flagPt, 0);
+    BOOST_TEST(checkDigest(world) == origHash);
+}
+
+BOOST_FIXTURE_TEST_CASE(AllocationStatsCountObjectsPerType, WorldFixtureEmpty1P)
+{
+    const MapPoint flagPt = world.MakeMapPoint(world.GetPlayer(0).GetHQPos() + Position(4, 2));
+    const auto origStats = GameObject::GetAllocationStats();
+    BOOST_TEST(origStats[GO_Type::Flag].numObjects == 1u); // HQ flag
+    const unsigned origObjIdCounter = GameObject::GetObjIDCounter();
+
+    world.SetFlag(flagPt, 0);
+    const auto stats = GameObject::GetAllocationStats();
+    BOOST_TEST(stats[GO_Type::Flag].numObjects == 2u);
+    BOOST_TEST(stats[GO_Type::Flag].numBytes == 2u * origStats[GO_Type::Flag].numBytes);
+    BOOST_TEST(stats[GO_Type::Flag].numBytes >= 2u * sizeof(noFlag));
+    // IDs are assigned as before
+    BOOST_TEST(world.GetSpecObj<noFlag>(flagPt)->GetObjId() == origObjIdCounter + 1u);
+
+    world.DestroyFlag(flagPt, 0);
+    BOOST_TEST(GameObject::GetAllocationStats()[GO_Type::Flag].numObjects == 1u);
+    // Memory of the destroyed flag is reused
+    world.SetFlag(flagPt, 0);
+    BOOST_TEST(GameObject::GetAllocationStats()[GO_Type::Flag].numObjects == 2u);
+    BOOST_TEST(GameObject::GetContext().objAllocator.getReservedBytes() > 0u);
+}
+
+namespace {
+template<size_t T_size>
+class PaddedObject : public GameObject
+{
+    char padding[T_size] = {};
+
+public:
+    // LCOV_EXCL_START
+    void Destroy() override {}
+    void Serialize(SerializedGameData&) const override {}
+    GO_Type GetGOT() const override { return GO_Type::Staticobject; }
+    // LCOV_EXCL_STOP
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(ObjectsFreedAfterTheThreadContext)
+{
+    unsigned numObjs = 0;
+    std::thread([&numObjs] {
+        // Constructed before the context of the thread, so destroyed after it
+        thread_local std::vector<std::unique_ptr<GameObject>> objects;
+        // From a slab and from the system allocator
+        objects.push_back(std::make_unique<PaddedObject<16>>());
+        objects.push_back(std::make_unique<PaddedObject<helpers::SlabAllocator::maxBlockSize * 2>>());
+        numObjs = GameObject::GetNumObjs();
+    }).join();
+    // Other threads don't affect this one
+    BOOST_TEST(numObjs == 2u);
+    BOOST_TEST(GameObject::TryGetContext() == &GameObject::GetContext());
+}
+
 BOOST_FIXTURE_TEST_CASE(LoadLua, WorldFixture<UninitializedWorldCreator>)
 {
     MapLoader loader(world);
@@ -97,6 +97,41 @@ BOOST_AUTO_TEST_CASE(Smooth_interpolates_values_around_peak)
     }
 }
 
+BOOST_AUTO_TEST_CASE(Smooth_sets_average_of_points_in_radius)
+{
+    // Includes maps smaller than the kernel, so points wrap around
+    for(const MapExtent size : {MapExtent(64, 48), MapExtent(15, 8), MapExtent(4, 2)})
+    {
+        for(unsigned radius = 0; radius <= 4; radius++)
+        {
+            BOOST_TEST_INFO("Size: " << size << " Radius: " << radius);
+            NodeMapBase<int> nodes;
+            nodes.Resize(size);
+            RTTR_FOREACH_PT(MapPoint, size)
+                nodes[pt] = (pt.x * 7919 + pt.y * 104729) % 1000 - 100;
+            NodeMapBase<int> expectedNodes = nodes;
+            for(unsigned i = 0; i < 2; i++)
+            {
+                const NodeMapBase<int> lastNodes = expectedNodes;
+                RTTR_FOREACH_PT(MapPoint, size)
+                {
+                    const auto pts = lastNodes.PointsInRadius(pt, radius, true);
+                    int sum = 0;
+                    for(const MapPoint p : pts)
+                        sum += lastNodes[p];
+                    expectedNodes[pt] = static_cast<int>(round(static_cast<double>(sum) / pts.size()));
+                }
+            }
+
+            Smooth(2, radius, nodes);
+
+            BOOST_TEST(std::vector<int>(nodes.begin(), nodes.end())
+                         == std::vector<int>(expectedNodes.begin(), expectedNodes.end()),
+                       boost::test_tools::per_element());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_CASE(Scale_updates_minimum_and_maximum_values_correctly)
 {
     MapExtent size(16, 8);
@@ -17,6 +17,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/nowide/fstream.hpp>
 #include <boost/test/unit_test.hpp>
+#include <future>
 
 namespace fs = boost::filesystem;
 
@@ -142,6 +143,26 @@ BOOST_FIXTURE_TEST_CASE(Overrides, CreateTestData)
     logAcc.clearLog();
 }
 
+BOOST_FIXTURE_TEST_CASE(LoadFromMultipleThreads, CreateTestData)
+{
+    rttr::test::LogAccessor logAcc;
+    const ArchiveLoader loader(LOG);
+    const ResolvedFile file{mainFile, overrideFolder1 / mainFile.filename(), overrideFolder2 / mainFile.filename()};
+
+    std::vector<std::future<libsiedler2::Archiv>> archives;
+    for(unsigned i = 0; i < 8; i++)
+        archives.push_back(std::async(std::launch::async, [&loader, &file]() { return loader.load(file); }));
+    for(auto& archive : archives)
+        BOOST_TEST(compareTxts(archive.get(), "2|10|20|30"));
+
+    // Messages are full lines and don't get mixed
+    for(const std::string& line : Tokenizer(logAcc.getLog(), "\n").explode())
+    {
+        if(!line.empty())
+            BOOST_TEST(line.find("Loaded ") == 0u);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(BobOverrides)
 {
     rttr::test::LogAccessor logAcc;
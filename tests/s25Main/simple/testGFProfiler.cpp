@@ -0,0 +1,69 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "GFProfiler.h"
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(GFProfilerSuite)
+
+BOOST_AUTO_TEST_CASE(RecordsMeasurementsPerGF)
+{
+    GFProfiler::Clear();
+    BOOST_TEST(GFProfiler::GetProfiles().empty());
+
+    {
+        // AIs run before the GF and belong to it
+        const GFProfiler::AIScope ai(1);
+    }
+    {
+        const GFProfiler::GFScope gf(42);
+        for(int i = 0; i < 3; i++)
+            const GFProfiler::EventScope event(GO_Type::NofCarrier);
+        GFProfiler::AddPathfinderCall();
+        GFProfiler::AddExpandedNode();
+        GFProfiler::AddExpandedNode();
+        GFProfiler::AddPhaseTime(SimulationPhase::Pathfinding, std::chrono::milliseconds(2));
+    }
+    {
+        const GFProfiler::GFScope gf(43);
+    }
+    const std::vector<GFProfile> profiles = GFProfiler::GetProfiles();
+    BOOST_TEST_REQUIRE(profiles.size() == 2u);
+    const GFProfile& profile = profiles[0];
+    BOOST_TEST(profile.gf == 42u);
+    BOOST_TEST(profile.numEvents[GO_Type::NofCarrier] == 3u);
+    BOOST_TEST(profile.numEvents[GO_Type::Ship] == 0u);
+    BOOST_TEST(profile.numPathfinderCalls == 1u);
+    BOOST_TEST(profile.numExpandedNodes == 2u);
+    BOOST_TEST((profile.phaseTimes[SimulationPhase::Pathfinding] == std::chrono::milliseconds(2)));
+    BOOST_TEST((profile.aiRuns[1].start <= profile.run.start));
+    BOOST_TEST((profile.aiRuns[0].length == GFProfile::duration::zero()));
+    // Measurements are reset for the next GF
+    BOOST_TEST(profiles[1].gf == 43u);
+    BOOST_TEST(profiles[1].numEvents[GO_Type::NofCarrier] == 0u);
+    BOOST_TEST(profiles[1].numExpandedNodes == 0u);
+
+    std::ostringstream trace;
+    GFProfiler::WriteChromeTrace(trace);
+    BOOST_TEST(trace.str().find(R"("name":"GF")") != std::string::npos);
+    BOOST_TEST(trace.str().find(R"("NofCarrier":"3 events)") != std::string::npos);
+    BOOST_TEST(trace.str().find(R"("name":"AI","ph":"X","pid":1,"tid":2)") != std::string::npos);
+    GFProfiler::Clear();
+}
+
+BOOST_AUTO_TEST_CASE(KeepsOnlyLastGFs)
+{
+    GFProfiler::Clear();
+    for(unsigned gf = 0; gf < GFProfiler::maxNumProfiles + 10; gf++)
+        const GFProfiler::GFScope scope(gf);
+    const std::vector<GFProfile> profiles = GFProfiler::GetProfiles();
+    BOOST_TEST_REQUIRE(profiles.size() == GFProfiler::maxNumProfiles);
+    BOOST_TEST(profiles.front().gf == 10u);
+    BOOST_TEST(profiles.back().gf == GFProfiler::maxNumProfiles + 9u);
+    GFProfiler::Clear();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -303,6 +303,24 @@ BOOST_AUTO_TEST_CASE(Serialization)
             BOOST_TEST(msgOut2->entries[i].objId == msgIn2.entries[i].objId);
         }
     }
+    {
+        const GameMessage_GetWorldDigest msgIn(randomValue<unsigned>(), randomValue<unsigned>(),
+                                               randomValue<unsigned>(), randomValue<unsigned>());
+        const auto msgOut = serializeDeserializeMessage(msgIn);
+        BOOST_TEST(msgOut->digest == msgIn.digest);
+        BOOST_TEST(msgOut->firstRegion == msgIn.firstRegion);
+        BOOST_TEST(msgOut->numRegions == msgIn.numRegions);
+        BOOST_TEST(msgOut->numParts == msgIn.numParts);
+    }
+    {
+        const GameMessage_WorldDigest msgIn(randomValue<unsigned>(), randomValue<unsigned>(), randomValue<unsigned>(),
+                                            std::vector<unsigned>(randomValue(0, 16), randomValue<unsigned>()));
+        const auto msgOut = serializeDeserializeMessage(msgIn);
+        BOOST_TEST(msgOut->firstRegion == msgIn.firstRegion);
+        BOOST_TEST(msgOut->numRegions == msgIn.numRegions);
+        BOOST_TEST(msgOut->regionsPerRow == msgIn.regionsPerRow);
+        BOOST_TEST(msgOut->partHashes == msgIn.partHashes, boost::test_tools::per_element());
+    }
 }
 
 BOOST_AUTO_TEST_SUITE_END()
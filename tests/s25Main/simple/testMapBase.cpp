@@ -11,6 +11,7 @@
 #include <rttr/test/random.hpp>
 #include <boost/test/unit_test.hpp>
 #include <array>
+#include <vector>
 
 BOOST_AUTO_TEST_SUITE(WorldCreationSuite)
 
@@ -151,6 +152,44 @@ BOOST_AUTO_TEST_CASE(GetMatchingPointsInRadius)
     BOOST_TEST(firstEvenPt.front() == evenPts.front());
 }
 
+BOOST_AUTO_TEST_CASE(PointsInRadiusRange)
+{
+    MapBase world;
+    world.Resize(MapExtent(20, 30));
+    for(const MapPoint center : {MapPoint(0, 0), MapPoint(19, 29), MapPoint(7, 12), MapPoint(8, 13)})
+    {
+        BOOST_TEST_INFO("Center: " << center);
+        for(unsigned radius = 0; radius <= 6; radius++)
+        {
+            BOOST_TEST_INFO("Radius: " << radius);
+            // Same points in same order
+            const std::vector<MapPoint> expectedPts = world.GetPointsInRadius(center, radius);
+            const auto range = world.PointsInRadius(center, radius);
+            BOOST_TEST(range.size() == expectedPts.size());
+            BOOST_TEST(std::vector<MapPoint>(range.begin(), range.end()) == expectedPts,
+                       boost::test_tools::per_element());
+            const std::vector<MapPoint> expectedPtsWithCenter = world.GetPointsInRadiusWithCenter(center, radius);
+            const auto rangeWithCenter = world.PointsInRadius(center, radius, true);
+            BOOST_TEST(rangeWithCenter.size() == expectedPtsWithCenter.size());
+            BOOST_TEST(std::vector<MapPoint>(rangeWithCenter.begin(), rangeWithCenter.end()) == expectedPtsWithCenter,
+                       boost::test_tools::per_element());
+
+            // Rings contain only the points with exactly that distance
+            const std::vector<MapPoint> ringPts =
+              world.GetPointsInRadius(center, radius, ReturnMapPoint{},
+                                      [&](const MapPoint pt) { return world.CalcDistance(center, pt) == radius; },
+                                      radius == 0);
+            const auto ring = world.PointsOnRing(center, radius);
+            BOOST_TEST(ring.size() == ringPts.size());
+            BOOST_TEST(std::vector<MapPoint>(ring.begin(), ring.end()) == ringPts, boost::test_tools::per_element());
+            for(auto it = ring.begin(); it != ring.end(); ++it)
+                BOOST_TEST(it.GetRadius() == radius);
+        }
+    }
+    BOOST_TEST(world.PointsInRadius(MapPoint(5, 5), 0).empty());
+    BOOST_TEST((world.PointsInRadius(MapPoint(5, 5), 0).begin() == world.PointsInRadius(MapPoint(5, 5), 0).end()));
+}
+
 BOOST_AUTO_TEST_CASE(GetIdx)
 {
     MapBase world;
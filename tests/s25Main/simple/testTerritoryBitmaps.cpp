@@ -0,0 +1,80 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "PointOutput.h"
+#include "RttrForeachPt.h"
+#include "world/MapBase.h"
+#include "world/TerritoryBitmaps.h"
+#include <rttr/test/random.hpp>
+#include <boost/test/unit_test.hpp>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(TerritoryBitmapsSuite)
+
+BOOST_AUTO_TEST_CASE(MatchesOwnersOfNodes)
+{
+    using rttr::test::randomValue;
+    // Width not a multiple of the word size and with more than 1 word per row
+    for(const MapExtent size : {MapExtent(70, 10), MapExtent(64, 8), MapExtent(10, 12)})
+    {
+        BOOST_TEST_CONTEXT("Size " << size)
+        {
+            MapBase world;
+            world.Resize(size);
+            TerritoryBitmaps bitmaps;
+            bitmaps.Init(size);
+            std::vector<unsigned char> owners(prodOfComponents(size));
+            // Few players to get big areas with interior nodes. Set some nodes twice to test changing owners
+            for(unsigned i = 0; i < owners.size() * 2; i++)
+            {
+                const MapPoint pt(randomValue<MapCoord>(0, size.x - 1), randomValue<MapCoord>(0, size.y - 1));
+                const auto newOwner = static_cast<unsigned char>(randomValue(0, 2));
+                for(const MapPoint curPt : world.GetPointsInRadiusWithCenter(pt, 1))
+                {
+                    bitmaps.ChangeOwner(curPt, owners[world.GetIdx(curPt)], newOwner);
+                    owners[world.GetIdx(curPt)] = newOwner;
+                }
+            }
+
+            std::vector<TerritoryBitmaps::Word> borderRow;
+            for(unsigned char owner = 1; owner <= 3; owner++)
+            {
+                unsigned numOwned = 0;
+                RTTR_FOREACH_PT(MapPoint, size)
+                {
+                    if(pt.x == 0)
+                        bitmaps.GetBorderRow(owner, pt.y, borderRow);
+                    const bool isOwned = owners[world.GetIdx(pt)] == owner;
+                    bool isInterior = isOwned;
+                    for(const MapPoint nb : world.GetNeighbours(pt))
+                        isInterior &= owners[world.GetIdx(nb)] == owner;
+                    BOOST_TEST_CONTEXT("Owner " << unsigned(owner) << " at " << pt)
+                    {
+                        BOOST_TEST(bitmaps.IsOwned(pt, owner) == isOwned);
+                        BOOST_TEST(bitmaps.IsInterior(pt, owner) == isInterior);
+                        BOOST_TEST(TerritoryBitmaps::IsSet(borderRow, pt.x) == (isOwned && !isInterior));
+                    }
+                    if(isOwned)
+                        numOwned++;
+                }
+                BOOST_TEST(bitmaps.CountOwned(owner, MapPoint(0, 0), size) == numOwned);
+                // Areas wrapping around the map
+                const MapPoint start(randomValue<MapCoord>(0, size.x - 1), randomValue<MapCoord>(0, size.y - 1));
+                const MapExtent areaSize(randomValue<MapCoord>(1, size.x), randomValue<MapCoord>(1, size.y));
+                unsigned numOwnedInArea = 0;
+                RTTR_FOREACH_PT(MapPoint, areaSize)
+                {
+                    const MapPoint curPt((start.x + pt.x) % size.x, (start.y + pt.y) % size.y);
+                    if(owners[world.GetIdx(curPt)] == owner)
+                        numOwnedInArea++;
+                }
+                BOOST_TEST(bitmaps.CountOwned(owner, start, areaSize) == numOwnedInArea);
+                // Bigger than the map counts every node once
+                BOOST_TEST(bitmaps.CountOwned(owner, start, size + MapExtent(5, 5)) == numOwned);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+// Copyright (C) 2005 - 2024 Settlers Freaks (sf-team at siedler25.org)
+//
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "network/WorldDigestBisection.h"
+#include "world/WorldDigest.h"
+#include <rttr/test/random.hpp>
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <vector>
+
+namespace {
+/// Players with their world digests, answering requests like the clients do
+struct BisectionFixture
+{
+    static constexpr unsigned numPlayers = 3;
+    const MapExtent mapSize = MapExtent(256, 128);
+    std::vector<WorldDigest> digests;
+
+    BisectionFixture() : digests(numPlayers)
+    {
+        for(WorldDigest& digest : digests)
+            digest.Init(mapSize);
+        // Same world for everyone
+        for(unsigned i = 0; i < 500; i++)
+        {
+            const MapPoint pt(rttr::test::randomValue<MapCoord>(0, mapSize.x - 1),
+                              rttr::test::randomValue<MapCoord>(0, mapSize.y - 1));
+            const unsigned value = rttr::test::randomValue(1u, 1000u);
+            for(WorldDigest& digest : digests)
+                digest.Toggle(pt, WorldDigest::Kind::Figure, value);
+        }
+    }
+
+    WorldDigestBisection startBisection(const uint8_t refPlayerId = 0) const
+    {
+        WorldDigestBisection bisection(refPlayerId);
+        for(unsigned i = 0; i < numPlayers; i++)
+        {
+            AsyncChecksum checksum;
+            checksum.worldDigest = digests[i].GetHash();
+            bisection.AddPlayer(static_cast<uint8_t>(i), checksum);
+        }
+        return bisection;
+    }
+
+    void answer(WorldDigestBisection& bisection, const WorldDigestBisection::Request& request) const
+    {
+        const std::vector<unsigned>& regionHashes = digests[request.playerId].GetRegionHashes();
+        const unsigned numRegions = request.numRegions ? request.numRegions : regionHashes.size();
+        const unsigned numParts = std::min(request.numParts, numRegions);
+        BOOST_TEST_REQUIRE(bisection.AddAnswer(
+          request.playerId, request.firstRegion, numRegions, digests[request.playerId].GetRegionsPerRow(),
+          WorldDigestBisection::GetPartHashes(regionHashes, request.firstRegion, numRegions, numParts)));
+    }
+
+    /// Answer all requests until the bisection is finished and return the found regions
+    std::vector<unsigned> run(WorldDigestBisection& bisection) const
+    {
+        while(!bisection.IsFinished())
+        {
+            for(const WorldDigestBisection::Request& request : bisection.RequestNextRange())
+                answer(bisection, request);
+            BOOST_TEST_REQUIRE(bisection.HasAllAnswers());
+            BOOST_TEST_REQUIRE(bisection.EvaluateAnswers());
+        }
+        std::vector<unsigned> result = bisection.GetAsyncRegions();
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+};
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(WorldDigestBisectionSuite)
+
+BOOST_AUTO_TEST_CASE(PartHashes)
+{
+    const std::vector<unsigned> regionHashes{1, 2, 4, 8, 16, 32, 64};
+    BOOST_TEST(WorldDigestBisection::GetPartHashes(regionHashes, 0, 7, 1) == std::vector<unsigned>{127},
+               boost::test_tools::per_element());
+    BOOST_TEST(WorldDigestBisection::GetPartHashes(regionHashes, 1, 4, 2) == (std::vector<unsigned>{2 | 4, 8 | 16}),
+               boost::test_tools::per_element());
+    BOOST_TEST(WorldDigestBisection::GetPartHashes(regionHashes, 4, 3, 3) == (std::vector<unsigned>{16, 32, 64}),
+               boost::test_tools::per_element());
+    // Invalid ranges
+    BOOST_TEST(WorldDigestBisection::GetPartHashes(regionHashes, 0, 7, 0).empty());
+    BOOST_TEST(WorldDigestBisection::GetPartHashes(regionHashes, 0, 2, 3).empty());
+    BOOST_TEST(WorldDigestBisection::GetPartHashes(regionHashes, 5, 3, 1).empty());
+}
+
+BOOST_FIXTURE_TEST_CASE(FindsDivergentRegions, BisectionFixture)
+{
+    // Same digests: Nothing found after the first request
+    {
+        WorldDigestBisection bisection = startBisection();
+        BOOST_TEST(run(bisection).empty());
+        BOOST_TEST(!bisection.HasPendingRanges());
+    }
+
+    // Player 2 differs in a few nodes
+    const std::vector<MapPoint> divergentPts{MapPoint(0, 0), MapPoint(100, 37), MapPoint(103, 44), MapPoint(255, 127)};
+    std::vector<unsigned> expectedRegions;
+    for(const MapPoint pt : divergentPts)
+    {
+        digests[2].Toggle(pt, WorldDigest::Kind::Owner, rttr::test::randomValue(1u, 7u));
+        expectedRegions.push_back(digests[2].GetRegion(pt));
+    }
+    std::sort(expectedRegions.begin(), expectedRegions.end());
+    expectedRegions.erase(std::unique(expectedRegions.begin(), expectedRegions.end()), expectedRegions.end());
+    BOOST_TEST_REQUIRE(digests[2].GetHash() != digests[0].GetHash());
+
+    for(const unsigned refPlayerId : {0u, 2u})
+    {
+        WorldDigestBisection bisection = startBisection(static_cast<uint8_t>(refPlayerId));
+        BOOST_TEST(run(bisection) == expectedRegions, boost::test_tools::per_element());
+        BOOST_TEST(bisection.GetRegionsPerRow() == mapSize.x / WorldDigest::regionSize);
+        BOOST_TEST(!bisection.HasPendingRanges());
+    }
+}
+
+BOOST_FIXTURE_TEST_CASE(ContinuesWhenPlayerLeaves, BisectionFixture)
+{
+    const MapPoint divergentPt(70, 90);
+    digests[1].Toggle(divergentPt, WorldDigest::Kind::Object, 42);
+
+    WorldDigestBisection bisection = startBisection();
+    std::vector<WorldDigestBisection::Request> requests = bisection.RequestNextRange();
+    BOOST_TEST_REQUIRE(requests.size() == numPlayers);
+    // Player 1 leaves after the others answered
+    answer(bisection, requests[0]);
+    answer(bisection, requests[2]);
+    BOOST_TEST(!bisection.HasAllAnswers());
+    BOOST_TEST(bisection.RemovePlayer(1));
+    BOOST_TEST(bisection.HasAllAnswers());
+    // Already removed
+    BOOST_TEST(!bisection.RemovePlayer(1));
+    // Player 1 is not asked anymore and its late answer is ignored
+    BOOST_TEST(!bisection.AddAnswer(1, 0, 0, 0, {}));
+    BOOST_TEST_REQUIRE(bisection.EvaluateAnswers());
+    BOOST_TEST(bisection.IsFinished());
+    BOOST_TEST(bisection.GetAsyncRegions().empty());
+
+    // Leaving after answering doesn't change the result
+    bisection = startBisection();
+    requests = bisection.RequestNextRange();
+    for(const WorldDigestBisection::Request& request : requests)
+        answer(bisection, request);
+    BOOST_TEST(!bisection.RemovePlayer(1));
+    BOOST_TEST_REQUIRE(bisection.EvaluateAnswers());
+    BOOST_TEST(!bisection.IsFinished());
+    requests = bisection.RequestNextRange();
+    BOOST_TEST(requests.size() == numPlayers - 1u);
+    for(const WorldDigestBisection::Request& request : requests)
+        BOOST_TEST(unsigned(request.playerId) != 1u);
+
+    // Without the reference player the bisection can't continue
+    bisection = startBisection();
+    requests = bisection.RequestNextRange();
+    answer(bisection, requests[1]);
+    answer(bisection, requests[2]);
+    BOOST_TEST(bisection.RemovePlayer(0));
+    BOOST_TEST_REQUIRE(bisection.HasAllAnswers());
+    BOOST_TEST(!bisection.EvaluateAnswers());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
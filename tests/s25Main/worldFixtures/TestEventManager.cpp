@@ -7,51 +7,38 @@
 
 unsigned TestEventManager::ExecuteNextEvent(unsigned maxGF)
 {
-    if(GetCurrentGF() >= maxGF)
+    const unsigned startGF = GetCurrentGF();
+    if(startGF >= maxGF)
         return 0;
-    if(events.empty())
+    const unsigned nextGF = GetNextEventGF();
+    if(nextGF == 0 || nextGF > maxGF)
     {
-        unsigned numGFs = maxGF - GetCurrentGF();
-        currentGF = maxGF;
-        return numGFs;
+        AdvanceToGF(maxGF);
+        return maxGF - startGF;
     }
-    auto itEvents = events.begin();
-    if(itEvents->first > maxGF)
-    {
-        unsigned numGFs = maxGF - GetCurrentGF();
-        currentGF = maxGF;
-        return numGFs;
-    }
-    unsigned numGFs = itEvents->first - GetCurrentGF();
-    currentGF = itEvents->first;
-    ExecuteEvents(itEvents);
+    AdvanceToGF(nextGF);
+    ExecuteCurrentEvents();
     DestroyCurrentObjects();
-    return numGFs;
+    return nextGF - startGF;
 }
 
 std::vector<const GameEvent*> TestEventManager::GetObjEvents(const GameObject& obj) const
 {
     std::vector<const GameEvent*> objEvnts;
-    for(const auto& event : events)
+    for(const GameEvent* ev : GetEvents())
     {
-        for(const GameEvent* ev : event.second)
-        {
-            if(ev->obj == &obj)
-                objEvnts.push_back(ev);
-        }
+        if(ev->obj == &obj)
+            objEvnts.push_back(ev);
     }
     return objEvnts;
 }
 
 bool TestEventManager::IsEventActive(const GameObject& obj, const unsigned id) const
 {
-    for(const auto& event : events)
+    for(const GameEvent* ev : GetEvents())
     {
-        for(const GameEvent* ev : event.second)
-        {
-            if(ev->id == id && ev->obj == &obj)
-                return true;
-        }
+        if(ev->id == id && ev->obj == &obj)
+            return true;
     }
 
     return false;
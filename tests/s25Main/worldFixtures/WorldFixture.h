@@ -126,6 +126,10 @@ public:
 protected:
     // LCOV_EXCL_START
     void AltitudeChanged(MapPoint) override {}
+    void NodeChanged(MapPoint) override {}
+    void FigureAdded(MapPoint, const noBase&) override {}
+    void FigureRemoved(MapPoint, const noBase&) override {}
+    void FigureMoved(MapPoint, MapPoint, const noBase&) override {}
     void VisibilityChanged(MapPoint, unsigned, Visibility, Visibility) override {}
     // LCOV_EXCL_STOP
 };